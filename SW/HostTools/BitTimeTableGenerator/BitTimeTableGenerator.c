@@ -0,0 +1,403 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+* Host tool which use bit time solver from drv_canfdspi_bittime.c to:
+* - check solver against tables from DRV_CANFDSPI_BitTimeConfigure for all
+*   CAN_BITTIME_SETUP values and 40/20/10MHz SYSCLK,
+* - emit constant tables with CiNBTCFG, CiDBTCFG and CiTDC values which can be
+*   written by DRV_CANFDSPI_BitTimeConfigureSolution without solver on target,
+* - solve any nominal/data bit rate pair.
+*
+* Driver files are compiled directly from LPC82X example project and SPI transfers
+* generated by Microchip tables are captured by stub of DRV_SPI_TransferData.
+*
+* Build(gcc or mingw):
+*	gcc -std=gnu99 -Wall -o BitTimeTableGenerator BitTimeTableGenerator.c
+*
+* Usage:
+*	BitTimeTableGenerator check [-l loopDelay]
+*	BitTimeTableGenerator table [-l loopDelay] [-c sysClk]
+*	BitTimeTableGenerator solve nominal data [-l loopDelay] [-b busDelay] [-c sysClk]
+*		[-s nominalSamplePoint] [-S dataSamplePoint] [-t tolerance]
+*
+* Delays are in ns, sample points and tolerance in per mille. Default loop delay is
+* worse case of board with optoisolation(243ns).
+*
+* Check don't require that registers are identical. Entry pass when solver and table
+* are equal(TDCV is ignored in auto mode) or solver has bit rate error and sample point
+* distance from target not bigger than table. Table entry with bit rate error above
+* tolerance(e.g. 3M at 40MHz) pass when solver reject it. Exit code is number of failed
+* entries.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_api.c"
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_bittime.c"
+
+typedef struct
+{
+	CAN_BITTIME_SETUP setup;
+	const char* name;
+	uint32_t nominalBitRate;
+	uint32_t dataBitRate;
+} BITTIME_SETUP_ENTRY;
+
+typedef struct
+{
+	CAN_SYSCLK_SPEED clk;
+	const char* name;
+	uint32_t sysClk;
+} SYSCLK_ENTRY;
+
+static const BITTIME_SETUP_ENTRY BitTimeSetups[] = {
+	{CAN_500K_1M, "CAN_500K_1M", 500000, 1000000},
+	{CAN_500K_2M, "CAN_500K_2M", 500000, 2000000},
+	{CAN_500K_3M, "CAN_500K_3M", 500000, 3000000},
+	{CAN_500K_4M, "CAN_500K_4M", 500000, 4000000},
+	{CAN_500K_5M, "CAN_500K_5M", 500000, 5000000},
+	{CAN_500K_6M7, "CAN_500K_6M7", 500000, 6666667},
+	{CAN_500K_8M, "CAN_500K_8M", 500000, 8000000},
+	{CAN_500K_10M, "CAN_500K_10M", 500000, 10000000},
+	{CAN_250K_500K, "CAN_250K_500K", 250000, 500000},
+	{CAN_250K_833K, "CAN_250K_833K", 250000, 833333},
+	{CAN_250K_1M, "CAN_250K_1M", 250000, 1000000},
+	{CAN_250K_1M5, "CAN_250K_1M5", 250000, 1500000},
+	{CAN_250K_2M, "CAN_250K_2M", 250000, 2000000},
+	{CAN_250K_3M, "CAN_250K_3M", 250000, 3000000},
+	{CAN_250K_4M, "CAN_250K_4M", 250000, 4000000},
+	{CAN_1000K_4M, "CAN_1000K_4M", 1000000, 4000000},
+	{CAN_1000K_8M, "CAN_1000K_8M", 1000000, 8000000},
+	{CAN_125K_500K, "CAN_125K_500K", 125000, 500000},
+};
+
+static const SYSCLK_ENTRY SysClks[] = {
+	{CAN_SYSCLK_40M, "40MHz", 40000000},
+	{CAN_SYSCLK_20M, "20MHz", 20000000},
+	{CAN_SYSCLK_10M, "10MHz", 10000000},
+};
+
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
+
+//registers 0x000 - 0x00C written by driver
+static uint32_t CapturedRegisters[4];
+
+int8_t DRV_SPI_TransferData(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxData, uint8_t *SpiRxData, uint16_t spiTransferSize)
+{
+	uint16_t address;
+	uint16_t i;
+
+	(void)spiSlaveDeviceIndex;
+	memset(SpiRxData, 0, spiTransferSize);
+
+	if((SpiTxData[0] >> 4) != cINSTRUCTION_WRITE)
+	{
+		return 0;
+	}
+
+	address = ((SpiTxData[0] & 0xF) << 8) | SpiTxData[1];
+
+	for(i = 2; i < spiTransferSize; i++, address++)
+	{
+		if(address < sizeof(CapturedRegisters))
+		{
+			((uint8_t*)CapturedRegisters)[address] = SpiTxData[i];
+		}
+	}
+
+	return 0;
+}
+
+int8_t DRV_SPI_TransferFill(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxHeader, uint16_t spiHeaderSize, uint8_t fillByte, uint16_t spiFillSize)
+{
+	//RAM initialization isn't used by tool
+	(void)spiSlaveDeviceIndex;
+	(void)SpiTxHeader;
+	(void)spiHeaderSize;
+	(void)fillByte;
+	(void)spiFillSize;
+
+	return 0;
+}
+
+static void DecodePhase(uint32_t sysClk, uint32_t brp, uint32_t tseg1, uint32_t tseg2, uint32_t* bitRate, uint32_t* samplePoint)
+{
+	uint32_t nTq = 1 + (tseg1 + 1) + (tseg2 + 1);
+
+	*bitRate = sysClk / ((brp + 1) * nTq);
+	*samplePoint = ((tseg1 + 2) * 1000) / nTq;
+}
+
+static uint32_t Distance(uint32_t a, uint32_t b)
+{
+	return (a > b) ? (a - b) : (b - a);
+}
+
+static void PrintSolution(const CAN_BITTIME_SOLUTION* solution)
+{
+	printf("    NBTCFG 0x%08X BRP %3u TSEG1 %3u TSEG2 %3u SJW %3u -> %7u bps(%+ldppm) SP %3u.%u%% margin %ldns\n",
+			solution->nbtcfg.word, solution->nbtcfg.bF.BRP, solution->nbtcfg.bF.TSEG1,
+			solution->nbtcfg.bF.TSEG2, solution->nbtcfg.bF.SJW, solution->nominalBitRate,
+			(long)solution->nominalBitRateError, solution->nominalSamplePoint / 10,
+			solution->nominalSamplePoint % 10, (long)solution->nominalDelayMargin);
+	printf("    DBTCFG 0x%08X BRP %3u TSEG1 %3u TSEG2 %3u SJW %3u -> %7u bps(%+ldppm) SP %3u.%u%% margin %ldns\n",
+			solution->dbtcfg.word, solution->dbtcfg.bF.BRP, solution->dbtcfg.bF.TSEG1,
+			solution->dbtcfg.bF.TSEG2, solution->dbtcfg.bF.SJW, solution->dataBitRate,
+			(long)solution->dataBitRateError, solution->dataSamplePoint / 10,
+			solution->dataSamplePoint % 10, (long)solution->dataDelayMargin);
+	printf("    TDC    0x%08X mode %u TDCO %u TDCV %u\n",
+			solution->tdc.word, solution->tdc.bF.TDCMode, solution->tdc.bF.TDCOffset,
+			solution->tdc.bF.TDCValue);
+}
+
+static int CheckTables(CAN_BITTIME_SOLVER_CONFIG* config)
+{
+	CAN_BITTIME_SOLUTION solution;
+	REG_CiNBTCFG nbtcfg;
+	REG_CiDBTCFG dbtcfg;
+	REG_CiTDC tdc;
+	uint32_t tableNominal, tableData, tableNominalSp, tableDataSp;
+	uint32_t c, s;
+	int8_t tableResult, solverResult;
+	int failed = 0;
+
+	for(c = 0; c < ARRAY_SIZE(SysClks); c++)
+	{
+		for(s = 0; s < ARRAY_SIZE(BitTimeSetups); s++)
+		{
+			memset(CapturedRegisters, 0, sizeof(CapturedRegisters));
+			tableResult = DRV_CANFDSPI_BitTimeConfigure(DRV_CANFDSPI_INDEX_0, BitTimeSetups[s].setup, CAN_SSP_MODE_AUTO, SysClks[c].clk);
+
+			config->sysClk = SysClks[c].sysClk;
+			config->nominalBitRate = BitTimeSetups[s].nominalBitRate;
+			config->dataBitRate = BitTimeSetups[s].dataBitRate;
+			solverResult = DRV_CANFDSPI_BitTimeSolve(config, &solution);
+
+			printf("%s %-14s ", SysClks[c].name, BitTimeSetups[s].name);
+
+			if(tableResult)
+			{
+				printf("table: not supported, solver: %s (%d)\n", (solverResult == 0) ? "ok" : "error", solverResult);
+				if(solverResult == 0 || solverResult <= -4)
+				{
+					PrintSolution(&solution);
+				}
+				continue;
+			}
+
+			nbtcfg.word = CapturedRegisters[cREGADDR_CiNBTCFG / 4];
+			dbtcfg.word = CapturedRegisters[cREGADDR_CiDBTCFG / 4];
+			tdc.word = CapturedRegisters[cREGADDR_CiTDC / 4];
+
+			DecodePhase(config->sysClk, nbtcfg.bF.BRP, nbtcfg.bF.TSEG1, nbtcfg.bF.TSEG2, &tableNominal, &tableNominalSp);
+			DecodePhase(config->sysClk, dbtcfg.bF.BRP, dbtcfg.bF.TSEG1, dbtcfg.bF.TSEG2, &tableData, &tableDataSp);
+
+			//solver reject bit rate which table approximate worse than tolerance
+			if((solverResult == -2 || solverResult == -3)
+				&& (Distance(tableNominal, config->nominalBitRate) > (config->nominalBitRate / 1000) * config->bitRateTolerance
+				|| Distance(tableData, config->dataBitRate) > (config->dataBitRate / 1000) * config->bitRateTolerance))
+			{
+				printf("table out of tolerance(%u bps), solver: error (%d)\n", tableData, solverResult);
+				continue;
+			}
+
+			if(solverResult && solverResult > -4)
+			{
+				printf("FAIL solver error %d\n", solverResult);
+				failed++;
+				continue;
+			}
+
+			//TDCV is measured by chip in auto mode
+			if(tdc.bF.TDCMode == CAN_SSP_MODE_AUTO)
+			{
+				tdc.bF.TDCValue = 0;
+			}
+
+			if(nbtcfg.word == solution.nbtcfg.word && dbtcfg.word == solution.dbtcfg.word && tdc.word == solution.tdc.word)
+			{
+				printf("match%s\n", (solverResult) ? ", delay budget exceeded" : "");
+				continue;
+			}
+
+			if(Distance(solution.nominalBitRate, config->nominalBitRate) <= Distance(tableNominal, config->nominalBitRate)
+				&& Distance(solution.dataBitRate, config->dataBitRate) <= Distance(tableData, config->dataBitRate)
+				&& Distance(solution.nominalSamplePoint, config->nominalSamplePoint) <= Distance(tableNominalSp, config->nominalSamplePoint)
+				&& Distance(solution.dataSamplePoint, config->dataSamplePoint) <= Distance(tableDataSp, config->dataSamplePoint))
+			{
+				printf("differ, solver not worse\n");
+			}
+			else
+			{
+				printf("FAIL\n");
+				failed++;
+			}
+
+			printf("    table: NBTCFG 0x%08X %7u bps SP %u.%u%%, DBTCFG 0x%08X %7u bps SP %u.%u%%, TDC 0x%08X\n",
+					nbtcfg.word, tableNominal, tableNominalSp / 10, tableNominalSp % 10,
+					dbtcfg.word, tableData, tableDataSp / 10, tableDataSp % 10, tdc.word);
+			PrintSolution(&solution);
+		}
+	}
+
+	printf("%d failed\n", failed);
+
+	return failed;
+}
+
+static void EmitTables(CAN_BITTIME_SOLVER_CONFIG* config, uint32_t sysClk)
+{
+	CAN_BITTIME_SOLUTION solution;
+	uint32_t c, s;
+	int8_t result;
+
+	printf("// Generated by BitTimeTableGenerator, loop delay %uns, bus delay %uns, sample point %u/%u per mille\n",
+			config->loopDelay, config->busDelay, config->nominalSamplePoint, config->dataSamplePoint);
+	printf("// Values in order CiNBTCFG, CiDBTCFG, CiTDC, index is CAN_BITTIME_SETUP, zeros mean not possible\n\n");
+
+	for(c = 0; c < ARRAY_SIZE(SysClks); c++)
+	{
+		if(sysClk != 0 && sysClk != SysClks[c].sysClk)
+		{
+			continue;
+		}
+
+		config->sysClk = SysClks[c].sysClk;
+		printf("static const uint32_t canBitTimeTable%s[][3] = {\n", SysClks[c].name);
+
+		for(s = 0; s < ARRAY_SIZE(BitTimeSetups); s++)
+		{
+			config->nominalBitRate = BitTimeSetups[s].nominalBitRate;
+			config->dataBitRate = BitTimeSetups[s].dataBitRate;
+			result = DRV_CANFDSPI_BitTimeSolve(config, &solution);
+
+			if(result)
+			{
+				printf("    {0x00000000, 0x00000000, 0x00000000}%s // %s: solver error %d\n",
+						(s + 1 < ARRAY_SIZE(BitTimeSetups)) ? "," : " ", BitTimeSetups[s].name, result);
+			}
+			else
+			{
+				printf("    {0x%08X, 0x%08X, 0x%08X}%s // %s\n", solution.nbtcfg.word, solution.dbtcfg.word,
+						solution.tdc.word, (s + 1 < ARRAY_SIZE(BitTimeSetups)) ? "," : " ", BitTimeSetups[s].name);
+			}
+		}
+
+		printf("};\n\n");
+	}
+}
+
+static void PrintUsage(void)
+{
+	printf("Usage:\n");
+	printf("  BitTimeTableGenerator check [-l loopDelay]\n");
+	printf("  BitTimeTableGenerator table [-l loopDelay] [-c sysClk]\n");
+	printf("  BitTimeTableGenerator solve nominal data [-l loopDelay] [-b busDelay] [-c sysClk]\n");
+	printf("                        [-s nominalSamplePoint] [-S dataSamplePoint] [-t tolerance]\n");
+}
+
+int main(int argc, char** argv)
+{
+	CAN_BITTIME_SOLVER_CONFIG config;
+	CAN_BITTIME_SOLUTION solution;
+	uint32_t sysClk = 0;
+	int firstOption = 2;
+	int8_t result;
+	int i;
+
+	DRV_CANFDSPI_BitTimeSolverConfigObjectReset(&config);
+	config.loopDelay = CAN_BITTIME_LOOP_DELAY_OPTO;
+
+	if(argc < 2)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	if(strcmp(argv[1], "solve") == 0)
+	{
+		if(argc < 4)
+		{
+			PrintUsage();
+			return -1;
+		}
+
+		config.nominalBitRate = strtoul(argv[2], NULL, 0);
+		config.dataBitRate = strtoul(argv[3], NULL, 0);
+		firstOption = 4;
+	}
+
+	for(i = firstOption; i + 1 < argc; i += 2)
+	{
+		uint32_t value = strtoul(argv[i + 1], NULL, 0);
+
+		if(strcmp(argv[i], "-l") == 0)
+			config.loopDelay = value;
+		else if(strcmp(argv[i], "-b") == 0)
+			config.busDelay = value;
+		else if(strcmp(argv[i], "-c") == 0)
+			sysClk = value;
+		else if(strcmp(argv[i], "-s") == 0)
+			config.nominalSamplePoint = value;
+		else if(strcmp(argv[i], "-S") == 0)
+			config.dataSamplePoint = value;
+		else if(strcmp(argv[i], "-t") == 0)
+			config.bitRateTolerance = value;
+		else
+		{
+			PrintUsage();
+			return -1;
+		}
+	}
+
+	if(strcmp(argv[1], "check") == 0)
+	{
+		return CheckTables(&config);
+	}
+	else if(strcmp(argv[1], "table") == 0)
+	{
+		EmitTables(&config, sysClk);
+		return 0;
+	}
+	else if(strcmp(argv[1], "solve") == 0)
+	{
+		config.sysClk = (sysClk != 0) ? sysClk : 40000000;
+		result = DRV_CANFDSPI_BitTimeSolve(&config, &solution);
+		printf("SYSCLK %uHz, nominal %ubps, data %ubps, loop delay %uns: result %d\n",
+				config.sysClk, config.nominalBitRate, config.dataBitRate, config.loopDelay, result);
+		if(result == 0 || result <= -4)
+		{
+			PrintSolution(&solution);
+		}
+		return (result == 0) ? 0 : 1;
+	}
+
+	PrintUsage();
+	return -1;
+}
@@ -0,0 +1,217 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+* Host tool for bus load and per ID statistics from drv_canfdspi_busload.c.
+*
+* Periodic message set with random jitter is fed to statistics for 10 seconds and
+* snapshot is taken every second. Load must be equal to sum of frame times(frame timing
+* calculator is checked by HostTools/FrameTimeTable) and every frequent ID must be in
+* table with correct mean period. Message set contain more IDs than CAN_BUSLOAD_MAX_IDS,
+* so rare IDs replace each other.
+*
+* Build(gcc or mingw):
+*	gcc -std=gnu99 -Wall -o BusLoadSimulator BusLoadSimulator.c
+*
+* Usage:
+*	BusLoadSimulator [nominal bit rate] [data bit rate]
+*
+* Exit code is number of failed checks.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_frametime.c"
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_busload.c"
+
+#define SIM_TIME 10000000
+#define SIM_WINDOW 1000000
+
+typedef struct
+{
+	uint32_t id;
+	bool extended;
+	uint8_t dlc;
+	bool fd;
+	bool brs;
+	//period and maximal random delay in us
+	uint32_t period;
+	uint32_t jitter;
+	//frequent IDs must be found in table
+	bool frequent;
+} SIM_MESSAGE;
+
+static const SIM_MESSAGE Messages[] = {
+	{0x010, false, 8, false, false, 1000, 0, true},
+	{0x080, false, 8, false, false, 2000, 100, true},
+	{0x100, false, CAN_DLC_64, true, true, 5000, 200, true},
+	{0x18FF1234, true, 8, false, false, 10000, 500, true},
+	{0x200, false, CAN_DLC_16, true, true, 10000, 0, true},
+	{0x1ABCDEF0, true, CAN_DLC_32, true, false, 20000, 1000, true},
+	{0x300, false, 4, false, false, 100000, 0, false},
+	{0x301, false, 2, false, false, 100000, 0, false},
+	{0x302, false, 1, false, false, 200000, 0, false},
+	{0x303, false, 0, false, false, 500000, 0, false},
+	{0x304, false, 8, false, false, 500000, 0, false},
+	{0x305, false, 8, false, false, 1000000, 0, false},
+};
+
+#define SIM_MESSAGES (sizeof(Messages) / sizeof(Messages[0]))
+
+static int CheckTraffic(uint32_t nominalBitRate, uint32_t dataBitRate)
+{
+	static uint8_t data[64];
+	CAN_BUSLOAD load;
+	CAN_BUSLOAD_SNAPSHOT snapshot;
+	CAN_FRAMETIME frameTime;
+	CAN_TX_MSGOBJ obj;
+	const CAN_BUSLOAD_ID* stat;
+	uint32_t release[SIM_MESSAGES];
+	uint32_t next[SIM_MESSAGES];
+	uint32_t sent[SIM_MESSAGES];
+	uint64_t busyNs = 0;
+	uint32_t expectedLoad, period, time, window = SIM_WINDOW;
+	uint32_t i, best;
+	int failed = 0;
+
+	DRV_CANFDSPI_BusLoadInitialize(&load, nominalBitRate, dataBitRate, 0);
+	DRV_CANFDSPI_FrameTimeInitialize(&frameTime, nominalBitRate, dataBitRate);
+	memset(sent, 0, sizeof(sent));
+	for(i = 0; i < SIM_MESSAGES; i++)
+	{
+		release[i] = i * 37;
+		next[i] = release[i];
+	}
+
+	printf("traffic: %u/%u bps, %u IDs, table with %u entries\n", nominalBitRate, dataBitRate,
+			(unsigned)SIM_MESSAGES, CAN_BUSLOAD_MAX_IDS);
+
+	while(window <= SIM_TIME)
+	{
+		//the earliest message, arbitration isn't simulated so frames can overlap
+		best = 0;
+		for(i = 1; i < SIM_MESSAGES; i++)
+		{
+			if(next[i] < next[best])
+				best = i;
+		}
+		time = next[best];
+
+		if(time >= window)
+		{
+			DRV_CANFDSPI_BusLoadSnapshot(&load, window, &snapshot);
+			expectedLoad = (uint32_t)(busyNs / SIM_WINDOW);
+			printf("  window %u: load %u.%u%%(reference %u.%u%%), peak %u.%u%%, %u frames, top ID 0x%X\n",
+					window / SIM_WINDOW, snapshot.load / 10, snapshot.load % 10, expectedLoad / 10, expectedLoad % 10,
+					snapshot.peakLoad / 10, snapshot.peakLoad % 10, snapshot.txFrames, snapshot.topId & 0x1FFFFFFF);
+			if(snapshot.load + 1 < expectedLoad || snapshot.load > expectedLoad + 1)
+			{
+				printf("  FAIL load\n");
+				failed++;
+			}
+			busyNs = 0;
+			window += SIM_WINDOW;
+			continue;
+		}
+
+		obj.word[0] = 0;
+		obj.word[1] = 0;
+		obj.bF.id.SID = Messages[best].extended ? (Messages[best].id >> 18) : Messages[best].id;
+		obj.bF.id.EID = Messages[best].extended ? (Messages[best].id & 0x3FFFF) : 0;
+		obj.bF.ctrl.IDE = Messages[best].extended;
+		obj.bF.ctrl.FDF = Messages[best].fd;
+		obj.bF.ctrl.BRS = Messages[best].brs;
+		obj.bF.ctrl.DLC = Messages[best].dlc;
+		data[0] = sent[best];
+
+		busyNs += DRV_CANFDSPI_FrameTime(&frameTime, obj.word, data);
+
+		DRV_CANFDSPI_BusLoadTxFrame(&load, &obj, data, time);
+		sent[best]++;
+
+		//jitter delay single frame, next frame is released after nominal period
+		release[best] += Messages[best].period;
+		next[best] = release[best] + (Messages[best].jitter ? rand() % (Messages[best].jitter + 1) : 0);
+	}
+
+	printf("  ID          sent  count  error  period  jitter\n");
+	for(i = 0; i < SIM_MESSAGES; i++)
+	{
+		stat = DRV_CANFDSPI_BusLoadIdGet(&load, Messages[i].extended ?
+				CAN_FILTER_EXT_ID(Messages[i].id) : CAN_FILTER_STD_ID(Messages[i].id));
+		if(stat == NULL)
+		{
+			printf("  %08X  %5u  not in table\n", Messages[i].id, sent[i]);
+			if(Messages[i].frequent)
+			{
+				printf("  FAIL frequent ID missing\n");
+				failed++;
+			}
+			continue;
+		}
+
+		period = DRV_CANFDSPI_BusLoadIdPeriod(stat);
+		printf("  %08X  %5u  %5u  %5u  %6u  %6u\n", Messages[i].id, sent[i], stat->count, stat->error,
+				period, DRV_CANFDSPI_BusLoadIdJitter(stat));
+
+		//count is never underestimated and overestimation is bounded by error
+		if(stat->count < sent[i] || stat->count - stat->error > sent[i])
+		{
+			printf("  FAIL count\n");
+			failed++;
+		}
+		if(Messages[i].frequent && (period + Messages[i].period / 100 < Messages[i].period ||
+				period > Messages[i].period + Messages[i].period / 100 ||
+				DRV_CANFDSPI_BusLoadIdJitter(stat) > 2 * Messages[i].jitter))
+		{
+			printf("  FAIL period\n");
+			failed++;
+		}
+	}
+
+	return failed;
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t nominalBitRate = (argc > 1) ? strtoul(argv[1], NULL, 0) : 500000;
+	uint32_t dataBitRate = (argc > 2) ? strtoul(argv[2], NULL, 0) : 2000000;
+	int failed;
+
+	if(nominalBitRate == 0 || dataBitRate == 0)
+	{
+		printf("wrong bit rate\n");
+		return 1;
+	}
+
+	failed = CheckTraffic(nominalBitRate, dataBitRate);
+
+	printf("%d failed\n", failed);
+
+	return failed;
+}
@@ -0,0 +1,356 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+* Host tool which run bus off recovery from drv_canfdspi_recovery.c against simulated
+* MCP2517FD connected by fake DRV_SPI_TransferData.
+*
+* Simulation step is one nominal bit time and CiTBC is incremented every step. Node
+* transmit frame which is never acknowledged, so every 32 bits TEC is incremented by 8:
+* node become error warning, error passive and bus off(CAN_BUS_ERROR_EVENT is set on
+* every change). Bus off is left after 128 * 11 recessive bits. DRV_CANFDSPI_RecoveryService
+* is called every poll period bits.
+*
+* Scenario select behaviour of chip: TXREQ kept or cleared during bus off and operation
+* mode after bus off(normal or restricted, REQOP write is applied one step later). Every
+* scenario check that:
+* - CiCON isn't written while node is bus off,
+* - frame is transmitted after recovery without help of application,
+* - reported offline time is 1408 bits +/- polling latency,
+* - bus off and error passive are counted once.
+*
+* Build(gcc or mingw):
+*	gcc -std=gnu99 -Wall -o BusOffRecoverySimulator BusOffRecoverySimulator.c
+*
+* Usage:
+*	BusOffRecoverySimulator
+*
+* Exit code is number of failed scenarios.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_api.c"
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_recovery.c"
+
+#define SIM_TX_CHANNEL CAN_FIFO_CH2
+#define SIM_ERROR_FRAME_BITS 32
+#define SIM_TIME_LIMIT 100000
+
+typedef struct
+{
+	const char* name;
+	//TXREQ cleared by chip when node enter bus off
+	bool txRequestCleared;
+	//operation mode after bus off
+	CAN_OPERATION_MODE modeAfterBusOff;
+	//DRV_CANFDSPI_RecoveryService is called every pollPeriod bits
+	uint32_t pollPeriod;
+} SIM_SCENARIO;
+
+static const SIM_SCENARIO Scenarios[] = {
+	{"TXREQ kept, poll every bit", false, CAN_NORMAL_MODE, 1},
+	{"TXREQ kept, poll every 100 bits", false, CAN_NORMAL_MODE, 100},
+	{"TXREQ cleared, poll every 100 bits", true, CAN_NORMAL_MODE, 100},
+	{"TXREQ cleared, poll every 1000 bits", true, CAN_NORMAL_MODE, 1000},
+	{"restricted mode after bus off", true, CAN_RESTRICTED_MODE, 100},
+};
+
+static const SIM_SCENARIO* SimScenario;
+static uint8_t SimMemory[0x1000];
+static uint32_t SimTime;
+static uint32_t SimBusOffTime;
+static uint32_t SimRecoveredTime;
+static uint32_t SimSentTime;
+static bool SimBusOff;
+static uint8_t SimPendingMode;
+static uint32_t SimConWritesInBusOff;
+static uint32_t SimSpiTransfers;
+
+static uint16_t SimFifoCon(void)
+{
+	return cREGADDR_CiFIFOCON + (SIM_TX_CHANNEL * CiFIFO_OFFSET);
+}
+
+static void SimSetMode(uint8_t mode)
+{
+	SimMemory[cREGADDR_CiCON + 2] = (SimMemory[cREGADDR_CiCON + 2] & 0x1F) | ((mode & 0x07) << 5);
+}
+
+static uint8_t SimMode(void)
+{
+	return SimMemory[cREGADDR_CiCON + 2] >> 5;
+}
+
+//update CiTREC flags and set CERRIF when they change
+static void SimErrorState(uint16_t tec)
+{
+	uint8_t flags = 0;
+
+	if(tec >= 256)
+	{
+		flags = CAN_TX_BUS_OFF_STATE | CAN_TX_BUS_PASSIVE_STATE | CAN_TX_WARNING_STATE | CAN_TX_RX_WARNING_STATE;
+		tec = 255;
+	}
+	else if(tec >= 128)
+	{
+		flags = CAN_TX_BUS_PASSIVE_STATE | CAN_TX_WARNING_STATE | CAN_TX_RX_WARNING_STATE;
+	}
+	else if(tec >= 96)
+	{
+		flags = CAN_TX_WARNING_STATE | CAN_TX_RX_WARNING_STATE;
+	}
+
+	SimMemory[cREGADDR_CiTREC + 1] = tec;
+	if(SimMemory[cREGADDR_CiTREC + 2] != flags)
+	{
+		SimMemory[cREGADDR_CiTREC + 2] = flags;
+		SimMemory[cREGADDR_CiINTFLAG + 1] |= CAN_BUS_ERROR_EVENT >> 8;
+	}
+}
+
+static void SimStep(void)
+{
+	uint16_t fifoCon = SimFifoCon();
+
+	SimTime++;
+	memcpy(&SimMemory[cREGADDR_CiTBC], &SimTime, 4);
+
+	if(SimPendingMode != CAN_INVALID_MODE)
+	{
+		SimSetMode(SimPendingMode);
+		SimPendingMode = CAN_INVALID_MODE;
+	}
+
+	if(SimBusOff)
+	{
+		if(SimTime - SimBusOffTime >= CAN_RECOVERY_BUS_OFF_BITS)
+		{
+			SimBusOff = false;
+			SimRecoveredTime = SimTime;
+			SimMemory[cREGADDR_CiTREC] = 0;
+			SimErrorState(0);
+			SimSetMode(SimScenario->modeAfterBusOff);
+		}
+		return;
+	}
+
+	if(!(SimMemory[fifoCon + 1] & 0x02) || (SimMode() != CAN_NORMAL_MODE))
+	{
+		return;
+	}
+
+	if(SimRecoveredTime)
+	{
+		//bus is working after recovery, frame is sent
+		SimSentTime = SimTime;
+		SimMemory[fifoCon + 1] &= ~0x02;
+		SimMemory[fifoCon + 4] |= CAN_TX_FIFO_EMPTY_EVENT | CAN_TX_FIFO_NOT_FULL_EVENT;
+	}
+	else if((SimTime % SIM_ERROR_FRAME_BITS) == 0)
+	{
+		//frame isn't acknowledged
+		SimErrorState(SimMemory[cREGADDR_CiTREC + 1] + 8);
+		if(SimMemory[cREGADDR_CiTREC + 2] & CAN_TX_BUS_OFF_STATE)
+		{
+			SimBusOff = true;
+			SimBusOffTime = SimTime;
+			if(SimScenario->txRequestCleared)
+			{
+				SimMemory[fifoCon + 1] &= ~0x02;
+			}
+		}
+	}
+}
+
+static void SimWrite(uint16_t address, uint8_t value)
+{
+	if(address < cREGADDR_CiCON + 4)
+	{
+		if(SimBusOff)
+		{
+			SimConWritesInBusOff++;
+		}
+		SimMemory[address] = value;
+		if(address == cREGADDR_CiCON + 3)
+		{
+			SimPendingMode = value & 0x07;
+		}
+	}
+	else if(address == cREGADDR_CiINTFLAG || address == cREGADDR_CiINTFLAG + 1)
+	{
+		//flags are HS/C, only writing 0 clear them
+		SimMemory[address] &= value;
+	}
+	else
+	{
+		SimMemory[address] = value;
+	}
+}
+
+static void SimReset(void)
+{
+	uint16_t fifoCon = SimFifoCon();
+
+	memset(SimMemory, 0, sizeof(SimMemory));
+	SimTime = 0;
+	SimBusOffTime = 0;
+	SimRecoveredTime = 0;
+	SimSentTime = 0;
+	SimBusOff = false;
+	SimPendingMode = CAN_INVALID_MODE;
+	SimConWritesInBusOff = 0;
+	SimSpiTransfers = 0;
+
+	//normal mode, TX FIFO contain one frame with TXREQ set
+	SimSetMode(CAN_NORMAL_MODE);
+	SimMemory[fifoCon] = 0x80;
+	SimMemory[fifoCon + 1] = 0x02;
+	SimMemory[fifoCon + 4] = CAN_TX_FIFO_NOT_FULL_EVENT;
+}
+
+int8_t DRV_SPI_TransferData(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxData, uint8_t *SpiRxData, uint16_t spiTransferSize)
+{
+	uint16_t address = ((SpiTxData[0] & 0xF) << 8) | SpiTxData[1];
+	uint16_t i;
+
+	(void)spiSlaveDeviceIndex;
+	memset(SpiRxData, 0, spiTransferSize);
+	SimSpiTransfers++;
+
+	for(i = 2; i < spiTransferSize; i++)
+	{
+		if((SpiTxData[0] >> 4) == cINSTRUCTION_READ)
+			SpiRxData[i] = SimMemory[(address + i - 2) & 0xFFF];
+		else if((SpiTxData[0] >> 4) == cINSTRUCTION_WRITE)
+			SimWrite((address + i - 2) & 0xFFF, SpiTxData[i]);
+	}
+
+	return 0;
+}
+
+int8_t DRV_SPI_TransferFill(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxHeader, uint16_t spiHeaderSize, uint8_t fillByte, uint16_t spiFillSize)
+{
+	(void)spiSlaveDeviceIndex;
+	(void)SpiTxHeader;
+	(void)spiHeaderSize;
+	(void)fillByte;
+	(void)spiFillSize;
+
+	return -1;
+}
+
+static int RunScenario(const SIM_SCENARIO* scenario)
+{
+	CAN_RECOVERY recovery;
+	uint32_t activeTransfers = 0;
+	uint32_t activePolls = 0;
+	uint32_t transfers;
+	uint32_t minOffline, maxOffline;
+	int failed = 0;
+
+	SimScenario = scenario;
+	SimReset();
+	DRV_CANFDSPI_RecoveryInitialize(&recovery, DRV_CANFDSPI_INDEX_0, CAN_NORMAL_MODE, 1 << SIM_TX_CHANNEL);
+
+	//chip can send frame before driver notice end of bus off
+	while((!SimSentTime || !recovery.busOffCount || !DRV_CANFDSPI_RecoveryOnline(&recovery)) &&
+			SimTime < SIM_TIME_LIMIT)
+	{
+		SimStep();
+		if((SimTime % scenario->pollPeriod) == 0)
+		{
+			transfers = SimSpiTransfers;
+			if(DRV_CANFDSPI_RecoveryService(&recovery) == CAN_RECOVERY_ERROR_ACTIVE)
+			{
+				activeTransfers += SimSpiTransfers - transfers;
+				activePolls++;
+			}
+		}
+	}
+
+	//offline time is measured from detection of bus off until TXREQ is set
+	minOffline = CAN_RECOVERY_BUS_OFF_BITS - scenario->pollPeriod;
+	maxOffline = CAN_RECOVERY_BUS_OFF_BITS + 2 * scenario->pollPeriod;
+
+	printf("%s:\n", scenario->name);
+	printf("  bus off at %u, recovered at %u, frame sent at %u(%u bits offline)\n",
+			SimBusOffTime, SimRecoveredTime, SimSentTime, SimSentTime - SimBusOffTime);
+	printf("  reported offline %u bits, poll period %u bits, bus off %u, error passive %u\n",
+			recovery.lastOfflineTime, scenario->pollPeriod, recovery.busOffCount, recovery.errorPassiveCount);
+	printf("  %u SPI transfers in %u polls while error active\n", activeTransfers, activePolls);
+
+	if(SimSentTime == 0)
+	{
+		printf("  FAIL frame not sent after recovery\n");
+		failed = 1;
+	}
+	if(SimConWritesInBusOff)
+	{
+		printf("  FAIL %u CiCON writes during bus off\n", SimConWritesInBusOff);
+		failed = 1;
+	}
+	if(recovery.lastOfflineTime < minOffline || recovery.lastOfflineTime > maxOffline)
+	{
+		printf("  FAIL reported offline time out of %u..%u\n", minOffline, maxOffline);
+		failed = 1;
+	}
+	if(SimSentTime - SimBusOffTime > maxOffline)
+	{
+		printf("  FAIL node offline longer than %u bits\n", maxOffline);
+		failed = 1;
+	}
+	if(recovery.busOffCount != 1 || recovery.errorPassiveCount != 1 ||
+			!DRV_CANFDSPI_RecoveryOnline(&recovery) || SimMode() != CAN_NORMAL_MODE)
+	{
+		printf("  FAIL state %u, mode %u\n", recovery.state, SimMode());
+		failed = 1;
+	}
+
+	if(!failed)
+	{
+		printf("  PASS\n");
+	}
+
+	return failed;
+}
+
+int main(void)
+{
+	int failed = 0;
+	uint32_t i;
+
+	for(i = 0; i < sizeof(Scenarios) / sizeof(Scenarios[0]); i++)
+	{
+		failed += RunScenario(&Scenarios[i]);
+	}
+
+	printf("%d failed\n", failed);
+
+	return failed;
+}
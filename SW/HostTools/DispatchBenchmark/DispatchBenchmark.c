@@ -0,0 +1,437 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+* Host tool for software acceptance filter, dispatch table and filter hit dispatch from
+* drv_canfdspi_dispatch.c.
+*
+* Check: for random route sets result of table lookup is compared with linear search
+* through routes for all 2048 standard IDs, for every listed extended ID and for random
+* extended IDs. Dispatch must call handler of route or count rejected frame. Filter hit
+* dispatch is checked with fake SPI which store registers in memory: registered filters
+* must have correct CiFLTOBJm, CiMASKm and CiFLTCONm values, 33rd filter can't be
+* allocated and released filter must be disabled.
+*
+* Benchmark: time of dispatching random frames(half of them accepted) by table, by
+* linear search and by filter hit for different number of routes. Host time is only
+* relative measure, cycles on MCU are measured by example application(canDispatchCycles
+* variable).
+*
+* Build(gcc or mingw):
+*	gcc -std=gnu99 -Wall -O2 -o DispatchBenchmark DispatchBenchmark.c
+*
+* Usage:
+*	DispatchBenchmark [-n frames]
+*
+* Exit code is number of failed checks.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_api.c"
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_filter.c"
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_dispatch.c"
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_image.h"
+
+#define CHECK_SETS 200
+#define FRAME_POOL 4096
+
+static CAN_DISPATCH_ROUTE Routes[255];
+static CAN_DISPATCH_TABLE Table;
+static CAN_FILTER_DISPATCH FilterDispatch;
+static uint8_t Registers[4096];
+static CAN_RX_MSGOBJ Frames[FRAME_POOL];
+static uint8_t Data[64];
+static uint32_t RandomState = 1;
+static uint32_t HandlerCalls;
+static uint32_t DefaultCalls;
+static const CAN_RX_MSGOBJ* LastHeader;
+
+//registers are stored in memory, only read and write instructions are supported
+int8_t DRV_SPI_TransferData(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxData, uint8_t *SpiRxData, uint16_t spiTransferSize)
+{
+	uint16_t address = ((SpiTxData[0] & 0xF) << 8) | SpiTxData[1];
+	uint16_t i;
+
+	(void)spiSlaveDeviceIndex;
+	memset(SpiRxData, 0, spiTransferSize);
+
+	for(i = 2; i < spiTransferSize; i++)
+	{
+		if((SpiTxData[0] >> 4) == cINSTRUCTION_READ)
+			SpiRxData[i] = Registers[(address + i - 2) & 0xFFF];
+		else if((SpiTxData[0] >> 4) == cINSTRUCTION_WRITE)
+			Registers[(address + i - 2) & 0xFFF] = SpiTxData[i];
+	}
+
+	return 0;
+}
+
+int8_t DRV_SPI_TransferFill(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxHeader, uint16_t spiHeaderSize, uint8_t fillByte, uint16_t spiFillSize)
+{
+	(void)spiSlaveDeviceIndex;
+	(void)SpiTxHeader;
+	(void)spiHeaderSize;
+	(void)fillByte;
+	(void)spiFillSize;
+
+	return -1;
+}
+
+static uint32_t Random(void)
+{
+	RandomState = RandomState * 1103515245u + 12345u;
+	return RandomState >> 16;
+}
+
+static void Handler(const CAN_RX_MSGOBJ* header, uint8_t* data)
+{
+	(void)data;
+	LastHeader = header;
+	HandlerCalls++;
+}
+
+static void DefaultHandler(const CAN_RX_MSGOBJ* header, uint8_t* data)
+{
+	(void)header;
+	(void)data;
+	DefaultCalls++;
+}
+
+//reference implementation
+static const CAN_DISPATCH_ROUTE* LinearLookup(uint8_t nRoutes, uint32_t id)
+{
+	uint8_t i;
+
+	for(i = 0; i < nRoutes; i++)
+	{
+		if(Routes[i].id == id)
+			return &Routes[i];
+	}
+
+	return NULL;
+}
+
+static uint32_t RandomId(bool extended)
+{
+	if(extended)
+		return CAN_FILTER_EXT_ID((Random() << 16) ^ Random());
+
+	return CAN_FILTER_STD_ID(Random());
+}
+
+//random routes without duplicates
+static void MakeRoutes(uint8_t nStd, uint8_t nExt)
+{
+	uint8_t i;
+
+	for(i = 0; i < nStd + nExt; i++)
+	{
+		do
+		{
+			Routes[i].id = RandomId(i >= nStd);
+		} while(LinearLookup(i, Routes[i].id) != NULL);
+
+		Routes[i].handler = Handler;
+	}
+}
+
+static void MakeFrame(CAN_RX_MSGOBJ* header, uint32_t id)
+{
+	header->word[0] = 0;
+	header->word[1] = 0;
+	header->word[2] = 0;
+
+	if(id & CAN_FILTER_EXTENDED)
+	{
+		header->bF.id.SID = (id >> 18) & 0x7FF;
+		header->bF.id.EID = id & 0x3FFFF;
+		header->bF.ctrl.IDE = 1;
+	}
+	else
+	{
+		header->bF.id.SID = id;
+	}
+}
+
+static int CheckSet(uint8_t nStd, uint8_t nExt)
+{
+	CAN_RX_MSGOBJ header;
+	uint32_t id;
+	uint32_t i;
+	int errors = 0;
+
+	MakeRoutes(nStd, nExt);
+	if(DRV_CANFDSPI_DispatchInitialize(&Table, Routes, nStd + nExt, DefaultHandler) != 0)
+	{
+		printf("ERROR: %u standard and %u extended routes not accepted\n", nStd, nExt);
+		return 1;
+	}
+
+	for(id = 0; id < 0x800; id++)
+	{
+		if(DRV_CANFDSPI_DispatchLookup(&Table, id) != LinearLookup(nStd + nExt, id))
+		{
+			printf("ERROR: wrong route of standard ID %03X\n", id);
+			errors++;
+		}
+	}
+
+	for(i = 0; i < nStd + nExt + 1000; i++)
+	{
+		id = (i < nStd + nExt) ? Routes[i].id : RandomId(true);
+		if(DRV_CANFDSPI_DispatchLookup(&Table, id) != LinearLookup(nStd + nExt, id))
+		{
+			printf("ERROR: wrong route of ID %08X\n", id);
+			errors++;
+		}
+
+		//frame header is converted to the same ID
+		MakeFrame(&header, id);
+		HandlerCalls = 0;
+		DefaultCalls = 0;
+		LastHeader = NULL;
+		if(DRV_CANFDSPI_Dispatch(&Table, &header, Data) != (LinearLookup(nStd + nExt, id) ? 0 : 1) ||
+				HandlerCalls + DefaultCalls != 1 || (HandlerCalls && LastHeader != &header))
+		{
+			printf("ERROR: frame with ID %08X dispatched wrongly\n", id);
+			errors++;
+		}
+	}
+
+	return errors;
+}
+
+static uint32_t Register(uint16_t address)
+{
+	return Registers[address] | (Registers[address + 1] << 8) | (Registers[address + 2] << 16) |
+			((uint32_t)Registers[address + 3] << 24);
+}
+
+static int CheckFilterDispatch(void)
+{
+	CAN_RX_MSGOBJ header;
+	uint32_t id, mask;
+	int8_t filter;
+	int errors = 0;
+	int i;
+
+	memset(Registers, 0, sizeof(Registers));
+
+	//filter 0 is reserved, so registration start from filter 1
+	DRV_CANFDSPI_FilterDispatchInitialize(&FilterDispatch, 1, DefaultHandler);
+
+	for(i = 1; i < CAN_FILTER_TOTAL; i++)
+	{
+		id = RandomId(i & 1);
+		mask = (i & 1) ? 0x1FFFFFF0 : 0x7F0;
+
+		filter = DRV_CANFDSPI_FilterHandlerRegister(DRV_CANFDSPI_INDEX_0, &FilterDispatch,
+				id, mask, CAN_FIFO_CH2, Handler);
+		if(filter != i)
+		{
+			printf("ERROR: filter %d allocated instead of %d\n", filter, i);
+			errors++;
+			continue;
+		}
+
+		if(Register(cREGADDR_CiFLTOBJ + 8 * i) != ((i & 1) ?
+				CAN_IMAGE_FLTOBJ_EID((id & mask) >> 18, id & mask) : CAN_IMAGE_FLTOBJ_SID(id & mask)) ||
+				Register(cREGADDR_CiMASK + 8 * i) != ((i & 1) ?
+				CAN_IMAGE_MASK(mask >> 18, mask, 1) : CAN_IMAGE_MASK(mask, 0, 1)) ||
+				Registers[cREGADDR_CiFLTCON + i] != CAN_IMAGE_FLTCON(CAN_FIFO_CH2))
+		{
+			printf("ERROR: wrong registers of filter %d\n", i);
+			errors++;
+		}
+	}
+
+	if(DRV_CANFDSPI_FilterHandlerRegister(DRV_CANFDSPI_INDEX_0, &FilterDispatch,
+			CAN_FILTER_STD_ID(0x100), 0x7FF, CAN_FIFO_CH2, Handler) != -1)
+	{
+		printf("ERROR: filter allocated when all filters are used\n");
+		errors++;
+	}
+
+	if(DRV_CANFDSPI_FilterHandlerUnregister(DRV_CANFDSPI_INDEX_0, &FilterDispatch, CAN_FILTER5) != 0 ||
+			(Registers[cREGADDR_CiFLTCON + 5] & 0x80) ||
+			DRV_CANFDSPI_FilterHandlerUnregister(DRV_CANFDSPI_INDEX_0, &FilterDispatch, CAN_FILTER5) != -1 ||
+			DRV_CANFDSPI_FilterHandlerRegister(DRV_CANFDSPI_INDEX_0, &FilterDispatch,
+			CAN_FILTER_STD_ID(0x100), 0x7FF, CAN_FIFO_CH2, Handler) != 5)
+	{
+		printf("ERROR: released filter isn't disabled or can't be allocated again\n");
+		errors++;
+	}
+
+	//filter 0 has no handler
+	for(i = 0; i < CAN_FILTER_TOTAL; i++)
+	{
+		MakeFrame(&header, CAN_FILTER_STD_ID(0x100));
+		header.bF.ctrl.FilterHit = i;
+		HandlerCalls = 0;
+		DefaultCalls = 0;
+		if(DRV_CANFDSPI_FilterDispatch(&FilterDispatch, &header, Data) != (i ? 0 : 1) ||
+				HandlerCalls != (i ? 1 : 0) || DefaultCalls != (i ? 0 : 1))
+		{
+			printf("ERROR: frame of filter %d dispatched wrongly\n", i);
+			errors++;
+		}
+	}
+
+	return errors;
+}
+
+static double Seconds(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static void Benchmark(uint8_t nStd, uint8_t nExt, uint32_t frames)
+{
+	const CAN_DISPATCH_ROUTE* route;
+	double start, tableTime, linearTime, filterTime;
+	uint32_t i;
+	uint32_t id;
+
+	MakeRoutes(nStd, nExt);
+	DRV_CANFDSPI_DispatchInitialize(&Table, Routes, nStd + nExt, DefaultHandler);
+
+	DRV_CANFDSPI_FilterDispatchInitialize(&FilterDispatch, 0, DefaultHandler);
+	for(i = 0; i < nStd + nExt && i < CAN_FILTER_TOTAL; i++)
+	{
+		DRV_CANFDSPI_FilterHandlerSet(&FilterDispatch, i, Handler);
+	}
+
+	//half of frames are accepted, 1/4 of frames have extended ID
+	for(i = 0; i < FRAME_POOL; i++)
+	{
+		if((i & 1) && nStd + nExt > 0)
+			id = Routes[Random() % (nStd + nExt)].id;
+		else
+			id = RandomId((i & 2) && nExt);
+		MakeFrame(&Frames[i], id);
+		Frames[i].bF.ctrl.FilterHit = Random() % CAN_FILTER_TOTAL;
+	}
+
+	start = Seconds();
+	for(i = 0; i < frames; i++)
+	{
+		DRV_CANFDSPI_Dispatch(&Table, &Frames[i & (FRAME_POOL - 1)], Data);
+	}
+	tableTime = Seconds() - start;
+
+	start = Seconds();
+	for(i = 0; i < frames; i++)
+	{
+		route = LinearLookup(nStd + nExt, DRV_CANFDSPI_DispatchFrameId(&Frames[i & (FRAME_POOL - 1)]));
+		if(route != NULL)
+			route->handler(&Frames[i & (FRAME_POOL - 1)], Data);
+		else
+			DefaultHandler(&Frames[i & (FRAME_POOL - 1)], Data);
+	}
+	linearTime = Seconds() - start;
+
+	start = Seconds();
+	for(i = 0; i < frames; i++)
+	{
+		DRV_CANFDSPI_FilterDispatch(&FilterDispatch, &Frames[i & (FRAME_POOL - 1)], Data);
+	}
+	filterTime = Seconds() - start;
+
+	printf("%3u standard + %2u extended routes: table %6.2f ns/frame, linear search %6.2f ns/frame, "
+			"filter hit %6.2f ns/frame, longest probe %u\n", nStd, nExt, tableTime * 1e9 / frames,
+			linearTime * 1e9 / frames, filterTime * 1e9 / frames, Table.extMaxProbe + 1);
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t frames = 20000000;
+	uint32_t set;
+	int failures = 0;
+	int i;
+
+	for(i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+		{
+			frames = strtoul(argv[++i], NULL, 0);
+		}
+		else
+		{
+			printf("Usage: DispatchBenchmark [-n frames]\n");
+			return -1;
+		}
+	}
+
+	printf("Table %u bytes on host(%u standard routes, %u extended routes)\n",
+			(uint32_t)sizeof(CAN_DISPATCH_TABLE), CAN_DISPATCH_MAX_STD_IDS, CAN_DISPATCH_MAX_EXT_IDS);
+
+	for(set = 0; set < CHECK_SETS; set++)
+	{
+		failures += CheckSet(Random() % (CAN_DISPATCH_MAX_STD_IDS + 1), Random() % (CAN_DISPATCH_MAX_EXT_IDS + 1));
+	}
+	failures += CheckSet(CAN_DISPATCH_MAX_STD_IDS, CAN_DISPATCH_MAX_EXT_IDS);
+
+	//limits of table
+	MakeRoutes(CAN_DISPATCH_MAX_STD_IDS + 1, 0);
+	if(DRV_CANFDSPI_DispatchInitialize(&Table, Routes, CAN_DISPATCH_MAX_STD_IDS + 1, NULL) != -1)
+	{
+		printf("ERROR: too many standard routes accepted\n");
+		failures++;
+	}
+	MakeRoutes(0, CAN_DISPATCH_MAX_EXT_IDS + 1);
+	if(DRV_CANFDSPI_DispatchInitialize(&Table, Routes, CAN_DISPATCH_MAX_EXT_IDS + 1, NULL) != -2)
+	{
+		printf("ERROR: too many extended routes accepted\n");
+		failures++;
+	}
+	MakeRoutes(2, 0);
+	Routes[1].id = Routes[0].id;
+	if(DRV_CANFDSPI_DispatchInitialize(&Table, Routes, 2, NULL) != -3)
+	{
+		printf("ERROR: duplicated route accepted\n");
+		failures++;
+	}
+
+	failures += CheckFilterDispatch();
+
+	printf("Check of %u route sets and filter hit dispatch: %d errors\n", CHECK_SETS + 1, failures);
+
+	if(frames > 0)
+	{
+		Benchmark(1, 0, frames);
+		Benchmark(8, 4, frames);
+		Benchmark(CAN_DISPATCH_MAX_STD_IDS, CAN_DISPATCH_MAX_EXT_IDS, frames);
+	}
+
+	return failures;
+}
@@ -0,0 +1,348 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+* Host tool for filter and mask compiler from drv_canfdspi_filter.c.
+*
+* Tool compile list of accepted IDs into filter/mask pairs and print them as CiFLTOBJm,
+* CiMASKm and CiFLTCONm arrays for CAN_CONFIG_IMAGE. IDs are written like in candump:
+* up to 3 hex digits for standard ID, more digits for extended ID(e.g. 0DA 18FEF100).
+* Before result is printed it is verified: every listed ID must be accepted and for
+* standard IDs number of false accepts is counted by checking all 2048 IDs.
+*
+* Without IDs tool run self check with random accept lists.
+*
+* Build(gcc or mingw):
+*	gcc -std=gnu99 -Wall -o FilterCompiler FilterCompiler.c
+*
+* Usage:
+*	FilterCompiler [-f maxFilters] [-e maxFalseAccepts] [-c channelName] [id ...]
+*
+* Exit code is number of failed checks.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_api.c"
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_filter.c"
+
+#define MAX_IDS 1024
+#define SELF_CHECK_LISTS 2000
+
+static uint32_t Ids[MAX_IDS];
+static CAN_FILTER_GROUP Groups[MAX_IDS];
+static uint32_t RandomState = 1;
+
+//compiler is used without SPI, stubs are required only by drv_canfdspi_api.c
+int8_t DRV_SPI_TransferData(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxData, uint8_t *SpiRxData, uint16_t spiTransferSize)
+{
+	(void)spiSlaveDeviceIndex;
+	(void)SpiTxData;
+	memset(SpiRxData, 0, spiTransferSize);
+
+	return -1;
+}
+
+int8_t DRV_SPI_TransferFill(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxHeader, uint16_t spiHeaderSize, uint8_t fillByte, uint16_t spiFillSize)
+{
+	(void)spiSlaveDeviceIndex;
+	(void)SpiTxHeader;
+	(void)spiHeaderSize;
+	(void)fillByte;
+	(void)spiFillSize;
+
+	return -1;
+}
+
+static uint32_t Random(void)
+{
+	RandomState = RandomState * 1103515245u + 12345u;
+	return RandomState >> 16;
+}
+
+static bool Listed(const uint32_t* ids, uint16_t nIds, uint32_t id)
+{
+	uint16_t i;
+
+	for(i = 0; i < nIds; i++)
+	{
+		if(ids[i] == id)
+			return true;
+	}
+
+	return false;
+}
+
+//check result of compiler, return number of errors
+static int Verify(const uint32_t* ids, uint16_t nIds, uint8_t maxFilters, uint32_t maxFalseAccepts,
+		int8_t result, uint8_t nFilters, uint32_t* stdFalseAccepts)
+{
+	uint32_t falseAccepts = 0;
+	uint32_t id;
+	uint16_t i;
+	int errors = 0;
+
+	if(result < 0 || nFilters == 0 || nFilters > maxFilters)
+	{
+		printf("ERROR: %u IDs, result %d, %u filters of %u\n", nIds, result, nFilters, maxFilters);
+		return 1;
+	}
+
+	for(i = 0; i < nIds; i++)
+	{
+		if(DRV_CANFDSPI_FilterMatch(Groups, nFilters, ids[i]) < 0)
+		{
+			printf("ERROR: listed ID %X is rejected\n", ids[i] & ~CAN_FILTER_EXTENDED);
+			errors++;
+		}
+	}
+
+	for(id = 0; id < 0x800; id++)
+	{
+		if(DRV_CANFDSPI_FilterMatch(Groups, nFilters, id) >= 0 && !Listed(ids, nIds, id))
+		{
+			falseAccepts++;
+		}
+	}
+
+	//false accepts of extended IDs can't be counted, so only standard only list is checked
+	for(i = 0; i < nIds && !(ids[i] & CAN_FILTER_EXTENDED); i++)
+		;
+	if(i == nIds)
+	{
+		if(falseAccepts > DRV_CANFDSPI_FilterFalseAccepts(Groups, nFilters))
+		{
+			printf("ERROR: %u false accepts, compiler report %u\n", falseAccepts,
+					DRV_CANFDSPI_FilterFalseAccepts(Groups, nFilters));
+			errors++;
+		}
+
+		if(result == 0 && falseAccepts > maxFalseAccepts)
+		{
+			printf("ERROR: %u false accepts, limit %u\n", falseAccepts, maxFalseAccepts);
+			errors++;
+		}
+	}
+
+	*stdFalseAccepts = falseAccepts;
+
+	return errors;
+}
+
+static int SelfCheck(void)
+{
+	static const uint8_t FilterLimits[] = {32, 8, 2};
+	static const uint32_t FalseLimits[] = {0, 16, 256};
+	uint32_t stdFalseAccepts;
+	uint32_t sumFilters[3] = {0};
+	uint32_t sumFalse[3] = {0};
+	uint32_t lists = 0;
+	uint16_t nIds;
+	uint16_t i;
+	uint8_t nFilters;
+	uint8_t f, e;
+	int8_t result;
+	int errors = 0;
+
+	//range aligned to power of 2 is single filter without false accepts
+	for(i = 0; i < 64; i++)
+	{
+		Ids[i] = 0x140 + (63 - i);
+	}
+	result = DRV_CANFDSPI_FilterCompile(Ids, 64, Groups, 32, 0, &nFilters);
+	errors += Verify(Ids, 64, 32, 0, result, nFilters, &stdFalseAccepts);
+	if(nFilters != 1 || stdFalseAccepts != 0 || Groups[0].mask != 0x7C0)
+	{
+		printf("ERROR: range 140..17F compiled into %u filters\n", nFilters);
+		errors++;
+	}
+
+	//standard and extended IDs can't share single filter
+	Ids[0] = 0x0DA;
+	Ids[1] = CAN_FILTER_EXT_ID(0x0DA);
+	if(DRV_CANFDSPI_FilterCompile(Ids, 2, Groups, 1, 0xFFFFFFFF, &nFilters) != -1)
+	{
+		printf("ERROR: standard and extended ID accepted by single filter\n");
+		errors++;
+	}
+
+	for(f = 0; f < sizeof(FilterLimits); f++)
+	{
+		for(e = 0; e < sizeof(FalseLimits) / sizeof(FalseLimits[0]); e++)
+		{
+			for(lists = 0; lists < SELF_CHECK_LISTS / 10; lists++)
+			{
+				//standard IDs with duplicates and every 4th list with extended IDs
+				nIds = 1 + Random() % 64;
+				for(i = 0; i < nIds; i++)
+				{
+					if((lists % 4) == 3 && (Random() & 1))
+						Ids[i] = CAN_FILTER_EXT_ID((Random() << 16) ^ Random());
+					else
+						Ids[i] = CAN_FILTER_STD_ID(Random() % 0x180);
+				}
+
+				result = DRV_CANFDSPI_FilterCompile(Ids, nIds, Groups, FilterLimits[f], FalseLimits[e], &nFilters);
+				errors += Verify(Ids, nIds, FilterLimits[f], FalseLimits[e], result, nFilters, &stdFalseAccepts);
+
+				if(f == 0 && (lists % 4) != 3)
+				{
+					sumFilters[e] += nFilters;
+					sumFalse[e] += stdFalseAccepts;
+				}
+			}
+		}
+	}
+
+	for(e = 0; e < sizeof(FalseLimits) / sizeof(FalseLimits[0]); e++)
+	{
+		printf("Random standard lists(1..64 IDs from 000..17F), false accept limit %3u: "
+				"avg %4.1f filters, avg %5.1f false accepts\n", FalseLimits[e],
+				(double)sumFilters[e] / (lists * 3 / 4), (double)sumFalse[e] / (lists * 3 / 4));
+	}
+
+	return errors;
+}
+
+static void PrintImage(uint8_t nFilters, const char* channelName)
+{
+	uint32_t filterObj[2 * CAN_FILTER_TOTAL];
+	uint8_t filterCon[CAN_FILTER_TOTAL];
+	uint32_t id;
+	uint32_t mask;
+	uint8_t i;
+
+	//image words are generated only to keep tool and driver consistent
+	DRV_CANFDSPI_FilterImageGet(Groups, nFilters, CAN_FIFO_CH1, filterObj, filterCon);
+
+	printf("static const uint32_t canFilterObjImage[] = {\n");
+	for(i = 0; i < nFilters; i++)
+	{
+		id = Groups[i].id & ~CAN_FILTER_EXTENDED;
+		mask = Groups[i].mask;
+
+		if(Groups[i].id & CAN_FILTER_EXTENDED)
+			printf("\tCAN_IMAGE_FLTOBJ_EID(0x%x, 0x%x), CAN_IMAGE_MASK(0x%x, 0x%x, 1)",
+					id >> 18, id & 0x3FFFF, mask >> 18, mask & 0x3FFFF);
+		else
+			printf("\tCAN_IMAGE_FLTOBJ_SID(0x%x), CAN_IMAGE_MASK(0x%x, 0x0, 1)", id, mask);
+
+		printf("%s // 0x%08X 0x%08X, %u IDs\n", (i + 1 < nFilters) ? "," : "",
+				filterObj[2 * i], filterObj[2 * i + 1], DRV_CANFDSPI_FilterGroupIds(&Groups[i]));
+	}
+	printf("};\n\nstatic const uint8_t canFilterConImage[] = {\n\t");
+	for(i = 0; i < nFilters; i++)
+	{
+		printf("CAN_IMAGE_FLTCON(%s)%s", channelName, (i + 1 < nFilters) ? ((i % 2) == 1 ? ",\n\t" : ", ") : "\n");
+	}
+	printf("};\n");
+}
+
+int main(int argc, char** argv)
+{
+	const char* channelName = "CAN_RX_FIFO";
+	uint32_t maxFalseAccepts = 0;
+	uint32_t maxFilters = CAN_FILTER_TOTAL;
+	uint32_t stdFalseAccepts;
+	uint32_t stdRejected = 0;
+	uint32_t id;
+	uint16_t nIds = 0;
+	uint8_t nFilters = 0;
+	int8_t result;
+	char* end;
+	int errors;
+	int i;
+
+	for(i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+		{
+			maxFilters = strtoul(argv[++i], NULL, 0);
+		}
+		else if(strcmp(argv[i], "-e") == 0 && i + 1 < argc)
+		{
+			maxFalseAccepts = strtoul(argv[++i], NULL, 0);
+		}
+		else if(strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+		{
+			channelName = argv[++i];
+		}
+		else if(nIds < MAX_IDS && argv[i][0] != '-' && strlen(argv[i]) <= 8)
+		{
+			Ids[nIds] = strtoul(argv[i], &end, 16);
+			if(*end != '\0' || (strlen(argv[i]) <= 3 ? Ids[nIds] > 0x7FF : Ids[nIds] > 0x1FFFFFFF))
+			{
+				printf("Wrong ID %s\n", argv[i]);
+				return -1;
+			}
+			if(strlen(argv[i]) > 3)
+			{
+				Ids[nIds] = CAN_FILTER_EXT_ID(Ids[nIds]);
+			}
+			nIds++;
+		}
+		else
+		{
+			printf("Usage: FilterCompiler [-f maxFilters] [-e maxFalseAccepts] [-c channelName] [id ...]\n");
+			return -1;
+		}
+	}
+
+	if(nIds == 0)
+	{
+		return SelfCheck();
+	}
+
+	if(maxFilters == 0 || maxFilters > CAN_FILTER_TOTAL)
+	{
+		printf("Number of filters must be in range 1 .. %u\n", CAN_FILTER_TOTAL);
+		return -1;
+	}
+
+	result = DRV_CANFDSPI_FilterCompile(Ids, nIds, Groups, maxFilters, maxFalseAccepts, &nFilters);
+	if(result < 0)
+	{
+		printf("Standard and extended IDs need at least 2 filters\n");
+		return -1;
+	}
+
+	errors = Verify(Ids, nIds, maxFilters, maxFalseAccepts, result, nFilters, &stdFalseAccepts);
+
+	printf("// %u IDs in %u filters, %u false accepts(%u of them standard IDs)%s\n", nIds, nFilters,
+			DRV_CANFDSPI_FilterFalseAccepts(Groups, nFilters), stdFalseAccepts,
+			result ? ", limit exceeded to fit into filters" : "");
+	for(id = 0; id < 0x800; id++)
+	{
+		if(DRV_CANFDSPI_FilterMatch(Groups, nFilters, id) < 0)
+			stdRejected++;
+	}
+	printf("// %u of 2048 standard IDs are rejected by hardware\n", stdRejected);
+	PrintImage(nFilters, channelName);
+
+	return errors;
+}
@@ -0,0 +1,335 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+* Host tool for frame timing calculator from drv_canfdspi_frametime.c.
+*
+* Actual length check: for random classic and FD frames length calculated by driver is
+* compared with reference which build whole frame as array of bits, calculate CRC15 from
+* this array and insert stuff bits by separate pass. Nominal and data phase are compared
+* separately.
+*
+* Worse case check: actual length of every random frame must not exceed worse case
+* length of its format and DLC, classic 8 byte frame must have 135 bits with standard
+* ID and 160 bits with extended ID(known worse case including 3 bits of intermission).
+*
+* Table: worse case frame time in us and maximal number of frames per second(100% bus
+* load) for every DLC, classic and FD format, standard and extended ID.
+*
+* Build(gcc or mingw):
+*	gcc -std=gnu99 -Wall -o FrameTimeTable FrameTimeTable.c
+*
+* Usage:
+*	FrameTimeTable [nominal bit rate] [data bit rate]
+*
+* Exit code is number of failed checks.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_frametime.c"
+
+#define CHECK_FRAMES 100000
+
+//reference frame builder
+static const uint8_t FdDataBytes[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+static uint8_t Bits[1024];
+static uint16_t BitCount;
+
+static void RefAdd(uint32_t value, uint8_t n)
+{
+	while(n--)
+	{
+		Bits[BitCount++] = (value >> n) & 1;
+	}
+}
+
+//number of stuff bits inserted into Bits[0..end), stuff bit after the last bit is counted
+static uint16_t RefStuffBits(uint16_t start, uint16_t end, uint16_t* stuffBefore, uint16_t before)
+{
+	uint16_t stuff = 0;
+	uint8_t last = 2;
+	uint8_t run = 0;
+	uint16_t i;
+
+	for(i = start; i < end; i++)
+	{
+		if(i == before)
+			*stuffBefore = stuff;
+
+		if(Bits[i] == last)
+			run++;
+		else
+			run = 1;
+		last = Bits[i];
+
+		if(run == 5)
+		{
+			stuff++;
+			last ^= 1;
+			run = 1;
+		}
+	}
+
+	return stuff;
+}
+
+static uint16_t RefCrc15(uint16_t end)
+{
+	uint16_t crc = 0;
+	uint16_t i;
+
+	for(i = 0; i < end; i++)
+	{
+		if(Bits[i] ^ ((crc >> 14) & 1))
+			crc = ((crc << 1) ^ 0x4599) & 0x7FFF;
+		else
+			crc = (crc << 1) & 0x7FFF;
+	}
+
+	return crc;
+}
+
+//reference frame length in bits, nominal part returned in nominalBits
+static uint32_t RefFrameBits(const CAN_TX_MSGOBJ* obj, const uint8_t* data, uint32_t* nominalBits)
+{
+	uint8_t dataBytes;
+	uint16_t brsEnd = 0;
+	uint16_t stuffBefore = 0;
+	uint16_t stuff;
+	uint32_t bits;
+	uint8_t i;
+
+	BitCount = 0;
+	if(obj->bF.ctrl.FDF)
+		dataBytes = FdDataBytes[obj->bF.ctrl.DLC];
+	else
+		dataBytes = obj->bF.ctrl.RTR ? 0 : ((obj->bF.ctrl.DLC > 8) ? 8 : obj->bF.ctrl.DLC);
+
+	//SOF, identifier
+	RefAdd(0, 1);
+	RefAdd(obj->bF.id.SID, 11);
+	if(obj->bF.ctrl.IDE)
+	{
+		RefAdd(1, 1); //SRR
+		RefAdd(1, 1); //IDE
+		RefAdd(obj->bF.id.EID, 18);
+		RefAdd(obj->bF.ctrl.FDF ? 0 : obj->bF.ctrl.RTR, 1); //RTR/RRS
+	}
+	else
+	{
+		RefAdd(obj->bF.ctrl.FDF ? 0 : obj->bF.ctrl.RTR, 1); //RTR/RRS
+		RefAdd(0, 1); //IDE
+	}
+
+	if(obj->bF.ctrl.FDF)
+	{
+		RefAdd(1, 1); //FDF
+		RefAdd(0, 1); //res
+		RefAdd(obj->bF.ctrl.BRS, 1);
+		brsEnd = BitCount;
+		RefAdd(obj->bF.ctrl.ESI, 1);
+	}
+	else
+	{
+		if(obj->bF.ctrl.IDE)
+			RefAdd(0, 1); //r1
+		RefAdd(0, 1); //r0
+	}
+
+	RefAdd(obj->bF.ctrl.DLC, 4);
+	for(i = 0; i < dataBytes; i++)
+		RefAdd(data[i], 8);
+
+	if(obj->bF.ctrl.FDF)
+	{
+		stuff = RefStuffBits(0, BitCount, &stuffBefore, brsEnd);
+		//stuff count with parity, CRC and fixed stuff bits
+		bits = BitCount + stuff + 4 + ((dataBytes > 16) ? 21 + 7 : 17 + 6);
+		*nominalBits = obj->bF.ctrl.BRS ? brsEnd + stuffBefore : bits;
+	}
+	else
+	{
+		RefAdd(RefCrc15(BitCount), 15);
+		bits = BitCount + RefStuffBits(0, BitCount, &stuffBefore, 0);
+		*nominalBits = bits;
+	}
+
+	//CRC delimiter, ACK, ACK delimiter, EOF, intermission
+	*nominalBits += 13;
+
+	return bits + 13;
+}
+
+static void RandomFrame(CAN_TX_MSGOBJ* obj, uint8_t* data)
+{
+	uint8_t i;
+
+	obj->word[0] = 0;
+	obj->word[1] = 0;
+	obj->bF.ctrl.IDE = rand() & 1;
+	obj->bF.ctrl.FDF = rand() & 1;
+	obj->bF.ctrl.BRS = obj->bF.ctrl.FDF ? rand() & 1 : 0;
+	obj->bF.ctrl.ESI = obj->bF.ctrl.FDF ? (rand() % 8 == 0) : 0;
+	obj->bF.ctrl.RTR = obj->bF.ctrl.FDF ? 0 : (rand() % 8 == 0);
+	obj->bF.ctrl.DLC = rand() & 0xF;
+
+	//often long runs of equal bits
+	if(rand() & 1)
+	{
+		obj->bF.id.SID = rand() & 0x7FF;
+		obj->bF.id.EID = rand() & 0x3FFFF;
+		for(i = 0; i < 64; i++)
+			data[i] = rand();
+	}
+	else
+	{
+		obj->bF.id.SID = (rand() & 1) ? 0x7FF : 0;
+		obj->bF.id.EID = (rand() & 1) ? 0x3FFFF : 0x3F;
+		memset(data, (rand() & 1) ? 0xFF : 0x00, 64);
+		data[rand() % 64] = rand();
+	}
+}
+
+static int CheckFrameBits(void)
+{
+	CAN_TX_MSGOBJ obj;
+	CAN_FRAME_BITS bits, worst;
+	uint8_t data[64];
+	uint32_t refBits, refNominal;
+	uint32_t maxStuff[2][2][2];
+	uint8_t fdf, ide, brs;
+	int wrong = 0;
+	int exceeded = 0;
+	int failed = 0;
+	uint32_t i;
+
+	memset(maxStuff, 0, sizeof(maxStuff));
+
+	for(i = 0; i < CHECK_FRAMES; i++)
+	{
+		RandomFrame(&obj, data);
+		refBits = RefFrameBits(&obj, data, &refNominal);
+		DRV_CANFDSPI_FrameBits(obj.word, data, &bits);
+
+		if(bits.nominalBits + bits.dataBits != refBits || bits.nominalBits != refNominal)
+		{
+			if(wrong < 10)
+				printf("FAIL frame %08X %08X: %u+%u bits(reference %u+%u)\n", obj.word[0], obj.word[1],
+						bits.nominalBits, bits.dataBits, refNominal, refBits - refNominal);
+			wrong++;
+		}
+
+		//remote frame is shorter than data frame with the same DLC
+		DRV_CANFDSPI_FrameBitsWorstCase(obj.bF.ctrl.IDE, obj.bF.ctrl.FDF, obj.bF.ctrl.BRS,
+				(CAN_DLC)obj.bF.ctrl.DLC, &worst);
+		if(bits.nominalBits > worst.nominalBits ||
+				bits.nominalBits + bits.dataBits > worst.nominalBits + worst.dataBits)
+		{
+			if(exceeded < 10)
+				printf("FAIL frame %08X %08X: %u+%u bits, worse case %u+%u\n", obj.word[0], obj.word[1],
+						bits.nominalBits, bits.dataBits, worst.nominalBits, worst.dataBits);
+			exceeded++;
+		}
+
+		fdf = obj.bF.ctrl.FDF;
+		ide = obj.bF.ctrl.IDE;
+		brs = obj.bF.ctrl.BRS;
+		if(bits.stuffBits > maxStuff[fdf][ide][brs])
+			maxStuff[fdf][ide][brs] = bits.stuffBits;
+	}
+
+	printf("actual length: %u random frames, %d wrong, %d above worse case\n", CHECK_FRAMES, wrong, exceeded);
+	printf("the most stuff bits: classic %u/%u, FD %u/%u(standard/extended ID)\n",
+			maxStuff[0][0][0], maxStuff[0][1][0], maxStuff[1][0][1] > maxStuff[1][0][0] ? maxStuff[1][0][1] : maxStuff[1][0][0],
+			maxStuff[1][1][1] > maxStuff[1][1][0] ? maxStuff[1][1][1] : maxStuff[1][1][0]);
+
+	DRV_CANFDSPI_FrameBitsWorstCase(false, false, false, CAN_DLC_8, &bits);
+	DRV_CANFDSPI_FrameBitsWorstCase(true, false, false, CAN_DLC_8, &worst);
+	printf("worse case classic 8 bytes: %u bits standard ID, %u bits extended ID\n",
+			bits.nominalBits, worst.nominalBits);
+	if(bits.nominalBits != 135 || worst.nominalBits != 160)
+	{
+		printf("FAIL expected 135 and 160 bits\n");
+		failed++;
+	}
+
+	return failed + (wrong ? 1 : 0) + (exceeded ? 1 : 0);
+}
+
+static void PrintTable(uint32_t nominalBitRate, uint32_t dataBitRate)
+{
+	static const char* formats[4] = {"classic", "classic ext", "FD BRS", "FD BRS ext"};
+	CAN_FRAMETIME frameTime;
+	uint32_t ns;
+	uint8_t dlc, format;
+
+	DRV_CANFDSPI_FrameTimeInitialize(&frameTime, nominalBitRate, dataBitRate);
+
+	printf("\nworse case frame time at %u/%u bps: us(frames/s at 100%% load)\n", nominalBitRate, dataBitRate);
+	printf("DLC bytes");
+	for(format = 0; format < 4; format++)
+		printf("  %-19s", formats[format]);
+	printf("\n");
+
+	for(dlc = CAN_DLC_0; dlc <= CAN_DLC_64; dlc++)
+	{
+		printf("%3u %5u", dlc, DRV_CANFDSPI_FrameDataBytes(true, (CAN_DLC)dlc));
+		for(format = 0; format < 4; format++)
+		{
+			if(format < 2 && dlc > CAN_DLC_8)
+			{
+				printf("  %-19s", "-");
+				continue;
+			}
+			ns = DRV_CANFDSPI_FrameTimeWorstCase(&frameTime, format & 1, format >= 2, format >= 2, (CAN_DLC)dlc);
+			printf("  %7u.%03u(%6u)", ns / 1000, ns % 1000, 1000000000u / ns);
+		}
+		printf("\n");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t nominalBitRate = (argc > 1) ? strtoul(argv[1], NULL, 0) : 500000;
+	uint32_t dataBitRate = (argc > 2) ? strtoul(argv[2], NULL, 0) : 2000000;
+	int failed;
+
+	if(nominalBitRate == 0 || dataBitRate == 0)
+	{
+		printf("wrong bit rate\n");
+		return 1;
+	}
+
+	failed = CheckFrameBits();
+	PrintTable(nominalBitRate, dataBitRate);
+
+	printf("%d failed\n", failed);
+
+	return failed;
+}
@@ -0,0 +1,1026 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+* Host side of CAN-UART gateway(CAN_GATEWAY_ENABLE in LPC82X example project), framing
+* from drv_canfdspi_gateway.c.
+*
+* Decode: binary stream from gateway(file, stdin or configured serial port) is printed
+* in candump log format, status records are printed as comments:
+*	(0000012.345678) can0 0DA#1122334455667788
+*	(0000012.346001) can0 100##1112233...
+* Capture blocks(CAN_GATEWAY_CAPTURE_ENABLE, format from drv_canfdspi_capture.c) are
+* decoded to the same output. After lost block frames are skipped until the next reset
+* record and number of lost blocks is printed as comment.
+*
+* Encode: frames in candump format(ID#data, ID#R, ID##<flags>data with flags 1 - BRS,
+* 2 - ESI) are written to stdout as TX records, which can be redirected to serial port.
+*
+* Without arguments tool run self check: CRC check value, round trip of random frames
+* through encoder and decoder, resynchronization after corrupted and lost bytes(also
+* when SYNC of the next record cause the error), round trip of capture blocks built like
+* in gateway for synthetic periodic traffic(also with lost blocks) and print link
+* capacity for UART baud rate compared with bus frame rate.
+*
+* Build(gcc or mingw):
+*	gcc -std=gnu99 -Wall -o GatewayDecoder GatewayDecoder.c
+*
+* Usage:
+*	GatewayDecoder -d file           decode stream, - is stdin
+*	GatewayDecoder -e frame...       encode TX frames to stdout
+*
+* Linux example:
+*	stty -F /dev/ttyUSB0 3000000 raw -echo
+*	GatewayDecoder -d /dev/ttyUSB0
+*	GatewayDecoder -e 123#11223344 18FEF100##1AABB > /dev/ttyUSB0
+*
+* Exit code is number of failed checks, records with wrong CRC in decode mode.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_frametime.c"
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_gateway.c"
+
+//decoder accept any dictionary size and history length sent by gateway
+#define CAN_CAPTURE_DICTIONARY_SIZE 32
+#define CAN_CAPTURE_HISTORY_BYTES 64
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_capture.c"
+
+#define CHECK_FRAMES 20000
+#define STREAM_FRAMES 2000
+#define UART_BITS_PER_BYTE 10
+
+//capture settings of gateway(LPC82X example project)
+#define GATEWAY_DICTIONARY_SIZE 32
+#define GATEWAY_HISTORY_BYTES 8
+#define GATEWAY_RESET_BLOCKS 16
+#define GATEWAY_FLUSH_US 10000
+
+//synthetic periodic traffic
+#define TRAFFIC_IDS 40
+#define TRAFFIC_FRAMES 30000
+#define TRAFFIC_STREAM_BYTES (TRAFFIC_FRAMES * CAN_GATEWAY_MAX_FRAME_RECORD_BYTES)
+
+typedef void (*FrameOutput)(void* context, const uint32_t* header, uint32_t timeStamp, const uint8_t* data);
+
+//capture blocks received from gateway
+typedef struct
+{
+	CAN_CAPTURE_CODER coder;
+	int sequence;
+	uint32_t blocks;
+	uint32_t lostBlocks;
+	uint32_t errors;
+} CaptureStream;
+
+//capture blocks built like in GatewaySendCapture
+typedef struct
+{
+	CAN_CAPTURE_CODER coder;
+	uint8_t block[CAN_GATEWAY_MAX_RECORD_BYTES];
+	uint8_t bytes;
+	uint8_t sequence;
+	uint32_t blockTime;
+	uint8_t* stream;
+	uint32_t length;
+} CaptureWriter;
+
+typedef struct
+{
+	CAN_TX_MSGOBJ obj;
+	uint32_t timeStamp;
+	uint8_t data[64];
+} TrafficFrame;
+
+static uint32_t RandomState = 1;
+
+static uint32_t Random(void)
+{
+	RandomState = RandomState * 1103515245 + 12345;
+	return RandomState >> 8;
+}
+
+static void PrintFrame(const uint32_t* header, uint32_t timeStamp, const uint8_t* data)
+{
+	CAN_TX_MSGOBJ obj;
+	uint8_t dataBytes;
+	uint8_t i;
+
+	obj.word[0] = header[0];
+	obj.word[1] = header[1];
+	dataBytes = DRV_CANFDSPI_FrameDataBytes(obj.bF.ctrl.FDF, (CAN_DLC)obj.bF.ctrl.DLC);
+
+	printf("(%07u.%06u) can0 ", timeStamp / 1000000, timeStamp % 1000000);
+	if(obj.bF.ctrl.IDE)
+		printf("%08X", ((uint32_t)obj.bF.id.SID << 18) | obj.bF.id.EID);
+	else
+		printf("%03X", obj.bF.id.SID);
+
+	if(obj.bF.ctrl.FDF)
+	{
+		printf("##%X", (obj.bF.ctrl.BRS ? 1 : 0) | (obj.bF.ctrl.ESI ? 2 : 0));
+	}
+	else
+	{
+		printf("#");
+		if(obj.bF.ctrl.RTR)
+		{
+			printf("R\n");
+			return;
+		}
+	}
+
+	for(i = 0; i < dataBytes; i++)
+		printf("%02X", data[i]);
+	printf("\n");
+}
+
+//candump frame: ID#data, ID#R or ID##<flags>data
+static int ParseFrame(const char* text, CAN_TX_MSGOBJ* obj, uint8_t* data)
+{
+	const char* hash = strchr(text, '#');
+	const char* p;
+	uint32_t id;
+	uint8_t dataBytes = 0;
+	uint8_t dlc;
+	char* end;
+
+	if(hash == NULL || hash == text || hash - text > 8)
+		return -1;
+
+	id = strtoul(text, &end, 16);
+	if(end != hash)
+		return -1;
+
+	memset(obj, 0, sizeof(CAN_TX_MSGOBJ));
+	obj->bF.ctrl.IDE = (hash - text > 3);
+	if(obj->bF.ctrl.IDE ? id > 0x1FFFFFFF : id > 0x7FF)
+		return -1;
+
+	if(obj->bF.ctrl.IDE)
+	{
+		obj->bF.id.SID = id >> 18;
+		obj->bF.id.EID = id & 0x3FFFF;
+	}
+	else
+	{
+		obj->bF.id.SID = id;
+	}
+
+	p = hash + 1;
+	if(*p == '#')
+	{
+		uint8_t flags;
+
+		if(p[1] == 0)
+			return -1;
+		flags = (p[1] >= 'A') ? (p[1] & ~0x20) - 'A' + 10 : p[1] - '0';
+		if(flags > 3)
+			return -1;
+		obj->bF.ctrl.FDF = 1;
+		obj->bF.ctrl.BRS = flags & 1;
+		obj->bF.ctrl.ESI = (flags >> 1) & 1;
+		p += 2;
+	}
+	else if(*p == 'R' && p[1] == 0)
+	{
+		obj->bF.ctrl.RTR = 1;
+		return 0;
+	}
+
+	while(p[0] && p[1] && dataBytes < 64)
+	{
+		unsigned int value;
+
+		if(sscanf(p, "%2x", &value) != 1)
+			return -1;
+		data[dataBytes++] = value;
+		p += 2;
+	}
+	if(*p)
+		return -1;
+
+	//classic frame can have up to 8 bytes, FD frame length must be one of DLC steps
+	for(dlc = CAN_DLC_0; dlc <= CAN_DLC_64; dlc++)
+	{
+		if(DRV_CANFDSPI_FrameDataBytes(obj->bF.ctrl.FDF, (CAN_DLC)dlc) == dataBytes)
+			break;
+	}
+	if(dlc > CAN_DLC_64 || (!obj->bF.ctrl.FDF && dataBytes > 8))
+		return -1;
+
+	obj->bF.ctrl.DLC = dlc;
+
+	return 0;
+}
+
+static void CaptureStreamInitialize(CaptureStream* stream)
+{
+	DRV_CANFDSPI_CaptureInitialize(&stream->coder, CAN_CAPTURE_DICTIONARY_SIZE, CAN_CAPTURE_HISTORY_BYTES);
+	stream->sequence = -1;
+	stream->blocks = 0;
+	stream->lostBlocks = 0;
+	stream->errors = 0;
+}
+
+//decode capture block from complete gateway record, return -1 when record isn't capture block
+static int CaptureStreamBlock(CaptureStream* stream, const CAN_GATEWAY_DECODER* decoder, FrameOutput output, void* context)
+{
+	const uint8_t* data;
+	uint8_t sequence;
+	uint8_t n;
+	uint16_t position = 0;
+	uint16_t used;
+	uint32_t header[2];
+	uint32_t timeStamp;
+	uint8_t payload[64];
+
+	if(DRV_CANFDSPI_GatewayDecodeCapture(decoder, &sequence, &data, &n) != 0)
+		return -1;
+
+	//records after lost block refer to dictionary state which decoder doesn't have
+	if(stream->sequence >= 0 && sequence != stream->sequence)
+	{
+		stream->lostBlocks += (uint8_t)(sequence - stream->sequence);
+		stream->coder.synchronized = false;
+	}
+	stream->sequence = (sequence + 1) & 0xFF;
+	stream->blocks++;
+
+	while(position < n)
+	{
+		bool synchronized = stream->coder.synchronized;
+		int8_t result = DRV_CANFDSPI_CaptureDecode(&stream->coder, &data[position], n - position, &used,
+			header, &timeStamp, payload);
+
+		if(result < 0)
+		{
+			//block without reset record after lost block isn't error
+			if(synchronized)
+				stream->errors++;
+			break;
+		}
+
+		if(result == CAN_CAPTURE_FRAME)
+			output(context, header, timeStamp, payload);
+
+		position += used;
+	}
+
+	return 0;
+}
+
+static void PrintOutput(void* context, const uint32_t* header, uint32_t timeStamp, const uint8_t* data)
+{
+	PrintFrame(header, timeStamp, data);
+}
+
+static int Decode(const char* name)
+{
+	FILE* file = strcmp(name, "-") ? fopen(name, "rb") : stdin;
+	CaptureStream capture;
+	uint32_t lostBlocks = 0;
+	CAN_GATEWAY_DECODER decoder;
+	CAN_GATEWAY_STATUS_INFO status;
+	uint32_t header[2];
+	uint32_t timeStamp;
+	uint8_t data[64];
+	int c;
+
+	if(file == NULL)
+	{
+		printf("Can't open %s\n", name);
+		return -1;
+	}
+
+	DRV_CANFDSPI_GatewayDecoderInitialize(&decoder);
+	CaptureStreamInitialize(&capture);
+
+	while((c = fgetc(file)) != EOF)
+	{
+		if(DRV_CANFDSPI_GatewayDecoderPut(&decoder, c) != 1)
+			continue;
+
+		if(DRV_CANFDSPI_GatewayDecodeFrame(&decoder, header, &timeStamp, data) >= 0)
+		{
+			PrintFrame(header, timeStamp, data);
+		}
+		else if(DRV_CANFDSPI_GatewayDecodeStatus(&decoder, &status) == 0)
+		{
+			printf("# state %u TEC %u REC %u rxOverruns %u decodeErrors %u txDropped %u\n",
+				status.state, status.tec, status.rec, status.rxOverruns, status.decodeErrors, status.txDropped);
+		}
+		else if(CaptureStreamBlock(&capture, &decoder, PrintOutput, NULL) == 0 && capture.lostBlocks != lostBlocks)
+		{
+			printf("# lost %u capture blocks\n", capture.lostBlocks - lostBlocks);
+			lostBlocks = capture.lostBlocks;
+		}
+		fflush(stdout);
+	}
+
+	if(file != stdin)
+		fclose(file);
+
+	fprintf(stderr, "%u records, %u errors", decoder.records, decoder.errors);
+	if(capture.blocks)
+		fprintf(stderr, ", %u capture blocks, %u lost, %u capture errors", capture.blocks, capture.lostBlocks, capture.errors);
+	fprintf(stderr, "\n");
+
+	return decoder.errors + capture.errors;
+}
+
+static int Encode(int argc, char** argv)
+{
+	CAN_TX_MSGOBJ obj;
+	uint8_t data[64];
+	uint8_t buffer[CAN_GATEWAY_MAX_RECORD_BYTES];
+	int i;
+
+	for(i = 0; i < argc; i++)
+	{
+		if(ParseFrame(argv[i], &obj, data) != 0)
+		{
+			fprintf(stderr, "Wrong frame %s\n", argv[i]);
+			return -1;
+		}
+
+		fwrite(buffer, 1, DRV_CANFDSPI_GatewayEncodeFrame(buffer, CAN_GATEWAY_TX_FRAME, obj.word, 0, data), stdout);
+	}
+
+	return 0;
+}
+
+static void RandomFrame(CAN_TX_MSGOBJ* obj, uint8_t* data)
+{
+	uint8_t i;
+
+	memset(obj, 0, sizeof(CAN_TX_MSGOBJ));
+	obj->bF.ctrl.IDE = Random() & 1;
+	obj->bF.id.SID = Random() & 0x7FF;
+	obj->bF.id.EID = obj->bF.ctrl.IDE ? Random() & 0x3FFFF : 0;
+	obj->bF.ctrl.FDF = Random() & 1;
+	obj->bF.ctrl.BRS = obj->bF.ctrl.FDF && (Random() & 1);
+	obj->bF.ctrl.ESI = obj->bF.ctrl.FDF && (Random() & 1);
+	obj->bF.ctrl.RTR = !obj->bF.ctrl.FDF && !(Random() % 8);
+	obj->bF.ctrl.DLC = Random() & 0xF;
+
+	for(i = 0; i < 64; i++)
+		data[i] = Random();
+}
+
+static int SameFrame(const CAN_TX_MSGOBJ* obj, const uint8_t* data, const uint32_t* header, const uint8_t* decoded)
+{
+	return obj->word[0] == header[0] && obj->word[1] == header[1] && memcmp(data, decoded,
+		DRV_CANFDSPI_FrameDataBytes(obj->bF.ctrl.FDF, (CAN_DLC)obj->bF.ctrl.DLC)) == 0;
+}
+
+static int CheckRoundTrip(void)
+{
+	CAN_GATEWAY_DECODER decoder;
+	CAN_TX_MSGOBJ obj;
+	uint8_t data[64];
+	uint8_t decoded[64];
+	uint8_t buffer[CAN_GATEWAY_MAX_RECORD_BYTES];
+	uint32_t header[2];
+	uint32_t timeStamp;
+	int failed = 0;
+	int i, j, n;
+
+	DRV_CANFDSPI_GatewayDecoderInitialize(&decoder);
+
+	for(i = 0; i < CHECK_FRAMES; i++)
+	{
+		uint32_t frameTimeStamp = Random() ^ (Random() << 16);
+		int result = 0;
+
+		RandomFrame(&obj, data);
+		n = DRV_CANFDSPI_GatewayEncodeFrame(buffer, (i & 1) ? CAN_GATEWAY_RX_FRAME : CAN_GATEWAY_TX_FRAME,
+			obj.word, frameTimeStamp, data);
+
+		if(n != CAN_GATEWAY_OVERHEAD_BYTES + CAN_GATEWAY_FRAME_BODY_BYTES +
+			DRV_CANFDSPI_FrameDataBytes(obj.bF.ctrl.FDF, (CAN_DLC)obj.bF.ctrl.DLC))
+		{
+			failed++;
+			continue;
+		}
+
+		for(j = 0; j < n; j++)
+		{
+			result = DRV_CANFDSPI_GatewayDecoderPut(&decoder, buffer[j]);
+			if(result != 0)
+				break;
+		}
+
+		if(result != 1 || j != n - 1
+			|| DRV_CANFDSPI_GatewayDecodeFrame(&decoder, header, &timeStamp, decoded) != ((i & 1) ? CAN_GATEWAY_RX_FRAME : CAN_GATEWAY_TX_FRAME)
+			|| timeStamp != frameTimeStamp || !SameFrame(&obj, data, header, decoded))
+		{
+			if(failed++ < 5)
+				printf("round trip: frame %d with word1 %08X wasn't decoded\n", i, obj.word[1]);
+		}
+	}
+
+	//record with valid CRC but payload which doesn't match DLC must be rejected
+	memset(&obj, 0, sizeof(obj));
+	obj.bF.ctrl.DLC = CAN_DLC_8;
+	n = DRV_CANFDSPI_GatewayEncodeFrame(buffer, CAN_GATEWAY_TX_FRAME, obj.word, 0, data);
+	buffer[4] = CAN_DLC_4;
+	buffer[n - 2] = DRV_CANFDSPI_GatewayCrc(0xFFFF, &buffer[1], n - 3);
+	buffer[n - 1] = DRV_CANFDSPI_GatewayCrc(0xFFFF, &buffer[1], n - 3) >> 8;
+	for(j = 0; j < n; j++)
+		DRV_CANFDSPI_GatewayDecoderPut(&decoder, buffer[j]);
+	if(decoder.records != CHECK_FRAMES + 1 || DRV_CANFDSPI_GatewayDecodeFrame(&decoder, header, &timeStamp, decoded) != -1)
+	{
+		printf("round trip: record with wrong length was accepted\n");
+		failed++;
+	}
+
+	printf("round trip: %d frames, %d failed\n", CHECK_FRAMES, failed);
+
+	return failed;
+}
+
+//stream of records with corrupted or lost bytes, every decoded record must be one of sent records
+static int CheckResync(void)
+{
+	static uint8_t stream[STREAM_FRAMES * CAN_GATEWAY_MAX_RECORD_BYTES];
+	static CAN_TX_MSGOBJ objs[STREAM_FRAMES];
+	static uint8_t datas[STREAM_FRAMES][64];
+	static int damaged[STREAM_FRAMES];
+	CAN_GATEWAY_DECODER decoder;
+	CAN_GATEWAY_STATUS_INFO status = {2, 128, 7, 1, 2, 3};
+	CAN_GATEWAY_STATUS_INFO decodedStatus;
+	uint8_t buffer[CAN_GATEWAY_MAX_RECORD_BYTES];
+	uint8_t decoded[64];
+	uint32_t header[2];
+	uint32_t timeStamp;
+	int length = 0;
+	int nDamaged = 0;
+	int received = 0;
+	int wrong = 0;
+	int statusRecords = 0;
+	int failed = 0;
+	int next = 0;
+	int i, j, n;
+
+	for(i = 0; i < STREAM_FRAMES; i++)
+	{
+		RandomFrame(&objs[i], datas[i]);
+		n = DRV_CANFDSPI_GatewayEncodeFrame(buffer, CAN_GATEWAY_RX_FRAME, objs[i].word, i, datas[i]);
+
+		//every 10th record has flipped or lost byte
+		damaged[i] = (Random() % 10 == 0);
+		if(damaged[i])
+		{
+			j = Random() % n;
+			if(Random() & 1)
+			{
+				buffer[j] ^= 1 << (Random() % 8);
+			}
+			else
+			{
+				memmove(&buffer[j], &buffer[j + 1], n - j - 1);
+				n--;
+			}
+			nDamaged++;
+		}
+
+		memcpy(&stream[length], buffer, n);
+		length += n;
+
+		//status record between frames
+		if(i % 100 == 99)
+		{
+			length += DRV_CANFDSPI_GatewayEncodeStatus(&stream[length], &status);
+		}
+	}
+
+	DRV_CANFDSPI_GatewayDecoderInitialize(&decoder);
+
+	for(i = 0; i < length; i++)
+	{
+		if(DRV_CANFDSPI_GatewayDecoderPut(&decoder, stream[i]) != 1)
+			continue;
+
+		if(DRV_CANFDSPI_GatewayDecodeStatus(&decoder, &decodedStatus) == 0)
+		{
+			if(decodedStatus.state != status.state || decodedStatus.tec != status.tec || decodedStatus.rec != status.rec
+				|| decodedStatus.rxOverruns != status.rxOverruns || decodedStatus.decodeErrors != status.decodeErrors
+				|| decodedStatus.txDropped != status.txDropped)
+				wrong++;
+			statusRecords++;
+			continue;
+		}
+
+		//time stamp is index of record, records are received in order
+		if(DRV_CANFDSPI_GatewayDecodeFrame(&decoder, header, &timeStamp, decoded) < 0
+			|| timeStamp >= STREAM_FRAMES || (int)timeStamp < next || damaged[timeStamp]
+			|| !SameFrame(&objs[timeStamp], datas[timeStamp], header, decoded))
+		{
+			wrong++;
+			continue;
+		}
+
+		next = timeStamp + 1;
+		received++;
+	}
+
+	//record after damaged record can be lost when false length cover its sync byte(rare)
+	if(wrong || received < (STREAM_FRAMES - nDamaged) - nDamaged / 4 || decoder.errors < (uint32_t)nDamaged / 2
+		|| statusRecords < STREAM_FRAMES / 100 - nDamaged)
+	{
+		failed++;
+	}
+
+	printf("resync: %d records, %d damaged, %d received, %d wrong, %u errors, %d status\n", STREAM_FRAMES,
+		nDamaged, received, wrong, decoder.errors, statusRecords);
+
+	return failed;
+}
+
+//SYNC which cause CRC or length error start the next record: record truncated before CRC
+//followed by record, stray SYNC(invalid length 0xA5) followed by record
+static int CheckResyncAtSync(void)
+{
+	CAN_GATEWAY_DECODER decoder;
+	CAN_TX_MSGOBJ obj;
+	uint8_t stream[3 * CAN_GATEWAY_MAX_RECORD_BYTES];
+	uint8_t data[64];
+	uint8_t decoded[64];
+	uint32_t header[2];
+	uint32_t timeStamp = 0;
+	int length;
+	int records = 0;
+	int failed = 0;
+	int i;
+
+	RandomFrame(&obj, data);
+
+	//CRC low byte of truncated record can't be SYNC, otherwise it is valid CRC
+	do
+	{
+		length = DRV_CANFDSPI_GatewayEncodeFrame(stream, CAN_GATEWAY_RX_FRAME, obj.word, timeStamp++, data);
+	} while(stream[length - 2] == CAN_GATEWAY_SYNC);
+	length -= 2;
+
+	length += DRV_CANFDSPI_GatewayEncodeFrame(&stream[length], CAN_GATEWAY_RX_FRAME, obj.word, 1000, data);
+	stream[length++] = CAN_GATEWAY_SYNC;
+	length += DRV_CANFDSPI_GatewayEncodeFrame(&stream[length], CAN_GATEWAY_RX_FRAME, obj.word, 1001, data);
+
+	DRV_CANFDSPI_GatewayDecoderInitialize(&decoder);
+
+	for(i = 0; i < length; i++)
+	{
+		if(DRV_CANFDSPI_GatewayDecoderPut(&decoder, stream[i]) != 1)
+			continue;
+
+		if(DRV_CANFDSPI_GatewayDecodeFrame(&decoder, header, &timeStamp, decoded) < 0
+			|| timeStamp != (uint32_t)(1000 + records) || !SameFrame(&obj, data, header, decoded))
+		{
+			failed++;
+		}
+		records++;
+	}
+
+	if(records != 2 || decoder.errors != 2)
+	{
+		failed++;
+	}
+
+	printf("resync at sync: %d records, %u errors, %d failed\n", records, decoder.errors, failed);
+
+	return failed;
+}
+
+//random frames from small set of identifiers with few changed bytes, dictionary is smaller than set
+static int CheckCaptureRoundTrip(uint8_t dictionarySize, uint8_t historyBytes)
+{
+	static TrafficFrame templates[12];
+	CAN_CAPTURE_CODER encoder;
+	CAN_CAPTURE_CODER decoder;
+	uint8_t buffer[CAN_CAPTURE_RESET_BYTES + CAN_CAPTURE_FRAME_BYTES(64)];
+	uint8_t decoded[64];
+	uint32_t header[2];
+	uint32_t timeStamp = Random();
+	uint32_t decodedTimeStamp;
+	uint32_t bytes = 0;
+	uint16_t used;
+	int failed = 0;
+	int i, n;
+
+	for(i = 0; i < 12; i++)
+		RandomFrame(&templates[i].obj, templates[i].data);
+
+	DRV_CANFDSPI_CaptureInitialize(&encoder, dictionarySize, historyBytes);
+	DRV_CANFDSPI_CaptureInitialize(&decoder, CAN_CAPTURE_DICTIONARY_SIZE, CAN_CAPTURE_HISTORY_BYTES);
+
+	if(DRV_CANFDSPI_CaptureEncodeFrame(&encoder, buffer, templates[0].obj.word, 0, templates[0].data) != 0)
+	{
+		printf("capture round trip: frame encoded before reset\n");
+		failed++;
+	}
+
+	for(i = 0; i < CHECK_FRAMES; i++)
+	{
+		TrafficFrame* frame = &templates[Random() % 12];
+		uint8_t dataBytes = DRV_CANFDSPI_FrameDataBytes(frame->obj.bF.ctrl.FDF, (CAN_DLC)frame->obj.bF.ctrl.DLC);
+		uint16_t position = 0;
+		int result = 0;
+
+		n = 0;
+		if(i % 500 == 0)
+			n = DRV_CANFDSPI_CaptureEncodeReset(&encoder, buffer, timeStamp);
+
+		//0 - 3 changed bytes, time step up to 2^31 to cover long varint
+		if(dataBytes)
+		{
+			int changes = Random() % 4;
+
+			while(changes--)
+				frame->data[Random() % dataBytes] = Random();
+		}
+		timeStamp += (Random() % 16 == 0) ? Random() << 8 : Random() % 5000;
+
+		n += DRV_CANFDSPI_CaptureEncodeFrame(&encoder, &buffer[n], frame->obj.word, timeStamp, frame->data);
+		if(n - ((i % 500 == 0) ? CAN_CAPTURE_RESET_BYTES : 0) > CAN_CAPTURE_FRAME_BYTES(dataBytes))
+		{
+			if(failed++ < 5)
+				printf("capture round trip: frame %d take %d bytes\n", i, n);
+		}
+		bytes += n;
+
+		while(position < n)
+		{
+			result = DRV_CANFDSPI_CaptureDecode(&decoder, &buffer[position], n - position, &used, header,
+				&decodedTimeStamp, decoded);
+			if(result < 0)
+				break;
+			position += used;
+		}
+
+		if(result != CAN_CAPTURE_FRAME || position != n || decodedTimeStamp != timeStamp
+			|| !SameFrame(&frame->obj, frame->data, header, decoded))
+		{
+			if(failed++ < 5)
+				printf("capture round trip: frame %d with word1 %08X wasn't decoded\n", i, frame->obj.word[1]);
+			DRV_CANFDSPI_CaptureInitialize(&decoder, CAN_CAPTURE_DICTIONARY_SIZE, CAN_CAPTURE_HISTORY_BYTES);
+		}
+	}
+
+	//truncated record must be rejected and decoder wait for reset record
+	n = DRV_CANFDSPI_CaptureEncodeFrame(&encoder, buffer, templates[0].obj.word, timeStamp, templates[0].data);
+	if(DRV_CANFDSPI_CaptureDecode(&decoder, buffer, n - 1, &used, header, &decodedTimeStamp, decoded) != -1
+		|| DRV_CANFDSPI_CaptureDecode(&decoder, buffer, n, &used, header, &decodedTimeStamp, decoded) != -1)
+	{
+		printf("capture round trip: truncated record was accepted\n");
+		failed++;
+	}
+
+	printf("capture round trip: dictionary %u history %u, %d frames, %u hits, %.1f bytes per frame, %d failed\n",
+		dictionarySize, historyBytes, CHECK_FRAMES, encoder.hits, (double)bytes / CHECK_FRAMES, failed);
+
+	return failed;
+}
+
+//periodic traffic: counter, checksum, slow signals, constant bytes and few noisy bytes
+static void GenerateTraffic(TrafficFrame* frames, int count)
+{
+	static const uint32_t Periods[] = {10000, 20000, 20000, 50000, 100000, 100000, 200000, 500000, 1000000};
+	TrafficFrame templates[TRAFFIC_IDS];
+	uint32_t period[TRAFFIC_IDS];
+	uint32_t due[TRAFFIC_IDS];
+	uint32_t next[TRAFFIC_IDS];
+	uint32_t start = 0xFFF00000;
+	int i, j;
+
+	for(i = 0; i < TRAFFIC_IDS; i++)
+	{
+		CAN_TX_MSGOBJ* obj = &templates[i].obj;
+
+		memset(obj, 0, sizeof(CAN_TX_MSGOBJ));
+		if(i < 30)
+		{
+			obj->bF.id.SID = (0x100 + i * 0x17) & 0x7FF;
+		}
+		else
+		{
+			obj->bF.ctrl.IDE = 1;
+			obj->bF.id.SID = 0x18FEF000 >> 18;
+			obj->bF.id.EID = (0x18FEF000 | i) & 0x3FFFF;
+		}
+
+		if(i % 13 == 5)
+		{
+			obj->bF.ctrl.FDF = 1;
+			obj->bF.ctrl.BRS = 1;
+			obj->bF.ctrl.DLC = CAN_DLC_16 + Random() % 4;
+		}
+		else
+		{
+			obj->bF.ctrl.DLC = (i % 5 == 0) ? CAN_DLC_4 : CAN_DLC_8;
+		}
+
+		for(j = 0; j < 64; j++)
+			templates[i].data[j] = Random();
+
+		period[i] = Periods[Random() % (sizeof(Periods) / sizeof(Periods[0]))];
+		next[i] = start + Random() % period[i];
+		due[i] = next[i] + Random() % 200;
+	}
+
+	for(i = 0; i < count; i++)
+	{
+		TrafficFrame* template;
+		uint8_t dataBytes;
+		uint8_t sum = 0;
+		int id = 0;
+
+		//frames are sent in order of time stamp with jitter
+		for(j = 1; j < TRAFFIC_IDS; j++)
+		{
+			if((int32_t)(due[j] - due[id]) < 0)
+				id = j;
+		}
+
+		template = &templates[id];
+		dataBytes = DRV_CANFDSPI_FrameDataBytes(template->obj.bF.ctrl.FDF, (CAN_DLC)template->obj.bF.ctrl.DLC);
+
+		template->data[0]++;
+		if(Random() % 10 == 0)
+			template->data[1] += (Random() & 1) ? 1 : -1;
+		if(id % 4 == 0 && dataBytes > 4)
+			template->data[3] = Random();
+		for(j = 0; j < dataBytes - 1; j++)
+			sum += template->data[j];
+		template->data[dataBytes - 1] = sum ^ id;
+
+		frames[i] = *template;
+		frames[i].timeStamp = due[id];
+
+		next[id] += period[id];
+		due[id] = next[id] + Random() % 200;
+	}
+}
+
+static void CaptureWriterInitialize(CaptureWriter* writer, uint8_t* stream)
+{
+	DRV_CANFDSPI_CaptureInitialize(&writer->coder, GATEWAY_DICTIONARY_SIZE, GATEWAY_HISTORY_BYTES);
+	writer->bytes = 0;
+	writer->sequence = 0;
+	writer->blockTime = 0;
+	writer->stream = stream;
+	writer->length = 0;
+}
+
+//send block, lossRate 1 / n blocks is lost and 1 / n blocks has flipped bit
+static void CaptureWriterFlush(CaptureWriter* writer, int lossRate, uint32_t* lost)
+{
+	uint8_t n;
+
+	if(writer->bytes == 0)
+		return;
+
+	n = DRV_CANFDSPI_GatewayEncodeCapture(writer->block, writer->sequence++, writer->bytes);
+	writer->bytes = 0;
+
+	if(lossRate && Random() % lossRate == 0)
+	{
+		(*lost)++;
+		return;
+	}
+
+	memcpy(&writer->stream[writer->length], writer->block, n);
+	if(lossRate && Random() % lossRate == 0)
+	{
+		writer->stream[writer->length + Random() % n] ^= 1 << (Random() % 8);
+		(*lost)++;
+	}
+	writer->length += n;
+}
+
+static void CaptureWriterFrame(CaptureWriter* writer, const TrafficFrame* frame, int lossRate, uint32_t* lost)
+{
+	uint8_t* blockData = &writer->block[CAN_GATEWAY_CAPTURE_DATA_OFFSET];
+	uint8_t dataBytes = DRV_CANFDSPI_FrameDataBytes(frame->obj.bF.ctrl.FDF, (CAN_DLC)frame->obj.bF.ctrl.DLC);
+
+	if(writer->bytes && frame->timeStamp - writer->blockTime >= GATEWAY_FLUSH_US)
+		CaptureWriterFlush(writer, lossRate, lost);
+
+	for(;;)
+	{
+		if(writer->bytes == 0)
+		{
+			if(writer->sequence % GATEWAY_RESET_BLOCKS == 0)
+				writer->bytes = DRV_CANFDSPI_CaptureEncodeReset(&writer->coder, blockData, frame->timeStamp);
+			writer->blockTime = frame->timeStamp;
+		}
+
+		if(writer->bytes + CAN_CAPTURE_FRAME_BYTES(dataBytes) <= CAN_GATEWAY_CAPTURE_DATA_BYTES)
+			break;
+
+		CaptureWriterFlush(writer, lossRate, lost);
+	}
+
+	writer->bytes += DRV_CANFDSPI_CaptureEncodeFrame(&writer->coder, &blockData[writer->bytes], frame->obj.word,
+		frame->timeStamp, frame->data);
+}
+
+typedef struct
+{
+	const TrafficFrame* frames;
+	int count;
+	int next;
+	int received;
+	int wrong;
+} TrafficCompare;
+
+//decoded frames must be sent frames in the same order, lost frames are skipped
+static void CompareOutput(void* context, const uint32_t* header, uint32_t timeStamp, const uint8_t* data)
+{
+	TrafficCompare* compare = context;
+	int i;
+
+	for(i = compare->next; i < compare->count; i++)
+	{
+		if(compare->frames[i].timeStamp == timeStamp
+			&& SameFrame(&compare->frames[i].obj, compare->frames[i].data, header, data))
+		{
+			compare->next = i + 1;
+			compare->received++;
+			return;
+		}
+	}
+
+	compare->wrong++;
+}
+
+static double CaptureBytesPerFrame;
+static double RecordBytesPerFrame;
+
+static int CheckCaptureTraffic(int lossRate)
+{
+	static TrafficFrame frames[TRAFFIC_FRAMES];
+	static uint8_t stream[TRAFFIC_STREAM_BYTES];
+	static CaptureWriter writer;
+	CAN_GATEWAY_DECODER decoder;
+	CaptureStream capture;
+	TrafficCompare compare = {frames, TRAFFIC_FRAMES, 0, 0, 0};
+	uint32_t recordBytes = 0;
+	uint32_t lost = 0;
+	int failed = 0;
+	uint32_t i;
+
+	GenerateTraffic(frames, TRAFFIC_FRAMES);
+
+	CaptureWriterInitialize(&writer, stream);
+	for(i = 0; i < TRAFFIC_FRAMES; i++)
+	{
+		CaptureWriterFrame(&writer, &frames[i], lossRate, &lost);
+		recordBytes += CAN_GATEWAY_OVERHEAD_BYTES + CAN_GATEWAY_FRAME_BODY_BYTES +
+			DRV_CANFDSPI_FrameDataBytes(frames[i].obj.bF.ctrl.FDF, (CAN_DLC)frames[i].obj.bF.ctrl.DLC);
+	}
+	CaptureWriterFlush(&writer, lossRate, &lost);
+
+	DRV_CANFDSPI_GatewayDecoderInitialize(&decoder);
+	CaptureStreamInitialize(&capture);
+
+	for(i = 0; i < writer.length; i++)
+	{
+		if(DRV_CANFDSPI_GatewayDecoderPut(&decoder, stream[i]) == 1)
+			CaptureStreamBlock(&capture, &decoder, CompareOutput, &compare);
+	}
+
+	if(lossRate == 0)
+	{
+		CaptureBytesPerFrame = (double)writer.length / TRAFFIC_FRAMES;
+		RecordBytesPerFrame = (double)recordBytes / TRAFFIC_FRAMES;
+
+		//the whole point of capture format: at least 2 times less bytes than frame records
+		if(compare.wrong || compare.received != TRAFFIC_FRAMES || capture.errors || capture.lostBlocks
+			|| writer.length * 2 > recordBytes)
+		{
+			failed++;
+		}
+
+		printf("capture traffic: %d frames, %u bytes of frame records, %u bytes of capture blocks(%.2f times less), %d received, %d wrong, %u errors\n",
+			TRAFFIC_FRAMES, recordBytes, writer.length, (double)recordBytes / writer.length, compare.received,
+			compare.wrong, capture.errors);
+	}
+	else
+	{
+		//after lost block frames are skipped until reset record, wrong frame is never decoded
+		if(compare.wrong || capture.errors || capture.lostBlocks != lost || compare.received < TRAFFIC_FRAMES / 2
+			|| compare.received == TRAFFIC_FRAMES)
+		{
+			failed++;
+		}
+
+		printf("capture loss: %u blocks, %u lost or damaged, %d of %d frames received, %d wrong, %u errors\n",
+			capture.blocks + capture.lostBlocks, capture.lostBlocks, compare.received, TRAFFIC_FRAMES,
+			compare.wrong, capture.errors);
+	}
+
+	return failed;
+}
+
+static void PrintCapacity(uint32_t baudrate)
+{
+	static const struct
+	{
+		const char* name;
+		bool fdf;
+		bool brs;
+		CAN_DLC dlc;
+		uint32_t nominalBitRate;
+		uint32_t dataBitRate;
+	} Cases[] = {
+		{"classic 8 bytes 500k", false, false, CAN_DLC_8, 500000, 500000},
+		{"classic 8 bytes 1M", false, false, CAN_DLC_8, 1000000, 1000000},
+		{"FD 64 bytes 500k/2M", true, true, CAN_DLC_64, 500000, 2000000},
+		{"FD 64 bytes 1M/5M", true, true, CAN_DLC_64, 1000000, 5000000},
+	};
+	CAN_FRAMETIME frameTime;
+	unsigned int i;
+
+	printf("link capacity at %u baud(%u bits per byte):\n", baudrate, UART_BITS_PER_BYTE);
+	for(i = 0; i < sizeof(Cases) / sizeof(Cases[0]); i++)
+	{
+		uint32_t recordBytes = CAN_GATEWAY_OVERHEAD_BYTES + CAN_GATEWAY_FRAME_BODY_BYTES +
+			DRV_CANFDSPI_FrameDataBytes(Cases[i].fdf, Cases[i].dlc);
+		uint32_t ns;
+
+		DRV_CANFDSPI_FrameTimeInitialize(&frameTime, Cases[i].nominalBitRate, Cases[i].dataBitRate);
+		ns = DRV_CANFDSPI_FrameTimeWorstCase(&frameTime, false, Cases[i].fdf, Cases[i].brs, Cases[i].dlc);
+
+		printf("  %-22s record %2u bytes, link %6u frames/s, bus %6u frames/s\n", Cases[i].name, recordBytes,
+			baudrate / (recordBytes * UART_BITS_PER_BYTE), 1000000000u / ns);
+	}
+
+	printf("  periodic traffic       frame records %.1f bytes %6u frames/s, capture %.1f bytes %6u frames/s\n",
+		RecordBytesPerFrame, (uint32_t)(baudrate / (RecordBytesPerFrame * UART_BITS_PER_BYTE)),
+		CaptureBytesPerFrame, (uint32_t)(baudrate / (CaptureBytesPerFrame * UART_BITS_PER_BYTE)));
+}
+
+int main(int argc, char** argv)
+{
+	int failed = 0;
+
+	if(argc > 2 && strcmp(argv[1], "-d") == 0)
+		return Decode(argv[2]);
+
+	if(argc > 2 && strcmp(argv[1], "-e") == 0)
+		return Encode(argc - 2, argv + 2);
+
+	if(argc > 1)
+	{
+		printf("Usage: GatewayDecoder -d file | -e frame...\n");
+		return -1;
+	}
+
+	//CRC-16/CCITT-FALSE check value
+	if(DRV_CANFDSPI_GatewayCrc(0xFFFF, (const uint8_t*)"123456789", 9) != 0x29B1)
+	{
+		printf("CRC check value %04X\n", DRV_CANFDSPI_GatewayCrc(0xFFFF, (const uint8_t*)"123456789", 9));
+		failed++;
+	}
+
+	failed += CheckRoundTrip();
+	failed += CheckResync();
+	failed += CheckResyncAtSync();
+	failed += CheckCaptureRoundTrip(4, GATEWAY_HISTORY_BYTES);
+	failed += CheckCaptureRoundTrip(1, 0);
+	failed += CheckCaptureRoundTrip(32, 64);
+	failed += CheckCaptureTraffic(0);
+	failed += CheckCaptureTraffic(40);
+	PrintCapacity(3000000);
+
+	printf("%d failed\n", failed);
+
+	return failed;
+}
@@ -0,0 +1,362 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+* Host tool for variable length packed frame ring from drv_canfdspi_packed.c.
+*
+* Capacity: frames with random payload size from traffic mix are put into empty ring
+* until first put fail. Result is compared with fixed slots(12 bytes header and 64
+* bytes payload) in the same memory.
+*
+* Check: producer and consumer are randomly interleaved for many frames, so every
+* wrap case(record ending at end of buffer, wrap marker, full ring) is exercised.
+* Every frame carry sequence number and payload derived from it, consumer check order,
+* payload and that frames are lost only when put reported full ring. Empty ring with
+* indexes at every offset must accept frame with 64 bytes payload.
+*
+* Build(gcc or mingw):
+*	gcc -std=gnu99 -Wall -o PackedRingCapacity PackedRingCapacity.c
+*
+* Usage:
+*	PackedRingCapacity [-r ramBytes] [-t trials] [w8:w16:w32:w64 ...]
+*
+* Mix is relative amount of frames with 8, 16, 32 and 64 bytes payload(classic frames
+* for 8 bytes). Without mix classic only, mixed and FD only traffic is measured.
+*
+* Exit code is number of failed checks.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_api.c"
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_packed.c"
+
+#define FIXED_SLOT_BYTES (CAN_PACKED_HEADER_BYTES + 64)
+#define MAX_RAM_BYTES 8192
+#define MAX_MIXES 16
+#define CHECK_FRAMES 1000000
+
+static const CAN_DLC ClassDlc[] = {CAN_DLC_8, CAN_DLC_16, CAN_DLC_32, CAN_DLC_64};
+
+static uint32_t RingMemory[MAX_RAM_BYTES / 4];
+static uint32_t RandomState = 1;
+
+//ring is used without SPI, stubs are required only by drv_canfdspi_api.c
+int8_t DRV_SPI_TransferData(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxData, uint8_t *SpiRxData, uint16_t spiTransferSize)
+{
+	(void)spiSlaveDeviceIndex;
+	(void)SpiTxData;
+	memset(SpiRxData, 0, spiTransferSize);
+
+	return -1;
+}
+
+int8_t DRV_SPI_TransferFill(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxHeader, uint16_t spiHeaderSize, uint8_t fillByte, uint16_t spiFillSize)
+{
+	(void)spiSlaveDeviceIndex;
+	(void)SpiTxHeader;
+	(void)spiHeaderSize;
+	(void)fillByte;
+	(void)spiFillSize;
+
+	return -1;
+}
+
+static uint32_t Random(void)
+{
+	RandomState = RandomState * 1103515245u + 12345u;
+	return RandomState >> 16;
+}
+
+static uint8_t RandomClass(const uint32_t weights[4])
+{
+	uint32_t r = Random() % (weights[0] + weights[1] + weights[2] + weights[3]);
+	uint8_t c;
+
+	for(c = 0; c < 3; c++)
+	{
+		if(r < weights[c])
+			break;
+		r -= weights[c];
+	}
+
+	return c;
+}
+
+//header and payload of frame with sequence number
+static void MakeFrame(CAN_RX_MSGOBJ* header, uint8_t* data, uint32_t sequence, uint8_t c)
+{
+	uint8_t i;
+
+	header->word[0] = sequence & 0x1FFFFFFF;
+	header->word[1] = 0;
+	header->bF.ctrl.DLC = ClassDlc[c];
+	header->bF.ctrl.FDF = (c > 0);
+	header->bF.ctrl.IDE = 1;
+	header->word[2] = sequence;
+
+	for(i = 0; i < 64; i++)
+	{
+		data[i] = (uint8_t)(sequence + i);
+	}
+}
+
+static bool MeasureMix(const uint32_t weights[4], uint16_t ramBytes, uint32_t trials)
+{
+	CAN_PACKED_RING ring;
+	CAN_RX_MSGOBJ header;
+	uint8_t data[64];
+	uint32_t fixedSlots = ramBytes / FIXED_SLOT_BYTES;
+	uint32_t sum = 0;
+	uint32_t min = ~0u;
+	uint32_t n;
+	uint32_t t;
+
+	for(t = 0; t < trials; t++)
+	{
+		DRV_CANFDSPI_PackedRingInitialize(&ring, RingMemory, ramBytes);
+
+		//record has at least 20 bytes, so more frames means broken full ring detection
+		for(n = 0; n <= ramBytes / 20; n++)
+		{
+			MakeFrame(&header, data, n, RandomClass(weights));
+			if(DRV_CANFDSPI_PackedRingPut(&ring, &header, data) != 0)
+				break;
+		}
+
+		if(n > ramBytes / 20)
+		{
+			printf("ERROR: ring accepted more frames than fit into memory\n");
+			return false;
+		}
+
+		sum += n;
+		if(n < min)
+			min = n;
+	}
+
+	printf("mix %2u:%2u:%2u:%2u  fixed slots %3u  packed frames avg %5.1f min %3u  gain %4.2fx\n",
+			weights[0], weights[1], weights[2], weights[3], fixedSlots,
+			(double)sum / trials, min, (double)sum / trials / (fixedSlots ? fixedSlots : 1));
+
+	//FD only traffic with 64 bytes payload can't be stored better than by fixed slots
+	return (weights[0] + weights[1] + weights[2] == 0) || (sum >= fixedSlots * trials);
+}
+
+static int CheckRing(uint16_t ramBytes)
+{
+	static const uint32_t Mix[4] = {4, 1, 1, 2};
+	CAN_PACKED_RING ring;
+	CAN_PACKED_RECORD* record;
+	CAN_RX_MSGOBJ header;
+	uint8_t data[64];
+	uint32_t produced = 0;
+	uint32_t expected = 0;
+	uint32_t dropped = 0;
+	uint32_t received = 0;
+	uint32_t dataBytes;
+	uint32_t sequence;
+	uint32_t steps = 0;
+	uint32_t i;
+	int errors = 0;
+	bool full = false;
+
+	DRV_CANFDSPI_PackedRingInitialize(&ring, RingMemory, ramBytes);
+
+	while(produced < CHECK_FRAMES || DRV_CANFDSPI_PackedRingUsedBytes(&ring) != 0)
+	{
+		//broken ring may never become empty
+		if(++steps > 20 * CHECK_FRAMES)
+		{
+			printf("ERROR: ring isn't empty after all frames were consumed\n");
+			errors++;
+			break;
+		}
+
+		//producer is faster when ring isn't full, so ring is often full
+		if(produced < CHECK_FRAMES && (Random() % 8) < (full ? 2 : 5))
+		{
+			MakeFrame(&header, data, produced, RandomClass(Mix));
+			full = (DRV_CANFDSPI_PackedRingPut(&ring, &header, data) != 0);
+			if(full)
+			{
+				dropped++;
+			}
+			produced++;
+			continue;
+		}
+
+		record = DRV_CANFDSPI_PackedRingPeek(&ring);
+		if(record == NULL)
+		{
+			continue;
+		}
+
+		sequence = record->rx.bF.timeStamp;
+		if(sequence < expected || record->word[0] != (sequence & 0x1FFFFFFF))
+		{
+			if(errors++ < 10)
+				printf("ERROR: wrong header, sequence %u expected %u\n", sequence, expected);
+		}
+		expected = sequence + 1;
+
+		if((uint8_t*)record + DRV_CANFDSPI_PackedRecordBytes(record) > (uint8_t*)RingMemory + ramBytes)
+		{
+			if(errors++ < 10)
+				printf("ERROR: record cross end of buffer, sequence %u\n", sequence);
+		}
+
+		dataBytes = DRV_CANFDSPI_DlcToDataBytes((CAN_DLC)record->rx.bF.ctrl.DLC);
+		for(i = 0; i < dataBytes; i++)
+		{
+			if(CAN_PACKED_DATA(record)[i] != (uint8_t)(sequence + i))
+			{
+				if(errors++ < 10)
+					printf("ERROR: wrong payload, sequence %u\n", sequence);
+				break;
+			}
+		}
+
+		DRV_CANFDSPI_PackedRingCommit(&ring);
+		received++;
+	}
+
+	printf("Check %u bytes: produced %u, received %u, dropped %u, overruns %u, high watermark %u bytes\n",
+			ramBytes, produced, received, dropped, ring.overruns, ring.highWatermark);
+
+	if(received + dropped != produced || dropped != ring.overruns)
+	{
+		printf("ERROR: frames missing\n");
+		errors++;
+	}
+
+	return errors;
+}
+
+static int CheckEmptyRing(uint16_t ramBytes)
+{
+	CAN_PACKED_RING ring;
+	uint16_t offset;
+	int errors = 0;
+
+	if(DRV_CANFDSPI_PackedRingInitialize(&ring, RingMemory, CAN_PACKED_MIN_BYTES - 4) == 0)
+	{
+		printf("ERROR: ring smaller than %u bytes was accepted\n", CAN_PACKED_MIN_BYTES);
+		errors++;
+	}
+
+	//consumer leave indexes where ring become empty
+	for(offset = 0; offset < ramBytes; offset += 4)
+	{
+		DRV_CANFDSPI_PackedRingInitialize(&ring, RingMemory, ramBytes);
+		ring.head = offset;
+		ring.tail = offset;
+
+		if(DRV_CANFDSPI_PackedRingReserve(&ring, 64) == NULL)
+		{
+			if(errors++ < 10)
+				printf("ERROR: empty ring of %u bytes at offset %u refuse 64 bytes payload\n", ramBytes, offset);
+		}
+	}
+
+	return errors;
+}
+
+static bool ParseQuad(const char* text, uint32_t values[4])
+{
+	return sscanf(text, "%u:%u:%u:%u", &values[0], &values[1], &values[2], &values[3]) == 4;
+}
+
+int main(int argc, char** argv)
+{
+	static const uint32_t DefaultMixes[][4] = {
+		{1, 0, 0, 0},
+		{6, 1, 1, 2},
+		{2, 1, 1, 1},
+		{0, 0, 0, 1}
+	};
+	uint32_t mixes[MAX_MIXES][4];
+	uint32_t nMixes = 0;
+	uint32_t ramBytes = 1520;
+	uint32_t trials = 1000;
+	int failures = 0;
+	int i;
+
+	for(i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+		{
+			ramBytes = strtoul(argv[++i], NULL, 0);
+		}
+		else if(strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			trials = strtoul(argv[++i], NULL, 0);
+		}
+		else if(nMixes < MAX_MIXES && ParseQuad(argv[i], mixes[nMixes]) &&
+				(mixes[nMixes][0] + mixes[nMixes][1] + mixes[nMixes][2] + mixes[nMixes][3]) > 0)
+		{
+			nMixes++;
+		}
+		else
+		{
+			printf("Usage: PackedRingCapacity [-r ramBytes] [-t trials] [w8:w16:w32:w64 ...]\n");
+			return -1;
+		}
+	}
+
+	ramBytes &= ~3u;
+	if(ramBytes > MAX_RAM_BYTES || ramBytes < CAN_PACKED_MIN_BYTES || trials == 0)
+	{
+		printf("RAM must be in range %u .. %u bytes and trials can't be 0\n", CAN_PACKED_MIN_BYTES, MAX_RAM_BYTES);
+		return -1;
+	}
+
+	if(nMixes == 0)
+	{
+		nMixes = sizeof(DefaultMixes) / sizeof(DefaultMixes[0]);
+		memcpy(mixes, DefaultMixes, sizeof(DefaultMixes));
+	}
+
+	printf("RAM %u bytes, fixed slot %u bytes, records 20/28/44/76 bytes, %u trials\n",
+			ramBytes, FIXED_SLOT_BYTES, trials);
+
+	for(i = 0; i < (int)nMixes; i++)
+	{
+		if(!MeasureMix(mixes[i], ramBytes, trials))
+		{
+			failures++;
+		}
+	}
+
+	failures += CheckRing(ramBytes);
+	failures += CheckRing(CAN_PACKED_MIN_BYTES);
+	failures += CheckEmptyRing(ramBytes);
+	failures += CheckEmptyRing(CAN_PACKED_MIN_BYTES);
+
+	return failures;
+}
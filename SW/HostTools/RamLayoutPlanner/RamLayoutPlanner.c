@@ -0,0 +1,313 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+* Host tool which use RAM layout planner from drv_canfdspi_ramplan.c to calculate FIFO
+* depth and payload size for traffic mix. For comparison the same RAM is planned also
+* with single 64 byte FIFO for every direction(as in example project). Result is printed
+* as CAN_TX_FIFO_CONFIG/CAN_RX_FIFO_CONFIG settings and as CAN_IMAGE_FIFOCON_* values for
+* configuration image. Every FIFO is additionally checked with CAN_RAM_FIFOCON_BYTES macro
+* used for compile time check.
+*
+* Build(gcc or mingw):
+*	gcc -std=gnu99 -Wall -o RamLayoutPlanner RamLayoutPlanner.c
+*
+* Usage:
+*	RamLayoutPlanner [-e tefDepth] [-E] [-q txqDepth] [-Q txqDataBytes] [-r ramSize] class...
+*
+* Class is dir:dataBytes:weight[:ts], where dir is tx or rx, weight is relative amount of
+* frames in burst and ts enable RX time stamp. -E enable TEF time stamp. Example for
+* gateway which receive mostly classic frames and transmit FD frames:
+*	RamLayoutPlanner -q 0 rx:8:6 rx:64:2 tx:8:1 tx:64:3
+*
+* Exit code is 0 when layout was planned and checked.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_api.c"
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_ramplan.c"
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_image.h"
+
+#define MAX_CLASSES 16
+
+static const char* const PayLoadSizeNames[] = {
+	"CAN_PLSIZE_8", "CAN_PLSIZE_12", "CAN_PLSIZE_16", "CAN_PLSIZE_20",
+	"CAN_PLSIZE_24", "CAN_PLSIZE_32", "CAN_PLSIZE_48", "CAN_PLSIZE_64"
+};
+
+int8_t DRV_SPI_TransferData(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxData, uint8_t *SpiRxData, uint16_t spiTransferSize)
+{
+	//planner doesn't use SPI
+	(void)spiSlaveDeviceIndex;
+	(void)SpiTxData;
+	memset(SpiRxData, 0, spiTransferSize);
+
+	return 0;
+}
+
+int8_t DRV_SPI_TransferFill(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxHeader, uint16_t spiHeaderSize, uint8_t fillByte, uint16_t spiFillSize)
+{
+	(void)spiSlaveDeviceIndex;
+	(void)SpiTxHeader;
+	(void)spiHeaderSize;
+	(void)fillByte;
+	(void)spiFillSize;
+
+	return 0;
+}
+
+static void PrintUsage(void)
+{
+	printf("Usage: RamLayoutPlanner [-e tefDepth] [-E] [-q txqDepth] [-Q txqDataBytes] [-r ramSize] class...\n");
+	printf("       class: tx:dataBytes:weight or rx:dataBytes:weight[:ts]\n");
+}
+
+static int ParseClass(const char* text, CAN_RAM_PLAN_CLASS* planClass)
+{
+	char dir[3];
+	unsigned int dataBytes;
+	unsigned int weight;
+	char timeStamp[3] = "";
+
+	if(sscanf(text, "%2[a-z]:%u:%u:%2s", dir, &dataBytes, &weight, timeStamp) < 3)
+	{
+		return -1;
+	}
+
+	if((strcmp(dir, "tx") != 0 && strcmp(dir, "rx") != 0) || dataBytes > 64 || weight > 0xFFFF)
+	{
+		return -1;
+	}
+
+	planClass->tx = (strcmp(dir, "tx") == 0);
+	planClass->dataBytes = dataBytes;
+	planClass->weight = weight;
+	planClass->timeStamp = (strcmp(timeStamp, "ts") == 0);
+
+	return 0;
+}
+
+//Depth of the FIFO with the lowest depth/weight ratio, multiplied by 100
+static uint32_t MinDepthPerWeight(const CAN_RAM_PLAN_CLASS* classes, const CAN_RAM_PLAN_FIFO* fifos, int nClasses)
+{
+	uint32_t min = 0xFFFFFFFF;
+	int i;
+
+	for(i = 0; i < nClasses; i++)
+	{
+		if(classes[i].weight && (fifos[i].depth * 100u / classes[i].weight) < min)
+		{
+			min = fifos[i].depth * 100u / classes[i].weight;
+		}
+	}
+
+	return min;
+}
+
+static int PrintPlan(const char* title, const CAN_RAM_PLAN_CONFIG* config, const CAN_RAM_PLAN_CLASS* classes,
+		const CAN_RAM_PLAN_FIFO* fifos, int nClasses)
+{
+	uint32_t fifoCon;
+	uint32_t total = DRV_CANFDSPI_RamPlanReservedBytes(config);
+	int failures = 0;
+	int i;
+
+	printf("%s:\n", title);
+	printf("  TEF %u objects, TXQ %u objects: %u bytes\n", config->tefDepth, config->txqDepth, total);
+
+	for(i = 0; i < nClasses; i++)
+	{
+		printf("  CH%-2u %s %2u bytes weight %5u -> %-13s depth %2u, %4u bytes\n", fifos[i].channel,
+				fifos[i].tx ? "TX" : "RX", classes[i].dataBytes, classes[i].weight,
+				PayLoadSizeNames[fifos[i].payLoadSize], fifos[i].depth, fifos[i].ramBytes);
+
+		//the same FIFO described by register value for compile time check
+		if(fifos[i].tx)
+			fifoCon = CAN_IMAGE_FIFOCON_TX(fifos[i].depth - 1, fifos[i].payLoadSize, 0, 3, 0);
+		else
+			fifoCon = CAN_IMAGE_FIFOCON_RX(fifos[i].depth - 1, fifos[i].payLoadSize, fifos[i].timeStamp, 0);
+
+		if(CAN_RAM_FIFOCON_BYTES(fifoCon) != fifos[i].ramBytes)
+		{
+			printf("  FAIL: CAN_RAM_FIFOCON_BYTES %u\n", (unsigned int)CAN_RAM_FIFOCON_BYTES(fifoCon));
+			failures++;
+		}
+
+		total += fifos[i].ramBytes;
+	}
+
+	printf("  total %u of %u bytes, minimal depth/weight %u.%02u\n", total, config->ramSize,
+			MinDepthPerWeight(classes, fifos, nClasses) / 100, MinDepthPerWeight(classes, fifos, nClasses) % 100);
+
+	if(total > config->ramSize)
+	{
+		printf("  FAIL: layout doesn't fit into RAM\n");
+		failures++;
+	}
+
+	return failures;
+}
+
+static void EmitCode(const CAN_RAM_PLAN_FIFO* fifos, int nClasses)
+{
+	CAN_TX_FIFO_CONFIG txConfig;
+	CAN_RX_FIFO_CONFIG rxConfig;
+	int i;
+
+	printf("\n// FIFO configuration\n");
+	for(i = 0; i < nClasses; i++)
+	{
+		if(fifos[i].tx)
+		{
+			DRV_CANFDSPI_RamPlanTxConfig(&fifos[i], &txConfig);
+			printf("DRV_CANFDSPI_TransmitChannelConfigureObjectReset(&txConfig);\n");
+			printf("txConfig.FifoSize = %u;\n", txConfig.FifoSize);
+			printf("txConfig.PayLoadSize = %s;\n", PayLoadSizeNames[txConfig.PayLoadSize]);
+			printf("DRV_CANFDSPI_TransmitChannelConfigure(DRV_CANFDSPI_INDEX_0, CAN_FIFO_CH%u, &txConfig);\n\n", fifos[i].channel);
+		}
+		else
+		{
+			DRV_CANFDSPI_RamPlanRxConfig(&fifos[i], &rxConfig);
+			printf("DRV_CANFDSPI_ReceiveChannelConfigureObjectReset(&rxConfig);\n");
+			printf("rxConfig.FifoSize = %u;\n", rxConfig.FifoSize);
+			printf("rxConfig.PayLoadSize = %s;\n", PayLoadSizeNames[rxConfig.PayLoadSize]);
+			printf("rxConfig.RxTimeStampEnable = %u;\n", rxConfig.RxTimeStampEnable);
+			printf("DRV_CANFDSPI_ReceiveChannelConfigure(DRV_CANFDSPI_INDEX_0, CAN_FIFO_CH%u, &rxConfig);\n\n", fifos[i].channel);
+		}
+	}
+
+	printf("// Configuration image(priority, attempts and events to be set)\n");
+	for(i = 0; i < nClasses; i++)
+	{
+		if(fifos[i].tx)
+			printf("[CAN_FIFO_CH%u] = CAN_IMAGE_FIFOCON_TX(%u, %s, 0, 3, CAN_TX_FIFO_NO_EVENT),\n",
+					fifos[i].channel, fifos[i].depth - 1, PayLoadSizeNames[fifos[i].payLoadSize]);
+		else
+			printf("[CAN_FIFO_CH%u] = CAN_IMAGE_FIFOCON_RX(%u, %s, %u, CAN_RX_FIFO_NO_EVENT),\n",
+					fifos[i].channel, fifos[i].depth - 1, PayLoadSizeNames[fifos[i].payLoadSize], fifos[i].timeStamp);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	CAN_RAM_PLAN_CONFIG config;
+	CAN_RAM_PLAN_CLASS classes[MAX_CLASSES];
+	CAN_RAM_PLAN_FIFO fifos[MAX_CLASSES];
+	CAN_RAM_PLAN_CLASS singleClasses[2];
+	CAN_RAM_PLAN_FIFO singleFifos[2];
+	int nClasses = 0;
+	int nSingle = 0;
+	int failures = 0;
+	int8_t result;
+	int i, j;
+
+	DRV_CANFDSPI_RamPlanConfigObjectReset(&config);
+
+	for(i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-E") == 0)
+		{
+			config.tefTimeStamp = true;
+		}
+		else if(argv[i][0] == '-' && i + 1 < argc)
+		{
+			uint32_t value = strtoul(argv[i + 1], NULL, 0);
+
+			if(strcmp(argv[i], "-e") == 0 && value <= CAN_RAM_MAX_FIFO_DEPTH)
+				config.tefDepth = value;
+			else if(strcmp(argv[i], "-q") == 0 && value <= CAN_RAM_MAX_FIFO_DEPTH)
+				config.txqDepth = value;
+			else if(strcmp(argv[i], "-Q") == 0 && value <= 64)
+				config.txqPayLoadSize = DRV_CANFDSPI_RamPlanPayLoadSize(value);
+			else if(strcmp(argv[i], "-r") == 0 && value <= cRAM_SIZE)
+				config.ramSize = value;
+			else
+			{
+				PrintUsage();
+				return -1;
+			}
+			i++;
+		}
+		else if(nClasses < MAX_CLASSES && ParseClass(argv[i], &classes[nClasses]) == 0)
+		{
+			nClasses++;
+		}
+		else
+		{
+			PrintUsage();
+			return -1;
+		}
+	}
+
+	if(nClasses == 0)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	result = DRV_CANFDSPI_RamPlan(&config, classes, nClasses, fifos);
+	if(result != 0)
+	{
+		printf("Planner error %d\n", result);
+		return 1;
+	}
+
+	//single 64 byte FIFO for every direction, the same classes share it
+	for(i = 0; i < nClasses; i++)
+	{
+		for(j = 0; j < nSingle; j++)
+		{
+			if(singleClasses[j].tx == classes[i].tx)
+				break;
+		}
+
+		if(j == nSingle)
+		{
+			singleClasses[j].tx = classes[i].tx;
+			singleClasses[j].dataBytes = 64;
+			singleClasses[j].weight = 0;
+			singleClasses[j].timeStamp = false;
+			nSingle++;
+		}
+
+		singleClasses[j].weight += classes[i].weight;
+		singleClasses[j].timeStamp |= classes[i].timeStamp;
+	}
+
+	failures += PrintPlan("Planned layout", &config, classes, fifos, nClasses);
+
+	if(DRV_CANFDSPI_RamPlan(&config, singleClasses, nSingle, singleFifos) == 0)
+	{
+		failures += PrintPlan("Single 64 byte FIFO per direction", &config, singleClasses, singleFifos, nSingle);
+	}
+
+	EmitCode(fifos, nClasses);
+
+	return failures;
+}
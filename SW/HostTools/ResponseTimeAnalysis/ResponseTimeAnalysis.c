@@ -0,0 +1,873 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+* Host tool for worse case response time analysis of CAN message set.
+*
+* Every message is described by ID, period, payload size, format and transmitter. Frame
+* time is worse case time from drv_canfdspi_frametime.c, so analysis is valid for any
+* payload. Response time is time from release of message in application to the end of
+* frame on the bus, deadline is equal to period when it isn't given.
+*
+* Analysis is revised schedulability analysis of CAN(Davis, Burns, Bril, Lukkien 2007):
+* busy period is calculated at priority of message and every instance in busy period is
+* checked, non preemptive blocking is the longest frame with lower priority and bit time
+* is added to queuing window(frame released one bit before arbitration still wait).
+*
+* Messages of remote nodes are treated as if every node use priority queue. Messages of
+* this node are transmitted from MCP2517FD queues:
+* - TXQ(channel 0) transmit frames in ID order,
+* - TX FIFO transmit frames in order of submission, so every other message from the same
+*   FIFO can be queued before analysed message and lowest priority message in FIFO set
+*   priority of whole FIFO(priority inversion),
+* - queue with the highest TXPRI(the lowest channel for equal TXPRI) is served first, so
+*   messages from queues with higher TXPRI interfere regardless of ID.
+* Release jitter of local message include MCU service latency: frame is submitted by
+* periodic poll(SysTick in example project) and loaded to MCP2517FD by three SPI
+* transactions of drv_spi.c(status read, object write and UINC/TXREQ). In the worst case
+* every local message is due in the same poll and analysed message is loaded as the last.
+*
+* Result is compared with simulation of the same message set with random offsets and
+* jitter. Simulated response time must not exceed analysed response time.
+*
+* Without messages tool analyse built-in example set and run self checks(known result
+* of example from the paper, FIFO priority inversion, TXPRI order, simulation bound).
+*
+* Build(gcc or mingw):
+*	gcc -std=gnu99 -Wall -o ResponseTimeAnalysis ResponseTimeAnalysis.c
+*
+* Usage:
+*	ResponseTimeAnalysis [-b nominalBitRate] [-d dataBitRate] [-p pollUs] [-o spiOverheadNs]
+*		[-s spiByteNs] [-t channel:txpri]... [-f file] [message...]
+*
+* Message is id:periodUs:dataBytes:format[:queue[:deadlineUs[:jitterUs]]], where ID is
+* written like in candump(up to 3 hex digits for standard ID), format is c(classic), fd
+* or brs and queue is - for remote node(default) or local channel(0 - TXQ, 1..31 - TX
+* FIFO). File contain one message per line, lines starting with # are skipped. Example
+* where urgent frame share TX FIFO with bulk frame:
+*	ResponseTimeAnalysis -t 1:1 080:1000:8:c 010:2000:8:c:1 500:5000:64:brs:1 120:10000:16:brs:2
+*
+* Exit code is number of messages which miss deadline, without messages number of failed
+* checks.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_frametime.c"
+
+#define MAX_MESSAGES 64
+#define MAX_CHANNELS 32
+#define REMOTE_QUEUE -1
+
+//SPI transfer cost: CS and driver overhead and 4MHz SPI clock(as in TxPriorityBenchmark)
+#define DEFAULT_SPI_OVERHEAD_NS 3000
+#define DEFAULT_SPI_BYTE_NS 2000
+#define DEFAULT_POLL_US 1000
+
+//busy period longer than this is treated as unbounded(bus overloaded)
+#define MAX_BUSY_PERIOD_NS 10000000000ull
+
+//simulation
+#define SIM_RUNS 20
+#define SIM_PERIODS 200
+#define SIM_QUEUE_DEPTH 256
+
+typedef struct
+{
+	//input
+	uint32_t id;
+	bool extended;
+	bool fdf;
+	bool brs;
+	uint8_t dataBytes;
+	int8_t queue;
+	uint64_t period;
+	uint64_t deadline;
+	uint64_t jitter;
+	//analysis, all times in ns
+	uint32_t key;
+	uint64_t frameTime;
+	uint64_t releaseJitter;
+	uint64_t blocking;
+	uint64_t response;
+	bool bounded;
+	//simulation
+	uint64_t simResponse;
+} MESSAGE;
+
+typedef struct
+{
+	uint32_t nominalBitRate;
+	uint32_t dataBitRate;
+	uint64_t poll;
+	uint32_t spiOverhead;
+	uint32_t spiByte;
+	uint8_t txPriority[MAX_CHANNELS];
+} CONFIG;
+
+static MESSAGE Messages[MAX_MESSAGES];
+static uint32_t RandomState = 1;
+
+static uint32_t Random(void)
+{
+	RandomState = RandomState * 1103515245 + 12345;
+	return RandomState >> 8;
+}
+
+static uint64_t DivCeil(uint64_t a, uint64_t b)
+{
+	return (a + b - 1) / b;
+}
+
+//arbitration field as number, the lowest value win: base ID, IDE(SRR is recessive), extended ID
+static uint32_t ArbitrationKey(uint32_t id, bool extended)
+{
+	if(extended)
+	{
+		return ((id >> 18) << 19) | (1 << 18) | (id & 0x3FFFF);
+	}
+
+	return id << 19;
+}
+
+static CAN_DLC DataBytesToDlc(bool fdf, uint8_t dataBytes)
+{
+	uint8_t dlc;
+
+	for(dlc = CAN_DLC_0; dlc < CAN_DLC_64; dlc++)
+	{
+		if(DRV_CANFDSPI_FrameDataBytes(fdf, (CAN_DLC)dlc) >= dataBytes)
+			break;
+	}
+
+	return (CAN_DLC)dlc;
+}
+
+//time of status read(CiFIFOCON/STA/UA), object write(rounded to words) and UINC/TXREQ
+static uint64_t LoadTime(const CONFIG* config, const MESSAGE* message)
+{
+	uint32_t bytes = (2 + 12) + (2 + 8 + ((message->dataBytes + 3) & ~3u)) + (2 + 1);
+
+	return 3 * (uint64_t)config->spiOverhead + bytes * (uint64_t)config->spiByte;
+}
+
+//local queues ordered by service order: higher TXPRI, then lower channel
+static bool QueueServedBefore(const CONFIG* config, int8_t a, int8_t b)
+{
+	if(config->txPriority[a] != config->txPriority[b])
+		return config->txPriority[a] > config->txPriority[b];
+
+	return a < b;
+}
+
+//k can delay start of transmission of m many times(is part of hp(m))
+static bool Interferes(const CONFIG* config, const MESSAGE* messages, int m, int k, uint32_t effectiveKey)
+{
+	const MESSAGE* mm = &messages[m];
+	const MESSAGE* mk = &messages[k];
+
+	if(k == m)
+		return false;
+
+	if(mm->queue == REMOTE_QUEUE || mk->queue == REMOTE_QUEUE)
+		return mk->key < effectiveKey;
+
+	if(mk->queue == mm->queue)
+	{
+		//TXQ is ordered by ID, TX FIFO by submission
+		return (mm->queue == 0) ? (mk->key < mm->key) : true;
+	}
+
+	return QueueServedBefore(config, mk->queue, mm->queue);
+}
+
+//the lowest priority frame which can be at the head of local queues served before m
+static uint32_t EffectiveKey(const CONFIG* config, const MESSAGE* messages, int nMessages, int m)
+{
+	uint32_t key = messages[m].key;
+	int k;
+
+	if(messages[m].queue == REMOTE_QUEUE)
+		return key;
+
+	for(k = 0; k < nMessages; k++)
+	{
+		if(k == m || messages[k].queue == REMOTE_QUEUE || messages[k].key <= key)
+			continue;
+
+		if((messages[k].queue == messages[m].queue && messages[m].queue != 0)
+			|| (messages[k].queue != messages[m].queue && QueueServedBefore(config, messages[k].queue, messages[m].queue)))
+		{
+			key = messages[k].key;
+		}
+	}
+
+	return key;
+}
+
+static void Analyse(const CONFIG* config, MESSAGE* messages, int nMessages)
+{
+	CAN_FRAMETIME frameTime;
+	uint64_t bitTime;
+	uint64_t localLoad = 0;
+	int m, k;
+
+	DRV_CANFDSPI_FrameTimeInitialize(&frameTime, config->nominalBitRate, config->dataBitRate);
+	bitTime = DivCeil(1000000000ull, config->nominalBitRate);
+
+	for(m = 0; m < nMessages; m++)
+	{
+		MESSAGE* message = &messages[m];
+
+		message->key = ArbitrationKey(message->id, message->extended);
+		if(message->frameTime == 0)
+		{
+			message->frameTime = DRV_CANFDSPI_FrameTimeWorstCase(&frameTime, message->extended,
+				message->fdf, message->brs, DataBytesToDlc(message->fdf, message->dataBytes));
+		}
+		if(message->queue != REMOTE_QUEUE)
+			localLoad += LoadTime(config, message);
+	}
+
+	for(m = 0; m < nMessages; m++)
+	{
+		MESSAGE* message = &messages[m];
+
+		message->releaseJitter = message->jitter;
+		if(message->queue != REMOTE_QUEUE)
+			message->releaseJitter += config->poll + localLoad;
+	}
+
+	for(m = 0; m < nMessages; m++)
+	{
+		MESSAGE* message = &messages[m];
+		uint32_t effectiveKey = EffectiveKey(config, messages, nMessages, m);
+		uint64_t busy, next, instances, q;
+
+		message->blocking = 0;
+		for(k = 0; k < nMessages; k++)
+		{
+			if(k != m && !Interferes(config, messages, m, k, effectiveKey) && messages[k].frameTime > message->blocking)
+				message->blocking = messages[k].frameTime;
+		}
+
+		//busy period at priority of message
+		busy = message->frameTime;
+		do
+		{
+			next = message->blocking + DivCeil(busy + message->releaseJitter, message->period) * message->frameTime;
+			for(k = 0; k < nMessages; k++)
+			{
+				if(Interferes(config, messages, m, k, effectiveKey))
+					next += DivCeil(busy + messages[k].releaseJitter, messages[k].period) * messages[k].frameTime;
+			}
+			if(next == busy)
+				break;
+			busy = next;
+		} while(busy <= MAX_BUSY_PERIOD_NS);
+
+		message->bounded = (busy <= MAX_BUSY_PERIOD_NS);
+		message->response = 0;
+		if(!message->bounded)
+			continue;
+
+		instances = DivCeil(busy + message->releaseJitter, message->period);
+		for(q = 0; q < instances; q++)
+		{
+			uint64_t window = message->blocking + q * message->frameTime;
+			int64_t response;
+
+			do
+			{
+				next = message->blocking + q * message->frameTime;
+				for(k = 0; k < nMessages; k++)
+				{
+					if(Interferes(config, messages, m, k, effectiveKey))
+						next += DivCeil(window + messages[k].releaseJitter + bitTime, messages[k].period) * messages[k].frameTime;
+				}
+				if(next == window)
+					break;
+				window = next;
+			} while(window <= MAX_BUSY_PERIOD_NS);
+
+			response = (int64_t)(message->releaseJitter + window + message->frameTime) - (int64_t)(q * message->period);
+			if(response > (int64_t)message->response)
+				message->response = response;
+		}
+	}
+}
+
+//simulated queues: local channels and then one priority queue for every remote message
+typedef struct
+{
+	uint8_t message;
+	uint64_t release;
+} SIM_ENTRY;
+
+typedef struct
+{
+	SIM_ENTRY entries[SIM_QUEUE_DEPTH];
+	uint16_t count;
+} SIM_QUEUE;
+
+static SIM_QUEUE SimQueues[MAX_CHANNELS + MAX_MESSAGES];
+
+static int SimQueueIndex(const MESSAGE* messages, int m)
+{
+	return (messages[m].queue == REMOTE_QUEUE) ? MAX_CHANNELS + m : messages[m].queue;
+}
+
+//entry offered for arbitration, TXQ offer frame with the lowest ID
+static int SimQueueHead(const MESSAGE* messages, int queue)
+{
+	const SIM_QUEUE* simQueue = &SimQueues[queue];
+	int head = 0;
+	int i;
+
+	if(queue == 0)
+	{
+		for(i = 1; i < simQueue->count; i++)
+		{
+			if(messages[simQueue->entries[i].message].key < messages[simQueue->entries[head].message].key)
+				head = i;
+		}
+	}
+
+	return head;
+}
+
+//the first run release every message at 0 with maximal jitter of the first instance
+static uint64_t SimJitter(const MESSAGE* message, int run, bool first)
+{
+	if(run == 0)
+		return first ? message->releaseJitter : 0;
+
+	return Random() % (message->releaseJitter + 1);
+}
+
+//simulate bus with analysed frame times, return number of queue overflows
+static int Simulate(const CONFIG* config, MESSAGE* messages, int nMessages)
+{
+	uint64_t nextRelease[MAX_MESSAGES];
+	uint64_t nextQueued[MAX_MESSAGES];
+	uint64_t horizon = 0;
+	uint64_t now;
+	int overflows = 0;
+	int run, m, i;
+
+	for(m = 0; m < nMessages; m++)
+	{
+		messages[m].simResponse = 0;
+		if(messages[m].period * SIM_PERIODS > horizon)
+			horizon = messages[m].period * SIM_PERIODS;
+	}
+
+	for(run = 0; run < SIM_RUNS; run++)
+	{
+		for(i = 0; i < MAX_CHANNELS + MAX_MESSAGES; i++)
+			SimQueues[i].count = 0;
+
+		for(m = 0; m < nMessages; m++)
+		{
+			nextRelease[m] = (run == 0) ? 0 : Random() % messages[m].period;
+			nextQueued[m] = nextRelease[m] + SimJitter(&messages[m], run, true);
+		}
+
+		now = 0;
+		while(now < horizon)
+		{
+			int queue = -1;
+			int head = 0;
+			SIM_ENTRY entry;
+
+			//move frames to queues in order of submission
+			for(;;)
+			{
+				int first = -1;
+				SIM_QUEUE* simQueue;
+
+				for(m = 0; m < nMessages; m++)
+				{
+					if(nextQueued[m] <= now && (first < 0 || nextQueued[m] < nextQueued[first]))
+						first = m;
+				}
+				if(first < 0)
+					break;
+
+				simQueue = &SimQueues[SimQueueIndex(messages, first)];
+				if(simQueue->count < SIM_QUEUE_DEPTH)
+				{
+					simQueue->entries[simQueue->count].message = first;
+					simQueue->entries[simQueue->count].release = nextRelease[first];
+					simQueue->count++;
+				}
+				else
+				{
+					overflows++;
+				}
+
+				nextRelease[first] += messages[first].period;
+				nextQueued[first] = nextRelease[first] + SimJitter(&messages[first], run, false);
+			}
+
+			//the first local queue in service order takes part in arbitration with remote nodes
+			for(i = 0; i < MAX_CHANNELS; i++)
+			{
+				if(SimQueues[i].count && (queue < 0 || QueueServedBefore(config, i, queue)))
+					queue = i;
+			}
+			if(queue >= 0)
+				head = SimQueueHead(messages, queue);
+
+			for(m = 0; m < nMessages; m++)
+			{
+				if(messages[m].queue == REMOTE_QUEUE && SimQueues[MAX_CHANNELS + m].count
+					&& (queue < 0 || messages[m].key < messages[SimQueues[queue].entries[head].message].key))
+				{
+					queue = MAX_CHANNELS + m;
+					head = 0;
+				}
+			}
+
+			if(queue < 0)
+			{
+				//bus idle until next submission
+				now = horizon;
+				for(m = 0; m < nMessages; m++)
+				{
+					if(nextQueued[m] < now)
+						now = nextQueued[m];
+				}
+				continue;
+			}
+
+			entry = SimQueues[queue].entries[head];
+			SimQueues[queue].count--;
+			memmove(&SimQueues[queue].entries[head], &SimQueues[queue].entries[head + 1],
+				(SimQueues[queue].count - head) * sizeof(SIM_ENTRY));
+
+			now += messages[entry.message].frameTime;
+			if(now - entry.release > messages[entry.message].simResponse)
+				messages[entry.message].simResponse = now - entry.release;
+		}
+	}
+
+	return overflows;
+}
+
+static void PrintResults(const CONFIG* config, const MESSAGE* messages, int nMessages)
+{
+	uint64_t utilization = 0;
+	int m;
+
+	printf("Bit rate %u/%u, poll %llu us, SPI %u ns + %u ns/byte\n", config->nominalBitRate,
+		config->dataBitRate, (unsigned long long)(config->poll / 1000), config->spiOverhead, config->spiByte);
+	printf("%-8s %5s %9s %9s %8s %8s %8s %9s %9s\n", "ID", "queue", "period", "deadline",
+		"frame", "jitter", "blocking", "response", "simulated");
+
+	for(m = 0; m < nMessages; m++)
+	{
+		const MESSAGE* message = &messages[m];
+		char queue[8] = "-";
+
+		if(message->queue != REMOTE_QUEUE)
+			snprintf(queue, sizeof(queue), "%d", message->queue);
+
+		printf(message->extended ? "%08X" : "%03X     ", message->id);
+		printf(" %5s %9llu %9llu %8llu %8llu %8llu", queue,
+			(unsigned long long)(message->period / 1000), (unsigned long long)(message->deadline / 1000),
+			(unsigned long long)(message->frameTime / 1000), (unsigned long long)(message->releaseJitter / 1000),
+			(unsigned long long)(message->blocking / 1000));
+
+		if(message->bounded)
+			printf(" %9llu", (unsigned long long)(message->response / 1000));
+		else
+			printf(" %9s", "-");
+
+		printf(" %9llu %s\n", (unsigned long long)(message->simResponse / 1000),
+			(!message->bounded || message->response > message->deadline) ? "MISS" : "");
+
+		utilization += message->frameTime * 1000000 / message->period;
+	}
+
+	printf("Times in us, bus utilization %llu.%01llu%%\n", (unsigned long long)(utilization / 10000),
+		(unsigned long long)(utilization / 1000 % 10));
+}
+
+static int CountMisses(const MESSAGE* messages, int nMessages)
+{
+	int misses = 0;
+	int m;
+
+	for(m = 0; m < nMessages; m++)
+	{
+		if(!messages[m].bounded || messages[m].response > messages[m].deadline)
+			misses++;
+	}
+
+	return misses;
+}
+
+static int ParseMessage(const char* text, MESSAGE* message)
+{
+	char id[9];
+	char format[4];
+	char queue[3] = "-";
+	unsigned int period;
+	unsigned int dataBytes;
+	unsigned int deadline = 0;
+	unsigned int jitter = 0;
+	char* end;
+
+	if(sscanf(text, "%8[0-9a-fA-F]:%u:%u:%3[a-z]:%2[-0-9]:%u:%u", id, &period, &dataBytes,
+		format, queue, &deadline, &jitter) < 4)
+	{
+		return -1;
+	}
+
+	memset(message, 0, sizeof(MESSAGE));
+	message->id = strtoul(id, &end, 16);
+	message->extended = (strlen(id) > 3);
+	message->fdf = (strcmp(format, "c") != 0);
+	message->brs = (strcmp(format, "brs") == 0);
+	message->dataBytes = dataBytes;
+	message->queue = (strcmp(queue, "-") == 0) ? REMOTE_QUEUE : (int8_t)strtol(queue, NULL, 10);
+	message->period = period * 1000ull;
+	message->deadline = (deadline ? deadline : period) * 1000ull;
+	message->jitter = jitter * 1000ull;
+
+	if((message->extended ? message->id > 0x1FFFFFFF : message->id > 0x7FF) || period == 0
+		|| (strcmp(format, "c") != 0 && strcmp(format, "fd") != 0 && strcmp(format, "brs") != 0)
+		|| dataBytes > (message->fdf ? 64u : 8u) || message->queue >= MAX_CHANNELS)
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+static int ParseFile(const char* name, MESSAGE* messages, int nMessages)
+{
+	FILE* file = fopen(name, "r");
+	char line[128];
+
+	if(file == NULL)
+	{
+		printf("Can't open %s\n", name);
+		return -1;
+	}
+
+	while(fgets(line, sizeof(line), file))
+	{
+		char* text = line + strspn(line, " \t");
+
+		text[strcspn(text, " \t\r\n")] = 0;
+		if(text[0] == 0 || text[0] == '#')
+			continue;
+
+		if(nMessages >= MAX_MESSAGES || ParseMessage(text, &messages[nMessages]) != 0)
+		{
+			printf("Wrong message %s in %s\n", text, name);
+			nMessages = -1;
+			break;
+		}
+		nMessages++;
+	}
+
+	fclose(file);
+
+	return nMessages;
+}
+
+static int CheckUniqueIds(const MESSAGE* messages, int nMessages)
+{
+	int m, k;
+
+	for(m = 0; m < nMessages; m++)
+	{
+		for(k = m + 1; k < nMessages; k++)
+		{
+			if(ArbitrationKey(messages[m].id, messages[m].extended) == ArbitrationKey(messages[k].id, messages[k].extended))
+			{
+				printf("ID %X is used by two messages\n", messages[m].id);
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static void ConfigReset(CONFIG* config)
+{
+	memset(config, 0, sizeof(CONFIG));
+	config->nominalBitRate = 500000;
+	config->dataBitRate = 2000000;
+	config->poll = DEFAULT_POLL_US * 1000ull;
+	config->spiOverhead = DEFAULT_SPI_OVERHEAD_NS;
+	config->spiByte = DEFAULT_SPI_BYTE_NS;
+}
+
+static int AddMessages(MESSAGE* messages, const char* const* texts, int nTexts)
+{
+	int i;
+
+	for(i = 0; i < nTexts; i++)
+	{
+		if(ParseMessage(texts[i], &messages[i]) != 0)
+		{
+			printf("Wrong built-in message %s\n", texts[i]);
+			return -1;
+		}
+	}
+
+	return nTexts;
+}
+
+//response time of message with ID 010 in set of texts
+static uint64_t UrgentResponse(const CONFIG* config, const char* const* texts, int nTexts)
+{
+	MESSAGE messages[8];
+	int m;
+
+	if(AddMessages(messages, texts, nTexts) < 0)
+		return 0;
+
+	Analyse(config, messages, nTexts);
+	for(m = 0; m < nTexts; m++)
+	{
+		if(messages[m].id == 0x010)
+			return messages[m].response;
+	}
+
+	return 0;
+}
+
+static int SelfCheck(void)
+{
+	//example from the paper: 125kbps, 1ms frames, message C has response time 3.5ms
+	static const char* const paper[] = {"001:2500:8:c", "002:3500:8:c", "003:3500:8:c"};
+	static const uint64_t paperResponse[] = {2000000, 3000000, 3500000};
+	static const char* const separateFifo[] = {"080:1000:8:c", "010:2000:8:c:1", "500:5000:64:brs:2"};
+	static const char* const sharedFifo[] = {"080:1000:8:c", "010:2000:8:c:1", "500:5000:64:brs:1"};
+	static const char* const txq[] = {"080:1000:8:c", "010:2000:8:c:0", "500:5000:64:brs:0"};
+	static const char* const lowTxPriority[] = {"080:1000:8:c", "010:2000:8:c:2", "500:5000:64:brs:1"};
+	CONFIG config;
+	MESSAGE messages[16];
+	uint64_t separate, shared, queued, low;
+	int failed = 0;
+	int set, m, k;
+
+	//exact result of paper example, simulation from critical instant reach it for message C
+	ConfigReset(&config);
+	config.nominalBitRate = 125000;
+	AddMessages(messages, paper, 3);
+	for(m = 0; m < 3; m++)
+		messages[m].frameTime = 1000000;
+	Analyse(&config, messages, 3);
+	Simulate(&config, messages, 3);
+	for(m = 0; m < 3; m++)
+	{
+		if(messages[m].response != paperResponse[m] || messages[m].simResponse > paperResponse[m]
+			|| (m == 2 && messages[m].simResponse != paperResponse[m]))
+		{
+			printf("Paper example message %c: response %llu simulated %llu expected %llu\n", 'A' + m,
+				(unsigned long long)messages[m].response, (unsigned long long)messages[m].simResponse,
+				(unsigned long long)paperResponse[m]);
+			failed++;
+		}
+	}
+
+	//frame sharing TX FIFO with bulk frame wait for it, TXQ keep ID order
+	ConfigReset(&config);
+	separate = UrgentResponse(&config, separateFifo, 3);
+	shared = UrgentResponse(&config, sharedFifo, 3);
+	queued = UrgentResponse(&config, txq, 3);
+	if(shared <= separate || queued != separate)
+	{
+		printf("FIFO check: separate %llu shared %llu TXQ %llu\n", (unsigned long long)separate,
+			(unsigned long long)shared, (unsigned long long)queued);
+		failed++;
+	}
+
+	//both local frames due in the same poll: 3 transactions, 35 and 91 bytes
+	AddMessages(messages, sharedFifo, 3);
+	Analyse(&config, messages, 3);
+	if(messages[0].releaseJitter != 0 || messages[1].releaseJitter != config.poll + 270000)
+	{
+		printf("SPI latency check: release jitter %llu expected %llu\n",
+			(unsigned long long)messages[1].releaseJitter, (unsigned long long)(config.poll + 270000));
+		failed++;
+	}
+
+	//queue with higher TXPRI is served first regardless of ID
+	config.txPriority[1] = 1;
+	low = UrgentResponse(&config, lowTxPriority, 3);
+	config.txPriority[2] = 2;
+	separate = UrgentResponse(&config, lowTxPriority, 3);
+	if(low <= separate)
+	{
+		printf("TXPRI check: low priority %llu high priority %llu\n", (unsigned long long)low,
+			(unsigned long long)separate);
+		failed++;
+	}
+
+	//random message sets, simulation must not exceed analysis
+	for(set = 0; set < 50; set++)
+	{
+		int nMessages = 4 + Random() % 12;
+
+		ConfigReset(&config);
+		for(k = 1; k < 4; k++)
+			config.txPriority[k] = Random() % 3;
+
+		memset(messages, 0, sizeof(messages));
+		for(m = 0; m < nMessages; m++)
+		{
+			uint32_t queue = Random() % 5;
+
+			messages[m].id = (m << 7) | (Random() & 0x7F);
+			messages[m].fdf = Random() & 1;
+			messages[m].brs = messages[m].fdf && (Random() & 1);
+			messages[m].dataBytes = Random() % (messages[m].fdf ? 65 : 9);
+			messages[m].queue = (queue < 4) ? (int8_t)queue : REMOTE_QUEUE;
+			messages[m].period = 1000000ull * (2 + Random() % 40);
+			messages[m].deadline = messages[m].period;
+			messages[m].jitter = (messages[m].queue == REMOTE_QUEUE) ? Random() % 200000 : 0;
+		}
+
+		Analyse(&config, messages, nMessages);
+		if(Simulate(&config, messages, nMessages) != 0 && CountMisses(messages, nMessages) == 0)
+		{
+			printf("Set %d: queue overflow in schedulable set\n", set);
+			failed++;
+		}
+
+		for(m = 0; m < nMessages; m++)
+		{
+			if(messages[m].bounded && messages[m].simResponse > messages[m].response)
+			{
+				printf("Set %d message %03X: simulated %llu above analysed %llu\n", set, messages[m].id,
+					(unsigned long long)messages[m].simResponse, (unsigned long long)messages[m].response);
+				failed++;
+			}
+		}
+	}
+
+	return failed;
+}
+
+static void PrintUsage(void)
+{
+	printf("Usage: ResponseTimeAnalysis [-b nominalBitRate] [-d dataBitRate] [-p pollUs] [-o spiOverheadNs]\n");
+	printf("       [-s spiByteNs] [-t channel:txpri]... [-f file] [message...]\n");
+	printf("       message: id:periodUs:dataBytes:c|fd|brs[:queue[:deadlineUs[:jitterUs]]]\n");
+}
+
+int main(int argc, char** argv)
+{
+	//remote engine and sensor nodes, this node send urgent frame from FIFO shared with bulk frame
+	static const char* const example[] = {
+		"080:2000:8:c", "0C0:5000:8:c", "200:10000:64:brs", "3FF:20000:8:c", "18FEF100:100000:8:c",
+		"010:2000:8:c:1", "500:5000:64:brs:1", "120:10000:16:brs:2"
+	};
+	CONFIG config;
+	int nMessages = 0;
+	int failed = 0;
+	int i;
+
+	ConfigReset(&config);
+
+	for(i = 1; i < argc; i++)
+	{
+		if(argv[i][0] == '-' && argv[i][1] != 0 && argv[i][2] == 0 && i + 1 < argc)
+		{
+			uint32_t value = strtoul(argv[i + 1], NULL, 0);
+			unsigned int channel, txPriority;
+
+			if(strcmp(argv[i], "-b") == 0 && value)
+				config.nominalBitRate = value;
+			else if(strcmp(argv[i], "-d") == 0 && value)
+				config.dataBitRate = value;
+			else if(strcmp(argv[i], "-p") == 0)
+				config.poll = value * 1000ull;
+			else if(strcmp(argv[i], "-o") == 0)
+				config.spiOverhead = value;
+			else if(strcmp(argv[i], "-s") == 0)
+				config.spiByte = value;
+			else if(strcmp(argv[i], "-t") == 0 && sscanf(argv[i + 1], "%u:%u", &channel, &txPriority) == 2
+				&& channel < MAX_CHANNELS && txPriority < 32)
+				config.txPriority[channel] = txPriority;
+			else if(strcmp(argv[i], "-f") == 0 && (nMessages = ParseFile(argv[i + 1], Messages, nMessages)) >= 0)
+				;
+			else
+			{
+				PrintUsage();
+				return -1;
+			}
+			i++;
+		}
+		else if(nMessages < MAX_MESSAGES && ParseMessage(argv[i], &Messages[nMessages]) == 0)
+		{
+			nMessages++;
+		}
+		else
+		{
+			PrintUsage();
+			return -1;
+		}
+	}
+
+	if(nMessages == 0)
+	{
+		failed = SelfCheck();
+
+		config.txPriority[1] = 1;
+		nMessages = AddMessages(Messages, example, sizeof(example) / sizeof(example[0]));
+		if(nMessages < 0)
+			return 1;
+	}
+
+	if(CheckUniqueIds(Messages, nMessages) != 0)
+		return -1;
+
+	Analyse(&config, Messages, nMessages);
+	if(Simulate(&config, Messages, nMessages) != 0)
+		printf("Simulation: queue overflow, bus is overloaded\n");
+	PrintResults(&config, Messages, nMessages);
+
+	if(argc > 1)
+	{
+		printf("%d messages miss deadline\n", CountMisses(Messages, nMessages));
+		return CountMisses(Messages, nMessages);
+	}
+
+	printf("%d failed\n", failed);
+
+	return failed;
+}
@@ -0,0 +1,273 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+* Host stress test of SPSC receive ring from drv_canfdspi_rxring.h. Producer thread
+* play role of interrupt and call ReceiveToRing with fake DRV_SPI_TransferData which
+* emulate RX FIFO with infinite stream of frames. Every frame carry sequence number in
+* time stamp and payload words equal to sequence number xor word index. Consumer thread
+* play role of main loop and check every frame returned by Peek:
+* - sequence numbers are increasing and every gap is counted,
+* - payload isn't torn(entry wasn't overwritten during processing),
+* - at the end number of gaps is equal to overrun counter and every produced frame is
+*   received or counted as overrun.
+* Both threads randomly stall so ring is sometimes empty and sometimes full.
+*
+* Build(gcc or mingw):
+*	gcc -std=gnu99 -Wall -O2 -pthread -o RxRingStressTest RxRingStressTest.c
+*
+* Usage:
+*	RxRingStressTest [frames]
+*
+* Exit code is number of detected errors(limited to 255).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_api.c"
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_rxring.h"
+
+#define RX_CHANNEL CAN_FIFO_CH1
+#define RING_DEPTH 8
+#define DEFAULT_FRAMES 200000
+
+DRV_CANFDSPI_DEFINE_RX_CODEC(StressFd64, CAN_PLSIZE_64, 1)
+DRV_CANFDSPI_DEFINE_RX_RING(StressRing, StressFd64, RING_DEPTH)
+
+static StressRing_RX_RING Ring;
+static uint32_t FifoSequence;
+static uint32_t FramesToProduce = DEFAULT_FRAMES;
+static volatile bool ProducerDone;
+
+static uint32_t ReceivedFrames;
+static uint32_t LostFrames;
+static uint32_t Errors;
+
+//fake chip: message object at RAM start, CiFIFOUA always point to it
+int8_t DRV_SPI_TransferData(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxData, uint8_t *SpiRxData, uint16_t spiTransferSize)
+{
+	uint16_t address = ((SpiTxData[0] & 0xF) << 8) | SpiTxData[1];
+	uint32_t object[3 + 16];
+	uint16_t i;
+
+	(void)spiSlaveDeviceIndex;
+	memset(SpiRxData, 0, spiTransferSize);
+
+	if((SpiTxData[0] >> 4) == cINSTRUCTION_READ && address == cRAMADDR_START)
+	{
+		//SPI transfer take time, consumer can run in the middle of it
+		if((FifoSequence % 7) == 0)
+		{
+			sched_yield();
+		}
+
+		object[0] = FifoSequence & 0x7FF;
+		object[1] = CAN_DLC_64 | (1 << 7) | ((FifoSequence % 32) << 11);
+		object[2] = FifoSequence;
+		for(i = 0; i < 16; i++)
+		{
+			object[3 + i] = FifoSequence ^ i;
+		}
+		memcpy(&SpiRxData[2], object, spiTransferSize - 2);
+	}
+	else if((SpiTxData[0] >> 4) == cINSTRUCTION_WRITE &&
+			address == cREGADDR_CiFIFOCON + RX_CHANNEL * CiFIFO_OFFSET + 1 && (SpiTxData[2] & 0x01))
+	{
+		//UINC
+		FifoSequence++;
+	}
+
+	return 0;
+}
+
+int8_t DRV_SPI_TransferFill(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxHeader, uint16_t spiHeaderSize, uint8_t fillByte, uint16_t spiFillSize)
+{
+	(void)spiSlaveDeviceIndex;
+	(void)SpiTxHeader;
+	(void)spiHeaderSize;
+	(void)fillByte;
+	(void)spiFillSize;
+
+	return 0;
+}
+
+static uint32_t Random(uint32_t* state)
+{
+	*state = *state * 1103515245u + 12345u;
+	return *state >> 16;
+}
+
+static void Stall(uint32_t* state)
+{
+	volatile uint32_t delay;
+	uint32_t n;
+
+	switch(Random(state) % 16)
+	{
+	case 0:
+		//long stall, ring become full or empty
+		for(n = Random(state) % 20000, delay = 0; delay < n; delay++);
+		break;
+	case 1:
+	case 2:
+		sched_yield();
+		break;
+	default:
+		for(n = Random(state) % 100, delay = 0; delay < n; delay++);
+		break;
+	}
+}
+
+static void* Producer(void* arg)
+{
+	uint32_t state = 1;
+
+	(void)arg;
+
+	while(FifoSequence < FramesToProduce)
+	{
+		StressRing_ReceiveToRing(&Ring, DRV_CANFDSPI_INDEX_0, RX_CHANNEL);
+		Stall(&state);
+	}
+
+	ProducerDone = true;
+	return NULL;
+}
+
+static void Error(const char* message, uint32_t sequence)
+{
+	if(Errors < 10)
+	{
+		printf("ERROR: %s, sequence %u\n", message, sequence);
+	}
+	Errors++;
+}
+
+static void* Consumer(void* arg)
+{
+	StressFd64_RX_FRAME* frame;
+	uint32_t expected = 0;
+	uint32_t sequence;
+	uint32_t state = 2;
+	uint8_t i;
+	bool done;
+
+	(void)arg;
+
+	for(;;)
+	{
+		//flag must be read before ring, otherwise last frames can be missed
+		done = ProducerDone;
+		frame = StressRing_Peek(&Ring);
+
+		if(frame == NULL)
+		{
+			if(done)
+				break;
+			sched_yield();
+			continue;
+		}
+
+		sequence = frame->header.bF.timeStamp;
+		if(sequence < expected)
+		{
+			Error("sequence not increasing", sequence);
+		}
+		else
+		{
+			LostFrames += sequence - expected;
+		}
+		expected = sequence + 1;
+
+		if(frame->header.bF.id.SID != (sequence & 0x7FF) || frame->header.bF.ctrl.FilterHit != (sequence % 32))
+		{
+			Error("wrong header", sequence);
+		}
+
+		Stall(&state);
+
+		//payload is checked after stall so overwrite by producer would be visible
+		for(i = 0; i < 16; i++)
+		{
+			if(frame->data.word[i] != (sequence ^ i))
+			{
+				Error("torn payload", sequence);
+				break;
+			}
+		}
+
+		StressRing_Release(&Ring);
+		ReceivedFrames++;
+	}
+
+	//frames dropped after the last received frame don't make gap
+	LostFrames += FramesToProduce - expected;
+
+	return NULL;
+}
+
+int main(int argc, char** argv)
+{
+	pthread_t producer;
+	pthread_t consumer;
+
+	if(argc == 2)
+	{
+		FramesToProduce = strtoul(argv[1], NULL, 0);
+	}
+	else if(argc != 1)
+	{
+		printf("Usage: RxRingStressTest [frames]\n");
+		return -1;
+	}
+
+	StressRing_Initialize(&Ring);
+
+	pthread_create(&consumer, NULL, Consumer, NULL);
+	pthread_create(&producer, NULL, Producer, NULL);
+	pthread_join(producer, NULL);
+	pthread_join(consumer, NULL);
+
+	printf("Produced %u, received %u, lost %u, overruns %u, high watermark %u/%u\n",
+			FramesToProduce, ReceivedFrames, LostFrames, Ring.overruns, Ring.highWatermark, RING_DEPTH);
+
+	if(LostFrames != Ring.overruns)
+	{
+		Error("lost frames not equal overrun counter", LostFrames);
+	}
+	if(ReceivedFrames + Ring.overruns != FramesToProduce)
+	{
+		Error("frames missing", ReceivedFrames + Ring.overruns);
+	}
+
+	printf("%s: %u errors\n", Errors ? "FAIL" : "PASS", Errors);
+
+	return (Errors > 255) ? 255 : Errors;
+}
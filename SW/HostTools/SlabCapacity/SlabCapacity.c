@@ -0,0 +1,291 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+* Host tool which measure how many received or transmitted frames can be stored in MCU
+* RAM by slab allocator from drv_canfdspi_slab.c in comparison to fixed slots. Fixed
+* slot has 12 bytes header and 64 bytes payload(entry of RX ring with time stamp), so
+* RAM / 76 frames fit always. For slab number of blocks in every class is planned
+* proportionally to traffic mix(or given by -b) and frames with random payload size from
+* mix are allocated until first allocation fail. Result is average and minimal number of
+* frames in flight from many trials.
+*
+* Build(gcc or mingw):
+*	gcc -std=gnu99 -Wall -o SlabCapacity SlabCapacity.c
+*
+* Usage:
+*	SlabCapacity [-r ramBytes] [-t trials] [-b n8:n16:n32:n64] [w8:w16:w32:w64 ...]
+*
+* Mix is relative amount of frames with 8, 16, 32 and 64 bytes payload. Without mix
+* classic only, mixed and FD only traffic is measured. Example for RAM used by example
+* project:
+*	SlabCapacity -r 1520 -b 16:4:4:12
+*
+* Exit code is 0 when slab store on average at least the same number of frames as fixed
+* slots for every mix which isn't FD only.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_api.c"
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_slab.c"
+
+#define FIXED_SLOT_BYTES CAN_SLAB_BLOCK_BYTES(64)
+#define MAX_RAM_BYTES 8192
+#define MAX_MIXES 16
+
+static uint32_t SlabMemory[MAX_RAM_BYTES / 4];
+static uint32_t RandomState = 1;
+
+//slab is used without SPI, stubs are required only by drv_canfdspi_api.c
+int8_t DRV_SPI_TransferData(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxData, uint8_t *SpiRxData, uint16_t spiTransferSize)
+{
+	(void)spiSlaveDeviceIndex;
+	(void)SpiTxData;
+	memset(SpiRxData, 0, spiTransferSize);
+
+	return -1;
+}
+
+int8_t DRV_SPI_TransferFill(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxHeader, uint16_t spiHeaderSize, uint8_t fillByte, uint16_t spiFillSize)
+{
+	(void)spiSlaveDeviceIndex;
+	(void)SpiTxHeader;
+	(void)spiHeaderSize;
+	(void)fillByte;
+	(void)spiFillSize;
+
+	return -1;
+}
+
+static uint32_t Random(void)
+{
+	RandomState = RandomState * 1103515245u + 12345u;
+	return RandomState >> 16;
+}
+
+static uint32_t BlockBytes(uint8_t c)
+{
+	return CAN_SLAB_BLOCK_BYTES(CAN_SLAB_CLASS_DATA_BYTES(c));
+}
+
+//Blocks proportional to mix, rest of RAM is given to class with the biggest shortage
+static void PlanBlocks(const uint32_t weights[CAN_SLAB_CLASSES], uint32_t ramBytes, uint8_t blocks[CAN_SLAB_CLASSES])
+{
+	uint32_t weightedBytes = 0;
+	uint32_t usedBytes = 0;
+	uint8_t best;
+	uint8_t c;
+
+	for(c = 0; c < CAN_SLAB_CLASSES; c++)
+	{
+		weightedBytes += weights[c] * BlockBytes(c);
+	}
+
+	for(c = 0; c < CAN_SLAB_CLASSES; c++)
+	{
+		uint32_t n = weights[c] * ramBytes / weightedBytes;
+
+		blocks[c] = (n > 255) ? 255 : n;
+		usedBytes += blocks[c] * BlockBytes(c);
+	}
+
+	for(;;)
+	{
+		best = CAN_SLAB_CLASSES;
+		for(c = 0; c < CAN_SLAB_CLASSES; c++)
+		{
+			if(weights[c] == 0 || blocks[c] == 255 || usedBytes + BlockBytes(c) > ramBytes)
+				continue;
+
+			//weight per block already planned
+			if(best == CAN_SLAB_CLASSES || weights[c] * (blocks[best] + 1) > weights[best] * (blocks[c] + 1))
+				best = c;
+		}
+
+		if(best == CAN_SLAB_CLASSES)
+			break;
+
+		blocks[best]++;
+		usedBytes += BlockBytes(best);
+	}
+}
+
+static uint8_t RandomClass(const uint32_t weights[CAN_SLAB_CLASSES])
+{
+	uint32_t sum = 0;
+	uint32_t r;
+	uint8_t c;
+
+	for(c = 0; c < CAN_SLAB_CLASSES; c++)
+	{
+		sum += weights[c];
+	}
+
+	r = Random() % sum;
+	for(c = 0; c < CAN_SLAB_CLASSES - 1; c++)
+	{
+		if(r < weights[c])
+			break;
+		r -= weights[c];
+	}
+
+	return c;
+}
+
+static bool MeasureMix(const uint32_t weights[CAN_SLAB_CLASSES], uint32_t ramBytes, const uint8_t* fixedBlocks, uint32_t trials)
+{
+	CAN_SLAB slab;
+	uint8_t blocks[CAN_SLAB_CLASSES];
+	uint32_t fixedSlots = ramBytes / FIXED_SLOT_BYTES;
+	uint32_t slabBytes = 0;
+	uint32_t sum = 0;
+	uint32_t min = ~0u;
+	uint32_t fallbacks = 0;
+	uint32_t n;
+	uint32_t t;
+	uint8_t c;
+
+	if(fixedBlocks != NULL)
+		memcpy(blocks, fixedBlocks, sizeof(blocks));
+	else
+		PlanBlocks(weights, ramBytes, blocks);
+
+	for(c = 0; c < CAN_SLAB_CLASSES; c++)
+	{
+		slabBytes += blocks[c] * BlockBytes(c);
+	}
+
+	for(t = 0; t < trials; t++)
+	{
+		if(DRV_CANFDSPI_SlabInitialize(&slab, SlabMemory, ramBytes / 4, blocks))
+		{
+			printf("Blocks don't fit into %u bytes\n", ramBytes);
+			return false;
+		}
+
+		for(n = 0; DRV_CANFDSPI_SlabAlloc(&slab, CAN_SLAB_CLASS_DATA_BYTES(RandomClass(weights))) != NULL; n++);
+
+		for(c = 0; c < CAN_SLAB_CLASSES; c++)
+		{
+			fallbacks += slab.classes[c].fallbacks;
+		}
+
+		sum += n;
+		if(n < min)
+			min = n;
+	}
+
+	printf("mix %2u:%2u:%2u:%2u  fixed slots %3u  slab %3u:%3u:%3u:%3u(%4u bytes) frames avg %5.1f min %3u fallbacks %4.1f  gain %4.2fx\n",
+			weights[0], weights[1], weights[2], weights[3], fixedSlots,
+			blocks[0], blocks[1], blocks[2], blocks[3], slabBytes,
+			(double)sum / trials, min, (double)fallbacks / trials, (double)sum / trials / (fixedSlots ? fixedSlots : 1));
+
+	//FD only traffic can't be stored better than by fixed slots
+	return (weights[0] + weights[1] + weights[2] == 0) || (sum >= fixedSlots * trials);
+}
+
+static bool ParseQuad(const char* text, uint32_t values[CAN_SLAB_CLASSES])
+{
+	return sscanf(text, "%u:%u:%u:%u", &values[0], &values[1], &values[2], &values[3]) == 4;
+}
+
+int main(int argc, char** argv)
+{
+	static const uint32_t DefaultMixes[][CAN_SLAB_CLASSES] = {
+		{1, 0, 0, 0},
+		{6, 1, 1, 2},
+		{2, 1, 1, 1},
+		{0, 0, 0, 1}
+	};
+	uint32_t mixes[MAX_MIXES][CAN_SLAB_CLASSES];
+	uint32_t nMixes = 0;
+	uint32_t ramBytes = 1520;
+	uint32_t trials = 1000;
+	uint32_t quad[CAN_SLAB_CLASSES];
+	uint8_t fixedBlocks[CAN_SLAB_CLASSES];
+	bool useFixedBlocks = false;
+	int failures = 0;
+	int i;
+	uint8_t c;
+
+	for(i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+		{
+			ramBytes = strtoul(argv[++i], NULL, 0);
+		}
+		else if(strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			trials = strtoul(argv[++i], NULL, 0);
+		}
+		else if(strcmp(argv[i], "-b") == 0 && i + 1 < argc && ParseQuad(argv[++i], quad))
+		{
+			for(c = 0; c < CAN_SLAB_CLASSES; c++)
+			{
+				fixedBlocks[c] = (quad[c] > 255) ? 255 : quad[c];
+			}
+			useFixedBlocks = true;
+		}
+		else if(nMixes < MAX_MIXES && ParseQuad(argv[i], mixes[nMixes]) &&
+				(mixes[nMixes][0] + mixes[nMixes][1] + mixes[nMixes][2] + mixes[nMixes][3]) > 0)
+		{
+			nMixes++;
+		}
+		else
+		{
+			printf("Usage: SlabCapacity [-r ramBytes] [-t trials] [-b n8:n16:n32:n64] [w8:w16:w32:w64 ...]\n");
+			return -1;
+		}
+	}
+
+	if(ramBytes > MAX_RAM_BYTES || ramBytes < FIXED_SLOT_BYTES || trials == 0)
+	{
+		printf("RAM must be in range %u .. %u bytes and trials can't be 0\n", FIXED_SLOT_BYTES, MAX_RAM_BYTES);
+		return -1;
+	}
+
+	if(nMixes == 0)
+	{
+		nMixes = sizeof(DefaultMixes) / sizeof(DefaultMixes[0]);
+		memcpy(mixes, DefaultMixes, sizeof(DefaultMixes));
+	}
+
+	printf("RAM %u bytes, fixed slot %u bytes, slab blocks %u/%u/%u/%u bytes, %u trials\n",
+			ramBytes, FIXED_SLOT_BYTES, BlockBytes(0), BlockBytes(1), BlockBytes(2), BlockBytes(3), trials);
+
+	for(i = 0; i < (int)nMixes; i++)
+	{
+		if(!MeasureMix(mixes[i], ramBytes, useFixedBlocks ? fixedBlocks : NULL, trials))
+		{
+			failures++;
+		}
+	}
+
+	return failures;
+}
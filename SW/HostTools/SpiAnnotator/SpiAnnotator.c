@@ -0,0 +1,473 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+* SPI transaction annotator, interface and description in SpiAnnotator.h.
+*
+* Can be compiled separately or included by host tool:
+*	#include "../SpiAnnotator/SpiAnnotator.c"
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "SpiAnnotator.h"
+
+#define HEADER_BYTES 2
+#define CRC_HEADER_BYTES 3
+#define CRC_BYTES 2
+#define HEAT_WIDTH 20
+
+#define RAM_ROW (cRAMADDR_START / 4)
+#define FILTER_END (cREGADDR_CiFLTOBJ + CiFILTER_OFFSET * CAN_FILTER_TOTAL)
+
+//registers below the first FIFO
+static const char* const ControlNames[] = {
+	"CiCON", "CiNBTCFG", "CiDBTCFG", "CiTDC", "CiTBC", "CiTSCON", "CiVEC", "CiINT",
+	"CiRXIF", "CiTXIF", "CiRXOVIF", "CiTXATIF", "CiTXREQ", "CiTREC", "CiBDIAG0", "CiBDIAG1",
+	"CiTEFCON", "CiTEFSTA", "CiTEFUA", "CiFIFOBA"
+};
+
+//bytes updated by hardware: flags, status, TDCV, BUSY and OPMOD of CiCON, UINC/TXREQ/FRESET
+static const uint8_t ControlHardwareMask[] = {
+	0x6, 0x0, 0x0, 0x1, 0xF, 0x0, 0xF, 0x3,
+	0xF, 0xF, 0xF, 0xF, 0xF, 0xF, 0xF, 0xF,
+	0x2, 0xF, 0xF, 0xF
+};
+
+static const char* const FifoNames[] = {"CON", "STA", "UA"};
+
+static const char* const McpNames[] = {"OSC", "IOCON", "CRC", "ECCCON", "ECCSTA", "DEVID"};
+
+//OSC ready bits, GPIO pin state, CRC value and flags, ECC status
+static const uint8_t McpHardwareMask[] = {0x2, 0x4, 0x7, 0x0, 0xF, 0x0};
+
+typedef struct
+{
+	uint16_t row;
+	uint32_t bytes;
+} ReportRow;
+
+static const char* AnnotatorInstructionName(uint8_t instruction)
+{
+	switch(instruction)
+	{
+		case cINSTRUCTION_RESET: return "RESET";
+		case cINSTRUCTION_READ: return "READ";
+		case cINSTRUCTION_WRITE: return "WRITE";
+		case cINSTRUCTION_READ_CRC: return "READ_CRC";
+		case cINSTRUCTION_WRITE_CRC: return "WRITE_CRC";
+		case cINSTRUCTION_WRITE_SAFE: return "WRITE_SAFE";
+		default: return "UNKNOWN";
+	}
+}
+
+static uint16_t Row(uint16_t address)
+{
+	if(address >= cRAMADDR_START && address < cRAMADDR_END)
+		return RAM_ROW;
+
+	return address / 4;
+}
+
+static int BitCount(uint8_t mask)
+{
+	int n = 0;
+
+	for(; mask; mask >>= 1)
+		n += mask & 1;
+
+	return n;
+}
+
+static void StoreWords(SpiAnnotator* annotator, uint16_t address, const uint32_t* words, uint16_t n)
+{
+	uint16_t i;
+	uint8_t j;
+
+	for(i = 0; i < n; i++)
+	{
+		for(j = 0; j < 4; j++)
+		{
+			annotator->value[address + i * 4 + j] = (uint8_t)(words[i] >> (8 * j));
+			annotator->known[address + i * 4 + j] = true;
+		}
+	}
+}
+
+//after RESET instruction all registers except RAM and DEVID have reset values
+static void LoadResetValues(SpiAnnotator* annotator)
+{
+	uint16_t i;
+
+	memset(annotator->known, 0, sizeof(annotator->known));
+	memset(annotator->pending, 0, sizeof(annotator->pending));
+
+	StoreWords(annotator, cREGADDR_CiCON, canControlResetValues,
+		sizeof(canControlResetValues) / sizeof(canControlResetValues[0]));
+	for(i = 0; i < CAN_FIFO_TOTAL_CHANNELS; i++)
+		StoreWords(annotator, cREGADDR_CiFIFOCON + i * CiFIFO_OFFSET, canFifoResetValues, 3);
+	for(i = 0; i < CAN_FIFO_TOTAL_CHANNELS; i += 4)
+		StoreWords(annotator, cREGADDR_CiFLTCON + i, &canFilterControlResetValue, 1);
+	for(i = 0; i < CAN_FILTER_TOTAL; i++)
+		StoreWords(annotator, cREGADDR_CiFLTOBJ + i * CiFILTER_OFFSET, canFilterObjectResetValues, 2);
+	StoreWords(annotator, cREGADDR_OSC, mcp25xxfdControlResetValues,
+		sizeof(mcp25xxfdControlResetValues) / sizeof(mcp25xxfdControlResetValues[0]));
+}
+
+void SpiAnnotatorInitialize(SpiAnnotator* annotator)
+{
+	memset(annotator, 0, sizeof(SpiAnnotator));
+}
+
+const char* SpiAnnotatorName(uint16_t address, char* name)
+{
+	uint16_t word = address & 0xFFC;
+	uint16_t offset;
+	int length;
+
+	address &= 0xFFF;
+
+	if(address >= cRAMADDR_START && address < cRAMADDR_END)
+	{
+		sprintf(name, "RAM+0x%03X", address - cRAMADDR_START);
+		return name;
+	}
+
+	if(word < cREGADDR_CiFIFOCON)
+	{
+		length = sprintf(name, "%s", ControlNames[word / 4]);
+	}
+	else if(word < cREGADDR_CiFLTCON)
+	{
+		offset = word - cREGADDR_CiFIFOCON;
+		if(offset < CiFIFO_OFFSET)
+			length = sprintf(name, "CiTXQ%s", FifoNames[offset / 4]);
+		else
+			length = sprintf(name, "CiFIFO%s%u", FifoNames[offset % CiFIFO_OFFSET / 4], offset / CiFIFO_OFFSET);
+	}
+	else if(word < cREGADDR_CiFLTOBJ)
+	{
+		length = sprintf(name, "CiFLTCON%u", (word - cREGADDR_CiFLTCON) / 4);
+	}
+	else if(word < FILTER_END)
+	{
+		offset = word - cREGADDR_CiFLTOBJ;
+		length = sprintf(name, "%s%u", (offset % CiFILTER_OFFSET) ? "CiMASK" : "CiFLTOBJ", offset / CiFILTER_OFFSET);
+	}
+	else if(word >= cREGADDR_OSC && word < cREGADDR_OSC + sizeof(McpNames) / sizeof(McpNames[0]) * 4)
+	{
+		length = sprintf(name, "%s", McpNames[(word - cREGADDR_OSC) / 4]);
+	}
+	else
+	{
+		length = sprintf(name, "0x%03X", word);
+	}
+
+	if(address & 3)
+		sprintf(&name[length], "+%u", address & 3);
+
+	return name;
+}
+
+uint8_t SpiAnnotatorHardwareMask(uint16_t address)
+{
+	uint16_t word = address & 0xFFC;
+
+	if(word < cREGADDR_CiFIFOCON)
+		return ControlHardwareMask[word / 4];
+	//FIFOCON: UINC, TXREQ and FRESET in byte 1, FIFOSTA and FIFOUA are status
+	if(word < cREGADDR_CiFLTCON)
+		return ((word - cREGADDR_CiFIFOCON) % CiFIFO_OFFSET) ? 0xF : 0x2;
+	if(word < FILTER_END)
+		return 0x0;
+	if(word >= cREGADDR_OSC && word < cREGADDR_OSC + sizeof(McpHardwareMask) * 4)
+		return McpHardwareMask[(word - cREGADDR_OSC) / 4];
+
+	//RAM(received objects) and unimplemented addresses
+	return 0xF;
+}
+
+int SpiAnnotatorTransaction(SpiAnnotator* annotator, const uint8_t* tx, const uint8_t* rx, uint16_t length)
+{
+	uint8_t instruction = length ? tx[0] >> 4 : 0xF;
+	uint16_t address;
+	uint16_t dataStart = HEADER_BYTES;
+	uint16_t dataEnd = length;
+	bool read = instruction == cINSTRUCTION_READ || instruction == cINSTRUCTION_READ_CRC;
+	const uint8_t* data = read ? rx : tx;
+	//bytes written with the same value as read by RMW, only leading and trailing are wasted
+	bool unchanged[SPI_ANNOTATOR_BYTES];
+	uint16_t first;
+	uint16_t last;
+	uint32_t wasted = 0;
+	bool rmw = false;
+	bool writeOnly = false;
+	bool race = false;
+	bool ramCounted = false;
+	char name[SPI_ANNOTATOR_NAME];
+	int textLength;
+	uint16_t i;
+
+	annotator->transactions++;
+	annotator->bytes += length;
+
+	if(instruction == cINSTRUCTION_READ_CRC || instruction == cINSTRUCTION_WRITE_CRC)
+		dataStart = CRC_HEADER_BYTES;
+	if(instruction == cINSTRUCTION_READ_CRC || instruction == cINSTRUCTION_WRITE_CRC
+		|| instruction == cINSTRUCTION_WRITE_SAFE)
+		dataEnd = length >= CRC_BYTES ? length - CRC_BYTES : 0;
+
+	if(instruction == cINSTRUCTION_RESET && length >= 1)
+	{
+		LoadResetValues(annotator);
+		sprintf(annotator->text, "RESET");
+		return 0;
+	}
+
+	if(length < HEADER_BYTES || dataEnd < dataStart || (read && rx == NULL) || (!read
+		&& instruction != cINSTRUCTION_WRITE && instruction != cINSTRUCTION_WRITE_CRC
+		&& instruction != cINSTRUCTION_WRITE_SAFE))
+	{
+		annotator->malformed++;
+		sprintf(annotator->text, "%s malformed", AnnotatorInstructionName(instruction));
+		return -1;
+	}
+
+	address = ((tx[0] & 0xF) << 8) | tx[1];
+
+	//header and CRC are counted to the first register
+	if(read)
+	{
+		annotator->stats[Row(address)].readBytes += length - (dataEnd - dataStart);
+		if(dataEnd == dataStart)
+			annotator->stats[Row(address)].reads++;
+	}
+	else
+	{
+		annotator->stats[Row(address)].writeBytes += length - (dataEnd - dataStart);
+		if(dataEnd == dataStart)
+			annotator->stats[Row(address)].writes++;
+	}
+
+	i = dataStart;
+	while(i < dataEnd)
+	{
+		uint16_t a = (address + i - dataStart) & 0xFFF;
+		uint16_t word = a / 4;
+		SpiRegisterStats* stats = &annotator->stats[Row(a)];
+		SpiPendingRead* pending = &annotator->pending[word];
+		uint8_t hardware = SpiAnnotatorHardwareMask(a);
+		uint8_t mask = 0;
+		uint8_t known = 0;
+		uint8_t changed = 0;
+		uint8_t values[4];
+
+		//bytes of the same register
+		do
+		{
+			uint8_t bit = 1 << (a & 3);
+
+			mask |= bit;
+			values[a & 3] = data[i];
+			if(read && !(hardware & bit) && annotator->known[a] && annotator->value[a] == data[i])
+				known |= bit;
+			if(!read && (pending->readMask & bit))
+			{
+				unchanged[i] = pending->value[a & 3] == data[i];
+				if(!unchanged[i])
+					changed |= bit;
+			}
+			else
+			{
+				unchanged[i] = false;
+				if(!read)
+					changed |= bit;
+			}
+
+			annotator->value[a] = data[i];
+			annotator->known[a] = true;
+			i++;
+			a = (address + i - dataStart) & 0xFFF;
+		}
+		while(i < dataEnd && a / 4 == word);
+
+		//access to RAM is counted once per transaction
+		if(Row(word * 4) != RAM_ROW || !ramCounted)
+		{
+			if(read)
+				stats->reads++;
+			else
+				stats->writes++;
+		}
+		if(Row(word * 4) == RAM_ROW)
+			ramCounted = true;
+
+		if(read)
+		{
+			stats->readBytes += BitCount(mask);
+			stats->wastedBytes += BitCount(known);
+			wasted += BitCount(known);
+			if((mask & ~hardware) && (mask & ~hardware) == known)
+				stats->same++;
+
+			//message objects aren't modified by RMW
+			if(Row(word * 4) == RAM_ROW)
+				continue;
+			pending->readMask = mask;
+			pending->knownMask = known;
+			memcpy(pending->value, values, sizeof(values));
+			continue;
+		}
+
+		stats->writeBytes += BitCount(mask);
+
+		if(pending->readMask & mask)
+		{
+			stats->rmw++;
+			rmw = true;
+			//value of every changed byte was known before read
+			if((changed & ~pending->knownMask) == 0)
+			{
+				stats->writeOnly++;
+				stats->wastedBytes += BitCount(pending->readMask & ~pending->knownMask);
+				writeOnly = true;
+			}
+			if(pending->readMask & mask & ~changed & hardware)
+			{
+				stats->race++;
+				race = true;
+			}
+		}
+		pending->readMask = 0;
+	}
+
+	//unchanged bytes at the begin and end of RMW write can be skipped
+	if(!read)
+	{
+		for(first = dataStart; first < dataEnd && unchanged[first]; first++)
+		{
+			annotator->stats[Row((address + first - dataStart) & 0xFFF)].wastedBytes++;
+			wasted++;
+		}
+		for(last = dataEnd; last > first && unchanged[last - 1]; last--)
+		{
+			annotator->stats[Row((address + last - 1 - dataStart) & 0xFFF)].wastedBytes++;
+			wasted++;
+		}
+	}
+
+	//the whole transaction can be skipped
+	if(dataEnd > dataStart && wasted == (uint32_t)(dataEnd - dataStart))
+	{
+		annotator->wastedTransactions++;
+		annotator->wastedTransactionBytes += length;
+		annotator->stats[Row(address)].wastedBytes += length - (dataEnd - dataStart);
+	}
+
+	textLength = sprintf(annotator->text, "%s %s", AnnotatorInstructionName(instruction), SpiAnnotatorName(address, name));
+	last = (address + dataEnd - dataStart - 1) & 0xFFF;
+	if(dataEnd - dataStart > 1 && Row(address) != Row(last))
+		textLength += sprintf(&annotator->text[textLength], "..%s",
+			SpiAnnotatorName((last & 3) == 3 ? last & 0xFFC : last, name));
+	textLength += sprintf(&annotator->text[textLength], " [%u]", dataEnd - dataStart);
+	if(wasted)
+		textLength += sprintf(&annotator->text[textLength], " wasted %u", wasted);
+	if(rmw)
+		textLength += sprintf(&annotator->text[textLength], " RMW");
+	if(writeOnly)
+		textLength += sprintf(&annotator->text[textLength], " write-only");
+	if(race)
+		sprintf(&annotator->text[textLength], " race");
+
+	return 0;
+}
+
+static int ReportRowCompare(const void* a, const void* b)
+{
+	const ReportRow* rowA = (const ReportRow*)a;
+	const ReportRow* rowB = (const ReportRow*)b;
+
+	if(rowA->bytes != rowB->bytes)
+		return rowA->bytes < rowB->bytes ? 1 : -1;
+
+	return (int)rowA->row - (int)rowB->row;
+}
+
+void SpiAnnotatorReport(const SpiAnnotator* annotator, FILE* output, int rows)
+{
+	static ReportRow table[SPI_ANNOTATOR_WORDS];
+	char name[SPI_ANNOTATOR_NAME];
+	char heat[HEAT_WIDTH + 1];
+	uint32_t wasted = 0;
+	int count = 0;
+	int i;
+	int j;
+
+	for(i = 0; i < SPI_ANNOTATOR_WORDS; i++)
+	{
+		const SpiRegisterStats* stats = &annotator->stats[i];
+
+		wasted += stats->wastedBytes;
+		if(stats->reads == 0 && stats->writes == 0)
+			continue;
+		table[count].row = i;
+		table[count].bytes = stats->readBytes + stats->writeBytes;
+		count++;
+	}
+	qsort(table, count, sizeof(ReportRow), ReportRowCompare);
+
+	if(rows <= 0 || rows > count)
+		rows = count;
+
+	//heat is bytes relative to the busiest register, x - wasted, # - needed
+	fprintf(output, "%-12s %7s %7s %9s %9s %7s %6s %6s %5s %8s  %s\n", "register", "reads", "writes",
+		"rd bytes", "wr bytes", "same", "RMW", "w-o", "race", "wasted", "heat(x wasted)");
+	for(i = 0; i < rows; i++)
+	{
+		const SpiRegisterStats* stats = &annotator->stats[table[i].row];
+		int width = (int)(((uint64_t)table[i].bytes * HEAT_WIDTH + table[0].bytes - 1) / table[0].bytes);
+		int wastedWidth = table[i].bytes ? (int)(((uint64_t)stats->wastedBytes * width + table[i].bytes / 2)
+			/ table[i].bytes) : 0;
+
+		for(j = 0; j < width; j++)
+			heat[j] = j < wastedWidth ? 'x' : '#';
+		heat[width] = 0;
+
+		fprintf(output, "%-12s %7u %7u %9u %9u %7u %6u %6u %5u %8u  %s\n",
+			table[i].row == RAM_ROW ? "RAM" : SpiAnnotatorName(table[i].row * 4, name),
+			stats->reads, stats->writes, stats->readBytes, stats->writeBytes, stats->same, stats->rmw,
+			stats->writeOnly, stats->race, stats->wastedBytes, heat);
+	}
+	if(rows < count)
+		fprintf(output, "... %d more registers\n", count - rows);
+
+	fprintf(output, "\n%u transactions, %u bytes, %u bytes wasted(%.1f%%), %u transactions can be skipped(%u bytes)\n",
+		annotator->transactions, annotator->bytes, wasted, annotator->bytes ? 100.0 * wasted / annotator->bytes : 0,
+		annotator->wastedTransactions, annotator->wastedTransactionBytes);
+	if(annotator->malformed)
+		fprintf(output, "%u malformed transactions\n", annotator->malformed);
+}
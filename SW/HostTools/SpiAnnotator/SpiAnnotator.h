@@ -0,0 +1,133 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _SPI_ANNOTATOR_H
+#define _SPI_ANNOTATOR_H
+
+/*
+* Annotator of SPI transactions between microcontroller and MCP2517FD.
+*
+* Every transaction(one CS frame: instruction, address, data and optional CRC) is
+* annotated with symbolic names of accessed registers from drv_canfdspi_register.h
+* (CiFIFOCON3, CiFLTOBJ12, OSC, RAM, ...) and counted per register:
+* - reads and writes, bytes on wire(instruction header is counted to the first register),
+* - same: reads which returned only known values, every byte of register which isn't
+*   updated by hardware was read or written before and has the same value,
+* - RMW: read of register followed by write to the same bytes without other access,
+* - write-only: RMW where every changed byte was known before read, driver could write
+*   cached value without read,
+* - race: RMW which write back byte updated by hardware(flags set between read and
+*   write are cleared or lost),
+* - wasted bytes: bytes of same reads, reads of write-only RMW and unchanged bytes at
+*   the begin and end of RMW write which could be skipped.
+* Values are tracked per byte. RESET instruction load reset values from
+* drv_canfdspi_register.h, so reads of configuration after reset are also detected.
+* Bytes of status registers, flags, self-clearing bits(UINC, TXREQ, FRESET) and RAM are
+* treated as updated by hardware and never known.
+*
+* Transactions can come from host run of driver(fake DRV_SPI_TransferData in
+* SpiHeatmap.c), text trace(SpiHeatmap -t) or logic analyzer capture
+* (SpiCaptureAnalyzer -a). Report is sorted by bytes on wire, so registers with the
+* biggest traffic and wasted bytes are on top.
+*
+* Simple example code:
+*
+*	static SpiAnnotator annotator;
+*
+*	SpiAnnotatorInitialize(&annotator);
+*	SpiAnnotatorTransaction(&annotator, tx, rx, length);
+*	printf("%s\n", annotator.text);
+*	SpiAnnotatorReport(&annotator, stdout, 0);
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_register.h"
+
+//MCP2517FD address space is 12 bits
+#define SPI_ANNOTATOR_BYTES 4096
+#define SPI_ANNOTATOR_WORDS (SPI_ANNOTATOR_BYTES / 4)
+
+//the longest annotation text and register name
+#define SPI_ANNOTATOR_TEXT 160
+#define SPI_ANNOTATOR_NAME 24
+
+//statistics of register, RAM is counted as single register
+typedef struct
+{
+	uint32_t reads;
+	uint32_t writes;
+	uint32_t readBytes;
+	uint32_t writeBytes;
+	uint32_t same;
+	uint32_t rmw;
+	uint32_t writeOnly;
+	uint32_t race;
+	uint32_t wastedBytes;
+} SpiRegisterStats;
+
+//read waiting for write of the same register, masks have bit per byte of register
+typedef struct
+{
+	uint8_t readMask;
+	uint8_t knownMask;
+	uint8_t value[4];
+} SpiPendingRead;
+
+typedef struct
+{
+	uint8_t value[SPI_ANNOTATOR_BYTES];
+	bool known[SPI_ANNOTATOR_BYTES];
+	SpiPendingRead pending[SPI_ANNOTATOR_WORDS];
+	SpiRegisterStats stats[SPI_ANNOTATOR_WORDS];
+	uint32_t transactions;
+	uint32_t bytes;
+	//transactions in which all data bytes were wasted
+	uint32_t wastedTransactions;
+	uint32_t wastedTransactionBytes;
+	uint32_t malformed;
+	//annotation of the last transaction
+	char text[SPI_ANNOTATOR_TEXT];
+} SpiAnnotator;
+
+void SpiAnnotatorInitialize(SpiAnnotator* annotator);
+
+//symbolic name of register with byte offset(e.g. CiINT+2), RAM address is offset in RAM
+const char* SpiAnnotatorName(uint16_t address, char* name);
+
+//mask of register bytes updated by hardware, bit per byte
+uint8_t SpiAnnotatorHardwareMask(uint16_t address);
+
+//tx and rx contain the whole CS frame, rx can be NULL for write, return -1 for
+//instruction which can't be decoded
+int SpiAnnotatorTransaction(SpiAnnotator* annotator, const uint8_t* tx, const uint8_t* rx, uint16_t length);
+
+//table of registers sorted by bytes on wire, rows limit the number of rows(0 - all)
+void SpiAnnotatorReport(const SpiAnnotator* annotator, FILE* output, int rows);
+
+#endif // _SPI_ANNOTATOR_H
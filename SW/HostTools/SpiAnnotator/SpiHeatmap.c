@@ -0,0 +1,537 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+* Register access heatmap of MCP2517FD driver, annotator from SpiAnnotator.c.
+*
+* Workload: driver from drv_canfdspi_api.c is run on host with fake DRV_SPI_TransferData
+* which keep registers in memory(reset values, OPMOD follow REQOP, UINC/TXREQ/FRESET are
+* self-clearing, TX FIFO is never full and RX FIFO never empty). Configuration is the
+* same as in Microchip example(TX FIFO CH1, RX FIFO CH2, filter 0, 500k/2M), then every
+* iteration load TX frame, read RX frame and error counters like polling loop. Every
+* SPI transaction is annotated and report show which registers take the most SPI
+* traffic and how much of it is wasted.
+*
+* Trace: text file with one transaction per line, hex bytes of MOSI and optionally
+* MISO after '|', lines starting with '#' are comments:
+*	# OperationModeSelect
+*	30 03 | FF FF 04
+*	20 03 00
+*
+* Logic analyzer captures are annotated by SpiCaptureAnalyzer -a.
+*
+* Without arguments tool run self check: register names, synthetic transactions with
+* known number of same reads, RMW, write-only RMW, race and wasted bytes and workload
+* with driver where known RMW of driver functions must be found.
+*
+* Build(gcc or mingw):
+*	gcc -std=gnu99 -Wall -o SpiHeatmap SpiHeatmap.c
+*
+* Usage:
+*	SpiHeatmap -w [-n iterations] [-v] [-r rows]    driver workload
+*	SpiHeatmap -t file [-v] [-r rows]               trace file, - is stdin
+*	  -v       print annotation of every transaction
+*	  -r rows  print only the busiest registers
+*
+* Exit code is number of failed checks, number of malformed transactions for workload
+* and trace.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_api.c"
+#include "SpiAnnotator.c"
+
+#define TX_CHANNEL CAN_FIFO_CH1
+#define RX_CHANNEL CAN_FIFO_CH2
+#define MAX_TRACE_LINE 16384
+#define MAX_TRACE_BYTES 4096
+
+static uint8_t Registers[SPI_ANNOTATOR_BYTES];
+static SpiAnnotator Annotator;
+static bool Verbose;
+
+static void RegistersReset(void)
+{
+	uint16_t i;
+
+	for(i = 0; i < SPI_ANNOTATOR_BYTES; i++)
+		Registers[i] = Annotator.known[i] ? Annotator.value[i] : 0;
+}
+
+static void RegisterWrite(uint16_t address, uint8_t value)
+{
+	uint16_t word = address & 0xFFC;
+
+	Registers[address] = value;
+
+	//REQOP is applied immediately, UINC, TXREQ and FRESET are cleared by hardware
+	if(address == cREGADDR_CiCON + 3)
+		Registers[cREGADDR_CiCON + 2] = (Registers[cREGADDR_CiCON + 2] & 0x1F) | ((value & 0x7) << 5);
+	if(word >= cREGADDR_CiTXQCON && word < cREGADDR_CiFLTCON && (address & 3) == 1
+		&& (word - cREGADDR_CiTXQCON) % CiFIFO_OFFSET == 0)
+		Registers[address] &= ~0x07;
+	if(word == cREGADDR_CiFIFOCON + TX_CHANNEL * CiFIFO_OFFSET || word == cREGADDR_CiFIFOCON + RX_CHANNEL * CiFIFO_OFFSET)
+	{
+		Registers[cREGADDR_CiFIFOSTA + TX_CHANNEL * CiFIFO_OFFSET] |= CAN_TX_FIFO_NOT_FULL_EVENT;
+		Registers[cREGADDR_CiFIFOSTA + RX_CHANNEL * CiFIFO_OFFSET] |= CAN_RX_FIFO_NOT_EMPTY_EVENT;
+		Registers[cREGADDR_CiFIFOUA + RX_CHANNEL * CiFIFO_OFFSET + 1] = 0x2;
+	}
+}
+
+//registers are stored in memory, every transfer is passed to annotator
+int8_t DRV_SPI_TransferData(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxData, uint8_t *SpiRxData, uint16_t spiTransferSize)
+{
+	uint8_t instruction = SpiTxData[0] >> 4;
+	uint16_t address = ((SpiTxData[0] & 0xF) << 8) | SpiTxData[1];
+	uint16_t dataStart = (instruction == cINSTRUCTION_READ_CRC || instruction == cINSTRUCTION_WRITE_CRC) ? 3 : 2;
+	uint16_t i;
+
+	(void)spiSlaveDeviceIndex;
+	memset(SpiRxData, 0, spiTransferSize);
+
+	for(i = dataStart; i < spiTransferSize; i++)
+	{
+		if(instruction == cINSTRUCTION_READ || instruction == cINSTRUCTION_READ_CRC)
+			SpiRxData[i] = Registers[(address + i - dataStart) & 0xFFF];
+		else if(instruction == cINSTRUCTION_WRITE)
+			RegisterWrite((address + i - dataStart) & 0xFFF, SpiTxData[i]);
+	}
+
+	SpiAnnotatorTransaction(&Annotator, SpiTxData, SpiRxData, spiTransferSize);
+	if(instruction == cINSTRUCTION_RESET)
+		RegistersReset();
+	if(Verbose)
+		printf("%s\n", Annotator.text);
+
+	return 0;
+}
+
+int8_t DRV_SPI_TransferFill(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxHeader, uint16_t spiHeaderSize, uint8_t fillByte, uint16_t spiFillSize)
+{
+	static uint8_t tx[2 + cRAM_SIZE];
+	static uint8_t rx[2 + cRAM_SIZE];
+
+	if(spiHeaderSize + spiFillSize > (int)sizeof(tx))
+		return -1;
+
+	memcpy(tx, SpiTxHeader, spiHeaderSize);
+	memset(&tx[spiHeaderSize], fillByte, spiFillSize);
+
+	return DRV_SPI_TransferData(spiSlaveDeviceIndex, tx, rx, spiHeaderSize + spiFillSize);
+}
+
+//configuration like in Microchip example and polling loop
+static void Workload(uint32_t iterations)
+{
+	CAN_CONFIG config;
+	CAN_TX_FIFO_CONFIG txConfig;
+	CAN_RX_FIFO_CONFIG rxConfig;
+	CAN_FILTEROBJ_ID filter;
+	CAN_MASKOBJ_ID mask;
+	CAN_TX_MSGOBJ txObj;
+	CAN_RX_MSGOBJ rxObj;
+	CAN_TX_FIFO_EVENT txFlags = CAN_TX_FIFO_NO_EVENT;
+	CAN_RX_FIFO_EVENT rxFlags = CAN_RX_FIFO_NO_EVENT;
+	CAN_ERROR_STATE errorFlags;
+	uint8_t txd[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+	uint8_t rxd[8];
+	uint8_t tec;
+	uint8_t rec;
+	uint32_t i;
+
+	SpiAnnotatorInitialize(&Annotator);
+	memset(Registers, 0, sizeof(Registers));
+
+	DRV_CANFDSPI_Reset(DRV_CANFDSPI_INDEX_0);
+	DRV_CANFDSPI_EccEnable(DRV_CANFDSPI_INDEX_0);
+	DRV_CANFDSPI_RamInit(DRV_CANFDSPI_INDEX_0, 0xff);
+
+	DRV_CANFDSPI_ConfigureObjectReset(&config);
+	config.IsoCrcEnable = 1;
+	config.StoreInTEF = 0;
+	DRV_CANFDSPI_Configure(DRV_CANFDSPI_INDEX_0, &config);
+
+	DRV_CANFDSPI_TransmitChannelConfigureObjectReset(&txConfig);
+	txConfig.FifoSize = 7;
+	txConfig.PayLoadSize = CAN_PLSIZE_64;
+	txConfig.TxPriority = 1;
+	DRV_CANFDSPI_TransmitChannelConfigure(DRV_CANFDSPI_INDEX_0, TX_CHANNEL, &txConfig);
+
+	DRV_CANFDSPI_ReceiveChannelConfigureObjectReset(&rxConfig);
+	rxConfig.FifoSize = 15;
+	rxConfig.PayLoadSize = CAN_PLSIZE_64;
+	DRV_CANFDSPI_ReceiveChannelConfigure(DRV_CANFDSPI_INDEX_0, RX_CHANNEL, &rxConfig);
+
+	memset(&filter, 0, sizeof(filter));
+	filter.SID = 0xDA;
+	DRV_CANFDSPI_FilterObjectConfigure(DRV_CANFDSPI_INDEX_0, CAN_FILTER0, &filter);
+	memset(&mask, 0, sizeof(mask));
+	mask.MSID = 0x7F8;
+	DRV_CANFDSPI_FilterMaskConfigure(DRV_CANFDSPI_INDEX_0, CAN_FILTER0, &mask);
+	DRV_CANFDSPI_FilterToFifoLink(DRV_CANFDSPI_INDEX_0, CAN_FILTER0, RX_CHANNEL, true);
+
+	DRV_CANFDSPI_BitTimeConfigure(DRV_CANFDSPI_INDEX_0, CAN_500K_2M, CAN_SSP_MODE_AUTO, CAN_SYSCLK_40M);
+	DRV_CANFDSPI_GpioModeConfigure(DRV_CANFDSPI_INDEX_0, GPIO_MODE_INT, GPIO_MODE_INT);
+	DRV_CANFDSPI_TransmitChannelEventEnable(DRV_CANFDSPI_INDEX_0, TX_CHANNEL, CAN_TX_FIFO_NOT_FULL_EVENT);
+	DRV_CANFDSPI_ReceiveChannelEventEnable(DRV_CANFDSPI_INDEX_0, RX_CHANNEL, CAN_RX_FIFO_NOT_EMPTY_EVENT);
+	DRV_CANFDSPI_ModuleEventEnable(DRV_CANFDSPI_INDEX_0, CAN_TX_EVENT | CAN_RX_EVENT);
+	DRV_CANFDSPI_OperationModeSelect(DRV_CANFDSPI_INDEX_0, CAN_NORMAL_MODE);
+
+	memset(&txObj, 0, sizeof(txObj));
+	txObj.bF.id.SID = 0x300;
+	txObj.bF.ctrl.DLC = CAN_DLC_8;
+
+	for(i = 0; i < iterations; i++)
+	{
+		DRV_CANFDSPI_TransmitChannelEventGet(DRV_CANFDSPI_INDEX_0, TX_CHANNEL, &txFlags);
+		if(txFlags & CAN_TX_FIFO_NOT_FULL_EVENT)
+			DRV_CANFDSPI_TransmitChannelLoad(DRV_CANFDSPI_INDEX_0, TX_CHANNEL, &txObj, txd, 8, true);
+
+		DRV_CANFDSPI_ReceiveChannelEventGet(DRV_CANFDSPI_INDEX_0, RX_CHANNEL, &rxFlags);
+		if(rxFlags & CAN_RX_FIFO_NOT_EMPTY_EVENT)
+			DRV_CANFDSPI_ReceiveMessageGet(DRV_CANFDSPI_INDEX_0, RX_CHANNEL, &rxObj, rxd, 8);
+
+		DRV_CANFDSPI_ErrorCountStateGet(DRV_CANFDSPI_INDEX_0, &tec, &rec, &errorFlags);
+	}
+}
+
+static int HexValue(char c)
+{
+	if(c >= '0' && c <= '9')
+		return c - '0';
+	c = (char)toupper((unsigned char)c);
+	if(c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+
+	return -1;
+}
+
+//return -1 when file can't be opened
+static int Trace(const char* fileName)
+{
+	static char line[MAX_TRACE_LINE];
+	static uint8_t tx[MAX_TRACE_BYTES];
+	static uint8_t rx[MAX_TRACE_BYTES];
+	FILE* file = strcmp(fileName, "-") == 0 ? stdin : fopen(fileName, "r");
+	uint32_t lineNumber = 0;
+
+	if(file == NULL)
+		return -1;
+
+	SpiAnnotatorInitialize(&Annotator);
+
+	while(fgets(line, sizeof(line), file) != NULL)
+	{
+		uint16_t txBytes = 0;
+		uint16_t rxBytes = 0;
+		bool miso = false;
+		bool error = false;
+		char* c = line;
+
+		lineNumber++;
+		while(isspace((unsigned char)*c))
+			c++;
+		if(*c == '#' || *c == 0)
+			continue;
+
+		for(; *c && !error; c++)
+		{
+			if(isspace((unsigned char)*c))
+				continue;
+			if(*c == '|' && !miso)
+			{
+				miso = true;
+				continue;
+			}
+			if(HexValue(c[0]) < 0 || HexValue(c[1]) < 0 || (miso ? rxBytes : txBytes) == MAX_TRACE_BYTES)
+			{
+				error = true;
+				break;
+			}
+			if(miso)
+				rx[rxBytes++] = (uint8_t)(HexValue(c[0]) * 16 + HexValue(c[1]));
+			else
+				tx[txBytes++] = (uint8_t)(HexValue(c[0]) * 16 + HexValue(c[1]));
+			c++;
+		}
+
+		//missing MISO bytes are zero, MOSI is padded for read
+		if(miso && rxBytes > txBytes)
+		{
+			memset(&tx[txBytes], 0, rxBytes - txBytes);
+			txBytes = rxBytes;
+		}
+		if(miso && rxBytes < txBytes)
+			memset(&rx[rxBytes], 0, txBytes - rxBytes);
+
+		if(error)
+		{
+			printf("line %u: wrong byte\n", lineNumber);
+			Annotator.malformed++;
+			continue;
+		}
+		SpiAnnotatorTransaction(&Annotator, tx, miso ? rx : NULL, txBytes);
+		if(Verbose)
+			printf("%u: %s\n", lineNumber, Annotator.text);
+	}
+
+	if(file != stdin)
+		fclose(file);
+
+	return 0;
+}
+
+static int CheckName(uint16_t address, const char* expected)
+{
+	char name[SPI_ANNOTATOR_NAME];
+
+	if(strcmp(SpiAnnotatorName(address, name), expected) == 0)
+		return 0;
+
+	printf("name of 0x%03X: %s, expected %s\n", address, name, expected);
+	return 1;
+}
+
+static int CheckNames(void)
+{
+	int failed = 0;
+
+	failed += CheckName(0x000, "CiCON");
+	failed += CheckName(0x003, "CiCON+3");
+	failed += CheckName(cREGADDR_CiINTENABLE, "CiINT+2");
+	failed += CheckName(0x04C, "CiFIFOBA");
+	failed += CheckName(0x050, "CiTXQCON");
+	failed += CheckName(0x058, "CiTXQUA");
+	failed += CheckName(0x05C, "CiFIFOCON1");
+	failed += CheckName(0x069, "CiFIFOCON2+1");
+	failed += CheckName(0x1CC, "CiFIFOUA31");
+	failed += CheckName(0x1D0, "CiFLTCON0");
+	failed += CheckName(0x1EF, "CiFLTCON7+3");
+	failed += CheckName(0x1F0, "CiFLTOBJ0");
+	failed += CheckName(0x1F4, "CiMASK0");
+	failed += CheckName(0x2EC, "CiMASK31");
+	failed += CheckName(0x2F0, "0x2F0");
+	failed += CheckName(0x400, "RAM+0x000");
+	failed += CheckName(0xBFF, "RAM+0x7FF");
+	failed += CheckName(0xE00, "OSC");
+	failed += CheckName(0xE0A, "CRC+2");
+	failed += CheckName(0xE14, "DEVID");
+	failed += CheckName(0xE18, "0xE18");
+
+	return failed;
+}
+
+typedef struct
+{
+	uint8_t tx[8];
+	uint8_t rx[16];
+	uint8_t length;
+	const char* text;
+} CheckTransaction;
+
+static int CheckStats(uint16_t address, uint32_t reads, uint32_t writes, uint32_t same, uint32_t rmw,
+	uint32_t writeOnly, uint32_t race, uint32_t wastedBytes)
+{
+	const SpiRegisterStats* stats = &Annotator.stats[address / 4];
+	char name[SPI_ANNOTATOR_NAME];
+
+	if(stats->reads == reads && stats->writes == writes && stats->same == same && stats->rmw == rmw
+		&& stats->writeOnly == writeOnly && stats->race == race && stats->wastedBytes == wastedBytes)
+		return 0;
+
+	printf("%s: %u/%u/%u/%u/%u/%u/%u, expected %u/%u/%u/%u/%u/%u/%u\n", SpiAnnotatorName(address, name),
+		stats->reads, stats->writes, stats->same, stats->rmw, stats->writeOnly, stats->race, stats->wastedBytes,
+		reads, writes, same, rmw, writeOnly, race, wastedBytes);
+	return 1;
+}
+
+static int CheckTransactions(void)
+{
+	static const CheckTransaction Transactions[] = {
+		{{0x00, 0x00}, {0}, 2, "RESET"},
+		//OperationModeSelect after reset: REQOP is known, read is wasted and RMW write-only
+		{{0x30, 0x03}, {0, 0, 0x04}, 3, "READ CiCON+3 [1] wasted 1"},
+		{{0x20, 0x03, 0x00}, {0}, 3, "WRITE CiCON+3 [1] RMW write-only"},
+		//new value, then the same value again
+		{{0x30, 0x04}, {0, 0, 0x07, 0x0E, 0x1E, 0x01}, 6, "READ CiNBTCFG [4]"},
+		{{0x30, 0x04}, {0, 0, 0x07, 0x0E, 0x1E, 0x01}, 6, "READ CiNBTCFG [4] wasted 4"},
+		//flags aren't known, enables are, write back of flags clear flag set after read
+		{{0x30, 0x1C}, {0, 0, 0x03, 0x00, 0x00, 0x00}, 6, "READ CiINT [4] wasted 2"},
+		{{0x20, 0x1C, 0x01, 0x00, 0x00, 0x00}, {0}, 6, "WRITE CiINT [4] wasted 3 RMW race"},
+		//RAM is never known and isn't modified by RMW
+		{{0x34, 0x00}, {0, 0, 1, 2, 3, 4, 5, 6, 7, 8}, 10, "READ RAM+0x000 [8]"},
+		{{0x34, 0x00}, {0, 0, 1, 2, 3, 4}, 6, "READ RAM+0x000 [4]"},
+		{{0x24, 0x00, 1, 2, 3, 4}, {0}, 6, "WRITE RAM+0x000 [4]"},
+		//reset value of FIFO
+		{{0x30, 0x8C}, {0, 0, 0x00, 0x04, 0x60, 0x00}, 6, "READ CiFIFOCON5 [4] wasted 3"},
+		//write without read, then read of FIFO registers, CON without UINC/TXREQ is known
+		{{0xC0, 0x5C, 0x80, 0x00, 0x60, 0x07, 0x12, 0x34}, {0}, 8, "WRITE_SAFE CiFIFOCON1 [4]"},
+		{{0xB0, 0x5C, 0x08}, {0, 0, 0, 0x80, 0x04, 0x60, 0x07, 0x01, 0, 0, 0, 0x56, 0x78}, 13,
+			"READ_CRC CiFIFOCON1..CiFIFOSTA1 [8] wasted 3"},
+		//changed byte 0 was known before read, unchanged bytes 1 - 3 are trimmed
+		{{0x20, 0x5C, 0x00, 0x04, 0x60, 0x07}, {0}, 6, "WRITE CiFIFOCON1 [4] wasted 3 RMW write-only race"},
+		{{0x50, 0x00}, {0}, 2, "UNKNOWN malformed"},
+		//write of the same value after read is wasted completely
+		{{0x3E, 0x0C}, {0, 0, 0x00}, 3, "READ ECCCON [1] wasted 1"},
+		{{0x3E, 0x00}, {0, 0, 0x60, 0x04, 0x00, 0x00}, 6, "READ OSC [4] wasted 3"},
+		{{0x2E, 0x00, 0x60}, {0}, 3, "WRITE OSC [1] wasted 1 RMW write-only"},
+		{{0x2E, 0x00, 0x60}, {0}, 3, "WRITE OSC [1]"},
+	};
+	uint32_t i;
+	int failed = 0;
+
+	SpiAnnotatorInitialize(&Annotator);
+
+	for(i = 0; i < sizeof(Transactions) / sizeof(Transactions[0]); i++)
+	{
+		const CheckTransaction* transaction = &Transactions[i];
+
+		SpiAnnotatorTransaction(&Annotator, transaction->tx, transaction->rx, transaction->length);
+		if(strcmp(Annotator.text, transaction->text) != 0)
+		{
+			printf("transaction %u: \"%s\", expected \"%s\"\n", i, Annotator.text, transaction->text);
+			failed++;
+		}
+	}
+
+	//header is wasted when all data bytes are wasted
+	failed += CheckStats(cREGADDR_CiCON, 1, 1, 1, 1, 1, 0, 1 + 2);
+	failed += CheckStats(cREGADDR_CiNBTCFG, 2, 0, 1, 0, 0, 0, 4 + 2);
+	failed += CheckStats(cREGADDR_CiINT, 1, 1, 1, 1, 0, 1, 5);
+	failed += CheckStats(cRAMADDR_START, 2, 1, 0, 0, 0, 0, 0);
+	failed += CheckStats(cREGADDR_CiFIFOCON + 5 * CiFIFO_OFFSET, 1, 0, 1, 0, 0, 0, 3);
+	failed += CheckStats(cREGADDR_CiFIFOCON + CiFIFO_OFFSET, 1, 2, 1, 1, 1, 1, 3 + 1 + 3);
+	failed += CheckStats(cREGADDR_CiFIFOSTA + CiFIFO_OFFSET, 1, 0, 0, 0, 0, 0, 0);
+	failed += CheckStats(cREGADDR_OSC, 1, 2, 1, 1, 1, 0, 3 + 1 + 1 + 2);
+
+	//CiCON+3 read, CiNBTCFG read, ECCCON read and OSC write
+	if(Annotator.transactions != 19 || Annotator.malformed != 1 || Annotator.wastedTransactions != 4
+		|| Annotator.wastedTransactionBytes != 3 + 6 + 3 + 3)
+	{
+		printf("%u transactions, %u malformed, %u wasted transactions with %u bytes\n", Annotator.transactions,
+			Annotator.malformed, Annotator.wastedTransactions, Annotator.wastedTransactionBytes);
+		failed++;
+	}
+
+	return failed;
+}
+
+//RMW of driver functions after reset, FIFO configuration read by every TX load and RX read
+static int CheckWorkload(void)
+{
+	uint32_t iterations = 10;
+	uint16_t tx = cREGADDR_CiFIFOCON + TX_CHANNEL * CiFIFO_OFFSET;
+	uint16_t rx = cREGADDR_CiFIFOCON + RX_CHANNEL * CiFIFO_OFFSET;
+	uint32_t race = 0;
+	int failed = 0;
+	int i;
+
+	Workload(iterations);
+
+	for(i = 0; i < SPI_ANNOTATOR_WORDS; i++)
+		race += Annotator.stats[i].race;
+
+	//EccEnable, GpioModeConfigure, ModuleEventEnable and OperationModeSelect
+	failed += CheckStats(cREGADDR_ECCCON, 1, 1, 1, 1, 1, 0, 1 + 2);
+	failed += CheckStats(cREGADDR_IOCON, 1, 1, 1, 1, 1, 0, 1 + 2 + 1 + 2);
+	failed += CheckStats(cREGADDR_CiINT, 1, 1, 1, 1, 1, 0, 2 + 2 + 1);
+	failed += CheckStats(cREGADDR_CiCON, 1, 2, 1, 1, 1, 0, 1 + 2);
+	//event enable RMW, then CON read and UINC/TXREQ write by every iteration
+	failed += CheckStats(tx, iterations + 1, iterations + 2, iterations + 1, iterations + 1, 1, 0, 3 * iterations + 3);
+	failed += CheckStats(rx, iterations + 1, iterations + 2, iterations + 1, iterations + 1, 1, 0, 3 * iterations + 3);
+	failed += CheckStats(tx + 4, 2 * iterations, 0, 0, 0, 0, 0, 0);
+
+	if(Annotator.malformed || race || Annotator.transactions != 23 + 9 * iterations)
+	{
+		printf("workload: %u transactions, %u malformed, %u races\n", Annotator.transactions, Annotator.malformed, race);
+		failed++;
+	}
+
+	return failed;
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t iterations = 100;
+	const char* traceFile = NULL;
+	bool workload = false;
+	int rows = 0;
+	int failed = 0;
+	int i;
+
+	for(i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-w") == 0)
+			workload = true;
+		else if(strcmp(argv[i], "-v") == 0)
+			Verbose = true;
+		else if(i + 1 < argc && strcmp(argv[i], "-n") == 0)
+			iterations = (uint32_t)atoi(argv[++i]);
+		else if(i + 1 < argc && strcmp(argv[i], "-r") == 0)
+			rows = atoi(argv[++i]);
+		else if(i + 1 < argc && strcmp(argv[i], "-t") == 0)
+			traceFile = argv[++i];
+		else
+			break;
+	}
+
+	if(i != argc || (argc > 1 && !workload && traceFile == NULL))
+	{
+		printf("Usage: SpiHeatmap -w [-n iterations] [-v] [-r rows]\n"
+			"       SpiHeatmap -t file [-v] [-r rows]\n");
+		return -1;
+	}
+
+	if(workload)
+	{
+		Workload(iterations);
+		SpiAnnotatorReport(&Annotator, stdout, rows);
+		return Annotator.malformed;
+	}
+
+	if(traceFile != NULL)
+	{
+		if(Trace(traceFile) != 0)
+		{
+			printf("Can't open %s\n", traceFile);
+			return -1;
+		}
+		SpiAnnotatorReport(&Annotator, stdout, rows);
+		return Annotator.malformed;
+	}
+
+	failed += CheckNames();
+	failed += CheckTransactions();
+	failed += CheckWorkload();
+
+	printf("%d failed\n", failed);
+
+	return failed;
+}
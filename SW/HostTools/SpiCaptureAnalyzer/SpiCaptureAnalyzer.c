@@ -0,0 +1,881 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+* Analyzer of SPI traffic between microcontroller and MCP2517FD recorded by logic analyzer
+* and exported as CSV(e.g. Doc/LogicAnalyzerLog/SPI_Command.csv from Saleae Logic):
+*	Time[s], Channel 0, Channel 1, Channel 2, Channel 3
+*	8.207047360000001, 0, 0, 1, 0
+* Every row contain time and state of all channels after change.
+*
+* Bytes are reconstructed from SCK edges while CS is low(MSB first, SPI mode 0 - 3) and
+* every CS frame is decoded as MCP2517FD instruction: RESET, READ, WRITE, READ_CRC,
+* WRITE_CRC or WRITE_SAFE with address, data and CRC. For every frame tool print:
+* - CS setup(CS low to first SCK edge) and hold(last SCK edge to CS high),
+* - gaps between bytes(time between last edge of byte and first edge of next byte),
+* - SCK frequency measured inside bytes, wire time(bits * SCK period) and efficiency
+*   (wire time / CS low time), effective throughput.
+* Frames with idle time shorter than group gap are counted as one driver operation(e.g.
+* read-modify-write of register or TX FIFO load with UINC), operation time is from CS
+* low of the first frame to CS high of the last frame.
+*
+* Summary contain totals per instruction and time lost in CS setup/hold and gaps, so
+* effect of driver change(e.g. transfer without byte-at-a-time loop in
+* spi_master_transfer) can be measured on real hardware.
+*
+* With -a every frame is annotated with register names by SpiAnnotator.c and summary
+* contain register access heatmap with redundant reads and RMW which could be write-only.
+*
+* Without arguments tool run self check: CSV with known timing is generated for all SPI
+* modes and every instruction, decoded bytes and measured times are compared with
+* generated values.
+*
+* Build(gcc or mingw):
+*	gcc -std=gnu99 -Wall -O2 -o SpiCaptureAnalyzer SpiCaptureAnalyzer.c
+*
+* Usage:
+*	SpiCaptureAnalyzer [options] file.csv
+*	  -m n -s n -c n -e n  channel of MOSI, MISO, SCK and CS(default 0 2 3 1 like
+*	                       Doc/LogicAnalyzerLog/SPI_Settings.png)
+*	  -M mode              SPI mode 0 - 3(default 0, CPOL = 0, CPHA = 0)
+*	  -f Hz                nominal SCK frequency(default measured in every frame)
+*	  -g us                group gap of driver operation(default 20us)
+*	  -q                   print only operations and summary
+*	  -a                   annotate registers and print heatmap
+*
+* Example:
+*	SpiCaptureAnalyzer ../../../Doc/LogicAnalyzerLog/SPI_Command.csv
+*
+* Exit code is number of failed checks, in analyze mode 1 when file can't be read or
+* contain frame with incomplete byte.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_register.h"
+#include "../SpiAnnotator/SpiAnnotator.c"
+
+#define MAX_CHANNELS 16
+#define MAX_FRAME_BYTES 4096
+#define MAX_LINE 1024
+
+//the longest instruction header: command, address and N of CRC instructions
+#define HEADER_BYTES 2
+#define CRC_HEADER_BYTES 3
+#define CRC_BYTES 2
+
+typedef struct
+{
+	int mosi;
+	int miso;
+	int sck;
+	int cs;
+	int mode;
+	double nominalFrequency;
+	int64_t groupGap;
+	bool quiet;
+	bool annotate;
+} Settings;
+
+//CS frame, times in ns
+typedef struct
+{
+	int64_t start;
+	int64_t end;
+	int64_t firstEdge;
+	int64_t lastEdge;
+	uint16_t bytes;
+	uint8_t bits;
+	bool truncated;
+	uint8_t mosiByte;
+	uint8_t misoByte;
+	//edges inside current byte, 2 per bit
+	int edges;
+	int64_t byteStart;
+	int64_t byteFirstSample;
+	int64_t lastSample;
+	int64_t previousByteEnd;
+	//gaps between bytes and sum of bit periods measured inside bytes
+	int64_t gapMin;
+	int64_t gapMax;
+	int64_t gapSum;
+	int64_t periodSum;
+	uint32_t periodBytes;
+	//data is the last, only fields before it are cleared at CS low
+	uint8_t mosi[MAX_FRAME_BYTES];
+	uint8_t miso[MAX_FRAME_BYTES];
+} Frame;
+
+typedef struct
+{
+	uint32_t frames;
+	uint64_t bytes;
+	int64_t time;
+	int64_t wireTime;
+} Totals;
+
+//driver operation: frames separated by idle time shorter than group gap
+typedef struct
+{
+	int64_t start;
+	int64_t end;
+	uint32_t frames;
+	uint32_t bytes;
+	int64_t wireTime;
+	char text[256];
+	int length;
+} Operation;
+
+typedef struct
+{
+	Settings settings;
+	Frame frame;
+	Operation operation;
+	bool operationOpen;
+	Totals instruction[16];
+	Totals all;
+	Totals operations;
+	int64_t setupSum;
+	int64_t holdSum;
+	int64_t gapSum;
+	uint64_t gaps;
+	int64_t gapMin;
+	int64_t gapMax;
+	int64_t periodSum;
+	uint64_t periodBytes;
+	uint32_t incompleteFrames;
+	FILE* output;
+	//register statistics, NULL when frames aren't annotated
+	SpiAnnotator* annotator;
+	//decoded frames are copied here by self check
+	Frame* history;
+	uint32_t historySize;
+	uint32_t historyFrames;
+} Analyzer;
+
+static const char* InstructionName(uint8_t instruction)
+{
+	switch(instruction)
+	{
+		case cINSTRUCTION_RESET: return "RESET";
+		case cINSTRUCTION_READ: return "READ";
+		case cINSTRUCTION_READ_CRC: return "READ_CRC";
+		case cINSTRUCTION_WRITE: return "WRITE";
+		case cINSTRUCTION_WRITE_CRC: return "WRITE_CRC";
+		case cINSTRUCTION_WRITE_SAFE: return "WRITE_SAFE";
+		default: return "UNKNOWN";
+	}
+}
+
+//memory region of address
+static const char* RegionName(uint16_t address)
+{
+	if(address < cRAMADDR_START)
+		return "SFR";
+	if(address < cRAMADDR_END)
+		return "RAM";
+	if(address >= cREGADDR_OSC && address < cREGADDR_OSC + 0x100)
+		return "MCP";
+	return "?";
+}
+
+static bool IsRead(uint8_t instruction)
+{
+	return instruction == cINSTRUCTION_READ || instruction == cINSTRUCTION_READ_CRC;
+}
+
+static void SettingsReset(Settings* settings)
+{
+	settings->mosi = 0;
+	settings->miso = 2;
+	settings->sck = 3;
+	settings->cs = 1;
+	settings->mode = 0;
+	settings->nominalFrequency = 0;
+	settings->groupGap = 20000;
+	settings->quiet = false;
+	settings->annotate = false;
+}
+
+static void AnalyzerInitialize(Analyzer* analyzer, const Settings* settings, FILE* output)
+{
+	memset(analyzer, 0, sizeof(Analyzer));
+	analyzer->settings = *settings;
+	analyzer->output = output;
+	analyzer->gapMin = INT64_MAX;
+}
+
+//bit period in ns, nominal or measured inside bytes of frame
+static double FramePeriod(const Analyzer* analyzer, const Frame* frame)
+{
+	if(analyzer->settings.nominalFrequency > 0)
+		return 1e9 / analyzer->settings.nominalFrequency;
+	if(frame->periodBytes == 0)
+		return 0;
+	return (double)frame->periodSum / (7.0 * frame->periodBytes);
+}
+
+static void OperationClose(Analyzer* analyzer)
+{
+	Operation* operation = &analyzer->operation;
+	int64_t time = operation->end - operation->start;
+
+	if(!analyzer->operationOpen)
+		return;
+
+	analyzer->operations.frames++;
+	analyzer->operations.bytes += operation->bytes;
+	analyzer->operations.time += time;
+	analyzer->operations.wireTime += operation->wireTime;
+
+	fprintf(analyzer->output, "operation %.6f s: %u frames, %u bytes, %.2f us, wire %.2f us(%.0f%%): %s\n",
+		operation->start / 1e9, operation->frames, operation->bytes, time / 1e3, operation->wireTime / 1e3,
+		time ? 100.0 * operation->wireTime / time : 0, operation->text);
+
+	analyzer->operationOpen = false;
+}
+
+static void FrameDecode(Analyzer* analyzer, Frame* frame)
+{
+	uint8_t instruction = frame->bytes ? frame->mosi[0] >> 4 : 0xF;
+	uint16_t address = (frame->bytes >= HEADER_BYTES) ? (((frame->mosi[0] & 0xF) << 8) | frame->mosi[1]) : 0;
+	const uint8_t* data = IsRead(instruction) ? frame->miso : frame->mosi;
+	bool crc = instruction == cINSTRUCTION_READ_CRC || instruction == cINSTRUCTION_WRITE_CRC
+		|| instruction == cINSTRUCTION_WRITE_SAFE;
+	uint16_t dataStart = HEADER_BYTES;
+	uint16_t dataEnd = frame->bytes;
+	double period = FramePeriod(analyzer, frame);
+	int64_t time = frame->end - frame->start;
+	int64_t wireTime = (int64_t)(period * 8 * frame->bytes + 0.5);
+	int64_t setup = frame->bytes ? frame->firstEdge - frame->start : 0;
+	int64_t hold = frame->bytes ? frame->end - frame->lastEdge : 0;
+	Totals* totals = &analyzer->instruction[instruction];
+	Operation* operation = &analyzer->operation;
+	FILE* output = analyzer->output;
+	char text[64];
+	uint16_t i;
+
+	if(frame->bits)
+		analyzer->incompleteFrames++;
+	if(analyzer->historyFrames < analyzer->historySize)
+		analyzer->history[analyzer->historyFrames++] = *frame;
+
+	//CRC instructions carry N(number of data bytes, READ_CRC and WRITE_CRC) and CRC after data
+	if(instruction == cINSTRUCTION_READ_CRC || instruction == cINSTRUCTION_WRITE_CRC)
+		dataStart = CRC_HEADER_BYTES;
+	if(crc && frame->bytes >= dataStart + CRC_BYTES)
+		dataEnd = frame->bytes - CRC_BYTES;
+	else
+		crc = false;
+	if(instruction == cINSTRUCTION_RESET || dataStart > dataEnd)
+		dataStart = dataEnd;
+
+	totals->frames++;
+	totals->bytes += frame->bytes;
+	totals->time += time;
+	totals->wireTime += wireTime;
+	analyzer->all.frames++;
+	analyzer->all.bytes += frame->bytes;
+	analyzer->all.time += time;
+	analyzer->all.wireTime += wireTime;
+	if(frame->bytes)
+	{
+		analyzer->setupSum += setup;
+		analyzer->holdSum += hold;
+	}
+	if(frame->bytes > 1)
+	{
+		analyzer->gapSum += frame->gapSum;
+		analyzer->gaps += frame->bytes - 1;
+		if(frame->gapMin < analyzer->gapMin)
+			analyzer->gapMin = frame->gapMin;
+		if(frame->gapMax > analyzer->gapMax)
+			analyzer->gapMax = frame->gapMax;
+	}
+	analyzer->periodSum += frame->periodSum;
+	analyzer->periodBytes += frame->periodBytes;
+
+	//frames with incomplete byte aren't annotated
+	if(analyzer->annotator != NULL && (frame->bits || frame->truncated))
+		snprintf(analyzer->annotator->text, sizeof(analyzer->annotator->text), "not annotated");
+	else if(analyzer->annotator != NULL)
+		SpiAnnotatorTransaction(analyzer->annotator, frame->mosi, frame->miso, frame->bytes);
+
+	if(!analyzer->settings.quiet)
+	{
+		fprintf(output, "%.9f %s", frame->start / 1e9, InstructionName(instruction));
+		if(instruction != cINSTRUCTION_RESET && frame->bytes >= HEADER_BYTES)
+			fprintf(output, " %s 0x%03X", RegionName(address), address);
+		if(dataStart == CRC_HEADER_BYTES && frame->bytes > 2)
+			fprintf(output, " N %u", frame->mosi[2]);
+		if(dataEnd > dataStart)
+		{
+			fprintf(output, " [%u]", dataEnd - dataStart);
+			for(i = dataStart; i < dataEnd; i++)
+				fprintf(output, " %02X", data[i]);
+		}
+		if(crc)
+			fprintf(output, " CRC %02X%02X", data[dataEnd], data[dataEnd + 1]);
+		if(frame->bits)
+			fprintf(output, " +%u bits", frame->bits);
+		if(frame->truncated)
+			fprintf(output, " truncated");
+		fprintf(output, "\n");
+
+		fprintf(output, "  %u bytes in %.2f us, SCK %.3f MHz, wire %.2f us(%.0f%%), %.0f kB/s, setup %lld ns, hold %lld ns",
+			frame->bytes, time / 1e3, period ? 1e3 / period : 0, wireTime / 1e3, time ? 100.0 * wireTime / time : 0,
+			time ? frame->bytes * 1e6 / time : 0, (long long)setup, (long long)hold);
+		if(frame->bytes > 1)
+			fprintf(output, ", gap %lld/%lld/%lld ns", (long long)frame->gapMin,
+				(long long)(frame->gapSum / (frame->bytes - 1)), (long long)frame->gapMax);
+		fprintf(output, "\n");
+		if(analyzer->annotator != NULL)
+			fprintf(output, "  %s\n", analyzer->annotator->text);
+	}
+
+	//frames closer than group gap belong to the same driver operation
+	if(analyzer->operationOpen && frame->start - operation->end >= analyzer->settings.groupGap)
+		OperationClose(analyzer);
+	if(!analyzer->operationOpen)
+	{
+		memset(operation, 0, sizeof(Operation));
+		operation->start = frame->start;
+		analyzer->operationOpen = true;
+	}
+	operation->end = frame->end;
+	operation->frames++;
+	operation->bytes += frame->bytes;
+	operation->wireTime += wireTime;
+
+	if(instruction == cINSTRUCTION_RESET || frame->bytes < HEADER_BYTES)
+		snprintf(text, sizeof(text), "%s%s", operation->length ? ", " : "", InstructionName(instruction));
+	else
+		snprintf(text, sizeof(text), "%s%s 0x%03X[%u]", operation->length ? ", " : "", InstructionName(instruction),
+			address, dataEnd - dataStart);
+	if(operation->length + strlen(text) < sizeof(operation->text) - 4)
+		operation->length += sprintf(&operation->text[operation->length], "%s", text);
+	else if(operation->length < (int)sizeof(operation->text) - 4)
+		operation->length += sprintf(&operation->text[operation->length], "...");
+}
+
+//state of channels after change at time
+static void AnalyzerRow(Analyzer* analyzer, int64_t time, const int* state, const int* previous)
+{
+	const Settings* settings = &analyzer->settings;
+	Frame* frame = &analyzer->frame;
+	bool cpha = settings->mode & 1;
+
+	if(state[settings->cs] != previous[settings->cs])
+	{
+		if(!state[settings->cs])
+		{
+			memset(frame, 0, offsetof(Frame, mosi));
+			frame->start = time;
+			frame->gapMin = INT64_MAX;
+		}
+		else
+		{
+			frame->end = time;
+			FrameDecode(analyzer, frame);
+		}
+	}
+
+	if(state[settings->cs] || state[settings->sck] == previous[settings->sck])
+		return;
+
+	//edges 1, 3, ... are leading edges, data is sampled on leading(CPHA = 0) or trailing edge
+	frame->edges++;
+	if(frame->edges == 1)
+	{
+		frame->byteStart = time;
+		if(frame->bytes == 0)
+			frame->firstEdge = time;
+	}
+	frame->lastEdge = time;
+
+	if((frame->edges & 1) != cpha)
+	{
+		//data before edge is sampled, it is stable since previous edge
+		frame->mosiByte = (frame->mosiByte << 1) | (previous[settings->mosi] & 1);
+		frame->misoByte = (frame->misoByte << 1) | (previous[settings->miso] & 1);
+		frame->bits++;
+		if(frame->bits == 1)
+			frame->byteFirstSample = time;
+		frame->lastSample = time;
+	}
+
+	if(frame->edges == 16)
+	{
+		int64_t gap = frame->byteStart - frame->previousByteEnd;
+
+		if(frame->bytes)
+		{
+			frame->gapSum += gap;
+			if(gap < frame->gapMin)
+				frame->gapMin = gap;
+			if(gap > frame->gapMax)
+				frame->gapMax = gap;
+		}
+		frame->previousByteEnd = time;
+		frame->periodSum += frame->lastSample - frame->byteFirstSample;
+		frame->periodBytes++;
+
+		if(frame->bytes < MAX_FRAME_BYTES)
+		{
+			frame->mosi[frame->bytes] = frame->mosiByte;
+			frame->miso[frame->bytes] = frame->misoByte;
+			frame->bytes++;
+		}
+		else
+		{
+			frame->truncated = true;
+		}
+		frame->bits = 0;
+		frame->edges = 0;
+	}
+}
+
+static void AnalyzerFinish(Analyzer* analyzer)
+{
+	FILE* output = analyzer->output;
+	double period = analyzer->settings.nominalFrequency > 0 ? 1e9 / analyzer->settings.nominalFrequency
+		: (analyzer->periodBytes ? (double)analyzer->periodSum / (7.0 * analyzer->periodBytes) : 0);
+	const Totals* all = &analyzer->all;
+	int i;
+
+	OperationClose(analyzer);
+
+	if(all->frames == 0)
+	{
+		fprintf(output, "no CS frames\n");
+		return;
+	}
+
+	fprintf(output, "\n%-12s %7s %9s %11s %11s %7s %9s\n", "instruction", "frames", "bytes", "time us", "wire us",
+		"eff", "us/frame");
+	for(i = 0; i < 16; i++)
+	{
+		const Totals* totals = &analyzer->instruction[i];
+
+		if(totals->frames == 0)
+			continue;
+		fprintf(output, "%-12s %7u %9llu %11.2f %11.2f %6.0f%% %9.2f\n", InstructionName(i), totals->frames,
+			(unsigned long long)totals->bytes, totals->time / 1e3, totals->wireTime / 1e3,
+			totals->time ? 100.0 * totals->wireTime / totals->time : 0, totals->time / 1e3 / totals->frames);
+	}
+	fprintf(output, "%-12s %7u %9llu %11.2f %11.2f %6.0f%% %9.2f\n", "all", all->frames,
+		(unsigned long long)all->bytes, all->time / 1e3, all->wireTime / 1e3,
+		all->time ? 100.0 * all->wireTime / all->time : 0, all->time / 1e3 / all->frames);
+
+	fprintf(output, "\nSCK %.3f MHz, nominal %.0f kB/s, effective %.0f kB/s inside CS\n", period ? 1e3 / period : 0,
+		period ? 1e6 / (8 * period) : 0, all->time ? all->bytes * 1e6 / all->time : 0);
+	fprintf(output, "CS setup %.2f us, hold %.2f us(average %lld/%lld ns)\n", analyzer->setupSum / 1e3,
+		analyzer->holdSum / 1e3, (long long)(analyzer->setupSum / all->frames), (long long)(analyzer->holdSum / all->frames));
+	if(analyzer->gaps)
+	{
+		fprintf(output, "gaps between bytes %.2f us(%llu gaps, %lld/%lld/%lld ns min/average/max)\n",
+			analyzer->gapSum / 1e3, (unsigned long long)analyzer->gaps, (long long)analyzer->gapMin,
+			(long long)(analyzer->gapSum / (int64_t)analyzer->gaps), (long long)analyzer->gapMax);
+	}
+	fprintf(output, "%u driver operations %.2f us, %.2f us per operation\n", analyzer->operations.frames,
+		analyzer->operations.time / 1e3, analyzer->operations.time / 1e3 / analyzer->operations.frames);
+	if(analyzer->incompleteFrames)
+		fprintf(output, "%u frames with incomplete byte\n", analyzer->incompleteFrames);
+
+	if(analyzer->annotator != NULL)
+	{
+		fprintf(output, "\n");
+		SpiAnnotatorReport(analyzer->annotator, output, 0);
+	}
+}
+
+//time from CSV in seconds to ns rounded to nearest, integer rounding doesn't need libm
+static int64_t SecondsToNs(double seconds)
+{
+	double ns = seconds * 1e9;
+
+	return (int64_t)((ns < 0) ? (ns - 0.5) : (ns + 0.5));
+}
+
+//parse CSV, return -1 when file can't be read or channel is missing
+static int AnalyzeFile(Analyzer* analyzer, FILE* file)
+{
+	char line[MAX_LINE];
+	int state[MAX_CHANNELS];
+	int previous[MAX_CHANNELS];
+	int needed = 0;
+	bool first = true;
+	const Settings* settings = &analyzer->settings;
+
+	needed = settings->mosi;
+	if(settings->miso > needed) needed = settings->miso;
+	if(settings->sck > needed) needed = settings->sck;
+	if(settings->cs > needed) needed = settings->cs;
+
+	while(fgets(line, sizeof(line), file))
+	{
+		char* p = line;
+		char* end;
+		double seconds;
+		int channels = 0;
+
+		seconds = strtod(p, &end);
+		//header line
+		if(end == p)
+			continue;
+		p = end;
+
+		while(channels < MAX_CHANNELS)
+		{
+			while(*p == ',' || *p == ' ' || *p == '\t')
+				p++;
+			state[channels] = strtol(p, &end, 10);
+			if(end == p)
+				break;
+			p = end;
+			channels++;
+		}
+		if(channels <= needed)
+			return -1;
+
+		//state before the first row is the same, only changes are analyzed
+		if(first)
+		{
+			memcpy(previous, state, sizeof(state));
+			first = false;
+			//capture started with CS low, frame start at the first row
+			if(!state[settings->cs])
+			{
+				previous[settings->cs] = 1;
+				AnalyzerRow(analyzer, SecondsToNs(seconds), state, previous);
+				previous[settings->cs] = 0;
+			}
+		}
+		else
+		{
+			AnalyzerRow(analyzer, SecondsToNs(seconds), state, previous);
+		}
+		memcpy(previous, state, sizeof(state));
+	}
+
+	return first ? -1 : 0;
+}
+
+//CSV writer of self check, changes at the same time are written in single row
+typedef struct
+{
+	FILE* file;
+	int64_t time;
+	int state[4];
+	bool pending;
+} CsvWriter;
+
+static void CsvFlush(CsvWriter* writer)
+{
+	if(writer->pending)
+	{
+		fprintf(writer->file, "%lld.%09lld, %d, %d, %d, %d\n", (long long)(writer->time / 1000000000),
+			(long long)(writer->time % 1000000000), writer->state[0], writer->state[1], writer->state[2], writer->state[3]);
+	}
+	writer->pending = false;
+}
+
+static void CsvSet(CsvWriter* writer, int64_t time, int channel, int value)
+{
+	if(writer->pending && time != writer->time)
+		CsvFlush(writer);
+	writer->time = time;
+	writer->state[channel] = value;
+	writer->pending = true;
+}
+
+typedef struct
+{
+	uint8_t mosi[32];
+	uint8_t miso[32];
+	uint16_t bytes;
+	//bits of the last incomplete byte
+	uint8_t bits;
+	int64_t setup;
+	int64_t hold;
+	int64_t gap;
+	int64_t gapStep;
+	//idle time before frame
+	int64_t idle;
+	const char* text;
+} CheckFrame;
+
+#define CHECK_HALF_PERIOD 100
+
+//channels like default settings: MOSI 0, CS 1, MISO 2, SCK 3
+static int64_t GenerateFrame(CsvWriter* writer, int mode, int64_t time, const CheckFrame* frame)
+{
+	bool cpol = mode >= 2;
+	bool cpha = mode & 1;
+	int64_t byteStart = time + frame->setup;
+	int64_t edge = 0;
+	int bits = frame->bytes * 8 + frame->bits;
+	int i;
+
+	CsvSet(writer, time, 1, 0);
+
+	for(i = 0; i < bits; i++)
+	{
+		int64_t lead = byteStart + 2 * (i % 8) * CHECK_HALF_PERIOD;
+		int mosi = (frame->mosi[i / 8] >> (7 - i % 8)) & 1;
+		int miso = (frame->miso[i / 8] >> (7 - i % 8)) & 1;
+
+		//data is changed between edges, sampled on the other edge
+		if(!cpha)
+		{
+			CsvSet(writer, lead - CHECK_HALF_PERIOD / 2, 0, mosi);
+			CsvSet(writer, lead - CHECK_HALF_PERIOD / 2, 2, miso);
+		}
+		CsvSet(writer, lead, 3, !cpol);
+		if(cpha)
+		{
+			CsvSet(writer, lead + CHECK_HALF_PERIOD / 2, 0, mosi);
+			CsvSet(writer, lead + CHECK_HALF_PERIOD / 2, 2, miso);
+		}
+		edge = lead + CHECK_HALF_PERIOD;
+		CsvSet(writer, edge, 3, cpol);
+
+		if(i % 8 == 7)
+			byteStart = edge + frame->gap + frame->gapStep * (i / 8);
+	}
+
+	CsvSet(writer, edge + frame->hold, 1, 1);
+
+	return edge + frame->hold;
+}
+
+static int CheckMode(int mode, const CheckFrame* frames, int count, int operations)
+{
+	static Analyzer analyzer;
+	static Frame history[16];
+	static SpiAnnotator annotator;
+	//register names, frame with incomplete byte is skipped
+	static const char* const Annotations[] = {
+		"  RESET\n", "  WRITE CiCON [4]\n", "  READ CiTXQSTA [4]\n", "  READ_CRC RAM+0x000 [8]\n",
+		"  WRITE_SAFE IOCON [4]\n", "  WRITE_CRC CiTXQCON [4]\n", "  not annotated\n"
+	};
+	Settings settings;
+	CsvWriter writer = {tmpfile(), 0, {0, 1, 0, 0}, false};
+	FILE* output = tmpfile();
+	char text[65536];
+	size_t length;
+	int64_t time = 1000000000;
+	int64_t setupSum = 0;
+	int64_t holdSum = 0;
+	int failed = 0;
+	int i, j;
+
+	if(writer.file == NULL || output == NULL)
+		return 1;
+
+	//idle state with CPOL
+	writer.state[3] = mode >= 2;
+	fprintf(writer.file, "Time[s], Channel 0, Channel 1, Channel 2, Channel 3\n");
+	CsvSet(&writer, 0, 3, mode >= 2);
+	for(i = 0; i < count; i++)
+	{
+		time = GenerateFrame(&writer, mode, time + frames[i].idle, &frames[i]);
+		setupSum += frames[i].setup;
+		holdSum += frames[i].hold;
+	}
+	CsvFlush(&writer);
+	rewind(writer.file);
+
+	SettingsReset(&settings);
+	settings.mode = mode;
+	settings.annotate = true;
+	AnalyzerInitialize(&analyzer, &settings, output);
+	analyzer.history = history;
+	analyzer.historySize = 16;
+	SpiAnnotatorInitialize(&annotator);
+	analyzer.annotator = &annotator;
+
+	if(AnalyzeFile(&analyzer, writer.file) != 0)
+	{
+		printf("mode %d: file wasn't analyzed\n", mode);
+		failed++;
+	}
+	AnalyzerFinish(&analyzer);
+	fclose(writer.file);
+
+	for(i = 0; i < count && i < (int)analyzer.historyFrames; i++)
+	{
+		const Frame* frame = &history[i];
+		int64_t gapSum = 0;
+
+		for(j = 0; j + 1 < frames[i].bytes; j++)
+			gapSum += frames[i].gap + frames[i].gapStep * j;
+
+		if(frame->bytes != frames[i].bytes || frame->bits != frames[i].bits
+			|| memcmp(frame->mosi, frames[i].mosi, frames[i].bytes) || memcmp(frame->miso, frames[i].miso, frames[i].bytes)
+			|| frame->firstEdge - frame->start != frames[i].setup || frame->end - frame->lastEdge != frames[i].hold
+			|| (frames[i].bytes > 1 && (frame->gapMin != frames[i].gap || frame->gapSum != gapSum
+			|| frame->gapMax != frames[i].gap + frames[i].gapStep * (frames[i].bytes - 2)))
+			|| FramePeriod(&analyzer, frame) - 2 * CHECK_HALF_PERIOD > 0.5
+			|| FramePeriod(&analyzer, frame) - 2 * CHECK_HALF_PERIOD < -0.5)
+		{
+			printf("mode %d: frame %d is wrong(%u bytes, %u bits, setup %lld, hold %lld, gap %lld/%lld)\n", mode, i,
+				frame->bytes, frame->bits, (long long)(frame->firstEdge - frame->start),
+				(long long)(frame->end - frame->lastEdge), (long long)frame->gapMin, (long long)frame->gapMax);
+			failed++;
+		}
+	}
+
+	if(analyzer.historyFrames != (uint32_t)count || analyzer.operations.frames != (uint32_t)operations
+		|| analyzer.incompleteFrames != 1 || analyzer.setupSum != setupSum || analyzer.holdSum != holdSum
+		|| annotator.transactions != (uint32_t)count - 1 || annotator.malformed)
+	{
+		printf("mode %d: %u frames, %u operations, %u incomplete\n", mode, analyzer.historyFrames,
+			analyzer.operations.frames, analyzer.incompleteFrames);
+		failed++;
+	}
+
+	//decoded instruction text
+	rewind(output);
+	length = fread(text, 1, sizeof(text) - 1, output);
+	text[length] = 0;
+	fclose(output);
+	for(i = 0; i < count; i++)
+	{
+		if(frames[i].text && strstr(text, frames[i].text) == NULL)
+		{
+			printf("mode %d: missing \"%s\"\n", mode, frames[i].text);
+			failed++;
+		}
+	}
+	for(i = 0; i < (int)(sizeof(Annotations) / sizeof(Annotations[0])); i++)
+	{
+		if(strstr(text, Annotations[i]) == NULL)
+		{
+			printf("mode %d: missing annotation \"%s\"\n", mode, Annotations[i]);
+			failed++;
+		}
+	}
+
+	printf("mode %d: %d frames, %u operations, %d failed\n", mode, count, analyzer.operations.frames, failed);
+
+	return failed;
+}
+
+int main(int argc, char** argv)
+{
+	static const CheckFrame Frames[] = {
+		{{0x00, 0x00}, {0xFF, 0xFF}, 2, 0, 500, 300, 1000, 0, 0, "RESET\n"},
+		{{0x20, 0x00, 0x11, 0x22, 0x33, 0x44}, {0}, 6, 0, 520, 310, 1000, 40, 100000,
+			"WRITE SFR 0x000 [4] 11 22 33 44\n"},
+		{{0x30, 0x54, 0, 0, 0, 0}, {0xFF, 0xFF, 0x2E, 0x05, 0x7C, 0x77}, 6, 0, 540, 320, 2000, 0, 5000,
+			"READ SFR 0x054 [4] 2E 05 7C 77\n"},
+		{{0xB4, 0x00, 0x08}, {0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 0xAB, 0xCD}, 13, 0, 560, 330, 200, 20, 100000,
+			"READ_CRC RAM 0x400 N 8 [8] 01 02 03 04 05 06 07 08 CRC ABCD\n"},
+		{{0xCE, 0x04, 0x03, 0x00, 0x00, 0x00, 0x12, 0x34}, {0}, 8, 0, 580, 340, 500, 0, 5000,
+			"WRITE_SAFE MCP 0xE04 [4] 03 00 00 00 CRC 1234\n"},
+		{{0xA0, 0x50, 0x04, 0x80, 0x00, 0x00, 0x00, 0x56, 0x78}, {0}, 9, 0, 600, 350, 100, 0, 5000,
+			"WRITE_CRC SFR 0x050 N 4 [4] 80 00 00 00 CRC 5678\n"},
+		{{0x30, 0x54, 0xF0}, {0}, 2, 4, 620, 360, 800, 0, 100000, "+4 bits"},
+	};
+	static Analyzer analyzer;
+	static SpiAnnotator annotator;
+	Settings settings;
+	FILE* file;
+	int failed = 0;
+	int mode;
+	int i;
+
+	if(argc > 1)
+	{
+		SettingsReset(&settings);
+
+		for(i = 1; i < argc - 1; i++)
+		{
+			if(strcmp(argv[i], "-q") == 0)
+				settings.quiet = true;
+			else if(strcmp(argv[i], "-a") == 0)
+				settings.annotate = true;
+			else if(i + 1 < argc - 1 && strcmp(argv[i], "-m") == 0)
+				settings.mosi = atoi(argv[++i]);
+			else if(i + 1 < argc - 1 && strcmp(argv[i], "-s") == 0)
+				settings.miso = atoi(argv[++i]);
+			else if(i + 1 < argc - 1 && strcmp(argv[i], "-c") == 0)
+				settings.sck = atoi(argv[++i]);
+			else if(i + 1 < argc - 1 && strcmp(argv[i], "-e") == 0)
+				settings.cs = atoi(argv[++i]);
+			else if(i + 1 < argc - 1 && strcmp(argv[i], "-M") == 0)
+				settings.mode = atoi(argv[++i]);
+			else if(i + 1 < argc - 1 && strcmp(argv[i], "-f") == 0)
+				settings.nominalFrequency = atof(argv[++i]);
+			else if(i + 1 < argc - 1 && strcmp(argv[i], "-g") == 0)
+				settings.groupGap = (int64_t)(atof(argv[++i]) * 1000);
+			else
+				break;
+		}
+
+		if(i != argc - 1 || settings.mode < 0 || settings.mode > 3 || settings.mosi < 0 || settings.mosi >= MAX_CHANNELS
+			|| settings.miso < 0 || settings.miso >= MAX_CHANNELS || settings.sck < 0 || settings.sck >= MAX_CHANNELS
+			|| settings.cs < 0 || settings.cs >= MAX_CHANNELS)
+		{
+			printf("Usage: SpiCaptureAnalyzer [-m n] [-s n] [-c n] [-e n] [-M mode] [-f Hz] [-g us] [-q] [-a] file.csv\n");
+			return -1;
+		}
+
+		file = fopen(argv[argc - 1], "r");
+		if(file == NULL)
+		{
+			printf("Can't open %s\n", argv[argc - 1]);
+			return 1;
+		}
+
+		AnalyzerInitialize(&analyzer, &settings, stdout);
+		if(settings.annotate)
+		{
+			SpiAnnotatorInitialize(&annotator);
+			analyzer.annotator = &annotator;
+		}
+		if(AnalyzeFile(&analyzer, file) != 0)
+		{
+			printf("%s doesn't contain selected channels\n", argv[argc - 1]);
+			failed = 1;
+		}
+		fclose(file);
+		AnalyzerFinish(&analyzer);
+
+		return failed || analyzer.incompleteFrames;
+	}
+
+	//frames with idle time 5us belong to the previous operation
+	for(mode = 0; mode < 4; mode++)
+		failed += CheckMode(mode, Frames, sizeof(Frames) / sizeof(Frames[0]), 4);
+
+	printf("%d failed\n", failed);
+
+	return failed;
+}
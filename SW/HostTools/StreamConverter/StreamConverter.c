@@ -0,0 +1,1009 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+* Converter of binary stream from CAN-UART gateway(CAN_GATEWAY_ENABLE in LPC82X example
+* project) to pcap or candump log, so captures can be opened in Wireshark or processed
+* by can-utils(canplayer, log2asc, ...).
+*
+* Stream can contain frame records, status records and capture blocks(decoded like in
+* GatewayDecoder). Status records aren't written. Frames after lost capture block are
+* skipped until the next reset record.
+*
+* pcap use LINKTYPE_CAN_SOCKETCAN(227): classic frame is 16 byte struct can_frame, FD
+* frame is 72 byte struct canfd_frame with CANFD_FDF, BRS and ESI flags. CAN ID is big
+* endian with CAN_EFF_FLAG and CAN_RTR_FLAG.
+*
+* Gateway time stamp(32 bit, 1us) wrap every 71 minutes, converter extend it to 64 bits
+* (difference between two frames is taken as signed 32 bit value) and add base time
+* given in seconds(e.g. Unix time of capture start).
+*
+* Input file is mapped into memory(mmap or MapViewOfFile), stdin and other files which
+* can't be mapped are read in 1MB blocks. Output is written in 1MB blocks, candump text
+* is formatted without printf. Time and throughput of conversion are printed to stderr.
+*
+* Without arguments tool run self check: synthetic stream with frame records, capture
+* blocks, status records, garbage and time stamp wrap is converted to pcap and candump,
+* result is parsed back and compared with sent frames(candump line with line printed by
+* printf). Conversion speed is printed at the end.
+*
+* Build(gcc or mingw):
+*	gcc -std=gnu99 -Wall -O2 -o StreamConverter StreamConverter.c
+*
+* Usage:
+*	StreamConverter -p|-c [-b seconds] [-i interface] input output
+*	  -p pcap, -c candump log, - is stdin or stdout
+*	  -b base time added to time stamps(default 0)
+*	  -i interface name in candump log(default can0)
+*
+* Linux example:
+*	StreamConverter -p -b $(date -d "2026-10-18 22:00" +%s) night.bin night.pcap
+*	StreamConverter -c night.bin - | grep " 18FEF1"
+*
+* Exit code is number of failed checks, in convert mode 1 when stream contain damaged
+* records or can't be read or written.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_frametime.c"
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_gateway.c"
+
+//decoder accept any dictionary size and history length sent by gateway
+#define CAN_CAPTURE_DICTIONARY_SIZE 32
+#define CAN_CAPTURE_HISTORY_BYTES 64
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_capture.c"
+
+#define IO_BLOCK_BYTES (1 << 20)
+
+#define PCAP_MAGIC 0xA1B2C3D4
+#define PCAP_LINKTYPE_CAN_SOCKETCAN 227
+#define PCAP_HEADER_BYTES 24
+#define PCAP_RECORD_HEADER_BYTES 16
+
+//struct can_frame and struct canfd_frame
+#define SOCKETCAN_EFF_FLAG 0x80000000
+#define SOCKETCAN_RTR_FLAG 0x40000000
+#define SOCKETCAN_BRS 0x01
+#define SOCKETCAN_ESI 0x02
+#define SOCKETCAN_FDF 0x04
+#define SOCKETCAN_HEADER_BYTES 8
+#define SOCKETCAN_CLASSIC_BYTES 16
+#define SOCKETCAN_FD_BYTES 72
+
+//the longest candump line: time, interface, extended ID, FD flags and 64 bytes
+#define CANDUMP_LINE_BYTES (40 + 64 + 9 + 3 + 128 + 1)
+
+#define CHECK_FRAMES 20000
+#define CHECK_BASE_TIME 1790000000u
+#define CHECK_LOST_BLOCK 21
+#define SPEED_STREAM_BYTES (64 << 20)
+
+typedef enum
+{
+	FORMAT_PCAP,
+	FORMAT_CANDUMP
+} OutputFormat;
+
+typedef struct
+{
+	FILE* file;
+	OutputFormat format;
+	const char* interface;
+	uint8_t buffer[IO_BLOCK_BYTES];
+	uint32_t used;
+	bool writeFailed;
+	//64 bit time in us
+	uint64_t time;
+	uint32_t lastTimeStamp;
+	bool started;
+	CAN_GATEWAY_DECODER decoder;
+	CAN_CAPTURE_CODER capture;
+	int sequence;
+	//statistics
+	uint64_t frames;
+	uint64_t statusRecords;
+	uint64_t captureBlocks;
+	uint64_t lostBlocks;
+	uint64_t captureErrors;
+} Converter;
+
+static const char HexDigits[] = "0123456789ABCDEF";
+
+static uint32_t RandomState = 1;
+
+static uint32_t Random(void)
+{
+	RandomState = RandomState * 1103515245 + 12345;
+	return RandomState >> 8;
+}
+
+static void OutputFlush(Converter* converter)
+{
+	if(converter->used && fwrite(converter->buffer, 1, converter->used, converter->file) != converter->used)
+		converter->writeFailed = true;
+	converter->used = 0;
+}
+
+//space for n bytes in output buffer
+static uint8_t* OutputReserve(Converter* converter, uint32_t n)
+{
+	if(converter->used + n > IO_BLOCK_BYTES)
+		OutputFlush(converter);
+	return &converter->buffer[converter->used];
+}
+
+static void PutBigEndian(uint8_t* buffer, uint32_t value)
+{
+	buffer[0] = value >> 24;
+	buffer[1] = value >> 16;
+	buffer[2] = value >> 8;
+	buffer[3] = value;
+}
+
+static void PutLittleEndian(uint8_t* buffer, uint32_t value)
+{
+	buffer[0] = value;
+	buffer[1] = value >> 8;
+	buffer[2] = value >> 16;
+	buffer[3] = value >> 24;
+}
+
+static void ConverterInitialize(Converter* converter, FILE* file, OutputFormat format, const char* interface,
+	uint64_t baseTime)
+{
+	converter->file = file;
+	converter->format = format;
+	converter->interface = interface;
+	converter->used = 0;
+	converter->writeFailed = false;
+	converter->time = baseTime * 1000000;
+	converter->lastTimeStamp = 0;
+	converter->started = false;
+	DRV_CANFDSPI_GatewayDecoderInitialize(&converter->decoder);
+	DRV_CANFDSPI_CaptureInitialize(&converter->capture, CAN_CAPTURE_DICTIONARY_SIZE, CAN_CAPTURE_HISTORY_BYTES);
+	converter->sequence = -1;
+	converter->frames = 0;
+	converter->statusRecords = 0;
+	converter->captureBlocks = 0;
+	converter->lostBlocks = 0;
+	converter->captureErrors = 0;
+
+	if(format == FORMAT_PCAP)
+	{
+		uint8_t* header = OutputReserve(converter, PCAP_HEADER_BYTES);
+
+		//little endian file, version 2.4, time zone 0, accuracy 0, snap length, link type
+		PutLittleEndian(&header[0], PCAP_MAGIC);
+		PutLittleEndian(&header[4], 2 | (4 << 16));
+		PutLittleEndian(&header[8], 0);
+		PutLittleEndian(&header[12], 0);
+		PutLittleEndian(&header[16], SOCKETCAN_FD_BYTES);
+		PutLittleEndian(&header[20], PCAP_LINKTYPE_CAN_SOCKETCAN);
+		converter->used += PCAP_HEADER_BYTES;
+	}
+}
+
+static void WritePcap(Converter* converter, const CAN_TX_MSGOBJ* obj, const uint8_t* data, uint8_t dataBytes)
+{
+	uint32_t frameBytes = obj->bF.ctrl.FDF ? SOCKETCAN_FD_BYTES : SOCKETCAN_CLASSIC_BYTES;
+	uint8_t* record = OutputReserve(converter, PCAP_RECORD_HEADER_BYTES + SOCKETCAN_FD_BYTES);
+	uint8_t* frame = &record[PCAP_RECORD_HEADER_BYTES];
+	uint32_t id;
+
+	PutLittleEndian(&record[0], converter->time / 1000000);
+	PutLittleEndian(&record[4], converter->time % 1000000);
+	PutLittleEndian(&record[8], frameBytes);
+	PutLittleEndian(&record[12], frameBytes);
+
+	if(obj->bF.ctrl.IDE)
+		id = ((uint32_t)obj->bF.id.SID << 18) | obj->bF.id.EID | SOCKETCAN_EFF_FLAG;
+	else
+		id = obj->bF.id.SID;
+
+	memset(frame, 0, frameBytes);
+	if(obj->bF.ctrl.FDF)
+	{
+		frame[5] = SOCKETCAN_FDF | (obj->bF.ctrl.BRS ? SOCKETCAN_BRS : 0) | (obj->bF.ctrl.ESI ? SOCKETCAN_ESI : 0);
+	}
+	else if(obj->bF.ctrl.RTR)
+	{
+		//remote frame has DLC but no payload
+		id |= SOCKETCAN_RTR_FLAG;
+		dataBytes = 0;
+	}
+	PutBigEndian(frame, id);
+	frame[4] = obj->bF.ctrl.FDF ? DRV_CANFDSPI_FrameDataBytes(true, (CAN_DLC)obj->bF.ctrl.DLC) : obj->bF.ctrl.DLC;
+	if(!obj->bF.ctrl.FDF && frame[4] > 8)
+		frame[4] = 8;
+	memcpy(&frame[SOCKETCAN_HEADER_BYTES], data, dataBytes);
+
+	converter->used += PCAP_RECORD_HEADER_BYTES + frameBytes;
+}
+
+static char* PutDecimal(char* text, uint64_t value, int digits)
+{
+	int i;
+
+	for(i = digits - 1; i >= 0; i--)
+	{
+		text[i] = '0' + value % 10;
+		value /= 10;
+	}
+	return text + digits;
+}
+
+static char* PutHex(char* text, uint32_t value, int digits)
+{
+	int i;
+
+	for(i = digits - 1; i >= 0; i--)
+	{
+		text[i] = HexDigits[value & 0xF];
+		value >>= 4;
+	}
+	return text + digits;
+}
+
+//candump -l format: (seconds.us) interface ID#data, ID#R or ID##<flags>data
+static void WriteCandump(Converter* converter, const CAN_TX_MSGOBJ* obj, const uint8_t* data, uint8_t dataBytes)
+{
+	char* start = (char*)OutputReserve(converter, CANDUMP_LINE_BYTES);
+	char* text = start;
+	uint64_t seconds = converter->time / 1000000;
+	const char* interface = converter->interface;
+	uint8_t i;
+
+	*text++ = '(';
+	text = PutDecimal(text, seconds, (seconds >= 10000000000ULL) ? 20 : 10);
+	*text++ = '.';
+	text = PutDecimal(text, converter->time % 1000000, 6);
+	*text++ = ')';
+	*text++ = ' ';
+	while(*interface)
+		*text++ = *interface++;
+	*text++ = ' ';
+
+	if(obj->bF.ctrl.IDE)
+		text = PutHex(text, ((uint32_t)obj->bF.id.SID << 18) | obj->bF.id.EID, 8);
+	else
+		text = PutHex(text, obj->bF.id.SID, 3);
+
+	*text++ = '#';
+	if(obj->bF.ctrl.FDF)
+	{
+		*text++ = '#';
+		*text++ = HexDigits[(obj->bF.ctrl.BRS ? 1 : 0) | (obj->bF.ctrl.ESI ? 2 : 0)];
+	}
+	else if(obj->bF.ctrl.RTR)
+	{
+		*text++ = 'R';
+		dataBytes = 0;
+	}
+
+	for(i = 0; i < dataBytes; i++)
+	{
+		*text++ = HexDigits[data[i] >> 4];
+		*text++ = HexDigits[data[i] & 0xF];
+	}
+	*text++ = '\n';
+
+	converter->used += text - start;
+}
+
+static void WriteFrame(Converter* converter, const uint32_t* header, uint32_t timeStamp, const uint8_t* data)
+{
+	CAN_TX_MSGOBJ obj;
+	uint8_t dataBytes;
+
+	//extend 32 bit time stamp, frames can be slightly out of order
+	if(converter->started)
+		converter->time += (int32_t)(timeStamp - converter->lastTimeStamp);
+	else
+		converter->time += timeStamp;
+	converter->lastTimeStamp = timeStamp;
+	converter->started = true;
+
+	obj.word[0] = header[0];
+	obj.word[1] = header[1];
+	dataBytes = DRV_CANFDSPI_FrameDataBytes(obj.bF.ctrl.FDF, (CAN_DLC)obj.bF.ctrl.DLC);
+
+	if(converter->format == FORMAT_PCAP)
+		WritePcap(converter, &obj, data, dataBytes);
+	else
+		WriteCandump(converter, &obj, data, dataBytes);
+
+	converter->frames++;
+}
+
+static void ConvertCapture(Converter* converter)
+{
+	const uint8_t* data;
+	uint8_t sequence;
+	uint8_t n;
+	uint16_t position = 0;
+	uint16_t used;
+	uint32_t header[2];
+	uint32_t timeStamp;
+	uint8_t payload[64];
+
+	if(DRV_CANFDSPI_GatewayDecodeCapture(&converter->decoder, &sequence, &data, &n) != 0)
+		return;
+
+	//records after lost block refer to dictionary state which decoder doesn't have
+	if(converter->sequence >= 0 && sequence != converter->sequence)
+	{
+		converter->lostBlocks += (uint8_t)(sequence - converter->sequence);
+		converter->capture.synchronized = false;
+	}
+	converter->sequence = (sequence + 1) & 0xFF;
+	converter->captureBlocks++;
+
+	while(position < n)
+	{
+		bool synchronized = converter->capture.synchronized;
+		int8_t result = DRV_CANFDSPI_CaptureDecode(&converter->capture, &data[position], n - position, &used,
+			header, &timeStamp, payload);
+
+		if(result < 0)
+		{
+			if(synchronized)
+				converter->captureErrors++;
+			break;
+		}
+
+		if(result == CAN_CAPTURE_FRAME)
+			WriteFrame(converter, header, timeStamp, payload);
+
+		position += used;
+	}
+}
+
+//CRC16 of whole byte
+static uint16_t CrcTable[256];
+
+static void CrcTableInitialize(void)
+{
+	uint8_t byte = 0;
+
+	do
+	{
+		CrcTable[byte] = DRV_CANFDSPI_GatewayCrc(0, &byte, 1);
+	}
+	while(++byte);
+}
+
+//whole record with valid CRC in buffer is copied to decoder without DRV_CANFDSPI_GatewayDecoderPut
+static bool ConvertFastRecord(Converter* converter, const uint8_t* record, size_t available)
+{
+	uint8_t length = record[1];
+	uint16_t crc = 0xFFFF;
+	uint16_t i;
+
+	if(length == 0 || length > CAN_GATEWAY_MAX_BODY_BYTES || available < (size_t)length + CAN_GATEWAY_OVERHEAD_BYTES)
+		return false;
+
+	for(i = 1; i < length + 2; i++)
+		crc = (crc << 8) ^ CrcTable[(crc >> 8) ^ record[i]];
+
+	if(record[length + 2] != (crc & 0xFF) || record[length + 3] != (crc >> 8))
+		return false;
+
+	memcpy(converter->decoder.body, &record[2], length);
+	converter->decoder.length = length;
+	converter->decoder.records++;
+
+	return true;
+}
+
+static void ConvertBuffer(Converter* converter, const uint8_t* stream, size_t length)
+{
+	uint32_t header[2];
+	uint32_t timeStamp;
+	uint8_t data[64];
+	size_t i;
+
+	if(CrcTable[1] == 0)
+		CrcTableInitialize();
+
+	for(i = 0; i < length; i++)
+	{
+		//damaged record and record split between two buffers go through decoder byte by byte
+		if(converter->decoder.state == CAN_GATEWAY_WAIT_SYNC && stream[i] == CAN_GATEWAY_SYNC
+			&& ConvertFastRecord(converter, &stream[i], length - i))
+		{
+			i += converter->decoder.length + CAN_GATEWAY_OVERHEAD_BYTES - 1;
+		}
+		else if(DRV_CANFDSPI_GatewayDecoderPut(&converter->decoder, stream[i]) != 1)
+		{
+			continue;
+		}
+
+		switch(converter->decoder.body[0])
+		{
+			case CAN_GATEWAY_RX_FRAME:
+			case CAN_GATEWAY_TX_FRAME:
+				if(DRV_CANFDSPI_GatewayDecodeFrame(&converter->decoder, header, &timeStamp, data) >= 0)
+					WriteFrame(converter, header, timeStamp, data);
+				break;
+
+			case CAN_GATEWAY_STATUS:
+				converter->statusRecords++;
+				break;
+
+			case CAN_GATEWAY_CAPTURE:
+				ConvertCapture(converter);
+				break;
+		}
+	}
+}
+
+//convert mapped file or file read in blocks, return -1 when file can't be read
+static int ConvertFile(Converter* converter, const char* name)
+{
+	static uint8_t block[IO_BLOCK_BYTES];
+	FILE* file;
+	size_t n;
+#ifdef _WIN32
+	HANDLE handle;
+	HANDLE mapping;
+	LARGE_INTEGER size = {.QuadPart = -1};
+	const uint8_t* stream;
+
+	if(strcmp(name, "-"))
+	{
+		handle = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if(handle == INVALID_HANDLE_VALUE)
+			return -1;
+
+		mapping = (GetFileSizeEx(handle, &size) && size.QuadPart > 0)
+			? CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+		stream = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+		if(stream != NULL)
+		{
+			ConvertBuffer(converter, stream, size.QuadPart);
+			UnmapViewOfFile(stream);
+		}
+		if(mapping)
+			CloseHandle(mapping);
+		CloseHandle(handle);
+		if(stream != NULL || size.QuadPart == 0)
+			return 0;
+	}
+#else
+	struct stat info;
+	void* stream;
+	int fd;
+
+	if(strcmp(name, "-"))
+	{
+		fd = open(name, O_RDONLY);
+		if(fd < 0)
+			return -1;
+
+		//regular file is mapped, pipe or device(e.g. serial port) is read
+		if(fstat(fd, &info) == 0 && S_ISREG(info.st_mode))
+		{
+			stream = (info.st_size > 0) ? mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+			if(stream != MAP_FAILED)
+			{
+				if(stream != NULL)
+				{
+					madvise(stream, info.st_size, MADV_SEQUENTIAL);
+					ConvertBuffer(converter, stream, info.st_size);
+					munmap(stream, info.st_size);
+				}
+				close(fd);
+				return 0;
+			}
+		}
+		close(fd);
+	}
+#endif
+
+	file = strcmp(name, "-") ? fopen(name, "rb") : stdin;
+	if(file == NULL)
+		return -1;
+
+	while((n = fread(block, 1, sizeof(block), file)) > 0)
+		ConvertBuffer(converter, block, n);
+
+	if(file != stdin)
+		fclose(file);
+
+	return 0;
+}
+
+static int Convert(OutputFormat format, uint64_t baseTime, const char* interface, const char* input, const char* output)
+{
+	static Converter converter;
+	FILE* file = strcmp(output, "-") ? fopen(output, "wb") : stdout;
+	clock_t start = clock();
+	double seconds;
+	int failed = 0;
+
+	if(file == NULL)
+	{
+		fprintf(stderr, "Can't create %s\n", output);
+		return 1;
+	}
+
+	ConverterInitialize(&converter, file, format, interface, baseTime);
+
+	if(ConvertFile(&converter, input) != 0)
+	{
+		fprintf(stderr, "Can't read %s\n", input);
+		failed = 1;
+	}
+
+	OutputFlush(&converter);
+	if(file != stdout && fclose(file) != 0)
+		converter.writeFailed = true;
+	if(converter.writeFailed)
+	{
+		fprintf(stderr, "Can't write %s\n", output);
+		failed = 1;
+	}
+
+	seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+	fprintf(stderr, "%llu frames, %u records, %u errors, %llu status, %llu capture blocks, %llu lost, %llu capture errors, %.2f s\n",
+		(unsigned long long)converter.frames, converter.decoder.records, converter.decoder.errors,
+		(unsigned long long)converter.statusRecords, (unsigned long long)converter.captureBlocks,
+		(unsigned long long)converter.lostBlocks, (unsigned long long)converter.captureErrors, seconds);
+
+	if(converter.decoder.errors || converter.lostBlocks || converter.captureErrors)
+		failed = 1;
+
+	return failed;
+}
+
+typedef struct
+{
+	CAN_TX_MSGOBJ obj;
+	uint32_t timeStamp;
+	//expected time in us, 32 bit time stamp extended independently from converter
+	uint64_t time;
+	uint8_t data[64];
+	//frames after lost capture block aren't converted
+	bool lost;
+} CheckFrame;
+
+static void RandomFrame(CheckFrame* frame)
+{
+	CAN_TX_MSGOBJ* obj = &frame->obj;
+	uint8_t i;
+
+	memset(obj, 0, sizeof(CAN_TX_MSGOBJ));
+	obj->bF.ctrl.IDE = Random() & 1;
+	obj->bF.id.SID = Random() & 0x7FF;
+	obj->bF.id.EID = obj->bF.ctrl.IDE ? Random() & 0x3FFFF : 0;
+	obj->bF.ctrl.FDF = Random() & 1;
+	obj->bF.ctrl.BRS = obj->bF.ctrl.FDF && (Random() & 1);
+	obj->bF.ctrl.ESI = obj->bF.ctrl.FDF && (Random() & 1);
+	obj->bF.ctrl.RTR = !obj->bF.ctrl.FDF && !(Random() % 8);
+	obj->bF.ctrl.DLC = Random() & 0xF;
+
+	for(i = 0; i < 64; i++)
+		frame->data[i] = Random();
+}
+
+static uint8_t CheckDataBytes(const CheckFrame* frame)
+{
+	return DRV_CANFDSPI_FrameDataBytes(frame->obj.bF.ctrl.FDF, (CAN_DLC)frame->obj.bF.ctrl.DLC);
+}
+
+//first half in frame records with status records and garbage, second half in capture blocks
+//with one lost block, frames are sometimes slightly out of order
+static size_t BuildCheckStream(uint8_t* stream, CheckFrame* frames, int count)
+{
+	static const CAN_GATEWAY_STATUS_INFO Status = {0, 0, 0, 1, 2, 3};
+	CAN_CAPTURE_CODER encoder;
+	uint8_t block[CAN_GATEWAY_MAX_RECORD_BYTES];
+	uint8_t* blockData = &block[CAN_GATEWAY_CAPTURE_DATA_OFFSET];
+	uint8_t blockBytes = 0;
+	uint8_t sequence = 0;
+	int blocks = 0;
+	uint32_t timeStamp = 0xFFF00000;
+	size_t length = 0;
+	int i, j;
+
+	DRV_CANFDSPI_CaptureInitialize(&encoder, 32, 8);
+
+	for(i = 0; i < count; i++)
+	{
+		int32_t step = (Random() % 32) ? (int32_t)(Random() % 10000) : -(int32_t)(Random() % 100);
+
+		timeStamp += step;
+		RandomFrame(&frames[i]);
+		frames[i].timeStamp = timeStamp;
+		frames[i].time = i ? frames[i - 1].time + step : (uint64_t)CHECK_BASE_TIME * 1000000 + timeStamp;
+		frames[i].lost = false;
+
+		if(i < count / 2)
+		{
+			length += DRV_CANFDSPI_GatewayEncodeFrame(&stream[length], CAN_GATEWAY_RX_FRAME, frames[i].obj.word,
+				timeStamp, frames[i].data);
+			if(i % 100 == 99)
+				length += DRV_CANFDSPI_GatewayEncodeStatus(&stream[length], &Status);
+			for(j = Random() % 4; j > 0; j--)
+			{
+				stream[length] = Random();
+				if(stream[length] != CAN_GATEWAY_SYNC)
+					length++;
+			}
+			continue;
+		}
+
+		//identifiers repeat, so dictionary hits are also converted
+		if(i > count / 2 && (Random() & 1))
+		{
+			frames[i].obj = frames[i - 1 - Random() % 16].obj;
+			memcpy(frames[i].data, frames[i - 1].data, 64);
+			frames[i].data[Random() % 8] ^= 0x11;
+		}
+
+		for(;;)
+		{
+			if(blockBytes == 0 && sequence % 16 == 0)
+				blockBytes = DRV_CANFDSPI_CaptureEncodeReset(&encoder, blockData, timeStamp);
+			if(blockBytes + CAN_CAPTURE_FRAME_BYTES(CheckDataBytes(&frames[i])) <= CAN_GATEWAY_CAPTURE_DATA_BYTES)
+				break;
+			if(blocks++ == CHECK_LOST_BLOCK)
+			{
+				sequence++;
+			}
+			else
+			{
+				memcpy(&stream[length], block, DRV_CANFDSPI_GatewayEncodeCapture(block, sequence++, blockBytes));
+				length += blockBytes + CAN_GATEWAY_OVERHEAD_BYTES + 2;
+			}
+			blockBytes = 0;
+		}
+		blockBytes += DRV_CANFDSPI_CaptureEncodeFrame(&encoder, &blockData[blockBytes], frames[i].obj.word,
+			timeStamp, frames[i].data);
+		//the next reset record start block aligned to 16
+		frames[i].lost = (blocks >= CHECK_LOST_BLOCK && blocks < (CHECK_LOST_BLOCK | 15) + 1);
+	}
+
+	if(blockBytes)
+	{
+		memcpy(&stream[length], block, DRV_CANFDSPI_GatewayEncodeCapture(block, sequence, blockBytes));
+		length += blockBytes + CAN_GATEWAY_OVERHEAD_BYTES + 2;
+	}
+
+	return length;
+}
+
+static uint32_t GetLittleEndian(const uint8_t* buffer)
+{
+	return buffer[0] | ((uint32_t)buffer[1] << 8) | ((uint32_t)buffer[2] << 16) | ((uint32_t)buffer[3] << 24);
+}
+
+static uint8_t* ConvertCheck(OutputFormat format, const uint8_t* stream, size_t length, bool chunks, long* outputBytes)
+{
+	static Converter converter;
+	FILE* file = tmpfile();
+	uint8_t* output;
+	size_t position = 0;
+
+	if(file == NULL)
+		return NULL;
+
+	ConverterInitialize(&converter, file, format, "can0", CHECK_BASE_TIME);
+
+	//random split of stream like blocks read from pipe
+	while(position < length)
+	{
+		size_t n = chunks ? 1 + Random() % 300 : length;
+
+		if(n > length - position)
+			n = length - position;
+		ConvertBuffer(&converter, &stream[position], n);
+		position += n;
+	}
+	OutputFlush(&converter);
+
+	*outputBytes = ftell(file);
+	output = malloc(*outputBytes + 1);
+	rewind(file);
+	if(output == NULL || fread(output, 1, *outputBytes, file) != (size_t)*outputBytes || converter.writeFailed
+		|| converter.decoder.errors || converter.lostBlocks != 1 || converter.captureErrors)
+	{
+		free(output);
+		output = NULL;
+	}
+	fclose(file);
+
+	return output;
+}
+
+static int CheckPcap(const uint8_t* stream, size_t length, const CheckFrame* frames, int count)
+{
+	long outputBytes;
+	long chunkedBytes;
+	uint8_t* output = ConvertCheck(FORMAT_PCAP, stream, length, false, &outputBytes);
+	uint8_t* chunked = ConvertCheck(FORMAT_PCAP, stream, length, true, &chunkedBytes);
+	long position = PCAP_HEADER_BYTES;
+	int failed = 0;
+	int i;
+
+	if(output == NULL || chunked == NULL)
+	{
+		printf("pcap: conversion failed\n");
+		free(output);
+		free(chunked);
+		return 1;
+	}
+
+	if(GetLittleEndian(&output[0]) != PCAP_MAGIC || GetLittleEndian(&output[4]) != 0x00040002
+		|| GetLittleEndian(&output[20]) != PCAP_LINKTYPE_CAN_SOCKETCAN)
+	{
+		printf("pcap: wrong file header\n");
+		failed++;
+	}
+
+	for(i = 0; i < count && position + PCAP_RECORD_HEADER_BYTES <= outputBytes; i++)
+	{
+		const CAN_TX_MSGOBJ* obj = &frames[i].obj;
+		const uint8_t* record = &output[position];
+		const uint8_t* frame = &record[PCAP_RECORD_HEADER_BYTES];
+		uint64_t time = frames[i].time;
+		uint32_t frameBytes = obj->bF.ctrl.FDF ? SOCKETCAN_FD_BYTES : SOCKETCAN_CLASSIC_BYTES;
+		uint32_t id = obj->bF.ctrl.IDE ? (((uint32_t)obj->bF.id.SID << 18) | obj->bF.id.EID | SOCKETCAN_EFF_FLAG)
+			: obj->bF.id.SID;
+		uint8_t dataBytes = CheckDataBytes(&frames[i]);
+		uint8_t len = obj->bF.ctrl.FDF ? dataBytes : (obj->bF.ctrl.DLC > 8 ? 8 : obj->bF.ctrl.DLC);
+		uint8_t flags = obj->bF.ctrl.FDF ? (SOCKETCAN_FDF | obj->bF.ctrl.BRS | (obj->bF.ctrl.ESI << 1)) : 0;
+		uint8_t expected[SOCKETCAN_FD_BYTES] = {0};
+
+		if(frames[i].lost)
+			continue;
+
+		if(obj->bF.ctrl.RTR && !obj->bF.ctrl.FDF)
+		{
+			id |= SOCKETCAN_RTR_FLAG;
+			dataBytes = 0;
+		}
+		expected[0] = id >> 24;
+		expected[1] = id >> 16;
+		expected[2] = id >> 8;
+		expected[3] = id;
+		expected[4] = len;
+		expected[5] = flags;
+		memcpy(&expected[SOCKETCAN_HEADER_BYTES], frames[i].data, dataBytes);
+
+		if(GetLittleEndian(&record[0]) != time / 1000000 || GetLittleEndian(&record[4]) != time % 1000000
+			|| GetLittleEndian(&record[8]) != frameBytes || GetLittleEndian(&record[12]) != frameBytes
+			|| position + PCAP_RECORD_HEADER_BYTES + frameBytes > outputBytes || memcmp(frame, expected, frameBytes))
+		{
+			if(failed++ < 5)
+				printf("pcap: frame %d with word1 %08X is wrong\n", i, obj->word[1]);
+		}
+
+		position += PCAP_RECORD_HEADER_BYTES + frameBytes;
+	}
+
+	if(i != count || position != outputBytes)
+	{
+		printf("pcap: %d of %d frames, %ld of %ld bytes\n", i, count, position, outputBytes);
+		failed++;
+	}
+
+	if(chunkedBytes != outputBytes || memcmp(output, chunked, outputBytes))
+	{
+		printf("pcap: output of stream split into blocks is different\n");
+		failed++;
+	}
+
+	printf("pcap: %d frames, %ld bytes, %d failed\n", count, outputBytes, failed);
+
+	free(output);
+	free(chunked);
+
+	return failed;
+}
+
+static int CheckCandump(const uint8_t* stream, size_t length, const CheckFrame* frames, int count)
+{
+	long outputBytes;
+	uint8_t* output = ConvertCheck(FORMAT_CANDUMP, stream, length, false, &outputBytes);
+	char* line;
+	char expected[CANDUMP_LINE_BYTES];
+	int failed = 0;
+	int i;
+
+	if(output == NULL)
+	{
+		printf("candump: conversion failed\n");
+		return 1;
+	}
+
+	output[outputBytes] = 0;
+	line = (char*)output;
+
+	for(i = 0; i < count && *line; i++)
+	{
+		const CAN_TX_MSGOBJ* obj = &frames[i].obj;
+		uint64_t time = frames[i].time;
+		char* end = strchr(line, '\n');
+		int n;
+		uint8_t j;
+
+		if(frames[i].lost)
+			continue;
+
+		n = sprintf(expected, "(%010llu.%06u) can0 ", (unsigned long long)(time / 1000000), (uint32_t)(time % 1000000));
+		if(obj->bF.ctrl.IDE)
+			n += sprintf(&expected[n], "%08X", ((uint32_t)obj->bF.id.SID << 18) | obj->bF.id.EID);
+		else
+			n += sprintf(&expected[n], "%03X", obj->bF.id.SID);
+
+		if(obj->bF.ctrl.FDF)
+			n += sprintf(&expected[n], "##%X", obj->bF.ctrl.BRS | (obj->bF.ctrl.ESI << 1));
+		else
+			n += sprintf(&expected[n], obj->bF.ctrl.RTR ? "#R" : "#");
+
+		if(obj->bF.ctrl.FDF || !obj->bF.ctrl.RTR)
+		{
+			for(j = 0; j < CheckDataBytes(&frames[i]); j++)
+				n += sprintf(&expected[n], "%02X", frames[i].data[j]);
+		}
+
+		if(end == NULL || end - line != n || memcmp(line, expected, n))
+		{
+			if(failed++ < 5)
+				printf("candump: line %d\n  %.*s\n  %s\n", i, end ? (int)(end - line) : 0, line, expected);
+			if(end == NULL)
+				break;
+		}
+		line = end + 1;
+	}
+
+	if(i != count || *line)
+	{
+		printf("candump: %d of %d lines\n", i, count);
+		failed++;
+	}
+
+	printf("candump: %d lines, %ld bytes, %d failed\n", count, outputBytes, failed);
+
+	free(output);
+
+	return failed;
+}
+
+//conversion speed of frame records without disk
+static void PrintSpeed(const uint8_t* stream, size_t length)
+{
+	static Converter converter;
+	uint8_t* big = malloc(SPEED_STREAM_BYTES);
+	FILE* null;
+	size_t n = 0;
+	int format;
+
+#ifdef _WIN32
+	null = fopen("NUL", "wb");
+#else
+	null = fopen("/dev/null", "wb");
+#endif
+	if(big == NULL || null == NULL)
+	{
+		free(big);
+		return;
+	}
+
+	while(n + length <= SPEED_STREAM_BYTES)
+	{
+		memcpy(&big[n], stream, length);
+		n += length;
+	}
+
+	for(format = FORMAT_PCAP; format <= FORMAT_CANDUMP; format++)
+	{
+		clock_t start = clock();
+		double seconds;
+
+		ConverterInitialize(&converter, null, (OutputFormat)format, "can0", 0);
+		ConvertBuffer(&converter, big, n);
+		OutputFlush(&converter);
+		seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+		printf("speed %-7s %llu MB of frame records, %.0f MB/s, %.0f frames/s\n", format == FORMAT_PCAP ? "pcap" : "candump",
+			(unsigned long long)(n >> 20), (n >> 20) / seconds, converter.frames / seconds);
+	}
+
+	fclose(null);
+	free(big);
+}
+
+int main(int argc, char** argv)
+{
+	static CheckFrame frames[CHECK_FRAMES];
+	static uint8_t stream[CHECK_FRAMES * (CAN_GATEWAY_MAX_FRAME_RECORD_BYTES + 8)];
+	OutputFormat format = FORMAT_PCAP;
+	const char* interface = "can0";
+	uint64_t baseTime = 0;
+	bool formatSet = false;
+	size_t length;
+	int failed = 0;
+	int i;
+
+	if(argc > 1)
+	{
+		for(i = 1; i < argc - 2; i++)
+		{
+			if(strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "-c") == 0)
+			{
+				format = (argv[i][1] == 'p') ? FORMAT_PCAP : FORMAT_CANDUMP;
+				formatSet = true;
+			}
+			else if(strcmp(argv[i], "-b") == 0 && i + 1 < argc - 2)
+			{
+				baseTime = strtoull(argv[++i], NULL, 10);
+			}
+			else if(strcmp(argv[i], "-i") == 0 && i + 1 < argc - 2)
+			{
+				interface = argv[++i];
+				if(strlen(interface) > 16)
+					break;
+			}
+			else
+			{
+				break;
+			}
+		}
+
+		if(!formatSet || i != argc - 2)
+		{
+			printf("Usage: StreamConverter -p|-c [-b seconds] [-i interface] input output\n");
+			return -1;
+		}
+
+		return Convert(format, baseTime, interface, argv[argc - 2], argv[argc - 1]);
+	}
+
+	length = BuildCheckStream(stream, frames, CHECK_FRAMES);
+
+	failed += CheckPcap(stream, length, frames, CHECK_FRAMES);
+	failed += CheckCandump(stream, length, frames, CHECK_FRAMES);
+	PrintSpeed(stream, length / 2);
+
+	printf("%d failed\n", failed);
+
+	return failed;
+}
@@ -0,0 +1,312 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+* Host tool which run TDC calibration from drv_canfdspi_tdc.c against simulated
+* MCP2517FD connected by fake DRV_SPI_TransferData.
+*
+* Simulated chip keep all registers and RAM in memory and emulate only things used by
+* calibration: operation mode change, TX FIFO status, TXREQ/UINC/FRESET, transmit error
+* counter and TDCV. When TXREQ is set frame is "transmitted" and TDCV is set to synthetic
+* loop delay(base delay + random jitter). Frame fail and TEC is incremented when data
+* bit time is shorter than limit of simulated transceiver.
+*
+* Every scenario has expected result of calibration and tool print PASS or FAIL. After
+* successful calibration profile is applied and written registers are printed.
+*
+* Build(gcc or mingw):
+*	gcc -std=gnu99 -Wall -o TdcCalibrationSimulator TdcCalibrationSimulator.c
+*
+* Usage:
+*	TdcCalibrationSimulator [seed]
+*
+* Exit code is number of failed scenarios.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_api.c"
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_bittime.c"
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_tdc.c"
+
+#define SIM_TX_CHANNEL CAN_FIFO_CH2
+
+typedef struct
+{
+	const char* name;
+	uint32_t sysClk;
+	//loop delay in ns and random jitter added to every frame
+	uint32_t loopDelay;
+	uint32_t jitter;
+	//the shortest data bit which transceiver can transmit
+	uint32_t minBitTime;
+	//expected result of DRV_CANFDSPI_TdcCalibrate and profile bit rate
+	int8_t expectedResult;
+	uint32_t expectedBitRate;
+} SIM_SCENARIO;
+
+static const SIM_SCENARIO Scenarios[] = {
+	{"opto board, MCP2562FD 5Mbps", 40000000, 200, 50, 200, 0, 5000000},
+	{"opto board, big jitter", 40000000, 200, 125, 125, 0, 2000000},
+	{"no opto, 8Mbps transceiver", 40000000, 120, 25, 125, 0, 8000000},
+	{"10MHz SYSCLK", 10000000, 243, 0, 125, 0, 2000000},
+	{"loop delay out of TDCV range", 40000000, 1700, 0, 125, -1, 0},
+};
+
+static const uint32_t DataBitRates[] = {1000000, 2000000, 4000000, 5000000, 8000000};
+
+static const SIM_SCENARIO* SimScenario;
+static uint8_t SimMemory[0x1000];
+static uint32_t SimFramesSent;
+
+static uint32_t SimDataBitTime(void)
+{
+	REG_CiDBTCFG dbtcfg;
+	uint32_t clocks;
+
+	memcpy(&dbtcfg.word, &SimMemory[cREGADDR_CiDBTCFG], 4);
+	clocks = (dbtcfg.bF.BRP + 1) * (dbtcfg.bF.TSEG1 + dbtcfg.bF.TSEG2 + 3);
+
+	return (uint32_t)(((uint64_t)clocks * 1000000000u) / SimScenario->sysClk);
+}
+
+static void SimTransmit(uint16_t fifoCon)
+{
+	uint16_t fifoSta = fifoCon + 4;
+	uint32_t delay = SimScenario->loopDelay;
+	uint32_t tdcv;
+
+	if(SimScenario->jitter)
+	{
+		delay += rand() % (SimScenario->jitter + 1);
+	}
+
+	//TDCV is measured in SYSCLK periods and saturate on 63
+	tdcv = (uint32_t)(((uint64_t)delay * SimScenario->sysClk + 500000000u) / 1000000000u);
+	if(tdcv > 63)
+	{
+		tdcv = 63;
+	}
+	SimMemory[cREGADDR_CiTDC] = (SimMemory[cREGADDR_CiTDC] & 0xC0) | tdcv;
+
+	if(SimDataBitTime() < SimScenario->minBitTime)
+	{
+		//frame stay in FIFO and every attempt increment TEC
+		SimMemory[cREGADDR_CiTREC + 1] += 8;
+		return;
+	}
+
+	SimFramesSent++;
+	SimMemory[fifoCon + 1] &= ~0x02;
+	SimMemory[fifoSta] |= CAN_TX_FIFO_EMPTY_EVENT | CAN_TX_FIFO_NOT_FULL_EVENT;
+	if(SimMemory[cREGADDR_CiTREC + 1])
+	{
+		SimMemory[cREGADDR_CiTREC + 1]--;
+	}
+}
+
+static void SimWrite(uint16_t address, uint8_t value)
+{
+	uint16_t fifoCon = cREGADDR_CiFIFOCON + (SIM_TX_CHANNEL * CiFIFO_OFFSET);
+
+	SimMemory[address] = value;
+
+	if(address == cREGADDR_CiCON + 3)
+	{
+		//REQOP is copied to OPMOD immediately
+		SimMemory[cREGADDR_CiCON + 2] = (SimMemory[cREGADDR_CiCON + 2] & 0x1F) | ((value & 0x07) << 5);
+	}
+	else if(address == fifoCon + 1)
+	{
+		if(value & 0x04)
+		{
+			//FRESET
+			SimMemory[fifoCon + 4] = CAN_TX_FIFO_EMPTY_EVENT | CAN_TX_FIFO_NOT_FULL_EVENT;
+			SimMemory[address] = 0;
+		}
+		else
+		{
+			if(value & 0x01)
+			{
+				//UINC
+				SimMemory[fifoCon + 4] &= ~CAN_TX_FIFO_EMPTY_EVENT;
+				SimMemory[address] &= ~0x01;
+			}
+			if(value & 0x02)
+			{
+				SimTransmit(fifoCon);
+			}
+		}
+	}
+}
+
+static void SimReset(void)
+{
+	uint16_t fifoCon = cREGADDR_CiFIFOCON + (SIM_TX_CHANNEL * CiFIFO_OFFSET);
+
+	memset(SimMemory, 0, sizeof(SimMemory));
+	memcpy(SimMemory, canControlResetValues, sizeof(canControlResetValues));
+
+	//configuration mode, TX FIFO enabled and empty
+	SimMemory[cREGADDR_CiCON + 2] = CAN_CONFIGURATION_MODE << 5;
+	SimMemory[fifoCon] = 0x80;
+	SimMemory[fifoCon + 4] = CAN_TX_FIFO_EMPTY_EVENT | CAN_TX_FIFO_NOT_FULL_EVENT;
+	SimFramesSent = 0;
+}
+
+int8_t DRV_SPI_TransferData(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxData, uint8_t *SpiRxData, uint16_t spiTransferSize)
+{
+	uint16_t address = ((SpiTxData[0] & 0xF) << 8) | SpiTxData[1];
+	uint16_t i;
+
+	(void)spiSlaveDeviceIndex;
+	memset(SpiRxData, 0, spiTransferSize);
+
+	switch(SpiTxData[0] >> 4)
+	{
+	case cINSTRUCTION_RESET:
+		SimReset();
+		break;
+
+	case cINSTRUCTION_READ:
+		for(i = 2; i < spiTransferSize; i++)
+		{
+			SpiRxData[i] = SimMemory[(address + i - 2) & 0xFFF];
+		}
+		break;
+
+	case cINSTRUCTION_WRITE:
+		for(i = 2; i < spiTransferSize; i++)
+		{
+			SimWrite((address + i - 2) & 0xFFF, SpiTxData[i]);
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+int8_t DRV_SPI_TransferFill(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxHeader, uint16_t spiHeaderSize, uint8_t fillByte, uint16_t spiFillSize)
+{
+	uint16_t address = ((SpiTxHeader[0] & 0xF) << 8) | SpiTxHeader[1];
+	uint16_t i;
+
+	(void)spiSlaveDeviceIndex;
+	(void)spiHeaderSize;
+
+	//only RAM initialization use fill transfer
+	for(i = 0; i < spiFillSize; i++)
+	{
+		SimWrite((address + i) & 0xFFF, fillByte);
+	}
+
+	return 0;
+}
+
+static void PrintProfile(const CAN_TDC_PROFILE* profile)
+{
+	printf("  profile: data %u bps, TDCV min %u max %u mean %u, TDCO %u, data SP %u.%u%%, crc 0x%04X\n",
+			profile->dataBitRate, profile->tdcvMin, profile->tdcvMax, profile->tdcvMean,
+			profile->tdcOffset, profile->dataSamplePoint / 10, profile->dataSamplePoint % 10, profile->crc);
+}
+
+static int RunScenario(const SIM_SCENARIO* scenario)
+{
+	CAN_TDC_CALIBRATION_CONFIG calibrationConfig;
+	CAN_BITTIME_SOLVER_CONFIG bitTimeConfig;
+	CAN_TDC_PROFILE profile;
+	uint32_t registers[3];
+	int8_t result;
+	int8_t applyResult;
+
+	SimScenario = scenario;
+	DRV_CANFDSPI_Reset(DRV_CANFDSPI_INDEX_0);
+
+	DRV_CANFDSPI_TdcCalibrationConfigObjectReset(&calibrationConfig);
+	calibrationConfig.txChannel = SIM_TX_CHANNEL;
+
+	DRV_CANFDSPI_BitTimeSolverConfigObjectReset(&bitTimeConfig);
+	bitTimeConfig.sysClk = scenario->sysClk;
+	bitTimeConfig.loopDelay = CAN_BITTIME_LOOP_DELAY_OPTO;
+
+	memset(&profile, 0, sizeof(profile));
+	result = DRV_CANFDSPI_TdcCalibrate(DRV_CANFDSPI_INDEX_0, &calibrationConfig, &bitTimeConfig,
+			DataBitRates, sizeof(DataBitRates) / sizeof(DataBitRates[0]), &profile);
+
+	printf("%s: loop delay %uns + 0..%uns, result %d, %u frames sent\n", scenario->name,
+			scenario->loopDelay, scenario->jitter, result, SimFramesSent);
+
+	if(result == 0)
+	{
+		PrintProfile(&profile);
+
+		//profile applied after reset as during init
+		DRV_CANFDSPI_Reset(DRV_CANFDSPI_INDEX_0);
+		applyResult = DRV_CANFDSPI_TdcProfileApply(DRV_CANFDSPI_INDEX_0, &profile, &bitTimeConfig);
+		memcpy(registers, &SimMemory[cREGADDR_CiNBTCFG], sizeof(registers));
+		printf("  apply %d: NBTCFG 0x%08X DBTCFG 0x%08X TDC 0x%08X\n", applyResult,
+				registers[0], registers[1], registers[2]);
+
+		//damaged profile must be rejected
+		profile.tdcOffset ^= 1;
+		if(DRV_CANFDSPI_TdcProfileIsValid(&profile) || applyResult != 0)
+		{
+			printf("  FAIL profile check\n");
+			return 1;
+		}
+	}
+
+	if(result != scenario->expectedResult || (result == 0 && profile.dataBitRate != scenario->expectedBitRate))
+	{
+		printf("  FAIL expected result %d, data %u bps\n", scenario->expectedResult, scenario->expectedBitRate);
+		return 1;
+	}
+
+	printf("  PASS\n");
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	int failed = 0;
+	uint32_t i;
+
+	srand((argc > 1) ? strtoul(argv[1], NULL, 0) : 1);
+
+	for(i = 0; i < sizeof(Scenarios) / sizeof(Scenarios[0]); i++)
+	{
+		failed += RunScenario(&Scenarios[i]);
+	}
+
+	printf("%d failed\n", failed);
+
+	return failed;
+}
@@ -0,0 +1,480 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+* Host benchmark of transmit priority engine from drv_canfdspi_txprio.c. Engine is
+* connected by fake DRV_SPI_TransferData to simulated MCP2517FD which emulate TX FIFOs
+* (UINC, TXREQ, FRESET, FIFO index, user address) and CAN bus. Simulated time is moved
+* by every SPI transfer(overhead + SPI clock) and by application idle time. When bus is
+* free frame from FIFO with the highest TXPRI(the lowest channel for equal priority) is
+* transmitted, frame time is calculated by DRV_CANFDSPI_FrameTimeWorstCase for CAN FD
+* frame with bit rate switch.
+*
+* Application transmit urgent 8 byte frame every period and keep bulk 64 byte FIFO
+* full, so bus is saturated. Every scenario is run for different bulk FIFO depth:
+* - single FIFO: urgent and bulk frames are loaded to the same FIFO,
+* - priority engine: urgent FIFO with TXPRI 31 and bulk FIFO with TXPRI 1.
+* Latency is time from moment when urgent frame should be sent to end of its frame
+* on bus. With priority engine maximal latency should not depend on bulk FIFO depth
+* and should be below one bulk frame + one urgent frame + poll time.
+*
+* Build(gcc or mingw):
+*	gcc -std=gnu99 -Wall -o TxPriorityBenchmark TxPriorityBenchmark.c
+*
+* Usage:
+*	TxPriorityBenchmark [nominalBitRate dataBitRate]
+*
+* Exit code is number of failed checks.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_api.c"
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_txprio.c"
+#include "../../MCP2517FD_ExampleFor_LPC82X/driver/canfdspi/drv_canfdspi_frametime.c"
+
+//SPI transfer cost: CS and driver overhead and 4MHz SPI clock
+#define SPI_TRANSFER_OVERHEAD_NS 3000
+#define SPI_BYTE_NS 2000
+
+//application idle time when bulk FIFO is full
+#define APP_POLL_NS 20000
+
+//simulated time of every run and period of urgent frames
+#define SIM_DURATION_NS 2000000000ull
+#define URGENT_PERIOD_NS 1000000ull
+
+#define URGENT_ID 0x010
+#define BULK_ID 0x500
+#define MAX_URGENT_FRAMES 4096
+
+typedef struct
+{
+	//software state of simulated FIFO
+	uint8_t head;
+	uint8_t tail;
+	uint8_t level;
+	uint64_t loadTime[32];
+} SIM_FIFO;
+
+static uint8_t SimMemory[0x1000];
+static SIM_FIFO SimFifos[CAN_FIFO_TOTAL_CHANNELS];
+static uint64_t SimTime;
+static uint64_t SimBusFree;
+static uint64_t SimBusBusyTime;
+static uint32_t NominalBitRate = 500000;
+static uint32_t DataBitRate = 2000000;
+static CAN_FRAMETIME FrameTime;
+
+static uint64_t UrgentDueTime[MAX_URGENT_FRAMES];
+static uint64_t LatencyMin, LatencyMax, LatencySum;
+static uint32_t UrgentSent, BulkSent;
+
+static uint32_t FifoConWord(uint8_t channel)
+{
+	uint32_t word;
+
+	memcpy(&word, &SimMemory[cREGADDR_CiFIFOCON + channel * CiFIFO_OFFSET], 4);
+	return word;
+}
+
+static uint8_t FifoDepth(uint8_t channel)
+{
+	return ((FifoConWord(channel) >> 24) & 0x1F) + 1;
+}
+
+static uint16_t FifoObjBytes(uint8_t channel)
+{
+	static const uint8_t PayLoad[] = {8, 12, 16, 20, 24, 32, 48, 64};
+
+	return 8 + PayLoad[FifoConWord(channel) >> 29];
+}
+
+//RAM offset of FIFO, TXQ is disabled and TEF isn't used
+static uint16_t FifoBase(uint8_t channel)
+{
+	uint16_t base = 0;
+	uint8_t i;
+
+	for(i = 1; i < channel; i++)
+	{
+		base += FifoDepth(i) * FifoObjBytes(i);
+	}
+
+	return base;
+}
+
+//Frame time of CAN FD frame with BRS and worse case stuffing
+static uint64_t FrameTimeNs(CAN_DLC dlc)
+{
+	return DRV_CANFDSPI_FrameTimeWorstCase(&FrameTime, false, true, true, dlc);
+}
+
+static void FrameDone(uint8_t channel)
+{
+	SIM_FIFO* fifo = &SimFifos[channel];
+	uint16_t a = FifoBase(channel) + fifo->head * FifoObjBytes(channel);
+	uint32_t id;
+	uint32_t seq;
+	uint64_t latency;
+
+	memcpy(&id, &SimMemory[cRAMADDR_START + a], 4);
+	memcpy(&seq, &SimMemory[cRAMADDR_START + a + 8], 4);
+
+	if((id & 0x7FF) == URGENT_ID)
+	{
+		latency = SimBusFree - UrgentDueTime[seq % MAX_URGENT_FRAMES];
+		if(latency < LatencyMin)
+			LatencyMin = latency;
+		if(latency > LatencyMax)
+			LatencyMax = latency;
+		LatencySum += latency;
+		UrgentSent++;
+	}
+	else
+	{
+		BulkSent++;
+	}
+
+	fifo->head = (fifo->head + 1) % FifoDepth(channel);
+	fifo->level--;
+}
+
+//Transmit all frames which start on bus before SimTime
+static void SimBus(void)
+{
+	uint64_t start;
+	uint64_t duration;
+	uint32_t ctrl;
+	uint8_t channel;
+	uint8_t best;
+	uint8_t bestPriority;
+
+	for(;;)
+	{
+		//the earliest moment when any frame is pending
+		start = SimTime + 1;
+		for(channel = 1; channel < CAN_FIFO_TOTAL_CHANNELS; channel++)
+		{
+			if(SimFifos[channel].level && SimFifos[channel].loadTime[SimFifos[channel].head] < start)
+				start = SimFifos[channel].loadTime[SimFifos[channel].head];
+		}
+
+		if(start < SimBusFree)
+			start = SimBusFree;
+		if(start > SimTime)
+			return;
+
+		//arbitration between frames pending at start
+		best = 0;
+		bestPriority = 0;
+		for(channel = 1; channel < CAN_FIFO_TOTAL_CHANNELS; channel++)
+		{
+			SIM_FIFO* fifo = &SimFifos[channel];
+			uint8_t priority = (FifoConWord(channel) >> 16) & 0x1F;
+
+			if(fifo->level && fifo->loadTime[fifo->head] <= start && (best == 0 || priority > bestPriority))
+			{
+				best = channel;
+				bestPriority = priority;
+			}
+		}
+
+		memcpy(&ctrl, &SimMemory[cRAMADDR_START + FifoBase(best) + SimFifos[best].head * FifoObjBytes(best) + 4], 4);
+		duration = FrameTimeNs((CAN_DLC)(ctrl & 0xF));
+
+		SimBusFree = start + duration;
+		SimBusBusyTime += duration;
+		FrameDone(best);
+	}
+}
+
+static void SimWrite(uint16_t address, uint8_t value)
+{
+	uint8_t channel;
+	SIM_FIFO* fifo;
+
+	if(address >= cREGADDR_CiFIFOCON && address < cREGADDR_CiFLTCON && ((address - cREGADDR_CiFIFOCON) % CiFIFO_OFFSET) == 1)
+	{
+		channel = (address - cREGADDR_CiFIFOCON) / CiFIFO_OFFSET;
+		fifo = &SimFifos[channel];
+
+		if(value & 0x04)
+		{
+			//FRESET
+			memset(fifo, 0, sizeof(SIM_FIFO));
+		}
+		else if((value & 0x01) && fifo->level < FifoDepth(channel))
+		{
+			//UINC, TXREQ is always set together with it by engine
+			fifo->loadTime[fifo->tail] = SimTime;
+			fifo->tail = (fifo->tail + 1) % FifoDepth(channel);
+			fifo->level++;
+		}
+
+		SimMemory[address] = value & 0xF8;
+		return;
+	}
+
+	SimMemory[address] = value;
+}
+
+static uint8_t SimRead(uint16_t address)
+{
+	uint32_t word;
+	uint8_t channel;
+	uint8_t offset;
+
+	if(address >= cREGADDR_CiFIFOCON && address < cREGADDR_CiFLTCON)
+	{
+		channel = (address - cREGADDR_CiFIFOCON) / CiFIFO_OFFSET;
+		offset = (address - cREGADDR_CiFIFOCON) % CiFIFO_OFFSET;
+
+		if(offset >= 8)
+		{
+			//CiFIFOUA
+			word = FifoBase(channel) + SimFifos[channel].tail * FifoObjBytes(channel);
+			return (word >> ((offset - 8) * 8)) & 0xFF;
+		}
+		if(offset >= 4)
+		{
+			//CiFIFOSTA: TFNRFNIF, TFHRFHIF, TFERFFIF and FIFOCI
+			word = (SimFifos[channel].level < FifoDepth(channel)) ? 0x01 : 0;
+			word |= (SimFifos[channel].level <= FifoDepth(channel) / 2) ? 0x02 : 0;
+			word |= (SimFifos[channel].level == 0) ? 0x04 : 0;
+			word |= SimFifos[channel].head << 8;
+			return (word >> ((offset - 4) * 8)) & 0xFF;
+		}
+	}
+
+	return SimMemory[address];
+}
+
+int8_t DRV_SPI_TransferData(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxData, uint8_t *SpiRxData, uint16_t spiTransferSize)
+{
+	uint16_t address = ((SpiTxData[0] & 0xF) << 8) | SpiTxData[1];
+	uint16_t i;
+
+	(void)spiSlaveDeviceIndex;
+	memset(SpiRxData, 0, spiTransferSize);
+
+	SimTime += SPI_TRANSFER_OVERHEAD_NS + spiTransferSize * SPI_BYTE_NS;
+	SimBus();
+
+	switch(SpiTxData[0] >> 4)
+	{
+	case cINSTRUCTION_RESET:
+		memset(SimMemory, 0, sizeof(SimMemory));
+		memset(SimFifos, 0, sizeof(SimFifos));
+		break;
+
+	case cINSTRUCTION_READ:
+		for(i = 2; i < spiTransferSize; i++)
+		{
+			SpiRxData[i] = SimRead((address + i - 2) & 0xFFF);
+		}
+		break;
+
+	case cINSTRUCTION_WRITE:
+		for(i = 2; i < spiTransferSize; i++)
+		{
+			SimWrite((address + i - 2) & 0xFFF, SpiTxData[i]);
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+int8_t DRV_SPI_TransferFill(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxHeader, uint16_t spiHeaderSize, uint8_t fillByte, uint16_t spiFillSize)
+{
+	//RAM initialization isn't used by benchmark
+	(void)spiSlaveDeviceIndex;
+	(void)SpiTxHeader;
+	(void)spiHeaderSize;
+	(void)fillByte;
+	(void)spiFillSize;
+
+	return 0;
+}
+
+static void RunScenario(bool priorityEngine, uint8_t bulkDepth)
+{
+	CAN_TXPRIO_CLASS_CONFIG classes[2];
+	CAN_TXPRIO_ENGINE engine;
+	CAN_TX_MSGOBJ urgentObj;
+	CAN_TX_MSGOBJ bulkObj;
+	uint8_t urgentData[8] = {0};
+	uint8_t bulkData[64] = {0};
+	uint8_t urgentClass = 0;
+	uint8_t bulkClass = priorityEngine ? 1 : 0;
+	uint64_t nextUrgent = URGENT_PERIOD_NS;
+	uint32_t urgentSeq = 0;
+	bool urgentPending = false;
+	bool idle;
+
+	SimTime = 0;
+	SimBusFree = 0;
+	SimBusBusyTime = 0;
+	LatencyMin = ~0ull;
+	LatencyMax = 0;
+	LatencySum = 0;
+	UrgentSent = 0;
+	BulkSent = 0;
+
+	DRV_CANFDSPI_Reset(DRV_CANFDSPI_INDEX_0);
+
+	if(priorityEngine)
+	{
+		DRV_CANFDSPI_TxPrioClassConfigObjectReset(&classes[0]);
+		classes[0].txPriority = 31;
+		classes[0].fifoSize = 3;
+		classes[0].payLoadSize = CAN_PLSIZE_8;
+		DRV_CANFDSPI_TxPrioClassConfigObjectReset(&classes[1]);
+		classes[1].txPriority = 1;
+		classes[1].fifoSize = bulkDepth - 1;
+		DRV_CANFDSPI_TxPrioConfigure(&engine, DRV_CANFDSPI_INDEX_0, CAN_FIFO_CH1, classes, 2);
+	}
+	else
+	{
+		DRV_CANFDSPI_TxPrioClassConfigObjectReset(&classes[0]);
+		classes[0].txPriority = 1;
+		classes[0].fifoSize = bulkDepth - 1;
+		DRV_CANFDSPI_TxPrioConfigure(&engine, DRV_CANFDSPI_INDEX_0, CAN_FIFO_CH1, classes, 1);
+	}
+
+	urgentObj.word[0] = 0;
+	urgentObj.word[1] = 0;
+	urgentObj.bF.id.SID = URGENT_ID;
+	urgentObj.bF.ctrl.DLC = CAN_DLC_8;
+	urgentObj.bF.ctrl.FDF = 1;
+	urgentObj.bF.ctrl.BRS = 1;
+
+	bulkObj.word[0] = 0;
+	bulkObj.word[1] = 0;
+	bulkObj.bF.id.SID = BULK_ID;
+	bulkObj.bF.ctrl.DLC = CAN_DLC_64;
+	bulkObj.bF.ctrl.FDF = 1;
+	bulkObj.bF.ctrl.BRS = 1;
+
+	while(SimTime < SIM_DURATION_NS)
+	{
+		idle = true;
+
+		if(!urgentPending && SimTime >= nextUrgent)
+		{
+			UrgentDueTime[urgentSeq % MAX_URGENT_FRAMES] = nextUrgent;
+			memcpy(urgentData, &urgentSeq, 4);
+			urgentPending = true;
+			nextUrgent += URGENT_PERIOD_NS;
+		}
+
+		if(urgentPending && DRV_CANFDSPI_TxPrioSubmit(&engine, urgentClass, &urgentObj, urgentData, 8) == 0)
+		{
+			urgentSeq++;
+			urgentPending = false;
+			idle = false;
+		}
+
+		if(DRV_CANFDSPI_TxPrioSubmit(&engine, bulkClass, &bulkObj, bulkData, 64) == 0)
+		{
+			idle = false;
+		}
+
+		if(idle)
+		{
+			SimTime += APP_POLL_NS;
+			SimBus();
+		}
+	}
+
+	printf("%-15s bulk depth %2u: urgent %4u latency min %5lluus avg %5lluus max %5lluus, bulk %5u frames, bus load %3llu%%, status reads %u\n",
+			priorityEngine ? "priority engine" : "single FIFO", bulkDepth, UrgentSent,
+			(unsigned long long)(LatencyMin / 1000),
+			(unsigned long long)(UrgentSent ? (LatencySum / UrgentSent) / 1000 : 0),
+			(unsigned long long)(LatencyMax / 1000),
+			BulkSent, (unsigned long long)(SimBusBusyTime * 100 / SimTime), engine.statusReads);
+}
+
+int main(int argc, char** argv)
+{
+	static const uint8_t BulkDepths[] = {4, 8, 16, 32};
+	uint64_t limit;
+	uint64_t firstMax = 0;
+	int failures = 0;
+	unsigned int i;
+
+	if(argc == 3)
+	{
+		NominalBitRate = strtoul(argv[1], NULL, 0);
+		DataBitRate = strtoul(argv[2], NULL, 0);
+	}
+	else if(argc != 1 || NominalBitRate == 0 || DataBitRate == 0)
+	{
+		printf("Usage: TxPriorityBenchmark [nominalBitRate dataBitRate]\n");
+		return -1;
+	}
+
+	DRV_CANFDSPI_FrameTimeInitialize(&FrameTime, NominalBitRate, DataBitRate);
+
+	//one bulk frame already on bus, urgent frame and application poll time
+	limit = FrameTimeNs(CAN_DLC_64) + FrameTimeNs(CAN_DLC_8) + APP_POLL_NS + 2 * (SPI_TRANSFER_OVERHEAD_NS + 80 * SPI_BYTE_NS);
+	printf("Nominal %ubps, data %ubps: bulk frame %lluus, urgent frame %lluus, latency limit %lluus\n",
+			NominalBitRate, DataBitRate, (unsigned long long)(FrameTimeNs(CAN_DLC_64) / 1000),
+			(unsigned long long)(FrameTimeNs(CAN_DLC_8) / 1000), (unsigned long long)(limit / 1000));
+
+	for(i = 0; i < sizeof(BulkDepths); i++)
+	{
+		RunScenario(false, BulkDepths[i]);
+	}
+
+	for(i = 0; i < sizeof(BulkDepths); i++)
+	{
+		RunScenario(true, BulkDepths[i]);
+
+		if(UrgentSent == 0 || LatencyMax > limit)
+		{
+			printf("FAIL: urgent latency above limit\n");
+			failures++;
+		}
+		if(i == 0)
+		{
+			firstMax = LatencyMax;
+		}
+		else if(LatencyMax > firstMax + FrameTimeNs(CAN_DLC_8))
+		{
+			printf("FAIL: urgent latency depend on bulk FIFO depth\n");
+			failures++;
+		}
+	}
+
+	return failures;
+}
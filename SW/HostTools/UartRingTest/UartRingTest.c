@@ -0,0 +1,641 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+* Host test of UART ring buffer from UART_RingBuffer.h used by interrupt driven UART
+* driver of all example projects(driver code is the same for LPC82X, LPC111X and
+* LPC11UXX, only copy from LPC82X project is tested).
+*
+* Test contain three parts:
+* - model check: random sequence of Put, Get, Write and Read on single thread compared
+*   with simple reference queue for different buffer sizes. Sequence is long enough to
+*   wrap 16 bit indexes many times,
+* - stress test: two threads play role of application and UART interrupt. In TX
+*   direction application write random blocks and interrupt take single bytes(LPC82X)
+*   or up to 16 bytes(LPC11xx FIFO). In RX direction interrupt put single bytes and
+*   count bytes lost when buffer is full(rxDropped in driver) and application read
+*   random blocks. Every byte carry value calculated from its position in stream so
+*   reordered, duplicated or overwritten bytes are detected. At the end every produced
+*   byte must be received or counted as dropped,
+* - DMA mock: TX buffer is read by mock of LPC82X DMA controller which take chain planned
+*   by UART_RingBufferDmaPlan and send one byte from memory per time step like USART TX
+*   request, so byte overwritten by application before it was sent is detected. Every
+*   span must be inside buffer memory, not longer than maximal DMA transfer and second
+*   span must continue the first one. Bytes are released by UART_RingBufferSkip when
+*   whole chain is sent(DMA interrupt). The same is checked with DMA thread.
+* Both threads randomly stall so buffer is sometimes empty and sometimes full.
+*
+* Build(gcc or mingw):
+*	gcc -std=gnu99 -Wall -O2 -pthread -I../../MCP2517FD_ExampleFor_LPC82X/inc -o UartRingTest UartRingTest.c
+*
+* Usage:
+*	UartRingTest [bytes]
+*
+* Exit code is number of detected errors(limited to 255).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "../../MCP2517FD_ExampleFor_LPC82X/src/UART_RingBuffer.c"
+
+#define DEFAULT_BYTES 2000000
+#define STRESS_RING_SIZE 64
+#define MAX_BLOCK 100
+#define MAX_REFERENCE 32768
+
+static uint32_t BytesToProduce = DEFAULT_BYTES;
+static uint32_t Errors;
+
+static UART_RingBuffer Ring;
+static uint8_t RingMemory[STRESS_RING_SIZE];
+static uint16_t DmaMaxSpan;
+static volatile bool ProducerDone;
+static uint32_t Dropped;
+static uint32_t Received;
+static uint32_t InterruptBytes;
+
+static void Error(const char* message, uint32_t position)
+{
+	if(Errors < 10)
+	{
+		printf("ERROR: %s, position %u\n", message, position);
+	}
+	Errors++;
+}
+
+static uint32_t Random(uint32_t* state)
+{
+	*state = *state * 1103515245u + 12345u;
+	return *state >> 16;
+}
+
+//byte value depend on position, so bytes shifted by multiply of 256 are detected too
+static uint8_t StreamByte(uint32_t position)
+{
+	return (uint8_t)(position ^ (position >> 8) ^ (position >> 16) ^ 0x5A);
+}
+
+static void Stall(uint32_t* state)
+{
+	volatile uint32_t delay;
+	uint32_t n;
+
+	switch(Random(state) % 16)
+	{
+	case 0:
+		//long stall, buffer become full or empty
+		for(n = Random(state) % 20000, delay = 0; delay < n; delay++);
+		break;
+	case 1:
+	case 2:
+		sched_yield();
+		break;
+	default:
+		for(n = Random(state) % 100, delay = 0; delay < n; delay++);
+		break;
+	}
+}
+
+/*****************************************************************************************
+* Model check
+*****************************************************************************************/
+
+static void ModelCheck(uint16_t size, uint32_t operations)
+{
+	static uint8_t memory[MAX_REFERENCE];
+	static uint8_t reference[MAX_REFERENCE];
+	uint8_t block[MAX_BLOCK];
+	UART_RingBuffer ring;
+	uint32_t referenceRead = 0;
+	uint32_t referenceWrite = 0;
+	uint32_t state = size;
+	uint32_t written = 0;
+	uint32_t errorsBefore = Errors;
+	uint16_t expected;
+	uint16_t length;
+	uint16_t n;
+	uint8_t byte;
+
+	if(!UART_RingBufferInit(&ring, memory, size))
+	{
+		Error("valid size rejected", size);
+		return;
+	}
+
+	for(uint32_t i = 0; i < operations; i++)
+	{
+		switch(Random(&state) % 4)
+		{
+		case 0:
+			byte = StreamByte(written);
+			if(UART_RingBufferPut(&ring, byte) != (referenceWrite - referenceRead < size))
+			{
+				Error("Put result differ from reference", i);
+			}
+			else if(referenceWrite - referenceRead < size)
+			{
+				reference[referenceWrite++ % MAX_REFERENCE] = byte;
+				written++;
+			}
+			break;
+		case 1:
+			if(UART_RingBufferGet(&ring, &byte) != (referenceWrite != referenceRead))
+			{
+				Error("Get result differ from reference", i);
+			}
+			else if(referenceWrite != referenceRead && byte != reference[referenceRead++ % MAX_REFERENCE])
+			{
+				Error("Get return wrong byte", i);
+			}
+			break;
+		case 2:
+			length = Random(&state) % MAX_BLOCK;
+			expected = size - (referenceWrite - referenceRead);
+			if(expected > length)
+				expected = length;
+
+			for(n = 0; n < length; n++)
+				block[n] = StreamByte(written + n);
+
+			if(UART_RingBufferWrite(&ring, block, length) != expected)
+			{
+				Error("Write length differ from reference", i);
+			}
+			for(n = 0; n < expected; n++)
+			{
+				reference[referenceWrite++ % MAX_REFERENCE] = block[n];
+			}
+			written += expected;
+			break;
+		default:
+			length = Random(&state) % MAX_BLOCK;
+			expected = referenceWrite - referenceRead;
+			if(expected > length)
+				expected = length;
+
+			if(UART_RingBufferRead(&ring, block, length) != expected)
+			{
+				Error("Read length differ from reference", i);
+			}
+			for(n = 0; n < expected; n++)
+			{
+				if(block[n] != reference[referenceRead++ % MAX_REFERENCE])
+				{
+					Error("Read return wrong byte", i);
+					break;
+				}
+			}
+			break;
+		}
+
+		if(UART_RingBufferCount(&ring) != referenceWrite - referenceRead ||
+				UART_RingBufferSpace(&ring) != size - (referenceWrite - referenceRead))
+		{
+			Error("Count or Space differ from reference", i);
+		}
+
+		if(Errors != errorsBefore)
+		{
+			//one wrong operation desynchronize reference
+			break;
+		}
+	}
+
+	printf("Model check size %5u: %u operations, %u bytes passed, %s\n",
+			size, operations, referenceRead, (Errors == errorsBefore) ? "OK" : "FAIL");
+}
+
+static void InitCheck(void)
+{
+	static uint8_t memory[UART_RING_BUFFER_MAX_SIZE];
+	UART_RingBuffer ring;
+	const uint16_t wrongSizes[] = {0, 3, 12, 100, 65535, 32769};
+	uint16_t i;
+	uint8_t byte;
+
+	for(i = 0; i < sizeof(wrongSizes) / sizeof(wrongSizes[0]); i++)
+	{
+		if(UART_RingBufferInit(&ring, memory, wrongSizes[i]))
+		{
+			Error("wrong size accepted", wrongSizes[i]);
+		}
+	}
+
+	//whole memory is used
+	UART_RingBufferInit(&ring, memory, UART_RING_BUFFER_MAX_SIZE);
+	for(i = 0; UART_RingBufferPut(&ring, 0x11); i++);
+	if(i != UART_RING_BUFFER_MAX_SIZE || UART_RingBufferSpace(&ring) != 0 ||
+			UART_RingBufferCount(&ring) != UART_RING_BUFFER_MAX_SIZE)
+	{
+		Error("full buffer doesn't contain size bytes", i);
+	}
+	for(i = 0; UART_RingBufferGet(&ring, &byte); i++);
+	if(i != UART_RING_BUFFER_MAX_SIZE || UART_RingBufferCount(&ring) != 0)
+	{
+		Error("not all bytes taken from full buffer", i);
+	}
+
+	//Skip release only bytes which are in buffer
+	UART_RingBufferWrite(&ring, (const uint8_t*)"abc", 3);
+	if(UART_RingBufferSkip(&ring, 10) != 3 || UART_RingBufferCount(&ring) != 0 ||
+			UART_RingBufferSpace(&ring) != UART_RING_BUFFER_MAX_SIZE)
+	{
+		Error("Skip released more bytes than buffer contain", 3);
+	}
+}
+
+/*****************************************************************************************
+* TX direction: application write blocks, interrupt take bytes
+*****************************************************************************************/
+
+static void* TxApplication(void* arg)
+{
+	uint8_t block[MAX_BLOCK];
+	uint32_t position = 0;
+	uint32_t state = 3;
+	uint16_t length;
+	uint16_t written;
+	uint16_t n;
+
+	(void)arg;
+
+	while(position < BytesToProduce)
+	{
+		length = 1 + Random(&state) % MAX_BLOCK;
+		if(length > BytesToProduce - position)
+			length = BytesToProduce - position;
+
+		for(n = 0; n < length; n++)
+			block[n] = StreamByte(position + n);
+
+		//application write rest of block in next call like UART_Write user
+		written = UART_RingBufferWrite(&Ring, block, length);
+		position += written;
+
+		Stall(&state);
+	}
+
+	ProducerDone = true;
+	return NULL;
+}
+
+static void* TxInterrupt(void* arg)
+{
+	uint32_t fifoSize = *(uint32_t*)arg;
+	uint32_t state = 4;
+	uint32_t i;
+	uint8_t byte;
+	bool done;
+
+	for(;;)
+	{
+		//flag must be read before buffer, otherwise last bytes can be missed
+		done = ProducerDone;
+
+		//interrupt fill empty FIFO
+		for(i = 0; i < fifoSize && UART_RingBufferGet(&Ring, &byte); i++)
+		{
+			if(byte != StreamByte(Received))
+			{
+				Error("TX byte wrong", Received);
+			}
+			Received++;
+		}
+
+		if(i > 0)
+			InterruptBytes++;
+		else if(done)
+			break;
+
+		Stall(&state);
+	}
+
+	return NULL;
+}
+
+/*****************************************************************************************
+* RX direction: interrupt put bytes, application read blocks
+*****************************************************************************************/
+
+static void* RxInterrupt(void* arg)
+{
+	uint32_t position = 0;
+	uint32_t state = 5;
+	uint32_t produced;
+
+	(void)arg;
+
+	for(produced = 0; produced < BytesToProduce; produced++)
+	{
+		//byte which doesn't fit is lost, next byte get the same value so order can be checked
+		if(UART_RingBufferPut(&Ring, StreamByte(position)))
+			position++;
+		else
+			Dropped++;
+
+		if(Random(&state) % 4 == 0)
+			Stall(&state);
+	}
+
+	ProducerDone = true;
+	return NULL;
+}
+
+static void* RxApplication(void* arg)
+{
+	uint8_t block[MAX_BLOCK];
+	uint32_t state = 6;
+	uint16_t length;
+	uint16_t n;
+	bool done;
+
+	(void)arg;
+
+	for(;;)
+	{
+		done = ProducerDone;
+		length = UART_RingBufferRead(&Ring, block, 1 + Random(&state) % MAX_BLOCK);
+
+		if(length == 0)
+		{
+			if(done)
+				break;
+			sched_yield();
+			continue;
+		}
+
+		for(n = 0; n < length; n++)
+		{
+			if(block[n] != StreamByte(Received + n))
+			{
+				Error("RX byte wrong", Received + n);
+				break;
+			}
+		}
+		Received += length;
+
+		Stall(&state);
+	}
+
+	return NULL;
+}
+
+/*****************************************************************************************
+* DMA mock: chain is sent byte by byte, interrupt after the last byte of chain
+*****************************************************************************************/
+
+static bool CheckChain(const UART_RingBuffer* ring, const UART_RingBufferDmaChain* chain, uint16_t maxSpan,
+		uint16_t count, uint32_t position)
+{
+	const volatile uint8_t* memoryEnd = ring->memory + ring->mask + 1;
+	const volatile uint8_t* expectedStart = &ring->memory[ring->readIndex & ring->mask];
+	uint16_t total = 0;
+	uint8_t i;
+
+	if(chain->spans > UART_RING_BUFFER_DMA_SPANS || (chain->spans == 0) != (count == 0))
+	{
+		Error("wrong number of spans", position);
+		return false;
+	}
+
+	for(i = 0; i < chain->spans; i++)
+	{
+		if(chain->length[i] == 0 || chain->length[i] > maxSpan ||
+				chain->start[i] != expectedStart || chain->start[i] + chain->length[i] > memoryEnd)
+		{
+			Error("wrong span", position);
+			return false;
+		}
+
+		total += chain->length[i];
+		expectedStart = chain->start[i] + chain->length[i];
+		if(expectedStart == memoryEnd)
+			expectedStart = ring->memory;
+	}
+
+	//chain take all bytes unless both spans are full
+	if(total != chain->total || total > count ||
+			(total < count && !(chain->spans == UART_RING_BUFFER_DMA_SPANS &&
+			(chain->length[0] == maxSpan || chain->start[1] + chain->length[1] == memoryEnd ||
+			chain->length[1] == maxSpan))))
+	{
+		Error("wrong chain length", position);
+		return false;
+	}
+
+	return true;
+}
+
+static void DmaMockCheck(uint16_t size, uint16_t maxSpan, uint32_t steps)
+{
+	static uint8_t memory[MAX_REFERENCE];
+	uint8_t block[MAX_BLOCK];
+	UART_RingBuffer ring;
+	UART_RingBufferDmaChain chain;
+	uint32_t state = size + maxSpan;
+	uint32_t written = 0;
+	uint32_t sent = 0;
+	uint32_t interrupts = 0;
+	uint32_t errorsBefore = Errors;
+	uint16_t spanPosition = 0;
+	uint8_t span = 0;
+	uint16_t length;
+	uint16_t n;
+
+	UART_RingBufferInit(&ring, memory, size);
+	chain.spans = 0;
+	chain.total = 0;
+
+	for(uint32_t step = 0; step < steps && Errors == errorsBefore; step++)
+	{
+		//application write random blocks, sometimes faster and sometimes slower than UART
+		if(Random(&state) % 8 < ((step / 10000) % 2 ? 7 : 1))
+		{
+			length = Random(&state) % MAX_BLOCK;
+			for(n = 0; n < length; n++)
+				block[n] = StreamByte(written + n);
+
+			written += UART_RingBufferWrite(&ring, block, length);
+		}
+
+		//DMA idle, chain is started by UART_Write
+		if(chain.total == 0)
+		{
+			UART_RingBufferDmaPlan(&ring, maxSpan, &chain);
+			if(!CheckChain(&ring, &chain, maxSpan, UART_RingBufferCount(&ring), sent))
+				break;
+			span = 0;
+			spanPosition = 0;
+			continue;
+		}
+
+		//USART request one byte, byte is read from memory now
+		if(chain.start[span][spanPosition] != StreamByte(sent))
+		{
+			Error("DMA sent wrong byte", sent);
+		}
+		sent++;
+
+		if(++spanPosition < chain.length[span])
+			continue;
+
+		spanPosition = 0;
+		if(++span < chain.spans)
+			continue;
+
+		//DMA interrupt after whole chain
+		interrupts++;
+		if(UART_RingBufferSkip(&ring, chain.total) != chain.total)
+		{
+			Error("Skip released wrong amount of bytes", sent);
+		}
+		UART_RingBufferDmaPlan(&ring, maxSpan, &chain);
+		if(!CheckChain(&ring, &chain, maxSpan, UART_RingBufferCount(&ring), sent))
+			break;
+		span = 0;
+	}
+
+	printf("DMA mock size %5u span %4u: %u bytes sent, %.1f bytes per interrupt, %s\n",
+			size, maxSpan, sent, interrupts ? (double)sent / interrupts : 0.0,
+			(Errors == errorsBefore) ? "OK" : "FAIL");
+}
+
+static void* TxDmaInterrupt(void* arg)
+{
+	UART_RingBufferDmaChain chain;
+	uint32_t state = 7;
+	uint16_t n;
+	uint8_t span;
+	bool done;
+
+	(void)arg;
+
+	for(;;)
+	{
+		done = ProducerDone;
+
+		if(UART_RingBufferDmaPlan(&Ring, DmaMaxSpan, &chain) == 0)
+		{
+			if(done)
+				break;
+			sched_yield();
+			continue;
+		}
+
+		//chain is in flight, application can write only to free space
+		Stall(&state);
+
+		for(span = 0; span < chain.spans; span++)
+		{
+			for(n = 0; n < chain.length[span]; n++)
+			{
+				if(chain.start[span][n] != StreamByte(Received))
+				{
+					Error("DMA byte wrong", Received);
+				}
+				Received++;
+			}
+		}
+
+		UART_RingBufferSkip(&Ring, chain.total);
+		InterruptBytes++;
+	}
+
+	return NULL;
+}
+
+static void StressTest(const char* name, void* (*producer)(void*), void* (*consumer)(void*), uint32_t fifoSize)
+{
+	pthread_t producerThread;
+	pthread_t consumerThread;
+
+	UART_RingBufferInit(&Ring, RingMemory, sizeof(RingMemory));
+	ProducerDone = false;
+	Dropped = 0;
+	Received = 0;
+	InterruptBytes = 0;
+
+	pthread_create(&consumerThread, NULL, consumer, &fifoSize);
+	pthread_create(&producerThread, NULL, producer, &fifoSize);
+	pthread_join(producerThread, NULL);
+	pthread_join(consumerThread, NULL);
+
+	printf("%-28s produced %u, received %u, dropped %u", name, BytesToProduce, Received, Dropped);
+	if(InterruptBytes > 0)
+		printf(", %.2f bytes per interrupt", (double)Received / InterruptBytes);
+	printf("\n");
+
+	if(Received + Dropped != BytesToProduce)
+	{
+		Error("bytes missing", Received + Dropped);
+	}
+	if(UART_RingBufferCount(&Ring) != 0)
+	{
+		Error("bytes left in buffer", UART_RingBufferCount(&Ring));
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if(argc == 2)
+	{
+		BytesToProduce = strtoul(argv[1], NULL, 0);
+	}
+	else if(argc != 1)
+	{
+		printf("Usage: UartRingTest [bytes]\n");
+		return -1;
+	}
+
+	InitCheck();
+	ModelCheck(1, 200000);
+	ModelCheck(8, 200000);
+	ModelCheck(64, 1000000);
+	ModelCheck(256, 1000000);
+	ModelCheck(UART_RING_BUFFER_MAX_SIZE, 1000000);
+
+	StressTest("TX single byte(LPC82X):", TxApplication, TxInterrupt, 1);
+	StressTest("TX 16 byte FIFO(LPC11xx):", TxApplication, TxInterrupt, 16);
+	StressTest("RX:", RxInterrupt, RxApplication, 1);
+
+	DmaMockCheck(64, 1024, 2000000);
+	DmaMockCheck(256, 100, 2000000);
+	DmaMockCheck(4096, 1024, 2000000);
+	DmaMockCheck(1, 1024, 200000);
+
+	DmaMaxSpan = 1024;
+	StressTest("TX DMA span 1024:", TxApplication, TxDmaInterrupt, 0);
+	DmaMaxSpan = 24;
+	StressTest("TX DMA span 24:", TxApplication, TxDmaInterrupt, 0);
+
+	printf("%s: %u errors\n", Errors ? "FAIL" : "PASS", Errors);
+
+	return (Errors > 255) ? 255 : Errors;
+}
@@ -11,6 +11,7 @@ C_SRCS += \
 ../src/I2C_Driver.c \
 ../src/SPI_Driver.c \
 ../src/UART_Driver.c \
+../src/UART_RingBuffer.c \
 ../src/c_library_ver_1_1_LPC82X.c \
 ../src/cr_startup_lpc82x.c \
 ../src/crp.c \
@@ -21,6 +22,7 @@ OBJS += \
 ./src/I2C_Driver.o \
 ./src/SPI_Driver.o \
 ./src/UART_Driver.o \
+./src/UART_RingBuffer.o \
 ./src/aeabi_romdiv_patch.o \
 ./src/c_library_ver_1_1_LPC82X.o \
 ./src/cr_startup_lpc82x.o \
@@ -32,6 +34,7 @@ C_DEPS += \
 ./src/I2C_Driver.d \
 ./src/SPI_Driver.d \
 ./src/UART_Driver.d \
+./src/UART_RingBuffer.d \
 ./src/c_library_ver_1_1_LPC82X.d \
 ./src/cr_startup_lpc82x.d \
 ./src/crp.d \
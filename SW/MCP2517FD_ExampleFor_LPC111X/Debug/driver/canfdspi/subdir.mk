@@ -4,13 +4,58 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
-../driver/canfdspi/drv_canfdspi_api.c 
+../driver/canfdspi/drv_canfdspi_api.c \
+../driver/canfdspi/drv_canfdspi_bittime.c \
+../driver/canfdspi/drv_canfdspi_busload.c \
+../driver/canfdspi/drv_canfdspi_capture.c \
+../driver/canfdspi/drv_canfdspi_dispatch.c \
+../driver/canfdspi/drv_canfdspi_filter.c \
+../driver/canfdspi/drv_canfdspi_frametime.c \
+../driver/canfdspi/drv_canfdspi_gateway.c \
+../driver/canfdspi/drv_canfdspi_image.c \
+../driver/canfdspi/drv_canfdspi_packed.c \
+../driver/canfdspi/drv_canfdspi_ramplan.c \
+../driver/canfdspi/drv_canfdspi_recovery.c \
+../driver/canfdspi/drv_canfdspi_slab.c \
+../driver/canfdspi/drv_canfdspi_tdc.c \
+../driver/canfdspi/drv_canfdspi_txprio.c \
+../driver/canfdspi/drv_canfdspi_txring.c 
 
 OBJS += \
-./driver/canfdspi/drv_canfdspi_api.o 
+./driver/canfdspi/drv_canfdspi_api.o \
+./driver/canfdspi/drv_canfdspi_bittime.o \
+./driver/canfdspi/drv_canfdspi_busload.o \
+./driver/canfdspi/drv_canfdspi_capture.o \
+./driver/canfdspi/drv_canfdspi_dispatch.o \
+./driver/canfdspi/drv_canfdspi_filter.o \
+./driver/canfdspi/drv_canfdspi_frametime.o \
+./driver/canfdspi/drv_canfdspi_gateway.o \
+./driver/canfdspi/drv_canfdspi_image.o \
+./driver/canfdspi/drv_canfdspi_packed.o \
+./driver/canfdspi/drv_canfdspi_ramplan.o \
+./driver/canfdspi/drv_canfdspi_recovery.o \
+./driver/canfdspi/drv_canfdspi_slab.o \
+./driver/canfdspi/drv_canfdspi_tdc.o \
+./driver/canfdspi/drv_canfdspi_txprio.o \
+./driver/canfdspi/drv_canfdspi_txring.o 
 
 C_DEPS += \
-./driver/canfdspi/drv_canfdspi_api.d 
+./driver/canfdspi/drv_canfdspi_api.d \
+./driver/canfdspi/drv_canfdspi_bittime.d \
+./driver/canfdspi/drv_canfdspi_busload.d \
+./driver/canfdspi/drv_canfdspi_capture.d \
+./driver/canfdspi/drv_canfdspi_dispatch.d \
+./driver/canfdspi/drv_canfdspi_filter.d \
+./driver/canfdspi/drv_canfdspi_frametime.d \
+./driver/canfdspi/drv_canfdspi_gateway.d \
+./driver/canfdspi/drv_canfdspi_image.d \
+./driver/canfdspi/drv_canfdspi_packed.d \
+./driver/canfdspi/drv_canfdspi_ramplan.d \
+./driver/canfdspi/drv_canfdspi_recovery.d \
+./driver/canfdspi/drv_canfdspi_slab.d \
+./driver/canfdspi/drv_canfdspi_tdc.d \
+./driver/canfdspi/drv_canfdspi_txprio.d \
+./driver/canfdspi/drv_canfdspi_txring.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
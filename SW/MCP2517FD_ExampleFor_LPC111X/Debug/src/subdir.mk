@@ -9,6 +9,7 @@ C_SRCS += \
 ../src/MCP2517FD_ExampleFor_LPC111X.c \
 ../src/SPI_Driver.c \
 ../src/UART_Driver.c \
+../src/UART_RingBuffer.c \
 ../src/cr_startup_lpc11xx.c \
 ../src/crp.c 
 
@@ -18,6 +19,7 @@ OBJS += \
 ./src/MCP2517FD_ExampleFor_LPC111X.o \
 ./src/SPI_Driver.o \
 ./src/UART_Driver.o \
+./src/UART_RingBuffer.o \
 ./src/cr_startup_lpc11xx.o \
 ./src/crp.o 
 
@@ -27,6 +29,7 @@ C_DEPS += \
 ./src/MCP2517FD_ExampleFor_LPC111X.d \
 ./src/SPI_Driver.d \
 ./src/UART_Driver.d \
+./src/UART_RingBuffer.d \
 ./src/cr_startup_lpc11xx.d \
 ./src/crp.d 
 
@@ -0,0 +1,218 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _DRV_CANFDSPI_BUSLOAD_H
+#define _DRV_CANFDSPI_BUSLOAD_H
+
+/*
+* Bus load and per ID traffic statistics.
+*
+* Every received and transmitted frame is converted to time when it occupy the bus by
+* DRV_CANFDSPI_FrameTime(drv_canfdspi_frametime.h), stuff bits are calculated from real
+* ID and payload. Transmitted frame should be accounted when TEF confirm it was sent on
+* the bus(DRV_CANFDSPI_BusLoadTefFrame), frames rejected or dropped before transmission
+* aren't counted then. TEF object doesn't contain payload, so it is counted as zeros(the
+* most stuff bits). Bit rates should be taken from bit time registers after bit time is
+* configured(DRV_CANFDSPI_BusLoadInitializeBitTime).
+*
+* Bus load is sum of frame times in window between two snapshots. All times are in us,
+* received frames use RX time stamp, so CiTSCON must increment CiTBC every 1us and RX
+* FIFO must store time stamp. Frame time is summed in ns, so snapshot must be taken at
+* least every 4 seconds. Only frames which pass acceptance filters are received, to
+* measure whole bus filter must accept all IDs.
+*
+* Per ID statistics are kept in table with CAN_BUSLOAD_MAX_IDS entries. When table is
+* full entry with the lowest count is replaced and new entry inherit its count as
+* error(Space-Saving algorithm), so every ID more frequent than 1/CAN_BUSLOAD_MAX_IDS of
+* frames is always in table and its count is overestimated at most by error. For every
+* ID mean period and jitter(difference between the longest and the shortest period) are
+* calculated.
+*
+* Simple example code:
+*
+*	CAN_BUSLOAD busLoad;
+*	CAN_BUSLOAD_SNAPSHOT snapshot;
+*
+*	DRV_CANFDSPI_ReadWordArray(DRV_CANFDSPI_INDEX_0, cREGADDR_CiNBTCFG, btcfg, 2);
+*	DRV_CANFDSPI_BusLoadInitializeBitTime(&busLoad, 40000000, btcfg[0], btcfg[1], 0);
+*
+*	DRV_CANFDSPI_BusLoadRxFrame(&busLoad, &rxObj, rxData);
+*	DRV_CANFDSPI_BusLoadTefFrame(&busLoad, &tefObj);
+*
+*	// Every second
+*	DRV_CANFDSPI_BusLoadSnapshot(&busLoad, time, &snapshot);
+*/
+
+#include "drv_canfdspi_api.h"
+#include "drv_canfdspi_filter.h"
+#include "drv_canfdspi_frametime.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+//! Size of per ID statistics table(28 bytes per entry)
+#ifndef CAN_BUSLOAD_MAX_IDS
+#define CAN_BUSLOAD_MAX_IDS 8
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+
+//! Statistics of single ID
+
+typedef struct _CAN_BUSLOAD_ID {
+    //! ID in CAN_FILTER_STD_ID/CAN_FILTER_EXT_ID format
+    uint32_t id;
+    uint32_t count;
+    //! Maximal overestimation of count(count of replaced entry)
+    uint32_t error;
+    //! Time of the first and the last frame since entry was created in us
+    uint32_t firstTime;
+    uint32_t lastTime;
+    //! The shortest and the longest period in us, valid when count - error > 1
+    uint32_t minPeriod;
+    uint32_t maxPeriod;
+} CAN_BUSLOAD_ID;
+
+//! Statistics engine
+
+typedef struct _CAN_BUSLOAD {
+    CAN_FRAMETIME frameTime;
+    //! Current window
+    uint32_t windowStart;
+    uint32_t busyTime;
+    uint32_t rxFrames;
+    uint32_t txFrames;
+    //! The highest load of all windows in per mille
+    uint16_t peakLoad;
+    uint8_t nIds;
+    CAN_BUSLOAD_ID ids[CAN_BUSLOAD_MAX_IDS];
+} CAN_BUSLOAD;
+
+//! Statistics of single window
+
+typedef struct _CAN_BUSLOAD_SNAPSHOT {
+    //! Length of window and time when bus was occupied in us
+    uint32_t windowTime;
+    uint32_t busyTime;
+    //! Bus load in per mille, peak of all windows
+    uint16_t load;
+    uint16_t peakLoad;
+    uint32_t rxFrames;
+    uint32_t txFrames;
+    //! The most frequent ID since initialization, 0 when no frame was seen
+    uint32_t topId;
+    uint32_t topCount;
+} CAN_BUSLOAD_SNAPSHOT;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Bus Load Statistics
+
+// *****************************************************************************
+//! Initialize statistics, window start at time(in us)
+
+void DRV_CANFDSPI_BusLoadInitialize(CAN_BUSLOAD* load, uint32_t nominalBitRate,
+        uint32_t dataBitRate, uint32_t time);
+
+// *****************************************************************************
+//! Initialize statistics for bit rates of CAN_BITTIME_SETUP
+/*!
+ * Return: 0 - success, -1 - unknown setup.
+ */
+
+int8_t DRV_CANFDSPI_BusLoadInitializeSetup(CAN_BUSLOAD* load, CAN_BITTIME_SETUP setup,
+        uint32_t time);
+
+// *****************************************************************************
+//! Initialize statistics for CiNBTCFG and CiDBTCFG values read from chip
+/*!
+ * sysClk is SYSCLK of chip in Hz.
+ */
+
+void DRV_CANFDSPI_BusLoadInitializeBitTime(CAN_BUSLOAD* load, uint32_t sysClk,
+        uint32_t nbtcfg, uint32_t dbtcfg, uint32_t time);
+
+// *****************************************************************************
+//! Account received frame, time is taken from RX time stamp
+
+void DRV_CANFDSPI_BusLoadRxFrame(CAN_BUSLOAD* load, const CAN_RX_MSGOBJ* header,
+        const uint8_t* data);
+
+// *****************************************************************************
+//! Account frame confirmed by TEF, time is taken from TEF time stamp
+
+void DRV_CANFDSPI_BusLoadTefFrame(CAN_BUSLOAD* load, const CAN_TEF_MSGOBJ* tefObj);
+
+// *****************************************************************************
+//! Account transmitted frame at time(in us), used when TEF is disabled
+
+void DRV_CANFDSPI_BusLoadTxFrame(CAN_BUSLOAD* load, const CAN_TX_MSGOBJ* header,
+        const uint8_t* data, uint32_t time);
+
+// *****************************************************************************
+//! Close current window at time(in us), fill snapshot and start next window
+
+void DRV_CANFDSPI_BusLoadSnapshot(CAN_BUSLOAD* load, uint32_t time,
+        CAN_BUSLOAD_SNAPSHOT* snapshot);
+
+// *****************************************************************************
+//! Statistics of ID, NULL when ID isn't in table
+
+const CAN_BUSLOAD_ID* DRV_CANFDSPI_BusLoadIdGet(const CAN_BUSLOAD* load, uint32_t id);
+
+// *****************************************************************************
+//! Mean period of ID in us, 0 when less than two frames were seen
+
+static inline uint32_t DRV_CANFDSPI_BusLoadIdPeriod(const CAN_BUSLOAD_ID* stat)
+{
+    return (stat->count - stat->error > 1) ?
+            (stat->lastTime - stat->firstTime) / (stat->count - stat->error - 1) : 0;
+}
+
+// *****************************************************************************
+//! Jitter of ID period in us
+
+static inline uint32_t DRV_CANFDSPI_BusLoadIdJitter(const CAN_BUSLOAD_ID* stat)
+{
+    return (stat->count - stat->error > 1) ? stat->maxPeriod - stat->minPeriod : 0;
+}
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // _DRV_CANFDSPI_BUSLOAD_H
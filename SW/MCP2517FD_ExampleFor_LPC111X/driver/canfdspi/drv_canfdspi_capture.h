@@ -0,0 +1,221 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef _DRV_CANFDSPI_CAPTURE_H
+#define _DRV_CANFDSPI_CAPTURE_H
+
+/*
+* Compact capture format of received frames for slow links.
+*
+* Gateway frame record(drv_canfdspi_gateway.h) take 23 bytes for classic 8 byte frame.
+* Periodic traffic repeat the same identifiers and most of payload bytes don't change
+* between two frames with the same identifier, so capture record contain only:
+* - time since previous frame as varint(7 bits per byte, LSB first, bit 7 - next byte
+*   follow), time base of MCP2517FD time stamp,
+* - index of dictionary entry with identifier, flags and DLC of frame, full header is
+*   sent only when identifier isn't in dictionary,
+* - payload(DLC length) as raw bytes, as mask of changed bytes followed by XOR of
+*   changed bytes with previous payload of this identifier or nothing when payload is
+*   the same. Encoder choose the shortest form.
+*
+* Records:
+*	Reset:   0x01 | dictionary size | history bytes | time stamp(4 bytes)
+*	Literal: 0 | flags(IDE, RTR, BRS, FDF, ESI) | 00, varint time, ID, payload
+*	         ID: standard frame 2 bytes(11 bit ID | DLC << 12), extended frame 4 bytes
+*	         29 bit ID and DLC byte
+*	Hit:     1 | index(5 bits) | mode(2 bits), varint time, payload
+*	         mode: 0 - raw, 1 - XOR mask and changed bytes, 2 - payload not changed
+* Multi byte fields are little endian. XOR delta cover first history bytes of payload,
+* the rest is sent raw. Mask has one bit per byte(bit 0 of first mask byte - payload
+* byte 0).
+*
+* Decoder keep the same dictionary as encoder, so every record must be decoded in order
+* after reset record. Dictionary entry is replaced by CLOCK algorithm(entry used since
+* last pass of clock hand get second chance), so identifiers of frequent frames stay
+* in dictionary even when bus contain more identifiers than dictionary entries. Reset
+* record set dictionary parameters and time base, it should be sent periodically when
+* stream can be interrupted(e.g. lost UART record).
+*
+* Dictionary need (8 + history bytes) per entry, default 32 entries with 8 byte history
+* take 512 bytes. On typical periodic traffic classic frame take 5 - 8 bytes(see
+* HostTools/GatewayDecoder).
+*
+* Simple example code:
+*
+*	uint8_t buffer[CAN_CAPTURE_RESET_BYTES + CAN_CAPTURE_FRAME_BYTES(64)];
+*
+*	DRV_CANFDSPI_CaptureInitialize(&encoder, CAN_CAPTURE_DICTIONARY_SIZE, CAN_CAPTURE_HISTORY_BYTES);
+*	n = DRV_CANFDSPI_CaptureEncodeReset(&encoder, buffer, rxObj.bF.timeStamp);
+*	n += DRV_CANFDSPI_CaptureEncodeFrame(&encoder, &buffer[n], rxObj.word, rxObj.bF.timeStamp, rxd);
+*
+*	// Host
+*	DRV_CANFDSPI_CaptureInitialize(&decoder, CAN_CAPTURE_DICTIONARY_SIZE, CAN_CAPTURE_HISTORY_BYTES);
+*	while (position < n) {
+*		if (DRV_CANFDSPI_CaptureDecode(&decoder, &buffer[position], n - position, &used,
+*			header, &timeStamp, data) < 0) {
+*			break;
+*		}
+*		position += used;
+*	}
+*/
+
+#include "drv_canfdspi_frametime.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+//! Limits given by record format
+#define CAN_CAPTURE_MAX_DICTIONARY 32
+#define CAN_CAPTURE_MAX_HISTORY 64
+
+//! Dictionary entries and payload history bytes per entry reserved in CAN_CAPTURE_CODER,
+//! decoder on host can be compiled with maximal values
+#ifndef CAN_CAPTURE_DICTIONARY_SIZE
+#define CAN_CAPTURE_DICTIONARY_SIZE 32
+#endif
+
+#ifndef CAN_CAPTURE_HISTORY_BYTES
+#define CAN_CAPTURE_HISTORY_BYTES 8
+#endif
+
+//! Record tags
+#define CAN_CAPTURE_TAG_RESET 0x01
+#define CAN_CAPTURE_TAG_HIT 0x80
+
+//! Payload modes of dictionary hit
+#define CAN_CAPTURE_PAYLOAD_RAW 0
+#define CAN_CAPTURE_PAYLOAD_XOR 1
+#define CAN_CAPTURE_PAYLOAD_SAME 2
+
+//! IDE bit of control field(bits 0 - 8 of word[1] of message object)
+#define CAN_CAPTURE_CONTROL_IDE 0x010
+
+//! Size of reset record
+#define CAN_CAPTURE_RESET_BYTES 7
+
+//! The longest frame record: literal with 5 byte time, extended ID and DLC
+#define CAN_CAPTURE_FRAME_BYTES(dataBytes) (11 + (dataBytes))
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+
+//! Decoded record type
+
+typedef enum {
+    CAN_CAPTURE_FRAME = 1,
+    CAN_CAPTURE_RESET = 2
+} CAN_CAPTURE_RECORD;
+
+//! Dictionary entry
+
+typedef struct _CAN_CAPTURE_ENTRY {
+    //! 11 or 29 bit identifier
+    uint32_t id;
+    //! DLC and flags, bits 0 - 8 of word[1] of message object
+    uint16_t control;
+    //! Second chance flag of CLOCK algorithm
+    uint8_t referenced;
+    uint8_t history[CAN_CAPTURE_HISTORY_BYTES];
+} CAN_CAPTURE_ENTRY;
+
+//! Encoder or decoder object, both keep the same state
+
+typedef struct _CAN_CAPTURE_CODER {
+    CAN_CAPTURE_ENTRY entry[CAN_CAPTURE_DICTIONARY_SIZE];
+    uint8_t dictionarySize;
+    uint8_t historyBytes;
+    uint8_t entries;
+    uint8_t hand;
+    //! Time stamp of previous record
+    uint32_t timeStamp;
+    //! Reset record was encoded or decoded
+    bool synchronized;
+    //! Statistics
+    uint32_t frames;
+    uint32_t hits;
+} CAN_CAPTURE_CODER;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Capture Format
+
+// *****************************************************************************
+//! Initialize encoder or decoder
+/*!
+ * Dictionary size and history bytes are limited to values reserved in object. Decoder
+ * get them from reset record, so for decoder they only must be big enough.
+ */
+
+void DRV_CANFDSPI_CaptureInitialize(CAN_CAPTURE_CODER* coder, uint8_t dictionarySize,
+        uint8_t historyBytes);
+
+// *****************************************************************************
+//! Encode reset record, clear dictionary and set time base
+/*!
+ * Buffer must have CAN_CAPTURE_RESET_BYTES. Return number of bytes.
+ */
+
+uint8_t DRV_CANFDSPI_CaptureEncodeReset(CAN_CAPTURE_CODER* coder, uint8_t* buffer,
+        uint32_t timeStamp);
+
+// *****************************************************************************
+//! Encode frame, header is word[0] and word[1] of RX message object
+/*!
+ * Buffer must have CAN_CAPTURE_FRAME_BYTES(data bytes). Return number of bytes, 0 when
+ * reset record wasn't encoded after initialization.
+ */
+
+uint8_t DRV_CANFDSPI_CaptureEncodeFrame(CAN_CAPTURE_CODER* coder, uint8_t* buffer,
+        const uint32_t* header, uint32_t timeStamp, const uint8_t* data);
+
+// *****************************************************************************
+//! Decode record from buffer
+/*!
+ * used get number of bytes of record. For frame header get word[0] and word[1] of
+ * message object(other bits are 0) and data must have 64 bytes, for reset record only
+ * time stamp is set. Return CAN_CAPTURE_RECORD or -1 when record is truncated, wrong
+ * or decoder isn't synchronized, then decoder wait for next reset record.
+ */
+
+int8_t DRV_CANFDSPI_CaptureDecode(CAN_CAPTURE_CODER* coder, const uint8_t* buffer,
+        uint16_t length, uint16_t* used, uint32_t* header, uint32_t* timeStamp, uint8_t* data);
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // _DRV_CANFDSPI_CAPTURE_H
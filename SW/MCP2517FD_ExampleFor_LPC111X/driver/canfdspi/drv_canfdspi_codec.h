@@ -0,0 +1,248 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _DRV_CANFDSPI_CODEC_H
+#define _DRV_CANFDSPI_CODEC_H
+
+/*
+* Compile time specialized message codecs for FIFOs with fixed payload size.
+*
+* Generic functions DRV_CANFDSPI_TransmitChannelLoad and DRV_CANFDSPI_ReceiveMessageGet
+* read CiFIFOCON, CiFIFOSTA and CiFIFOUA on every call, convert DLC to number of bytes
+* during runtime and copy header and payload byte by byte to local buffer. When FIFO
+* payload size and DLC are known during compilation they can be constants. Macros from
+* this file generate message object type which contain header and payload in layout
+* used by MCP2517FD RAM (word aligned and padded to multiply of 4 bytes) and load/get
+* functions which:
+* - read only CiFIFOUA register (6 bytes SPI transfer instead of 14 bytes),
+* - transfer constant amount of bytes directly from/to message object,
+* - copy payload by words with constant number of iterations.
+*
+* Code size and execution time on target weren't measured yet, comparison with generic
+* functions(flash size and cycles on Cortex-M0) is still open. Generated functions are
+* static inline, every codec has its own copy of load/get code.
+*
+* Generic functions are still available and should be used when DLC is selected during
+* runtime. Specialized functions don't check that FIFO is configured as TX or RX and
+* don't check payload size of FIFO so user is responsible to use them only with FIFO
+* configured with the same payload size(CAN_..._CODEC_CHECK macros can help).
+*
+* Simple example code which send 64 bytes frames via FIFO with CAN_PLSIZE_64:
+*
+*	DRV_CANFDSPI_DEFINE_TX_CODEC(Fd64, CAN_DLC_64)
+*
+*	Fd64_TX_FRAME frame;
+*
+*	frame.header.bF.id.SID = 0x100;
+*	frame.header.bF.ctrl.DLC = CAN_DLC_64;
+*	frame.header.bF.ctrl.FDF = 1;
+*	frame.header.bF.ctrl.BRS = 1;
+*	frame.data.byte[0] = 0xAA;
+*
+*	Fd64_TransmitChannelLoad(DRV_CANFDSPI_INDEX_0, CAN_FIFO_CH2, &frame, true);
+*/
+
+#include "drv_canfdspi_api.h"
+#include "drv_canfdspi_register.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Compile time conversions
+
+//! Number of data bytes for DLC, can be used in constant expressions
+#define CAN_DLC_DATA_BYTES(dlc) \
+    ((dlc) <= CAN_DLC_8 ? (dlc) : \
+     (dlc) <= CAN_DLC_24 ? (((dlc) - 6) * 4) : \
+     (dlc) == CAN_DLC_32 ? 32 : \
+     (dlc) == CAN_DLC_48 ? 48 : 64)
+
+//! Number of data bytes for FIFO payload size, can be used in constant expressions
+#define CAN_PLSIZE_DATA_BYTES(plSize) \
+    ((plSize) <= CAN_PLSIZE_24 ? (8 + ((plSize) * 4)) : \
+     (plSize) == CAN_PLSIZE_32 ? 32 : \
+     (plSize) == CAN_PLSIZE_48 ? 48 : 64)
+
+//! Smallest DLC which can carry n bytes, can be used in constant expressions
+#define CAN_DATA_BYTES_TO_DLC(n) \
+    ((n) <= 8 ? (n) : \
+     (n) <= 24 ? (((n) + 3) / 4 + 6) : \
+     (n) <= 32 ? CAN_DLC_32 : \
+     (n) <= 48 ? CAN_DLC_48 : CAN_DLC_64)
+
+//! Payload rounded up to multiply of 4 bytes(RAM is accessed only by words)
+#define CAN_PADDED_DATA_BYTES(n) (((n) + 3) & ~3)
+
+//! Size of message object in RAM: ID, control, optional time stamp and payload
+#define CAN_MSG_OBJ_BYTES(nDataBytes, timeStamp) \
+    (8 + ((timeStamp) ? 4 : 0) + CAN_PADDED_DATA_BYTES(nDataBytes))
+
+//! Compile time check that DLC fit into FIFO configured with plSize
+#define CAN_TX_CODEC_CHECK(name, dlc, plSize) \
+    typedef char name##_DlcFitsPayloadSize[(CAN_DLC_DATA_BYTES(dlc) <= CAN_PLSIZE_DATA_BYTES(plSize)) ? 1 : -1]
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Code generators
+
+//! Generate TX frame type and load function for constant DLC
+/*!
+ * Generated symbols:
+ * name##_TX_FRAME - message object with header and word aligned payload,
+ * name##_DATA_BYTES - number of payload bytes,
+ * name##_TransmitChannelLoad() - write frame to TX FIFO and set UINC(and TXREQ when
+ * flush is true). DLC field is always overwritten by constant DLC of codec.
+ *
+ * Frame type of CAN_DLC_0 codec has one unused payload word(zero length array isn't
+ * valid C), only header is written to FIFO.
+ */
+#define DRV_CANFDSPI_DEFINE_TX_CODEC(name, dlc) \
+    enum { name##_DATA_BYTES = CAN_DLC_DATA_BYTES(dlc), \
+        name##_DATA_WORDS = CAN_PADDED_DATA_BYTES(CAN_DLC_DATA_BYTES(dlc)) / 4, \
+        name##_ARRAY_WORDS = (name##_DATA_WORDS > 0) ? name##_DATA_WORDS : 1 }; \
+    \
+    typedef struct { \
+        CAN_TX_MSGOBJ header; \
+        union { \
+            uint32_t word[name##_ARRAY_WORDS]; \
+            uint8_t byte[name##_ARRAY_WORDS * 4]; \
+        } data; \
+    } name##_TX_FRAME; \
+    \
+    static inline int8_t name##_TransmitChannelLoad(CANFDSPI_MODULE_ID index, \
+            CAN_FIFO_CHANNEL channel, name##_TX_FRAME* frame, bool flush) \
+    { \
+        uint32_t ua; \
+        uint16_t a; \
+        uint32_t obj[2 + name##_DATA_WORDS]; \
+        uint8_t i; \
+        int8_t spiTransferError; \
+        \
+        spiTransferError = DRV_CANFDSPI_ReadWord(index, \
+                cREGADDR_CiFIFOUA + (channel * CiFIFO_OFFSET), &ua); \
+        if (spiTransferError) { \
+            return -1; \
+        } \
+        a = DRV_CANFDSPI_UA_TO_RAMADDR(ua); \
+        \
+        frame->header.bF.ctrl.DLC = (dlc); \
+        obj[0] = frame->header.word[0]; \
+        obj[1] = frame->header.word[1]; \
+        for (i = 0; i < name##_DATA_WORDS; i++) { \
+            obj[2 + i] = frame->data.word[i]; \
+        } \
+        \
+        spiTransferError = DRV_CANFDSPI_WriteByteArray(index, a, (uint8_t*) obj, sizeof (obj)); \
+        if (spiTransferError) { \
+            return -4; \
+        } \
+        \
+        spiTransferError = DRV_CANFDSPI_TransmitChannelUpdate(index, channel, flush); \
+        if (spiTransferError) { \
+            return -5; \
+        } \
+        \
+        return spiTransferError; \
+    }
+
+//! Generate RX frame type and get function for FIFO with constant payload size
+/*!
+ * Generated symbols:
+ * name##_RX_FRAME - message object with header(time stamp is zero when timeStamp
+ * is 0) and word aligned payload,
+ * name##_DATA_BYTES - payload size of FIFO,
+ * name##_ReceiveMessageGet() - read whole object from RX FIFO and set UINC.
+ *
+ * timeStamp must be equal RxTimeStampEnable field of FIFO configuration.
+ */
+#define DRV_CANFDSPI_DEFINE_RX_CODEC(name, plSize, timeStamp) \
+    enum { name##_DATA_BYTES = CAN_PLSIZE_DATA_BYTES(plSize), \
+        name##_DATA_WORDS = CAN_PLSIZE_DATA_BYTES(plSize) / 4, \
+        name##_HEADER_WORDS = (timeStamp) ? 3 : 2 }; \
+    \
+    typedef struct { \
+        CAN_RX_MSGOBJ header; \
+        union { \
+            uint32_t word[name##_DATA_WORDS]; \
+            uint8_t byte[name##_DATA_WORDS * 4]; \
+        } data; \
+    } name##_RX_FRAME; \
+    \
+    static inline int8_t name##_ReceiveMessageGet(CANFDSPI_MODULE_ID index, \
+            CAN_FIFO_CHANNEL channel, name##_RX_FRAME* frame) \
+    { \
+        uint32_t ua; \
+        uint16_t a; \
+        uint32_t obj[name##_HEADER_WORDS + name##_DATA_WORDS]; \
+        uint8_t i; \
+        int8_t spiTransferError; \
+        \
+        spiTransferError = DRV_CANFDSPI_ReadWord(index, \
+                cREGADDR_CiFIFOUA + (channel * CiFIFO_OFFSET), &ua); \
+        if (spiTransferError) { \
+            return -1; \
+        } \
+        a = DRV_CANFDSPI_UA_TO_RAMADDR(ua); \
+        \
+        spiTransferError = DRV_CANFDSPI_ReadByteArray(index, a, (uint8_t*) obj, sizeof (obj)); \
+        if (spiTransferError) { \
+            return -3; \
+        } \
+        \
+        frame->header.word[0] = obj[0]; \
+        frame->header.word[1] = obj[1]; \
+        frame->header.word[2] = (timeStamp) ? obj[2] : 0; \
+        for (i = 0; i < name##_DATA_WORDS; i++) { \
+            frame->data.word[i] = obj[name##_HEADER_WORDS + i]; \
+        } \
+        \
+        spiTransferError = DRV_CANFDSPI_ReceiveChannelUpdate(index, channel); \
+        if (spiTransferError) { \
+            return -4; \
+        } \
+        \
+        return spiTransferError; \
+    }
+
+//! Convert CiFIFOUA register value to SPI address of message object
+#ifdef USERADDRESS_TIMES_FOUR
+#define DRV_CANFDSPI_UA_TO_RAMADDR(ua) ((uint16_t) (cRAMADDR_START + 4 * ((ua) & 0xFFF)))
+#else
+#define DRV_CANFDSPI_UA_TO_RAMADDR(ua) ((uint16_t) (cRAMADDR_START + ((ua) & 0xFFF)))
+#endif
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // _DRV_CANFDSPI_CODEC_H
@@ -0,0 +1,288 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_canfdspi_dispatch.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local functions
+
+//! Number of set bits, Cortex-M0 doesn't have instruction for it
+static uint32_t DispatchBitCount(uint32_t value)
+{
+    value = value - ((value >> 1) & 0x55555555);
+    value = (value & 0x33333333) + ((value >> 2) & 0x33333333);
+    value = (value + (value >> 4)) & 0x0F0F0F0F;
+
+    return (value * 0x01010101) >> 24;
+}
+
+//! Rank of standard ID(number of accepted IDs below it)
+static uint8_t DispatchStdRank(const CAN_DISPATCH_TABLE* table, uint32_t sid)
+{
+    return table->stdRank[sid >> 5] +
+            DispatchBitCount(table->stdBitmap[sid >> 5] & ((1u << (sid & 31)) - 1));
+}
+
+//! Multiplicative hash, upper bits of product are the best mixed
+static uint8_t DispatchExtHash(uint32_t id)
+{
+    return (id * 2654435761u) >> (32 - CAN_DISPATCH_EXT_SLOTS_LOG2);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Dispatch Table
+
+int8_t DRV_CANFDSPI_DispatchInitialize(CAN_DISPATCH_TABLE* table,
+        const CAN_DISPATCH_ROUTE* routes, uint8_t nRoutes, CAN_DISPATCH_HANDLER defaultHandler)
+{
+    uint32_t id;
+    uint16_t nStdIds = 0;
+    uint8_t i, w, slot, probe;
+
+    if (nRoutes == 0xFF) {
+        return -1;
+    }
+
+    table->routes = routes;
+    table->defaultHandler = defaultHandler;
+    table->rejected = 0;
+    table->nExtIds = 0;
+    table->extMaxProbe = 0;
+
+    for (w = 0; w < 64; w++) {
+        table->stdBitmap[w] = 0;
+    }
+    for (slot = 0; slot < CAN_DISPATCH_EXT_SLOTS; slot++) {
+        table->extId[slot] = CAN_DISPATCH_EMPTY_SLOT;
+    }
+
+    // Set bitmap and insert extended IDs into hash set
+    for (i = 0; i < nRoutes; i++) {
+        id = routes[i].id;
+
+        if (!(id & CAN_FILTER_EXTENDED)) {
+            id &= 0x7FF;
+            if (table->stdBitmap[id >> 5] & (1u << (id & 31))) {
+                return -3;
+            }
+            if (++nStdIds > CAN_DISPATCH_MAX_STD_IDS) {
+                return -1;
+            }
+            table->stdBitmap[id >> 5] |= 1u << (id & 31);
+            continue;
+        }
+
+        id &= 0x1FFFFFFF;
+        if (table->nExtIds >= CAN_DISPATCH_MAX_EXT_IDS) {
+            return -2;
+        }
+
+        // Linear probing, set is never full so free slot always exist
+        slot = DispatchExtHash(id);
+        for (probe = 0; table->extId[slot] != CAN_DISPATCH_EMPTY_SLOT; probe++) {
+            if (table->extId[slot] == id) {
+                return -3;
+            }
+            slot = (slot + 1) & (CAN_DISPATCH_EXT_SLOTS - 1);
+        }
+
+        table->extId[slot] = id;
+        table->extRoute[slot] = i;
+        table->nExtIds++;
+        if (probe > table->extMaxProbe) {
+            table->extMaxProbe = probe;
+        }
+    }
+
+    // Rank of every bitmap word and route index in rank order
+    table->stdRank[0] = 0;
+    for (w = 1; w < 64; w++) {
+        table->stdRank[w] = table->stdRank[w - 1] + DispatchBitCount(table->stdBitmap[w - 1]);
+    }
+
+    for (i = 0; i < nRoutes; i++) {
+        if (!(routes[i].id & CAN_FILTER_EXTENDED)) {
+            table->stdRoute[DispatchStdRank(table, routes[i].id & 0x7FF)] = i;
+        }
+    }
+
+    return 0;
+}
+
+uint32_t DRV_CANFDSPI_DispatchFrameId(const CAN_RX_MSGOBJ* header)
+{
+    if (header->bF.ctrl.IDE) {
+        return CAN_FILTER_EXT_ID(((uint32_t) header->bF.id.SID << 18) | header->bF.id.EID);
+    }
+
+    return CAN_FILTER_STD_ID(header->bF.id.SID);
+}
+
+const CAN_DISPATCH_ROUTE* DRV_CANFDSPI_DispatchLookup(const CAN_DISPATCH_TABLE* table, uint32_t id)
+{
+    uint8_t slot;
+    uint8_t probe;
+
+    if (!(id & CAN_FILTER_EXTENDED)) {
+        id &= 0x7FF;
+        if (!(table->stdBitmap[id >> 5] & (1u << (id & 31)))) {
+            return NULL;
+        }
+
+        return &table->routes[table->stdRoute[DispatchStdRank(table, id)]];
+    }
+
+    id &= 0x1FFFFFFF;
+    slot = DispatchExtHash(id);
+
+    for (probe = 0; probe <= table->extMaxProbe; probe++) {
+        if (table->extId[slot] == id) {
+            return &table->routes[table->extRoute[slot]];
+        }
+        if (table->extId[slot] == CAN_DISPATCH_EMPTY_SLOT) {
+            break;
+        }
+        slot = (slot + 1) & (CAN_DISPATCH_EXT_SLOTS - 1);
+    }
+
+    return NULL;
+}
+
+int8_t DRV_CANFDSPI_Dispatch(CAN_DISPATCH_TABLE* table, const CAN_RX_MSGOBJ* header, uint8_t* data)
+{
+    const CAN_DISPATCH_ROUTE* route;
+
+    route = DRV_CANFDSPI_DispatchLookup(table, DRV_CANFDSPI_DispatchFrameId(header));
+
+    if (route == NULL) {
+        table->rejected++;
+        if (table->defaultHandler != NULL) {
+            table->defaultHandler(header, data);
+        }
+        return 1;
+    }
+
+    route->handler(header, data);
+
+    return 0;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Filter Hit Dispatch
+
+void DRV_CANFDSPI_FilterDispatchInitialize(CAN_FILTER_DISPATCH* dispatch,
+        uint32_t reservedFilters, CAN_DISPATCH_HANDLER defaultHandler)
+{
+    uint8_t i;
+
+    for (i = 0; i < CAN_FILTER_TOTAL; i++) {
+        dispatch->handler[i] = NULL;
+    }
+
+    dispatch->used = reservedFilters;
+    dispatch->defaultHandler = defaultHandler;
+    dispatch->rejected = 0;
+}
+
+void DRV_CANFDSPI_FilterHandlerSet(CAN_FILTER_DISPATCH* dispatch, CAN_FILTER filter,
+        CAN_DISPATCH_HANDLER handler)
+{
+    dispatch->handler[filter] = handler;
+    dispatch->used |= 1u << filter;
+}
+
+int8_t DRV_CANFDSPI_FilterHandlerRegister(CANFDSPI_MODULE_ID index,
+        CAN_FILTER_DISPATCH* dispatch, uint32_t id, uint32_t mask,
+        CAN_FIFO_CHANNEL channel, CAN_DISPATCH_HANDLER handler)
+{
+    CAN_FILTER_GROUP group;
+    uint8_t filter;
+
+    for (filter = 0; (filter < CAN_FILTER_TOTAL) && (dispatch->used & (1u << filter)); filter++) {
+    }
+
+    if (filter == CAN_FILTER_TOTAL) {
+        return -1;
+    }
+
+    group.mask = mask & ((id & CAN_FILTER_EXTENDED) ? 0x1FFFFFFF : 0x7FF);
+    group.id = (id & group.mask) | (id & CAN_FILTER_EXTENDED);
+    group.nIds = 1;
+
+    // Handler must be ready before the first frame is accepted
+    dispatch->handler[filter] = handler;
+
+    if (DRV_CANFDSPI_FilterProgram(index, filter, &group, 1, channel)) {
+        dispatch->handler[filter] = NULL;
+        return -2;
+    }
+
+    dispatch->used |= 1u << filter;
+
+    return filter;
+}
+
+int8_t DRV_CANFDSPI_FilterHandlerUnregister(CANFDSPI_MODULE_ID index,
+        CAN_FILTER_DISPATCH* dispatch, CAN_FILTER filter)
+{
+    if ((filter >= CAN_FILTER_TOTAL) || !(dispatch->used & (1u << filter))) {
+        return -1;
+    }
+
+    if (DRV_CANFDSPI_FilterDisable(index, filter)) {
+        return -2;
+    }
+
+    dispatch->handler[filter] = NULL;
+    dispatch->used &= ~(1u << filter);
+
+    return 0;
+}
+
+int8_t DRV_CANFDSPI_FilterDispatch(CAN_FILTER_DISPATCH* dispatch,
+        const CAN_RX_MSGOBJ* header, uint8_t* data)
+{
+    CAN_DISPATCH_HANDLER handler = dispatch->handler[header->bF.ctrl.FilterHit];
+
+    if (handler == NULL) {
+        dispatch->rejected++;
+        if (dispatch->defaultHandler != NULL) {
+            dispatch->defaultHandler(header, data);
+        }
+        return 1;
+    }
+
+    handler(header, data);
+
+    return 0;
+}
@@ -0,0 +1,293 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_canfdspi_gateway.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+
+//! Decoder state
+
+typedef enum {
+    CAN_GATEWAY_WAIT_SYNC,
+    CAN_GATEWAY_WAIT_LENGTH,
+    CAN_GATEWAY_WAIT_BODY,
+    CAN_GATEWAY_WAIT_CRC_LOW,
+    CAN_GATEWAY_WAIT_CRC_HIGH
+} CAN_GATEWAY_DECODER_STATE;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+//! CRC16 of single nibble, 32 bytes instead of 512 bytes table for whole byte
+static const uint16_t canGatewayCrcTable[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local functions
+
+static void GatewayPutWord(uint8_t* buffer, uint32_t value)
+{
+    buffer[0] = value;
+    buffer[1] = value >> 8;
+    buffer[2] = value >> 16;
+    buffer[3] = value >> 24;
+}
+
+static uint32_t GatewayGetWord(const uint8_t* buffer)
+{
+    return buffer[0] | ((uint32_t) buffer[1] << 8) | ((uint32_t) buffer[2] << 16) |
+            ((uint32_t) buffer[3] << 24);
+}
+
+//! Add sync, length and CRC around body placed at buffer + 2
+static uint8_t GatewayFinish(uint8_t* buffer, uint8_t bodyBytes)
+{
+    uint16_t crc;
+
+    buffer[0] = CAN_GATEWAY_SYNC;
+    buffer[1] = bodyBytes;
+
+    crc = DRV_CANFDSPI_GatewayCrc(0xFFFF, &buffer[1], bodyBytes + 1);
+    buffer[bodyBytes + 2] = crc;
+    buffer[bodyBytes + 3] = crc >> 8;
+
+    return bodyBytes + CAN_GATEWAY_OVERHEAD_BYTES;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Gateway Framing
+
+uint16_t DRV_CANFDSPI_GatewayCrc(uint16_t crc, const uint8_t* data, uint16_t n)
+{
+    while (n--) {
+        crc = (crc << 4) ^ canGatewayCrcTable[(crc >> 12) ^ (*data >> 4)];
+        crc = (crc << 4) ^ canGatewayCrcTable[(crc >> 12) ^ (*data & 0xF)];
+        data++;
+    }
+
+    return crc;
+}
+
+uint8_t DRV_CANFDSPI_GatewayEncodeFrame(uint8_t* buffer, CAN_GATEWAY_TYPE type,
+        const uint32_t* header, uint32_t timeStamp, const uint8_t* data)
+{
+    CAN_TX_MSGOBJ obj;
+    uint8_t* body = &buffer[2];
+    uint8_t dataBytes;
+    uint8_t i;
+
+    obj.word[0] = header[0];
+    obj.word[1] = header[1];
+    dataBytes = DRV_CANFDSPI_FrameDataBytes(obj.bF.ctrl.FDF, (CAN_DLC) obj.bF.ctrl.DLC);
+
+    body[0] = type;
+    body[1] = (obj.word[1] >> 4) & 0x1F;
+    body[2] = obj.bF.ctrl.DLC;
+    if (obj.bF.ctrl.IDE) {
+        GatewayPutWord(&body[3], ((uint32_t) obj.bF.id.SID << 18) | obj.bF.id.EID);
+    } else {
+        GatewayPutWord(&body[3], obj.bF.id.SID);
+    }
+    GatewayPutWord(&body[7], timeStamp);
+
+    for (i = 0; i < dataBytes; i++) {
+        body[CAN_GATEWAY_FRAME_BODY_BYTES + i] = data[i];
+    }
+
+    return GatewayFinish(buffer, CAN_GATEWAY_FRAME_BODY_BYTES + dataBytes);
+}
+
+uint8_t DRV_CANFDSPI_GatewayEncodeStatus(uint8_t* buffer, const CAN_GATEWAY_STATUS_INFO* status)
+{
+    uint8_t* body = &buffer[2];
+
+    body[0] = CAN_GATEWAY_STATUS;
+    body[1] = status->state;
+    body[2] = status->tec;
+    body[3] = status->rec;
+    GatewayPutWord(&body[4], status->rxOverruns);
+    GatewayPutWord(&body[8], status->decodeErrors);
+    GatewayPutWord(&body[12], status->txDropped);
+
+    return GatewayFinish(buffer, CAN_GATEWAY_STATUS_BODY_BYTES);
+}
+
+uint8_t DRV_CANFDSPI_GatewayEncodeCapture(uint8_t* buffer, uint8_t sequence, uint8_t n)
+{
+    if (n > CAN_GATEWAY_CAPTURE_DATA_BYTES) {
+        n = CAN_GATEWAY_CAPTURE_DATA_BYTES;
+    }
+
+    buffer[2] = CAN_GATEWAY_CAPTURE;
+    buffer[3] = sequence;
+
+    return GatewayFinish(buffer, n + 2);
+}
+
+void DRV_CANFDSPI_GatewayDecoderInitialize(CAN_GATEWAY_DECODER* decoder)
+{
+    decoder->state = CAN_GATEWAY_WAIT_SYNC;
+    decoder->length = 0;
+    decoder->position = 0;
+    decoder->crc = 0xFFFF;
+    decoder->records = 0;
+    decoder->errors = 0;
+}
+
+int8_t DRV_CANFDSPI_GatewayDecoderPut(CAN_GATEWAY_DECODER* decoder, uint8_t byte)
+{
+    switch (decoder->state) {
+        case CAN_GATEWAY_WAIT_SYNC:
+            if (byte == CAN_GATEWAY_SYNC) {
+                decoder->state = CAN_GATEWAY_WAIT_LENGTH;
+            }
+            return 0;
+
+        case CAN_GATEWAY_WAIT_LENGTH:
+            if (byte == 0 || byte > CAN_GATEWAY_MAX_BODY_BYTES) {
+                break;
+            }
+            decoder->length = byte;
+            decoder->position = 0;
+            decoder->crc = DRV_CANFDSPI_GatewayCrc(0xFFFF, &byte, 1);
+            decoder->state = CAN_GATEWAY_WAIT_BODY;
+            return 0;
+
+        case CAN_GATEWAY_WAIT_BODY:
+            // CRC is updated by every byte, so time of Put doesn't depend on record length
+            decoder->body[decoder->position++] = byte;
+            decoder->crc = DRV_CANFDSPI_GatewayCrc(decoder->crc, &byte, 1);
+            if (decoder->position == decoder->length) {
+                decoder->state = CAN_GATEWAY_WAIT_CRC_LOW;
+            }
+            return 0;
+
+        case CAN_GATEWAY_WAIT_CRC_LOW:
+            if (byte != (decoder->crc & 0xFF)) {
+                break;
+            }
+            decoder->state = CAN_GATEWAY_WAIT_CRC_HIGH;
+            return 0;
+
+        default:
+            if (byte != (decoder->crc >> 8)) {
+                break;
+            }
+            decoder->state = CAN_GATEWAY_WAIT_SYNC;
+            decoder->records++;
+            return 1;
+    }
+
+    // Wrong byte can be SYNC of next record(e.g. previous record was truncated)
+    decoder->state = (byte == CAN_GATEWAY_SYNC) ? CAN_GATEWAY_WAIT_LENGTH : CAN_GATEWAY_WAIT_SYNC;
+    decoder->errors++;
+
+    return -1;
+}
+
+int8_t DRV_CANFDSPI_GatewayDecodeFrame(const CAN_GATEWAY_DECODER* decoder, uint32_t* header,
+        uint32_t* timeStamp, uint8_t* data)
+{
+    const uint8_t* body = decoder->body;
+    CAN_TX_MSGOBJ obj;
+    uint32_t id;
+    uint8_t dataBytes;
+    uint8_t i;
+
+    if ((body[0] != CAN_GATEWAY_RX_FRAME && body[0] != CAN_GATEWAY_TX_FRAME) ||
+            decoder->length < CAN_GATEWAY_FRAME_BODY_BYTES || body[2] > CAN_DLC_64) {
+        return -1;
+    }
+
+    dataBytes = DRV_CANFDSPI_FrameDataBytes(body[1] & CAN_GATEWAY_FLAG_FDF, (CAN_DLC) body[2]);
+    if (decoder->length != CAN_GATEWAY_FRAME_BODY_BYTES + dataBytes) {
+        return -1;
+    }
+
+    id = GatewayGetWord(&body[3]);
+    obj.word[0] = 0;
+    obj.word[1] = body[2] | ((uint32_t) (body[1] & 0x1F) << 4);
+    if (body[1] & CAN_GATEWAY_FLAG_IDE) {
+        obj.bF.id.SID = (id >> 18) & 0x7FF;
+        obj.bF.id.EID = id & 0x3FFFF;
+    } else {
+        obj.bF.id.SID = id & 0x7FF;
+    }
+
+    header[0] = obj.word[0];
+    header[1] = obj.word[1];
+    *timeStamp = GatewayGetWord(&body[7]);
+
+    for (i = 0; i < dataBytes; i++) {
+        data[i] = body[CAN_GATEWAY_FRAME_BODY_BYTES + i];
+    }
+
+    return body[0];
+}
+
+int8_t DRV_CANFDSPI_GatewayDecodeStatus(const CAN_GATEWAY_DECODER* decoder,
+        CAN_GATEWAY_STATUS_INFO* status)
+{
+    const uint8_t* body = decoder->body;
+
+    if (body[0] != CAN_GATEWAY_STATUS || decoder->length != CAN_GATEWAY_STATUS_BODY_BYTES) {
+        return -1;
+    }
+
+    status->state = body[1];
+    status->tec = body[2];
+    status->rec = body[3];
+    status->rxOverruns = GatewayGetWord(&body[4]);
+    status->decodeErrors = GatewayGetWord(&body[8]);
+    status->txDropped = GatewayGetWord(&body[12]);
+
+    return 0;
+}
+
+int8_t DRV_CANFDSPI_GatewayDecodeCapture(const CAN_GATEWAY_DECODER* decoder,
+        uint8_t* sequence, const uint8_t** data, uint8_t* n)
+{
+    if (decoder->body[0] != CAN_GATEWAY_CAPTURE || decoder->length < 2) {
+        return -1;
+    }
+
+    *sequence = decoder->body[1];
+    *data = &decoder->body[2];
+    *n = decoder->length - 2;
+
+    return 0;
+}
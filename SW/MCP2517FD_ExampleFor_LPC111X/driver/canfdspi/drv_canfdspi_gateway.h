@@ -0,0 +1,245 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _DRV_CANFDSPI_GATEWAY_H
+#define _DRV_CANFDSPI_GATEWAY_H
+
+/*
+* Binary framing of CAN frames for UART gateway.
+*
+* Every record start with sync byte, then length of body, body and CRC16 of length
+* and body(CCITT polynomial 0x1021, initial value 0xFFFF, little endian):
+*
+*	0xA5 | length | type | body ... | CRC low | CRC high
+*
+* Frame body(CAN_GATEWAY_RX_FRAME sent by gateway, CAN_GATEWAY_TX_FRAME sent by host):
+*	type | flags(IDE, RTR, BRS, FDF, ESI) | DLC | ID(4 bytes) | time stamp(4 bytes) | payload
+* ID is 11 or 29 bit identifier(not SID/EID fields), multi byte fields are little endian
+* and payload length is given by DLC and FDF. Classic 8 byte frame take 23 bytes and FD
+* 64 byte frame 79 bytes, so 3Mbaud link carry about 13000 or 3800 frames per second,
+* more than 500kbps bus(or 500kbps/2Mbps with 64 byte frames) can transmit.
+*
+* Status body(CAN_GATEWAY_STATUS) contain error state and drop counters of gateway, so
+* host can detect lost frames.
+*
+* Capture body(CAN_GATEWAY_CAPTURE) carry block of compact capture records of received
+* frames(drv_canfdspi_capture.h):
+*	type | sequence | capture records ...
+* Block contain only whole records and sequence is incremented for every block, so host
+* can detect lost block and wait for the next reset record.
+*
+* Decoder get stream byte by byte and search sync byte. Record with wrong length or CRC
+* is counted in errors and decoder wait for the next sync byte, so after corruption
+* stream is synchronized again on the next record boundary.
+*
+* Module use only drv_canfdspi_frametime.c(payload length from DLC), so it can be used
+* by host tools without SPI driver.
+*
+* Simple example code:
+*
+*	uint8_t buffer[CAN_GATEWAY_MAX_RECORD_BYTES];
+*
+*	n = DRV_CANFDSPI_GatewayEncodeFrame(buffer, CAN_GATEWAY_RX_FRAME, rxObj.word,
+*		rxObj.bF.timeStamp, rxd);
+*	UartSend(buffer, n);
+*
+*	// Bytes received from UART
+*	if (DRV_CANFDSPI_GatewayDecoderPut(&decoder, byte) == 1
+*		&& DRV_CANFDSPI_GatewayDecodeFrame(&decoder, txObj.word, &timeStamp, txd) == CAN_GATEWAY_TX_FRAME) {
+*		DRV_CANFDSPI_TransmitChannelLoad(DRV_CANFDSPI_INDEX_0, CAN_FIFO_CH2, &txObj, txd,
+*			DRV_CANFDSPI_DlcToDataBytes(txObj.bF.ctrl.DLC), true);
+*	}
+*/
+
+#include "drv_canfdspi_frametime.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+//! First byte of every record
+#define CAN_GATEWAY_SYNC 0xA5
+
+//! Sync, length and CRC
+#define CAN_GATEWAY_OVERHEAD_BYTES 4
+
+//! Frame body without payload: type, flags, DLC, ID and time stamp
+#define CAN_GATEWAY_FRAME_BODY_BYTES 11
+
+//! Status body: type, state, TEC, REC and three counters
+#define CAN_GATEWAY_STATUS_BODY_BYTES 16
+
+//! The longest frame record
+#define CAN_GATEWAY_MAX_FRAME_RECORD_BYTES \
+    (CAN_GATEWAY_OVERHEAD_BYTES + CAN_GATEWAY_FRAME_BODY_BYTES + 64)
+
+//! The longest capture body, capture records start at CAN_GATEWAY_CAPTURE_DATA_OFFSET of
+//! record buffer(after sync, length, type and sequence)
+#define CAN_GATEWAY_CAPTURE_BODY_BYTES 128
+#define CAN_GATEWAY_CAPTURE_DATA_OFFSET 4
+#define CAN_GATEWAY_CAPTURE_DATA_BYTES (CAN_GATEWAY_CAPTURE_BODY_BYTES - 2)
+
+//! The longest body and record
+#define CAN_GATEWAY_MAX_BODY_BYTES CAN_GATEWAY_CAPTURE_BODY_BYTES
+#define CAN_GATEWAY_MAX_RECORD_BYTES (CAN_GATEWAY_OVERHEAD_BYTES + CAN_GATEWAY_MAX_BODY_BYTES)
+
+//! Flags byte, the same bit order as control field of message object after DLC
+#define CAN_GATEWAY_FLAG_IDE 0x01
+#define CAN_GATEWAY_FLAG_RTR 0x02
+#define CAN_GATEWAY_FLAG_BRS 0x04
+#define CAN_GATEWAY_FLAG_FDF 0x08
+#define CAN_GATEWAY_FLAG_ESI 0x10
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+
+//! Record type
+
+typedef enum {
+    CAN_GATEWAY_RX_FRAME = 1,
+    CAN_GATEWAY_TX_FRAME = 2,
+    CAN_GATEWAY_STATUS = 3,
+    CAN_GATEWAY_CAPTURE = 4
+} CAN_GATEWAY_TYPE;
+
+//! Content of status record
+
+typedef struct _CAN_GATEWAY_STATUS_INFO {
+    //! Error state(e.g. CAN_RECOVERY_STATE), TEC and REC
+    uint8_t state;
+    uint8_t tec;
+    uint8_t rec;
+    //! Received frames dropped by gateway
+    uint32_t rxOverruns;
+    //! Records from host with wrong length or CRC
+    uint32_t decodeErrors;
+    //! Frames from host which weren't transmitted
+    uint32_t txDropped;
+} CAN_GATEWAY_STATUS_INFO;
+
+//! Decoder object
+
+typedef struct _CAN_GATEWAY_DECODER {
+    uint8_t state;
+    uint8_t length;
+    uint8_t position;
+    uint16_t crc;
+    uint8_t body[CAN_GATEWAY_MAX_BODY_BYTES];
+    //! Statistics
+    uint32_t records;
+    uint32_t errors;
+} CAN_GATEWAY_DECODER;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Gateway Framing
+
+// *****************************************************************************
+//! Update CRC16 by bytes
+
+uint16_t DRV_CANFDSPI_GatewayCrc(uint16_t crc, const uint8_t* data, uint16_t n);
+
+// *****************************************************************************
+//! Encode frame, header is word[0] and word[1] of RX or TX message object
+/*!
+ * Buffer must have CAN_GATEWAY_MAX_RECORD_BYTES. Return number of bytes of record.
+ */
+
+uint8_t DRV_CANFDSPI_GatewayEncodeFrame(uint8_t* buffer, CAN_GATEWAY_TYPE type,
+        const uint32_t* header, uint32_t timeStamp, const uint8_t* data);
+
+// *****************************************************************************
+//! Encode status record, return number of bytes
+
+uint8_t DRV_CANFDSPI_GatewayEncodeStatus(uint8_t* buffer, const CAN_GATEWAY_STATUS_INFO* status);
+
+// *****************************************************************************
+//! Encode capture record
+/*!
+ * n bytes of capture records(at most CAN_GATEWAY_CAPTURE_DATA_BYTES) must be already
+ * placed at CAN_GATEWAY_CAPTURE_DATA_OFFSET of buffer, so block is built without copy.
+ * Return number of bytes of record.
+ */
+
+uint8_t DRV_CANFDSPI_GatewayEncodeCapture(uint8_t* buffer, uint8_t sequence, uint8_t n);
+
+// *****************************************************************************
+//! Reset decoder and statistics
+
+void DRV_CANFDSPI_GatewayDecoderInitialize(CAN_GATEWAY_DECODER* decoder);
+
+// *****************************************************************************
+//! Put received byte into decoder
+/*!
+ * Return: 1 - record is complete and body is valid until next call, 0 - record isn't
+ * complete, -1 - wrong length or CRC, record dropped.
+ */
+
+int8_t DRV_CANFDSPI_GatewayDecoderPut(CAN_GATEWAY_DECODER* decoder, uint8_t byte);
+
+// *****************************************************************************
+//! Decode frame from complete record
+/*!
+ * header get word[0] and word[1] of message object(other bits are 0), data must have
+ * 64 bytes. Return record type or -1 when record isn't frame or length doesn't match DLC.
+ */
+
+int8_t DRV_CANFDSPI_GatewayDecodeFrame(const CAN_GATEWAY_DECODER* decoder, uint32_t* header,
+        uint32_t* timeStamp, uint8_t* data);
+
+// *****************************************************************************
+//! Decode capture block from complete record
+/*!
+ * data get pointer to capture records inside decoder body. Return: 0 - success,
+ * -1 - record isn't capture record.
+ */
+
+int8_t DRV_CANFDSPI_GatewayDecodeCapture(const CAN_GATEWAY_DECODER* decoder,
+        uint8_t* sequence, const uint8_t** data, uint8_t* n);
+
+// *****************************************************************************
+//! Decode status from complete record
+/*!
+ * Return: 0 - success, -1 - record isn't status record.
+ */
+
+int8_t DRV_CANFDSPI_GatewayDecodeStatus(const CAN_GATEWAY_DECODER* decoder,
+        CAN_GATEWAY_STATUS_INFO* status);
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // _DRV_CANFDSPI_GATEWAY_H
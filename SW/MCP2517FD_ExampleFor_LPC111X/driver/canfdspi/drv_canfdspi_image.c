@@ -0,0 +1,149 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_canfdspi_image.h"
+#include "drv_canfdspi_register.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+//! Number of registers from CiCON to CiTEFCON
+#define CAN_IMAGE_CONTROL_WORDS ((cREGADDR_CiTEFCON - cREGADDR_CiCON) / 4 + 1)
+
+//! FIFO channels in single burst(CiFIFOCON, CiFIFOSTA and CiFIFOUA for every channel)
+#define CAN_IMAGE_BURST_FIFOS (CAN_IMAGE_BURST_WORDS / 3)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local functions
+
+//! Write contiguous words split into bursts which fit into SPI buffer
+
+static int8_t DRV_CANFDSPI_ConfigImageWriteWords(CANFDSPI_MODULE_ID index,
+        uint16_t address, const uint32_t* words, uint16_t nWords)
+{
+    uint16_t n;
+
+    while (nWords > 0) {
+        n = (nWords > CAN_IMAGE_BURST_WORDS) ? CAN_IMAGE_BURST_WORDS : nWords;
+
+        if (DRV_CANFDSPI_WriteWordArray(index, address, (uint32_t*) words, n)) {
+            return -1;
+        }
+
+        address += n * 4;
+        words += n;
+        nWords -= n;
+    }
+
+    return 0;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Configuration Image
+
+int8_t DRV_CANFDSPI_ConfigImageApply(CANFDSPI_MODULE_ID index,
+        const CAN_CONFIG_IMAGE* image)
+{
+    uint32_t burst[CAN_IMAGE_BURST_WORDS];
+    REG_CiCON ciCon;
+    REG_CiTDC ciTdc;
+    uint16_t i, n, channel;
+
+    if ((image->nFifo > CAN_FIFO_TOTAL_CHANNELS) || (image->nFilters > CAN_FILTER_TOTAL)) {
+        return -1;
+    }
+
+    // CiCON .. CiTEFCON, registers not kept in image get reset values
+    for (i = 0; i < CAN_IMAGE_CONTROL_WORDS; i++) {
+        burst[i] = canControlResetValues[i];
+    }
+
+    // Chip stay in configuration mode
+    ciCon.word = image->con;
+    ciCon.bF.OpMode = 0;
+    ciCon.bF.RequestOpMode = CAN_CONFIGURATION_MODE;
+
+    ciTdc.word = image->tdc;
+#ifdef REV_A
+    ciTdc.bF.TDCOffset = 0;
+    ciTdc.bF.TDCValue = 0;
+#endif
+
+    burst[cREGADDR_CiCON / 4] = ciCon.word;
+    burst[cREGADDR_CiNBTCFG / 4] = image->nbtcfg;
+    burst[cREGADDR_CiDBTCFG / 4] = image->dbtcfg;
+    burst[cREGADDR_CiTDC / 4] = ciTdc.word;
+    burst[cREGADDR_CiTSCON / 4] = image->tscon;
+    burst[cREGADDR_CiINT / 4] = (uint32_t) image->intEnable << 16;
+    burst[cREGADDR_CiTEFCON / 4] = image->tefcon;
+
+    if (DRV_CANFDSPI_WriteWordArray(index, cREGADDR_CiCON, burst, CAN_IMAGE_CONTROL_WORDS)) {
+        return -2;
+    }
+
+    // FIFO channels, status flags are cleared and user address is read only
+    for (channel = 0; channel < image->nFifo; channel += n) {
+        n = image->nFifo - channel;
+        if (n > CAN_IMAGE_BURST_FIFOS) {
+            n = CAN_IMAGE_BURST_FIFOS;
+        }
+
+        for (i = 0; i < n; i++) {
+            burst[i * 3] = image->fifoCon[channel + i];
+            burst[i * 3 + 1] = canFifoResetValues[1];
+            burst[i * 3 + 2] = canFifoResetValues[2];
+        }
+
+        if (DRV_CANFDSPI_WriteWordArray(index, cREGADDR_CiFIFOCON + (channel * CiFIFO_OFFSET),
+                burst, n * 3)) {
+            return -2;
+        }
+    }
+
+    if (image->nFilters == 0) {
+        return 0;
+    }
+
+    // Filter objects and masks can be written only when filters are disabled
+    if (DRV_CANFDSPI_ConfigImageWriteWords(index, cREGADDR_CiFLTOBJ,
+            image->filterObj, image->nFilters * 2)) {
+        return -2;
+    }
+
+    if (DRV_CANFDSPI_WriteByteArray(index, cREGADDR_CiFLTCON,
+            (uint8_t*) image->filterCon, image->nFilters)) {
+        return -2;
+    }
+
+    return 0;
+}
@@ -0,0 +1,237 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _DRV_CANFDSPI_IMAGE_H
+#define _DRV_CANFDSPI_IMAGE_H
+
+/*
+* Whole controller configuration as constant register image.
+*
+* Configuration by API functions(DRV_CANFDSPI_Configure, TransmitChannelConfigure,
+* FilterObjectConfigure, ...) need separate SPI transaction for every register and
+* some of them do read-modify-write. CAN_CONFIG_IMAGE keep final value of every
+* configuration register and is built at compile time by CAN_IMAGE_* macros, so it
+* can be placed in flash. DRV_CANFDSPI_ConfigImageApply write it by burst writes of
+* contiguous register ranges:
+* - CiCON .. CiTEFCON(0x000 - 0x040): control, bit time, time stamp, interrupt enables
+*   and TEF, registers between them are written with reset values,
+* - CiFIFOCONm/CiFIFOSTAm/CiFIFOUAm for channels 0 .. nFifo - 1,
+* - CiFLTOBJm/CiMASKm for filters 0 .. nFilters - 1,
+* - CiFLTCONm bytes for filters 0 .. nFilters - 1(filters enabled last).
+* Ranges longer than SPI buffer are split into bursts of CAN_IMAGE_BURST_WORDS words.
+* With TX and RX FIFO in channels 1 and 2 and single filter whole configuration is
+* written in 4 transactions.
+*
+* Image must be applied directly after reset, chip must be in configuration mode and
+* it stays in this mode, so bit time can be still changed(e.g. by TDC profile) before
+* DRV_CANFDSPI_OperationModeSelect.
+*
+* Simple example code:
+*
+*	static const uint32_t fifoCon[] = {
+*		CAN_IMAGE_FIFOCON_RESET,
+*		CAN_IMAGE_FIFOCON_RX(15, CAN_PLSIZE_64, 0, CAN_RX_FIFO_NOT_EMPTY_EVENT),
+*		CAN_IMAGE_FIFOCON_TX(7, CAN_PLSIZE_64, 1, 3, CAN_TX_FIFO_NO_EVENT)
+*	};
+*	static const uint32_t filterObj[] = {
+*		CAN_IMAGE_FLTOBJ_SID(0xDA), CAN_IMAGE_MASK(0, 0, 1)
+*	};
+*	static const uint8_t filterCon[] = {
+*		CAN_IMAGE_FLTCON(CAN_FIFO_CH1)
+*	};
+*	static const CAN_CONFIG_IMAGE image = {
+*		.con = CAN_IMAGE_CON_RESET & ~CAN_IMAGE_CON_STEF,
+*		.nbtcfg = CAN_IMAGE_BTCFG(40000000, 0, 500000, 800),
+*		.dbtcfg = CAN_IMAGE_BTCFG(40000000, 0, 2000000, 800),
+*		.tdc = CAN_IMAGE_TDC_AUTO(40000000, 0, 2000000, 800),
+*		.intEnable = CAN_RX_EVENT,
+*		.tefcon = CAN_IMAGE_TEFCON_RESET,
+*		.fifoCon = fifoCon, .nFifo = 3,
+*		.filterObj = filterObj, .filterCon = filterCon, .nFilters = 1
+*	};
+*
+*	DRV_CANFDSPI_ConfigImageApply(DRV_CANFDSPI_INDEX_0, &image);
+*	DRV_CANFDSPI_OperationModeSelect(DRV_CANFDSPI_INDEX_0, CAN_NORMAL_MODE);
+*/
+
+#include "drv_canfdspi_api.h"
+#include "../spi/drv_spi.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+//! The biggest burst which fit into SPI buffer(2 bytes of command)
+#define CAN_IMAGE_BURST_WORDS ((SPI_DEFAULT_BUFFER_LENGTH - 2) / 4)
+
+//! CiCON reset value without OPMOD and REQOP fields
+#define CAN_IMAGE_CON_RESET         0x00180760
+
+//! CiCON bits
+#define CAN_IMAGE_CON_ISOCRCEN      0x00000020
+#define CAN_IMAGE_CON_PXEDIS        0x00000040
+#define CAN_IMAGE_CON_WAKFIL        0x00000100
+#define CAN_IMAGE_CON_BRSDIS        0x00001000
+#define CAN_IMAGE_CON_RTXAT         0x00010000
+#define CAN_IMAGE_CON_ESIGM         0x00020000
+#define CAN_IMAGE_CON_SERR2LOM      0x00040000
+#define CAN_IMAGE_CON_STEF          0x00080000
+#define CAN_IMAGE_CON_TXQEN         0x00100000
+#define CAN_IMAGE_CON_TXBWS(txbws)  ((uint32_t) (txbws) << 28)
+
+//! Number of TQ per bit for BRP register value, SYSCLK must be multiply of bit rate
+#define CAN_IMAGE_BTCFG_TQ(sysClk, brp, bitRate) \
+    ((uint32_t) (sysClk) / (((uint32_t) (brp) + 1) * (uint32_t) (bitRate)))
+
+//! TSEG1 and TSEG2 register values for sample point in per mille
+#define CAN_IMAGE_BTCFG_TSEG1(sysClk, brp, bitRate, samplePoint) \
+    ((CAN_IMAGE_BTCFG_TQ(sysClk, brp, bitRate) * (samplePoint)) / 1000 - 2)
+#define CAN_IMAGE_BTCFG_TSEG2(sysClk, brp, bitRate, samplePoint) \
+    (CAN_IMAGE_BTCFG_TQ(sysClk, brp, bitRate) - CAN_IMAGE_BTCFG_TSEG1(sysClk, brp, bitRate, samplePoint) - 3)
+
+//! CiNBTCFG or CiDBTCFG(fields are on the same positions), SJW equal TSEG2
+#define CAN_IMAGE_BTCFG(sysClk, brp, bitRate, samplePoint) \
+    (((uint32_t) (brp) << 24) | \
+     (CAN_IMAGE_BTCFG_TSEG1(sysClk, brp, bitRate, samplePoint) << 16) | \
+     (CAN_IMAGE_BTCFG_TSEG2(sysClk, brp, bitRate, samplePoint) << 8) | \
+     CAN_IMAGE_BTCFG_TSEG2(sysClk, brp, bitRate, samplePoint))
+
+//! CiTDC in auto mode with TDCO placed on data sample point, the same as solver
+#define CAN_IMAGE_TDC_AUTO(sysClk, brp, bitRate, samplePoint) \
+    (((uint32_t) CAN_SSP_MODE_AUTO << 16) | \
+     ((((uint32_t) (brp) + 1) * (CAN_IMAGE_BTCFG_TSEG1(sysClk, brp, bitRate, samplePoint) + 1)) << 8))
+
+//! CiTDC with TDC disabled(data bit rate below 1Mbps)
+#define CAN_IMAGE_TDC_OFF ((uint32_t) CAN_SSP_MODE_OFF << 16)
+
+//! CiTSCON with time base counter enabled, counter is incremented every prescaler
+//! SYSCLK periods(1 .. 1024) and time stamp is captured at SOF
+#define CAN_IMAGE_TSCON(prescaler) (0x00010000 | ((uint32_t) (prescaler) - 1))
+
+//! Compile time check that bit time is exact and segments fit into register fields
+#define CAN_IMAGE_BTCFG_VALID(sysClk, brp, bitRate, samplePoint, minTq, maxTseg1, maxTseg2) \
+    ((((uint32_t) (sysClk) % (((uint32_t) (brp) + 1) * (uint32_t) (bitRate))) == 0) && \
+     (CAN_IMAGE_BTCFG_TQ(sysClk, brp, bitRate) >= (minTq)) && \
+     (CAN_IMAGE_BTCFG_TSEG1(sysClk, brp, bitRate, samplePoint) <= (maxTseg1)) && \
+     (CAN_IMAGE_BTCFG_TSEG2(sysClk, brp, bitRate, samplePoint) <= (maxTseg2)))
+#define CAN_IMAGE_NBTCFG_CHECK(name, sysClk, brp, bitRate, samplePoint) \
+    typedef char name##_NominalBitTimeValid[ \
+        CAN_IMAGE_BTCFG_VALID(sysClk, brp, bitRate, samplePoint, 8, 255, 127) ? 1 : -1]
+#define CAN_IMAGE_DBTCFG_CHECK(name, sysClk, brp, bitRate, samplePoint) \
+    typedef char name##_DataBitTimeValid[ \
+        CAN_IMAGE_BTCFG_VALID(sysClk, brp, bitRate, samplePoint, 4, 31, 15) ? 1 : -1]
+
+//! CiTEFCON reset value(TEF reset)
+#define CAN_IMAGE_TEFCON_RESET 0x00000400
+
+//! CiTEFCON with fifoSize + 1 objects(used when CiCON.STEF is set), without interrupts
+#define CAN_IMAGE_TEFCON(fifoSize, timeStamp) \
+    (CAN_IMAGE_TEFCON_RESET | ((uint32_t) (fifoSize) << 24) | ((timeStamp) ? 0x00000020 : 0))
+
+//! CiFIFOCONm reset value, used for not used channels
+#define CAN_IMAGE_FIFOCON_RESET 0x00600400
+
+//! CiFIFOCONm of TX FIFO, fifoSize and plSize as in CAN_TX_FIFO_CONFIG, events
+//! are CAN_TX_FIFO_EVENT interrupt enables
+#define CAN_IMAGE_FIFOCON_TX(fifoSize, plSize, txPriority, txAttempts, events) \
+    (((uint32_t) (plSize) << 29) | ((uint32_t) (fifoSize) << 24) | \
+     ((uint32_t) (txAttempts) << 21) | ((uint32_t) (txPriority) << 16) | \
+     0x00000400 | 0x00000080 | ((uint32_t) (events) & CAN_TX_FIFO_ALL_EVENTS))
+
+//! CiFIFOCONm of RX FIFO, events are CAN_RX_FIFO_EVENT interrupt enables
+#define CAN_IMAGE_FIFOCON_RX(fifoSize, plSize, timeStamp, events) \
+    (CAN_IMAGE_FIFOCON_RESET | ((uint32_t) (plSize) << 29) | ((uint32_t) (fifoSize) << 24) | \
+     ((timeStamp) ? 0x00000020 : 0) | ((uint32_t) (events) & CAN_RX_FIFO_ALL_EVENTS))
+
+//! CiFLTOBJm for standard and extended ID
+#define CAN_IMAGE_FLTOBJ_SID(sid) ((uint32_t) (sid) & 0x7FF)
+#define CAN_IMAGE_FLTOBJ_EID(sid, eid) \
+    (((uint32_t) (sid) & 0x7FF) | (((uint32_t) (eid) & 0x3FFFF) << 11) | 0x40000000)
+
+//! CiMASKm, mide = 1 match only frame type(standard/extended) set in filter object
+#define CAN_IMAGE_MASK(msid, meid, mide) \
+    (((uint32_t) (msid) & 0x7FF) | (((uint32_t) (meid) & 0x3FFFF) << 11) | ((mide) ? 0x40000000 : 0))
+
+//! CiFLTCONm byte: filter enabled and linked with FIFO channel
+#define CAN_IMAGE_FLTCON(channel) (0x80 | ((channel) & 0x1F))
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+
+//! Register image of whole controller configuration
+
+typedef struct _CAN_CONFIG_IMAGE {
+    //! CiCON, OPMOD and REQOP are ignored
+    uint32_t con;
+    //! CiNBTCFG, CiDBTCFG and CiTDC
+    uint32_t nbtcfg;
+    uint32_t dbtcfg;
+    uint32_t tdc;
+    //! CiTSCON
+    uint32_t tscon;
+    //! Module interrupt enables(CAN_MODULE_EVENT), upper half of CiINT
+    uint16_t intEnable;
+    //! CiTEFCON
+    uint32_t tefcon;
+    //! CiFIFOCONm for channels 0(TXQ) .. nFifo - 1
+    const uint32_t* fifoCon;
+    uint8_t nFifo;
+    //! CiFLTOBJm and CiMASKm pairs for filters 0 .. nFilters - 1
+    const uint32_t* filterObj;
+    //! CiFLTCONm bytes for filters 0 .. nFilters - 1
+    const uint8_t* filterCon;
+    uint8_t nFilters;
+} CAN_CONFIG_IMAGE;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Configuration Image
+
+// *****************************************************************************
+//! Write register image by burst writes
+/*!
+ * Chip must be in configuration mode directly after reset and stays in it.
+ *
+ * Return: 0 - success, -1 - nFifo or nFilters out of range, -2 - SPI error.
+ */
+
+int8_t DRV_CANFDSPI_ConfigImageApply(CANFDSPI_MODULE_ID index,
+        const CAN_CONFIG_IMAGE* image);
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // _DRV_CANFDSPI_IMAGE_H
@@ -0,0 +1,273 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_canfdspi_packed.h"
+#include "drv_canfdspi_register.h"
+#include "drv_canfdspi_codec.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local functions
+
+//! Payload bytes of frame, DLC above 8 of classic frame mean 8 bytes
+static uint32_t PackedDataBytes(const CAN_PACKED_RECORD* record)
+{
+    uint32_t dataBytes = DRV_CANFDSPI_DlcToDataBytes((CAN_DLC) record->rx.bF.ctrl.DLC);
+
+    if (!record->rx.bF.ctrl.FDF && (dataBytes > 8)) {
+        dataBytes = 8;
+    }
+
+    return dataBytes;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Packed Ring
+
+int8_t DRV_CANFDSPI_PackedRingInitialize(CAN_PACKED_RING* ring, uint32_t* buffer, uint16_t size)
+{
+    // Smaller ring can refuse the biggest record forever when it become empty in the middle
+    if (((uintptr_t) buffer & 3) || (size & 3) || (size < CAN_PACKED_MIN_BYTES) || (size > 0x8000)) {
+        return -1;
+    }
+
+    ring->buffer = (uint8_t*) buffer;
+    ring->size = size;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->reservedOffset = 0;
+    ring->reservedBytes = 0;
+    ring->frames = 0;
+    ring->overruns = 0;
+    ring->highWatermark = 0;
+
+    return 0;
+}
+
+uint16_t DRV_CANFDSPI_PackedRecordBytes(const CAN_PACKED_RECORD* record)
+{
+    return CAN_PACKED_HEADER_BYTES + CAN_PADDED_DATA_BYTES(PackedDataBytes(record));
+}
+
+CAN_PACKED_RECORD* DRV_CANFDSPI_PackedRingReserve(CAN_PACKED_RING* ring, uint8_t dataBytes)
+{
+    uint16_t need = CAN_PACKED_HEADER_BYTES + CAN_PADDED_DATA_BYTES(dataBytes);
+    uint16_t head = ring->head;
+    uint16_t tail = ring->tail;
+    uint16_t toEnd;
+
+    if (head >= tail) {
+        toEnd = ring->size - head;
+
+        // Record can end exactly at end of buffer only when head doesn't meet tail at 0
+        if ((need < toEnd) || ((need == toEnd) && (tail != 0))) {
+            ring->reservedOffset = head;
+        } else if (need < tail) {
+            // Consumer jump to beginning when it read marker
+            *(uint32_t*) &ring->buffer[head] = CAN_PACKED_WRAP_MARKER;
+            ring->reservedOffset = 0;
+        } else {
+            return NULL;
+        }
+    } else if ((head + need) < tail) {
+        ring->reservedOffset = head;
+    } else {
+        return NULL;
+    }
+
+    ring->reservedBytes = need;
+
+    return (CAN_PACKED_RECORD*) &ring->buffer[ring->reservedOffset];
+}
+
+void DRV_CANFDSPI_PackedRingPublish(CAN_PACKED_RING* ring)
+{
+    uint16_t head = ring->reservedOffset + ring->reservedBytes;
+    uint16_t used;
+
+    if (head >= ring->size) {
+        head = 0;
+    }
+
+    CAN_PACKED_BARRIER();
+    ring->head = head;
+
+    ring->frames++;
+    used = DRV_CANFDSPI_PackedRingUsedBytes(ring);
+    if (used > ring->highWatermark) {
+        ring->highWatermark = used;
+    }
+}
+
+int8_t DRV_CANFDSPI_PackedRingPut(CAN_PACKED_RING* ring, const CAN_RX_MSGOBJ* header,
+        const uint8_t* data)
+{
+    CAN_PACKED_RECORD* record;
+    uint32_t dataBytes;
+    uint8_t* recordData;
+    uint8_t i;
+
+    dataBytes = PackedDataBytes((const CAN_PACKED_RECORD*) header);
+
+    record = DRV_CANFDSPI_PackedRingReserve(ring, dataBytes);
+    if (record == NULL) {
+        ring->overruns++;
+        return 1;
+    }
+
+    record->word[0] = header->word[0];
+    record->word[1] = header->word[1];
+    record->word[2] = header->word[2];
+
+    recordData = CAN_PACKED_DATA(record);
+    for (i = 0; i < dataBytes; i++) {
+        recordData[i] = data[i];
+    }
+    for (; i < CAN_PADDED_DATA_BYTES(dataBytes); i++) {
+        recordData[i] = 0;
+    }
+
+    DRV_CANFDSPI_PackedRingPublish(ring);
+
+    return 0;
+}
+
+int8_t DRV_CANFDSPI_PackedRingReceive(CAN_PACKED_RING* ring, CANFDSPI_MODULE_ID index,
+        CAN_FIFO_CHANNEL channel, bool timeStamp)
+{
+    uint32_t object[3 + 2];
+    uint32_t headerWords = timeStamp ? 3 : 2;
+    uint32_t dataBytes;
+    uint32_t firstBytes;
+    CAN_PACKED_RECORD* record;
+    uint32_t ua;
+    uint16_t a;
+    uint8_t i;
+
+    if (DRV_CANFDSPI_ReadWord(index, cREGADDR_CiFIFOUA + (channel * CiFIFO_OFFSET), &ua)) {
+        return -1;
+    }
+    a = DRV_CANFDSPI_UA_TO_RAMADDR(ua);
+
+    // Header and payload of classic frame
+    if (DRV_CANFDSPI_ReadByteArray(index, a, (uint8_t*) object, (headerWords + 2) * 4)) {
+        return -1;
+    }
+    if (!timeStamp) {
+        object[4] = object[3];
+        object[3] = object[2];
+        object[2] = 0;
+    }
+
+    dataBytes = PackedDataBytes((CAN_PACKED_RECORD*) object);
+    record = DRV_CANFDSPI_PackedRingReserve(ring, dataBytes);
+
+    if (record != NULL) {
+        record->word[0] = object[0];
+        record->word[1] = object[1];
+        record->word[2] = object[2];
+
+        // Record of short frame is smaller than data already read
+        firstBytes = CAN_PADDED_DATA_BYTES(dataBytes);
+        if (firstBytes > 8) {
+            firstBytes = 8;
+        }
+        for (i = 0; i < (firstBytes / 4); i++) {
+            ((uint32_t*) CAN_PACKED_DATA(record))[i] = object[3 + i];
+        }
+
+        // Rest of payload directly into record
+        if (dataBytes > 8) {
+            if (DRV_CANFDSPI_ReadByteArray(index, a + (headerWords + 2) * 4,
+                    CAN_PACKED_DATA(record) + 8, CAN_PADDED_DATA_BYTES(dataBytes) - 8)) {
+                return -1;
+            }
+        }
+    }
+
+    // Frame is removed from FIFO also when it is dropped
+    if (DRV_CANFDSPI_ReceiveChannelUpdate(index, channel)) {
+        return -1;
+    }
+
+    if (record == NULL) {
+        ring->overruns++;
+        return 1;
+    }
+
+    DRV_CANFDSPI_PackedRingPublish(ring);
+
+    return 0;
+}
+
+CAN_PACKED_RECORD* DRV_CANFDSPI_PackedRingPeek(CAN_PACKED_RING* ring)
+{
+    CAN_PACKED_RECORD* record;
+    uint16_t tail = ring->tail;
+
+    if (tail == ring->head) {
+        return NULL;
+    }
+
+    CAN_PACKED_BARRIER();
+    record = (CAN_PACKED_RECORD*) &ring->buffer[tail];
+
+    if (record->word[0] == CAN_PACKED_WRAP_MARKER) {
+        ring->tail = 0;
+
+        if (ring->head == 0) {
+            return NULL;
+        }
+
+        CAN_PACKED_BARRIER();
+        record = (CAN_PACKED_RECORD*) ring->buffer;
+    }
+
+    return record;
+}
+
+void DRV_CANFDSPI_PackedRingCommit(CAN_PACKED_RING* ring)
+{
+    uint16_t tail = ring->tail;
+
+    tail += DRV_CANFDSPI_PackedRecordBytes((CAN_PACKED_RECORD*) &ring->buffer[tail]);
+    if (tail >= ring->size) {
+        tail = 0;
+    }
+
+    CAN_PACKED_BARRIER();
+    ring->tail = tail;
+}
+
+uint16_t DRV_CANFDSPI_PackedRingUsedBytes(const CAN_PACKED_RING* ring)
+{
+    return (uint16_t) ((ring->head + ring->size - ring->tail) % ring->size);
+}
@@ -0,0 +1,152 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_canfdspi_ramplan.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: RAM Layout Planner
+
+void DRV_CANFDSPI_RamPlanConfigObjectReset(CAN_RAM_PLAN_CONFIG* config)
+{
+    config->ramSize = cRAM_SIZE;
+    config->tefDepth = 0;
+    config->tefTimeStamp = false;
+    config->txqDepth = 1;
+    config->txqPayLoadSize = CAN_PLSIZE_8;
+    config->firstChannel = CAN_FIFO_CH1;
+}
+
+CAN_FIFO_PLSIZE DRV_CANFDSPI_RamPlanPayLoadSize(uint8_t dataBytes)
+{
+    CAN_FIFO_PLSIZE plSize = CAN_PLSIZE_8;
+
+    while ((plSize < CAN_PLSIZE_64) && (CAN_PLSIZE_DATA_BYTES(plSize) < dataBytes)) {
+        plSize++;
+    }
+
+    return plSize;
+}
+
+uint16_t DRV_CANFDSPI_RamPlanReservedBytes(const CAN_RAM_PLAN_CONFIG* config)
+{
+    uint16_t bytes = 0;
+
+    bytes += config->tefDepth * (config->tefTimeStamp ? 12 : 8);
+    bytes += config->txqDepth * CAN_RAM_OBJ_BYTES(config->txqPayLoadSize, false);
+
+    return bytes;
+}
+
+int8_t DRV_CANFDSPI_RamPlan(const CAN_RAM_PLAN_CONFIG* config,
+        const CAN_RAM_PLAN_CLASS* classes, uint8_t nClasses, CAN_RAM_PLAN_FIFO* fifos)
+{
+    uint16_t objBytes[CAN_FIFO_TOTAL_CHANNELS];
+    uint16_t reserved;
+    uint16_t freeBytes;
+    uint8_t i, best;
+    bool found;
+
+    if ((nClasses == 0) || (config->firstChannel == CAN_FIFO_CH0) ||
+            (nClasses > (CAN_FIFO_TOTAL_CHANNELS - config->firstChannel))) {
+        return -1;
+    }
+
+    reserved = DRV_CANFDSPI_RamPlanReservedBytes(config);
+    if (reserved > config->ramSize) {
+        return -2;
+    }
+    freeBytes = config->ramSize - reserved;
+
+    // Every FIFO need at least one object
+    for (i = 0; i < nClasses; i++) {
+        if (classes[i].dataBytes > 64) {
+            return -1;
+        }
+
+        fifos[i].channel = config->firstChannel + i;
+        fifos[i].tx = classes[i].tx;
+        fifos[i].timeStamp = classes[i].tx ? false : classes[i].timeStamp;
+        fifos[i].payLoadSize = DRV_CANFDSPI_RamPlanPayLoadSize(classes[i].dataBytes);
+        fifos[i].depth = 1;
+
+        objBytes[i] = CAN_RAM_OBJ_BYTES(fifos[i].payLoadSize, fifos[i].timeStamp);
+        if (objBytes[i] > freeBytes) {
+            return -2;
+        }
+        freeBytes -= objBytes[i];
+    }
+
+    // Add object to FIFO with the lowest depth/weight ratio until RAM is full
+    do {
+        found = false;
+        best = 0;
+
+        for (i = 0; i < nClasses; i++) {
+            if ((classes[i].weight == 0) || (fifos[i].depth >= CAN_RAM_MAX_FIFO_DEPTH) ||
+                    (objBytes[i] > freeBytes)) {
+                continue;
+            }
+
+            // depth[i] / weight[i] < depth[best] / weight[best]
+            if (!found || ((uint32_t) fifos[i].depth * classes[best].weight <
+                    (uint32_t) fifos[best].depth * classes[i].weight)) {
+                best = i;
+                found = true;
+            }
+        }
+
+        if (found) {
+            fifos[best].depth++;
+            freeBytes -= objBytes[best];
+        }
+    } while (found);
+
+    for (i = 0; i < nClasses; i++) {
+        fifos[i].ramBytes = fifos[i].depth * objBytes[i];
+    }
+
+    return 0;
+}
+
+void DRV_CANFDSPI_RamPlanTxConfig(const CAN_RAM_PLAN_FIFO* fifo, CAN_TX_FIFO_CONFIG* config)
+{
+    DRV_CANFDSPI_TransmitChannelConfigureObjectReset(config);
+    config->FifoSize = fifo->depth - 1;
+    config->PayLoadSize = fifo->payLoadSize;
+}
+
+void DRV_CANFDSPI_RamPlanRxConfig(const CAN_RAM_PLAN_FIFO* fifo, CAN_RX_FIFO_CONFIG* config)
+{
+    DRV_CANFDSPI_ReceiveChannelConfigureObjectReset(config);
+    config->FifoSize = fifo->depth - 1;
+    config->PayLoadSize = fifo->payLoadSize;
+    config->RxTimeStampEnable = fifo->timeStamp;
+}
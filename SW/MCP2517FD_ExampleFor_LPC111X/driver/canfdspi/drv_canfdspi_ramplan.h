@@ -0,0 +1,198 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _DRV_CANFDSPI_RAMPLAN_H
+#define _DRV_CANFDSPI_RAMPLAN_H
+
+/*
+* Message RAM layout planner.
+*
+* MCP2517FD allocate message objects in 2KB RAM one after another: TEF(when CiCON.STEF
+* is set), TXQ(when CiCON.TXQEN is set) and FIFO1 .. FIFO31. Size of every object
+* depend on FIFO payload size and time stamp. FIFO which exceed RAM don't work but chip
+* doesn't report any error, so layout should be checked at compile time by macros:
+*
+*	CAN_RAM_LAYOUT_CHECK(CanRam, CAN_RAM_FIFOCON_BYTES(CAN_IMAGE_FIFOCON_RESET) +
+*		CAN_RAM_FIFOCON_BYTES(RX_FIFOCON) + CAN_RAM_FIFOCON_BYTES(TX_FIFOCON));
+*
+* When traffic contain classic frames and FD frames single FIFO with 64 byte payload
+* waste 56 bytes for every classic frame. Planner take traffic mix as list of classes
+* (direction, the longest payload and relative amount of frames during burst), create
+* separate FIFO with the smallest payload size for every class and share RAM so depth
+* of every FIFO is proportional to class weight(maximal depth of the FIFO with the
+* lowest depth/weight ratio). FIFO depth is limited to 32 objects by FSIZE field.
+*
+* Planner can be used at runtime or on host(HostTools/RamLayoutPlanner), result is
+* converted to CAN_TX_FIFO_CONFIG/CAN_RX_FIFO_CONFIG by DRV_CANFDSPI_RamPlanTxConfig and
+* DRV_CANFDSPI_RamPlanRxConfig.
+*
+* Simple example code:
+*
+*	const CAN_RAM_PLAN_CLASS classes[] = {
+*		{true, 8, 3, false}, {true, 64, 1, false}, {false, 8, 6, false}, {false, 64, 2, false}
+*	};
+*	CAN_RAM_PLAN_FIFO fifos[4];
+*
+*	DRV_CANFDSPI_RamPlanConfigObjectReset(&planConfig);
+*	DRV_CANFDSPI_RamPlan(&planConfig, classes, 4, fifos);
+*
+*	DRV_CANFDSPI_RamPlanTxConfig(&fifos[0], &txConfig);
+*	DRV_CANFDSPI_TransmitChannelConfigure(DRV_CANFDSPI_INDEX_0, fifos[0].channel, &txConfig);
+*/
+
+#include "drv_canfdspi_api.h"
+#include "drv_canfdspi_codec.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+//! Maximal number of objects in single FIFO(FSIZE is 5 bits)
+#define CAN_RAM_MAX_FIFO_DEPTH 32
+
+//! Size of TX/RX object in RAM for FIFO payload size, can be used in constant expressions
+#define CAN_RAM_OBJ_BYTES(plSize, timeStamp) \
+    (8 + ((timeStamp) ? 4 : 0) + CAN_PLSIZE_DATA_BYTES(plSize))
+
+//! RAM used by FIFO, fifoSize is register value(depth - 1)
+#define CAN_RAM_FIFO_BYTES(fifoSize, plSize, timeStamp) \
+    (((fifoSize) + 1) * CAN_RAM_OBJ_BYTES(plSize, timeStamp))
+
+//! RAM used by FIFO or TXQ described by CiFIFOCONm/CiTXQCON value, time stamp is
+//! stored only in RX FIFO(TXEN = 0, RXTSEN = 1)
+#define CAN_RAM_FIFOCON_BYTES(fifoCon) \
+    CAN_RAM_FIFO_BYTES(((fifoCon) >> 24) & 0x1F, ((fifoCon) >> 29) & 0x7, \
+        (((fifoCon) & 0xA0) == 0x20))
+
+//! RAM used by TEF described by CiTEFCON value(8 byte objects, optional time stamp)
+#define CAN_RAM_TEFCON_BYTES(tefCon) \
+    (((((tefCon) >> 24) & 0x1F) + 1) * (((tefCon) & 0x20) ? 12 : 8))
+
+//! Compile time check that sum of TEF, TXQ and FIFOs fit into message RAM
+#define CAN_RAM_LAYOUT_CHECK(name, ramBytes) \
+    typedef char name##_LayoutFitsRam[((ramBytes) <= cRAM_SIZE) ? 1 : -1]
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+
+//! Planner configuration, RAM used by TEF and TXQ is reserved before FIFOs
+
+typedef struct _CAN_RAM_PLAN_CONFIG {
+    //! Available RAM, normally cRAM_SIZE
+    uint16_t ramSize;
+    //! Number of TEF objects, 0 when TEF is disabled
+    uint8_t tefDepth;
+    bool tefTimeStamp;
+    //! Number of TXQ objects, 0 when TXQ is disabled
+    uint8_t txqDepth;
+    CAN_FIFO_PLSIZE txqPayLoadSize;
+    //! Channel of the first planned FIFO, next classes get next channels
+    CAN_FIFO_CHANNEL firstChannel;
+} CAN_RAM_PLAN_CONFIG;
+
+//! Traffic class
+
+typedef struct _CAN_RAM_PLAN_CLASS {
+    //! true - TX FIFO, false - RX FIFO
+    bool tx;
+    //! The longest payload of frames in this class(0 - 64 bytes)
+    uint8_t dataBytes;
+    //! Relative amount of frames in this class during burst
+    uint16_t weight;
+    //! RX time stamp, ignored for TX FIFO
+    bool timeStamp;
+} CAN_RAM_PLAN_CLASS;
+
+//! Planned FIFO, one for every class
+
+typedef struct _CAN_RAM_PLAN_FIFO {
+    CAN_FIFO_CHANNEL channel;
+    bool tx;
+    bool timeStamp;
+    CAN_FIFO_PLSIZE payLoadSize;
+    //! Number of objects(FifoSize register value + 1)
+    uint8_t depth;
+    //! RAM used by FIFO
+    uint16_t ramBytes;
+} CAN_RAM_PLAN_FIFO;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: RAM Layout Planner
+
+// *****************************************************************************
+//! Reset planner configuration object
+/*!
+ * Default configuration is the same as after reset: TEF disabled, TXQ with single
+ * 8 byte object, FIFOs from CAN_FIFO_CH1.
+ */
+
+void DRV_CANFDSPI_RamPlanConfigObjectReset(CAN_RAM_PLAN_CONFIG* config);
+
+// *****************************************************************************
+//! The smallest FIFO payload size which can hold dataBytes
+
+CAN_FIFO_PLSIZE DRV_CANFDSPI_RamPlanPayLoadSize(uint8_t dataBytes);
+
+// *****************************************************************************
+//! RAM used by TEF and TXQ
+
+uint16_t DRV_CANFDSPI_RamPlanReservedBytes(const CAN_RAM_PLAN_CONFIG* config);
+
+// *****************************************************************************
+//! Plan FIFO for every traffic class
+/*!
+ * Return: 0 - success, -1 - wrong number of classes or payload, -2 - classes don't
+ * fit into RAM even with single object per FIFO.
+ */
+
+int8_t DRV_CANFDSPI_RamPlan(const CAN_RAM_PLAN_CONFIG* config,
+        const CAN_RAM_PLAN_CLASS* classes, uint8_t nClasses, CAN_RAM_PLAN_FIFO* fifos);
+
+// *****************************************************************************
+//! Fill TX FIFO configuration(other fields get reset values)
+
+void DRV_CANFDSPI_RamPlanTxConfig(const CAN_RAM_PLAN_FIFO* fifo, CAN_TX_FIFO_CONFIG* config);
+
+// *****************************************************************************
+//! Fill RX FIFO configuration
+
+void DRV_CANFDSPI_RamPlanRxConfig(const CAN_RAM_PLAN_FIFO* fifo, CAN_RX_FIFO_CONFIG* config);
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // _DRV_CANFDSPI_RAMPLAN_H
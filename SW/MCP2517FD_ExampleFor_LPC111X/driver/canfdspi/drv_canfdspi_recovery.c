@@ -0,0 +1,179 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_canfdspi_recovery.h"
+#include "drv_canfdspi_register.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local functions
+
+//! Error state from CiTREC flags
+static CAN_RECOVERY_STATE RecoveryStateGet(CAN_ERROR_STATE flags)
+{
+    if (flags & CAN_TX_BUS_OFF_STATE) {
+        return CAN_RECOVERY_BUS_OFF;
+    }
+    if (flags & (CAN_TX_BUS_PASSIVE_STATE | CAN_RX_BUS_PASSIVE_STATE)) {
+        return CAN_RECOVERY_ERROR_PASSIVE;
+    }
+    if (flags & (CAN_TX_WARNING_STATE | CAN_RX_WARNING_STATE | CAN_TX_RX_WARNING_STATE)) {
+        return CAN_RECOVERY_ERROR_WARNING;
+    }
+
+    return CAN_RECOVERY_ERROR_ACTIVE;
+}
+
+//! Set TXREQ of TX FIFOs which contain frames and update offline time
+static int8_t RecoveryRestart(CAN_RECOVERY* recovery)
+{
+    CAN_TX_FIFO_STATUS status;
+    uint32_t now;
+    uint8_t channel;
+
+    for (channel = 0; channel < CAN_FIFO_TOTAL_CHANNELS; channel++) {
+        if (!(recovery->txChannels & (1u << channel))) {
+            continue;
+        }
+
+        if (DRV_CANFDSPI_TransmitChannelStatusGet(recovery->index, channel, &status)) {
+            return -1;
+        }
+
+        if (!(status & (CAN_TX_FIFO_EMPTY | CAN_TX_FIFO_TRANSMITTING))) {
+            if (DRV_CANFDSPI_TransmitChannelFlush(recovery->index, channel)) {
+                return -1;
+            }
+        }
+    }
+
+    if (DRV_CANFDSPI_ReadWord(recovery->index, cREGADDR_CiTBC, &now)) {
+        return -1;
+    }
+
+    recovery->lastOfflineTime = now - recovery->busOffTime;
+    recovery->totalOfflineTime += recovery->lastOfflineTime;
+    if (recovery->lastOfflineTime > recovery->maxOfflineTime) {
+        recovery->maxOfflineTime = recovery->lastOfflineTime;
+    }
+
+    return 0;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Bus Off Recovery
+
+void DRV_CANFDSPI_RecoveryInitialize(CAN_RECOVERY* recovery, CANFDSPI_MODULE_ID index,
+        CAN_OPERATION_MODE mode, uint32_t txChannels)
+{
+    recovery->index = index;
+    recovery->mode = mode;
+    recovery->txChannels = txChannels;
+    recovery->state = CAN_RECOVERY_ERROR_ACTIVE;
+    recovery->tec = 0;
+    recovery->rec = 0;
+    recovery->flags = CAN_ERROR_FREE_STATE;
+    recovery->busOffDiagnostic.word[0] = 0;
+    recovery->busOffDiagnostic.word[1] = 0;
+    recovery->busOffDiagnostic.word[2] = 0;
+    recovery->busOffTime = 0;
+    recovery->busOffCount = 0;
+    recovery->errorPassiveCount = 0;
+    recovery->lastOfflineTime = 0;
+    recovery->maxOfflineTime = 0;
+    recovery->totalOfflineTime = 0;
+}
+
+int8_t DRV_CANFDSPI_RecoveryService(CAN_RECOVERY* recovery)
+{
+    CAN_MODULE_EVENT events;
+    CAN_RECOVERY_STATE state;
+
+    // Controller finished recovery sequence, wait until it return to operation mode
+    if (recovery->state == CAN_RECOVERY_RESTART) {
+        if (DRV_CANFDSPI_OperationModeGet(recovery->index) != recovery->mode) {
+            return recovery->state;
+        }
+        if (RecoveryRestart(recovery)) {
+            return -1;
+        }
+        recovery->state = RecoveryStateGet(recovery->flags);
+        return recovery->state;
+    }
+
+    if (DRV_CANFDSPI_ModuleEventGet(recovery->index, &events)) {
+        return -1;
+    }
+
+    if (!(events & CAN_BUS_ERROR_EVENT) && (recovery->state == CAN_RECOVERY_ERROR_ACTIVE)) {
+        return recovery->state;
+    }
+
+    // Event is cleared before CiTREC is read, so next change isn't lost
+    if (events & CAN_BUS_ERROR_EVENT) {
+        if (DRV_CANFDSPI_ModuleEventClear(recovery->index, CAN_BUS_ERROR_EVENT)) {
+            return -1;
+        }
+    }
+
+    if (DRV_CANFDSPI_ErrorCountStateGet(recovery->index, &recovery->tec, &recovery->rec,
+            &recovery->flags)) {
+        return -1;
+    }
+
+    state = RecoveryStateGet(recovery->flags);
+
+    if ((state == CAN_RECOVERY_BUS_OFF) && (recovery->state != CAN_RECOVERY_BUS_OFF)) {
+        // Diagnostic registers show which error caused bus off
+        if (DRV_CANFDSPI_ReadWord(recovery->index, cREGADDR_CiTBC, &recovery->busOffTime) ||
+                DRV_CANFDSPI_BusDiagnosticsGet(recovery->index, &recovery->busOffDiagnostic)) {
+            return -1;
+        }
+        recovery->busOffCount++;
+    } else if ((state == CAN_RECOVERY_ERROR_PASSIVE) && (recovery->state < CAN_RECOVERY_ERROR_PASSIVE)) {
+        recovery->errorPassiveCount++;
+    } else if ((state != CAN_RECOVERY_BUS_OFF) && (recovery->state == CAN_RECOVERY_BUS_OFF)) {
+        if (DRV_CANFDSPI_OperationModeGet(recovery->index) != recovery->mode) {
+            if (DRV_CANFDSPI_OperationModeSelect(recovery->index, recovery->mode)) {
+                return -1;
+            }
+            recovery->state = CAN_RECOVERY_RESTART;
+            return recovery->state;
+        }
+        if (RecoveryRestart(recovery)) {
+            return -1;
+        }
+    }
+
+    recovery->state = state;
+
+    return recovery->state;
+}
@@ -0,0 +1,251 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _DRV_CANFDSPI_SLAB_H
+#define _DRV_CANFDSPI_SLAB_H
+
+/*
+* Fixed block slab allocator for frames.
+*
+* Ring with fixed slots reserve header and 64 bytes payload for every frame, so on bus
+* with classic 8 byte frames most of RAM is never used. Slab allocator has four size
+* classes for 8, 16, 32 and 64 bytes payload(CAN FD DLC steps). Every block has 12
+* bytes header(ID, control and time stamp of RX object or ID and control of TX object)
+* followed by payload. Number of blocks in every class is selected by user for expected
+* traffic mix, all blocks are placed in one memory area given during initialization.
+*
+* Allocation take first free block from the smallest class which fit payload, when
+* this class is empty the next bigger class is used(fallback counted in statistics).
+* Free find class by block address. Both operations are O(1)(free list per class) and
+* can be used from interrupt and main loop together: free list is modified with
+* interrupts disabled for few instructions(CAN_SLAB_LOCK/CAN_SLAB_UNLOCK, on Cortex-M
+* PRIMASK is saved and restored so functions can be called also from interrupt).
+*
+* Frames are passed between interrupt and main loop by CAN_SLAB_QUEUE, single
+* producer/single consumer queue of block pointers. DRV_CANFDSPI_SlabReceive read frame
+* from RX FIFO into block which fit its DLC: CiFIFOUA is read first, then header with
+* first 8 bytes of payload and the rest of payload only for frames longer than 8 bytes,
+* so classic frame is received by 3 SPI transactions with 20 bytes of data. Software
+* TX ring(drv_canfdspi_txring.h) can store frames in slab blocks as well.
+*
+* Simple example code:
+*
+*	static const uint8_t blocks[CAN_SLAB_CLASSES] = {16, 4, 4, 8};
+*	static uint32_t slabMemory[CAN_SLAB_MEMORY_WORDS(16, 4, 4, 8)];
+*	static CAN_SLAB_FRAME* rxSlots[8];
+*
+*	DRV_CANFDSPI_SlabInitialize(&slab, slabMemory, sizeof(slabMemory) / 4, blocks);
+*	DRV_CANFDSPI_SlabQueueInitialize(&rxQueue, rxSlots, 8);
+*
+*	// In interrupt
+*	DRV_CANFDSPI_SlabReceive(&slab, &rxQueue, DRV_CANFDSPI_INDEX_0, CAN_FIFO_CH1, true);
+*
+*	// In main loop
+*	while ((frame = DRV_CANFDSPI_SlabQueueGet(&rxQueue)) != NULL) {
+*		process(frame->rx.bF.id.SID, CAN_SLAB_RX_DATA(frame));
+*		DRV_CANFDSPI_SlabFree(&slab, frame);
+*	}
+*/
+
+#include "drv_canfdspi_api.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+//! Number of size classes and payload size of class
+#define CAN_SLAB_CLASSES 4
+#define CAN_SLAB_CLASS_DATA_BYTES(c) (8u << (c))
+
+//! Header of every block: ID, control and time stamp
+#define CAN_SLAB_HEADER_BYTES 12
+
+//! Size of block in bytes
+#define CAN_SLAB_BLOCK_BYTES(dataBytes) (CAN_SLAB_HEADER_BYTES + (dataBytes))
+
+//! Size of slab memory in words for number of blocks in every class
+#define CAN_SLAB_MEMORY_WORDS(n8, n16, n32, n64) \
+    (((n8) * CAN_SLAB_BLOCK_BYTES(8) + (n16) * CAN_SLAB_BLOCK_BYTES(16) + \
+      (n32) * CAN_SLAB_BLOCK_BYTES(32) + (n64) * CAN_SLAB_BLOCK_BYTES(64)) / 4)
+
+//! Payload of block used as TX object(8 bytes header) or RX object(12 bytes header)
+#define CAN_SLAB_TX_DATA(frame) ((uint8_t*) &(frame)->word[2])
+#define CAN_SLAB_RX_DATA(frame) ((uint8_t*) &(frame)->word[3])
+
+//! Interrupt lock around free list update
+#ifndef CAN_SLAB_LOCK
+#if defined(__arm__)
+#define CAN_SLAB_LOCK(state) __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (state) :: "memory")
+#define CAN_SLAB_UNLOCK(state) __asm volatile ("msr primask, %0" :: "r" (state) : "memory")
+#else
+#define CAN_SLAB_LOCK(state) ((void) (state))
+#define CAN_SLAB_UNLOCK(state) ((void) (state))
+#endif
+#endif
+
+//! Memory barrier between queue slot and index access
+#ifndef CAN_SLAB_BARRIER
+#define CAN_SLAB_BARRIER() __sync_synchronize()
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+
+//! Block header, payload follow it
+
+typedef union _CAN_SLAB_FRAME {
+    CAN_TX_MSGOBJ tx;
+    CAN_RX_MSGOBJ rx;
+    uint32_t word[3];
+    //! Used only when block is free
+    union _CAN_SLAB_FRAME* next;
+} CAN_SLAB_FRAME;
+
+//! Size class state and statistics
+
+typedef struct _CAN_SLAB_CLASS {
+    CAN_SLAB_FRAME* freeList;
+    //! Memory of class, used to find class of freed block
+    uint8_t* start;
+    uint8_t* end;
+    uint8_t blockBytes;
+    uint8_t blocks;
+    uint8_t inUse;
+    uint8_t highWatermark;
+    //! Allocations requested for this class
+    uint32_t allocations;
+    //! Requests served by bigger class
+    uint32_t fallbacks;
+    //! Requests not served at all
+    uint32_t failures;
+} CAN_SLAB_CLASS;
+
+//! Slab object
+
+typedef struct _CAN_SLAB {
+    CAN_SLAB_CLASS classes[CAN_SLAB_CLASSES];
+} CAN_SLAB;
+
+//! Single producer/single consumer queue of blocks
+
+typedef struct _CAN_SLAB_QUEUE {
+    CAN_SLAB_FRAME** slots;
+    uint8_t depth;
+    //! Free running indexes, head is written only by producer and tail by consumer
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    uint8_t highWatermark;
+    //! Frames dropped because queue or slab was full
+    volatile uint32_t overruns;
+} CAN_SLAB_QUEUE;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Slab Allocator
+
+// *****************************************************************************
+//! Split memory into blocks of every class
+/*!
+ * Return: 0 - success, -1 - memory too small or more than 255 blocks in class.
+ */
+
+int8_t DRV_CANFDSPI_SlabInitialize(CAN_SLAB* slab, uint32_t* memory, uint32_t memoryWords,
+        const uint8_t blocks[CAN_SLAB_CLASSES]);
+
+// *****************************************************************************
+//! Class for payload size, CAN_SLAB_CLASSES when payload is bigger than 64 bytes
+
+uint8_t DRV_CANFDSPI_SlabClassGet(uint32_t dataBytes);
+
+// *****************************************************************************
+//! Allocate block for payload size, NULL when this and bigger classes are empty
+
+CAN_SLAB_FRAME* DRV_CANFDSPI_SlabAlloc(CAN_SLAB* slab, uint32_t dataBytes);
+
+// *****************************************************************************
+//! Return block to its class
+
+void DRV_CANFDSPI_SlabFree(CAN_SLAB* slab, CAN_SLAB_FRAME* frame);
+
+// *****************************************************************************
+//! Number of payload bytes of frame, DLC above 8 of classic frame mean 8 bytes
+
+uint32_t DRV_CANFDSPI_SlabFrameDataBytes(const CAN_SLAB_FRAME* frame);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Slab Queue
+
+// *****************************************************************************
+//! Initialize queue, depth must be power of two not bigger than 128
+/*!
+ * Return: 0 - success, -1 - wrong depth.
+ */
+
+int8_t DRV_CANFDSPI_SlabQueueInitialize(CAN_SLAB_QUEUE* queue, CAN_SLAB_FRAME** slots,
+        uint8_t depth);
+
+// *****************************************************************************
+//! Producer: add block, false when queue is full
+
+bool DRV_CANFDSPI_SlabQueuePut(CAN_SLAB_QUEUE* queue, CAN_SLAB_FRAME* frame);
+
+// *****************************************************************************
+//! Consumer: remove the oldest block, NULL when queue is empty
+
+CAN_SLAB_FRAME* DRV_CANFDSPI_SlabQueueGet(CAN_SLAB_QUEUE* queue);
+
+// *****************************************************************************
+//! Number of blocks in queue
+
+uint8_t DRV_CANFDSPI_SlabQueueCount(const CAN_SLAB_QUEUE* queue);
+
+// *****************************************************************************
+//! Move one frame from RX FIFO to block from slab and add it to queue
+/*!
+ * timeStamp must be equal RxTimeStampEnable of FIFO, without it time stamp of frame is
+ * 0. When queue or slab is full frame is removed from FIFO and counted in overruns.
+ *
+ * Return: 0 - frame queued, 1 - frame dropped, -1 - SPI error.
+ */
+
+int8_t DRV_CANFDSPI_SlabReceive(CAN_SLAB* slab, CAN_SLAB_QUEUE* queue,
+        CANFDSPI_MODULE_ID index, CAN_FIFO_CHANNEL channel, bool timeStamp);
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // _DRV_CANFDSPI_SLAB_H
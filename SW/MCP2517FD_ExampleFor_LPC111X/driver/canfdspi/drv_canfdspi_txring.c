@@ -0,0 +1,249 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_canfdspi_txring.h"
+#include "drv_canfdspi_register.h"
+#include "drv_canfdspi_codec.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Software TX Ring
+
+int8_t DRV_CANFDSPI_TxRingInitialize(CAN_TXRING* ring, CANFDSPI_MODULE_ID index,
+        CAN_FIFO_CHANNEL channel, CAN_TXRING_POLICY policy, uint32_t* storage,
+        uint8_t depth, uint8_t dataBytes)
+{
+    // Indexes are free running, slot is index & (depth - 1)
+    if ((depth == 0) || (depth > 128) || (depth & (depth - 1)) || (dataBytes > MAX_DATA_BYTES)
+            || (channel >= CAN_FIFO_TOTAL_CHANNELS)) {
+        return -1;
+    }
+
+    ring->index = index;
+    ring->channel = channel;
+    ring->policy = policy;
+    ring->storage = storage;
+    ring->slots = NULL;
+    ring->slab = NULL;
+    ring->depth = depth;
+    ring->entryWords = CAN_TXRING_ENTRY_WORDS(dataBytes);
+    ring->dataBytes = dataBytes;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->eventEnabled = false;
+    ring->submitted = 0;
+    ring->transmitted = 0;
+    ring->rejected = 0;
+    ring->dropped = 0;
+    ring->statusReads = 0;
+    ring->highWatermark = 0;
+
+    return 0;
+}
+
+int8_t DRV_CANFDSPI_TxRingInitializeSlab(CAN_TXRING* ring, CANFDSPI_MODULE_ID index,
+        CAN_FIFO_CHANNEL channel, CAN_TXRING_POLICY policy, CAN_SLAB_FRAME** slots,
+        uint8_t depth, CAN_SLAB* slab)
+{
+    if (DRV_CANFDSPI_TxRingInitialize(ring, index, channel, policy, NULL, depth, MAX_DATA_BYTES)) {
+        return -1;
+    }
+
+    ring->slots = slots;
+    ring->slab = slab;
+
+    return 0;
+}
+
+int8_t DRV_CANFDSPI_TxRingSubmit(CAN_TXRING* ring, const CAN_TX_MSGOBJ* txObj,
+        const uint8_t* txd, uint8_t txdNumBytes)
+{
+    uint32_t dataBytesInObject;
+    CAN_SLAB_FRAME* frame = NULL;
+    uint32_t* entry;
+    uint8_t* entryData;
+    uint32_t lockState;
+    uint8_t count;
+    uint8_t i;
+    bool full;
+    int8_t result = 0;
+
+    // Check that DLC is big enough for data and fit into ring entry
+    dataBytesInObject = DRV_CANFDSPI_DlcToDataBytes((CAN_DLC) txObj->bF.ctrl.DLC);
+    if ((dataBytesInObject < txdNumBytes) || (dataBytesInObject > ring->dataBytes)) {
+        return -3;
+    }
+
+    full = ((uint16_t) (ring->tail - ring->head) >= ring->depth);
+
+    if (full && (ring->policy == CAN_TXRING_BACKPRESSURE)) {
+        ring->rejected++;
+        return -1;
+    }
+    if (full && (ring->policy == CAN_TXRING_DROP_NEWEST)) {
+        ring->dropped++;
+        return -2;
+    }
+
+    // Slab without free block is handled like full ring, only the oldest frame isn't
+    // dropped because its block can be from other class
+    if (ring->slab != NULL) {
+        frame = DRV_CANFDSPI_SlabAlloc(ring->slab, dataBytesInObject);
+
+        if ((frame == NULL) && (ring->policy == CAN_TXRING_BACKPRESSURE)) {
+            ring->rejected++;
+            return -1;
+        }
+        if (frame == NULL) {
+            ring->dropped++;
+            return -2;
+        }
+    }
+
+    // DROP_OLDEST policy, head is moved with interrupts disabled so service called from
+    // interrupt can't write dropped entry to TX FIFO. Service could free slot meanwhile.
+    if (full) {
+        CAN_SLAB_LOCK(lockState);
+        if ((uint16_t) (ring->tail - ring->head) >= ring->depth) {
+            if (ring->slab != NULL) {
+                DRV_CANFDSPI_SlabFree(ring->slab, ring->slots[ring->head & (ring->depth - 1)]);
+            }
+            ring->head++;
+            ring->dropped++;
+            result = 1;
+        }
+        CAN_SLAB_UNLOCK(lockState);
+    }
+
+    if (frame != NULL) {
+        ring->slots[ring->tail & (ring->depth - 1)] = frame;
+        entry = frame->word;
+    } else {
+        entry = &ring->storage[(ring->tail & (ring->depth - 1)) * ring->entryWords];
+    }
+    entry[0] = txObj->word[0];
+    entry[1] = txObj->word[1];
+
+    entryData = (uint8_t*) &entry[2];
+    for (i = 0; i < txdNumBytes; i++) {
+        entryData[i] = txd[i];
+    }
+    for (; i < CAN_PADDED_DATA_BYTES(dataBytesInObject); i++) {
+        entryData[i] = 0;
+    }
+
+    // Entry must be complete before service can see it
+    CAN_SLAB_BARRIER();
+    ring->tail++;
+    ring->submitted++;
+
+    count = ring->tail - ring->head;
+    if (count > ring->highWatermark) {
+        ring->highWatermark = count;
+    }
+
+    return result;
+}
+
+int8_t DRV_CANFDSPI_TxRingService(CAN_TXRING* ring)
+{
+    uint32_t fifoReg[3];
+    REG_CiFIFOSTA ciFifoSta;
+    CAN_TX_MSGOBJ* txObj;
+    uint32_t* entry;
+    uint16_t n;
+    bool pending;
+
+    while (ring->head != ring->tail) {
+        // Read CiFIFOCON, CiFIFOSTA and CiFIFOUA
+        if (DRV_CANFDSPI_ReadWordArray(ring->index,
+                cREGADDR_CiFIFOCON + (ring->channel * CiFIFO_OFFSET), fifoReg, 3)) {
+            return -1;
+        }
+        ring->statusReads++;
+
+        ciFifoSta.word = fifoReg[1];
+        if (!ciFifoSta.txBF.TxNotFullIF) {
+            break;
+        }
+
+        CAN_SLAB_BARRIER();
+        if (ring->slab != NULL) {
+            entry = ring->slots[ring->head & (ring->depth - 1)]->word;
+        } else {
+            entry = &ring->storage[(ring->head & (ring->depth - 1)) * ring->entryWords];
+        }
+        txObj = (CAN_TX_MSGOBJ*) entry;
+        n = 8 + CAN_PADDED_DATA_BYTES(DRV_CANFDSPI_DlcToDataBytes((CAN_DLC) txObj->bF.ctrl.DLC));
+
+        if (DRV_CANFDSPI_WriteByteArray(ring->index, DRV_CANFDSPI_UA_TO_RAMADDR(fifoReg[2]),
+                (uint8_t*) entry, n)) {
+            return -1;
+        }
+
+        // Set UINC and TXREQ
+        if (DRV_CANFDSPI_TransmitChannelUpdate(ring->index, ring->channel, true)) {
+            return -1;
+        }
+
+        if (ring->slab != NULL) {
+            DRV_CANFDSPI_SlabFree(ring->slab, (CAN_SLAB_FRAME*) entry);
+        }
+
+        // Entry is released to submit only after it was written to TX FIFO
+        CAN_SLAB_BARRIER();
+        ring->head++;
+        ring->transmitted++;
+    }
+
+    // TX FIFO not full interrupt is active only while frames wait in ring
+    pending = (ring->head != ring->tail);
+    if (pending != ring->eventEnabled) {
+        if (pending) {
+            if (DRV_CANFDSPI_TransmitChannelEventEnable(ring->index, ring->channel,
+                    CAN_TX_FIFO_NOT_FULL_EVENT)) {
+                return -1;
+            }
+        } else {
+            if (DRV_CANFDSPI_TransmitChannelEventDisable(ring->index, ring->channel,
+                    CAN_TX_FIFO_NOT_FULL_EVENT)) {
+                return -1;
+            }
+        }
+        ring->eventEnabled = pending;
+    }
+
+    return pending ? 1 : 0;
+}
+
+uint8_t DRV_CANFDSPI_TxRingCount(const CAN_TXRING* ring)
+{
+    return ring->tail - ring->head;
+}
@@ -32,6 +32,16 @@ DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
  *****************************************************************************************/
 
 #include "../driver/canfdspi/drv_canfdspi_api.h"
+#include "../driver/canfdspi/drv_canfdspi_codec.h"
+#include "../driver/canfdspi/drv_canfdspi_bittime.h"
+#include "../driver/canfdspi/drv_canfdspi_tdc.h"
+#include "../driver/canfdspi/drv_canfdspi_image.h"
+#include "../driver/canfdspi/drv_canfdspi_ramplan.h"
+#include "../driver/canfdspi/drv_canfdspi_txring.h"
+#include "../driver/canfdspi/drv_canfdspi_slab.h"
+#include "../driver/canfdspi/drv_canfdspi_dispatch.h"
+#include "../driver/canfdspi/drv_canfdspi_recovery.h"
+#include "../driver/canfdspi/drv_canfdspi_busload.h"
 #include "../driver/spi/drv_spi.h"
 #include "LPC11xx.h"
 
@@ -44,28 +54,138 @@ DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
 // Receive FIFO channel
 #define CAN_RX_FIFO CAN_FIFO_CH1
 
-// Maximal amount of test that TX fifo isn't full
-#define MAX_TXQUEUE_ATTEMPTS 20
-
-// CAN configuration object
-CAN_CONFIG canConfig;
+// Amount of frames which can wait in MCU RAM when TX FIFO is full
+#define CAN_TX_RING_DEPTH 8
+
+// Amount of received frames which can wait for main loop(power of two)
+#define CAN_RX_QUEUE_DEPTH 32
+
+// Slab blocks for 8, 16, 32 and 64 bytes payload shared by TX ring and RX queue. 64
+// bytes blocks are enough for full TX ring and few received FD frames, classic frames
+// use 20 bytes blocks instead of 76 bytes fixed slots.
+#define CAN_SLAB_BLOCKS_8 16
+#define CAN_SLAB_BLOCKS_16 4
+#define CAN_SLAB_BLOCKS_32 4
+#define CAN_SLAB_BLOCKS_64 12
+
+// Maximal RAM used by frames in MCU, the smallest supported MCUs have only 4KB of RAM
+#define CAN_FRAME_RAM_BUDGET 1536
+
+// Payload size of TX and RX FIFO
+#define CAN_TX_FIFO_PLSIZE CAN_PLSIZE_64
+#define CAN_RX_FIFO_PLSIZE CAN_PLSIZE_64
+
+// DLC of transmitted test frames
+#define CAN_TX_DLC CAN_DLC_64
+
+// Bit rates and SYSCLK of MCP2517FD
+#define CAN_NOMINAL_BITRATE 500000
+#define CAN_DATA_BITRATE 2000000
+#define CAN_SYSCLK 40000000
+
+// Maximal amount of OPMOD reads after Normal Mode request
+#define MAX_MODE_CHANGE_ATTEMPTS 10000
+
+// Set to 1 to calibrate transmitter delay compensation in external loopback mode
+// during startup. Calibrated profile can be read by debugger and stored as constant.
+#define CAN_TDC_CALIBRATION_ENABLE 0
+
+// Codecs specialized for above FIFO configuration
+DRV_CANFDSPI_DEFINE_TX_CODEC(CanTxFd64, CAN_TX_DLC)
+CAN_TX_CODEC_CHECK(CanTxFd64, CAN_TX_DLC, CAN_TX_FIFO_PLSIZE);
+
+// Bit time used when TDC profile isn't valid
+CAN_IMAGE_NBTCFG_CHECK(CanImage, CAN_SYSCLK, 0, CAN_NOMINAL_BITRATE, CAN_BITTIME_DEFAULT_SAMPLE_POINT);
+CAN_IMAGE_DBTCFG_CHECK(CanImage, CAN_SYSCLK, 0, CAN_DATA_BITRATE, CAN_BITTIME_DEFAULT_SAMPLE_POINT);
+
+// FIFO configuration: TXQ not used, RX FIFO with time stamp and interrupt when not
+// empty, TX FIFO with priority 1 and unlimited retransmission attempts
+#define CAN_RX_FIFOCON_IMAGE CAN_IMAGE_FIFOCON_RX(15, CAN_RX_FIFO_PLSIZE, 1, CAN_RX_FIFO_NOT_EMPTY_EVENT)
+#define CAN_TX_FIFOCON_IMAGE CAN_IMAGE_FIFOCON_TX(7, CAN_TX_FIFO_PLSIZE, 1, 3, CAN_TX_FIFO_NO_EVENT)
+
+static const uint32_t canFifoConImage[] = {
+	[CAN_TXQUEUE_CH0] = CAN_IMAGE_FIFOCON_RESET,
+	[CAN_RX_FIFO] = CAN_RX_FIFOCON_IMAGE,
+	[CAN_TX_FIFO] = CAN_TX_FIFOCON_IMAGE
+};
+
+// TEF confirm transmitted frames for bus load statistics. It has the same depth as TX FIFO
+// and is read before TX FIFO is refilled, so it can't overflow.
+#define CAN_TEFCON_IMAGE CAN_IMAGE_TEFCON(7, 1)
+
+// TEF, TXQ(enabled after reset), RX FIFO and TX FIFO must fit into message RAM.
+// Layout for other traffic mix can be calculated by HostTools/RamLayoutPlanner.
+CAN_RAM_LAYOUT_CHECK(CanRam, CAN_RAM_TEFCON_BYTES(CAN_TEFCON_IMAGE) +
+		CAN_RAM_FIFOCON_BYTES(CAN_IMAGE_FIFOCON_RESET) + CAN_RAM_FIFOCON_BYTES(CAN_RX_FIFOCON_IMAGE) +
+		CAN_RAM_FIFOCON_BYTES(CAN_TX_FIFOCON_IMAGE));
+
+// Filter 0 accept only standard ID 0xDA and store it in RX FIFO, other frames are rejected
+// by controller without SPI transfer. Filters for list of IDs can be generated by
+// HostTools/FilterCompiler(e.g. FilterCompiler 0DA 100 101 102 103).
+static const uint32_t canFilterObjImage[] = {
+	CAN_IMAGE_FLTOBJ_SID(0xda), CAN_IMAGE_MASK(0x7ff, 0x0, 1)
+};
+
+static const uint8_t canFilterConImage[] = {
+	CAN_IMAGE_FLTCON(CAN_RX_FIFO)
+};
+
+// Whole controller configuration written during initialization
+static const CAN_CONFIG_IMAGE canConfigImage = {
+	.con = CAN_IMAGE_CON_RESET,
+	.nbtcfg = CAN_IMAGE_BTCFG(CAN_SYSCLK, 0, CAN_NOMINAL_BITRATE, CAN_BITTIME_DEFAULT_SAMPLE_POINT),
+	.dbtcfg = CAN_IMAGE_BTCFG(CAN_SYSCLK, 0, CAN_DATA_BITRATE, CAN_BITTIME_DEFAULT_SAMPLE_POINT),
+	.tdc = CAN_IMAGE_TDC_AUTO(CAN_SYSCLK, 0, CAN_DATA_BITRATE, CAN_BITTIME_DEFAULT_SAMPLE_POINT),
+	.tscon = CAN_IMAGE_TSCON(CAN_SYSCLK / 1000000),
+	.intEnable = CAN_TX_EVENT | CAN_RX_EVENT | CAN_BUS_ERROR_EVENT,
+	.tefcon = CAN_TEFCON_IMAGE,
+	.fifoCon = canFifoConImage,
+	.nFifo = sizeof(canFifoConImage) / sizeof(canFifoConImage[0]),
+	.filterObj = canFilterObjImage,
+	.filterCon = canFilterConImage,
+	.nFilters = sizeof(canFilterConImage) / sizeof(canFilterConImage[0])
+};
 
 // Transmit objects
-CAN_TX_FIFO_CONFIG canTxConfig;
-CAN_TX_MSGOBJ canTxObj;
-
-// Receive objects
-CAN_RX_FIFO_CONFIG canRxConfig;
-REG_CiFLTOBJ canFifoFilterObj;
-REG_CiMASK canFifoMaskObj;
-
-CAN_RX_MSGOBJ canRxMsgObj;
-uint8_t canRxMsgPayload[MAX_DATA_BYTES];
-
-// Comunication status flags and error counters which is get from CiTREC register
-CAN_ERROR_STATE canErrorFlags;
-uint8_t canTrasmitErrorCounter;
-uint8_t canReceiveErrorCounter;
+CanTxFd64_TX_FRAME canTxFrame;
+
+// Frame memory of TX ring and RX queue
+CAN_SLAB canSlab;
+static const uint8_t canSlabBlocks[CAN_SLAB_CLASSES] = {
+	CAN_SLAB_BLOCKS_8, CAN_SLAB_BLOCKS_16, CAN_SLAB_BLOCKS_32, CAN_SLAB_BLOCKS_64
+};
+static uint32_t canSlabMemory[CAN_SLAB_MEMORY_WORDS(CAN_SLAB_BLOCKS_8, CAN_SLAB_BLOCKS_16,
+		CAN_SLAB_BLOCKS_32, CAN_SLAB_BLOCKS_64)];
+typedef char CanSlabFitsRamBudget[(sizeof(canSlabMemory) <= CAN_FRAME_RAM_BUDGET) ? 1 : -1];
+
+// Software TX ring placed before TX FIFO
+CAN_TXRING canTxRing;
+static CAN_SLAB_FRAME* canTxRingSlots[CAN_TX_RING_DEPTH];
+
+// Received frames passed from SysTick interrupt to main loop, time stamp in us
+CAN_SLAB_QUEUE canRxQueue;
+static CAN_SLAB_FRAME* canRxQueueSlots[CAN_RX_QUEUE_DEPTH];
+
+// Handlers of received frames selected by filter which accepted frame. Every filter
+// accept single ID so ID table(CAN_DISPATCH_TABLE) isn't needed, frames of filters
+// without handler are counted in canFilterDispatch.rejected.
+void CanMessage0DAHandler(const CAN_RX_MSGOBJ* header, uint8_t* data);
+
+CAN_FILTER_DISPATCH canFilterDispatch;
+
+// Bit time configuration and TDC profile applied during initialization
+CAN_BITTIME_SOLVER_CONFIG canBitTimeConfig;
+CAN_TDC_PROFILE canTdcProfile;
+
+// Comunication status flags and error counters which is get from CiTREC register, bus off
+// statistics(offline time in us, CiTBC is incremented every 1us)
+CAN_RECOVERY canRecovery;
+
+// Bus load and per ID statistics of received and transmitted frames, snapshot is taken
+// every 5 SysTick periods(window must be shorter than 4s). CiTBC time in us is read then.
+CAN_BUSLOAD canBusLoad;
+CAN_BUSLOAD_SNAPSHOT canBusLoadSnapshot;
+uint32_t canTime;
 
 /*****************************************************************************************
  * Application variables
@@ -73,6 +193,38 @@ uint8_t canReceiveErrorCounter;
 uint32_t canRxMessageCounter;
 uint32_t interruptCounter;
 
+// Duration of RAM initialization and whole initialization until chip enter Normal Mode
+// in core clock cycles. Measured by SysTick so values above 2^24 cycles are not valid.
+uint32_t canRamInitTime;
+uint32_t canStartupTime;
+
+// Core clock cycles of the last dispatched frame(handler lookup and call)
+uint32_t canDispatchCycles;
+
+/*****************************************************************************************
+* StartupTimerStart() - start SysTick as free running down counter without interrupt. It is
+* used only during initialization, later main configure SysTick for periodic interrupt.
+*
+*****************************************************************************************/
+void StartupTimerStart(void)
+{
+	SysTick->CTRL = 0;
+	SysTick->LOAD = 0xFFFFFF;
+	SysTick->VAL = 0;
+
+	// Set bit 0(ENABLE) and 2(CLKSOURCE) so counter is clocked by core clock
+	SysTick->CTRL = 5;
+}
+
+/*****************************************************************************************
+* StartupTimerRead() - return amount of core clock cycles since StartupTimerStart().
+*
+*****************************************************************************************/
+uint32_t StartupTimerRead(void)
+{
+	return 0xFFFFFF - SysTick->VAL;
+}
+
 /*****************************************************************************************
 * InitCanFdChip() - initialize MCP2517FD chip to work with appropriate baudrate and mode.
 * During initialization is also correctly configured RX and TX FIFO.
@@ -80,6 +232,11 @@ uint32_t interruptCounter;
 *****************************************************************************************/
 void InitCanFdChip(void)
 {
+	uint32_t attempts = 0;
+	uint32_t bitTimeReg[2];
+
+	StartupTimerStart();
+
 	// Reset device
 	DRV_CANFDSPI_Reset(DRV_CANFDSPI_INDEX_0);
 
@@ -88,56 +245,83 @@ void InitCanFdChip(void)
 
 	DRV_CANFDSPI_RamInit(DRV_CANFDSPI_INDEX_0, 0xff);
 
-	// Configure device by set CiCON register
-	DRV_CANFDSPI_ConfigureObjectReset(&canConfig);
-	canConfig.IsoCrcEnable = 1;
-	canConfig.StoreInTEF = 0;
-
-	DRV_CANFDSPI_Configure(DRV_CANFDSPI_INDEX_0, &canConfig);
+	canRamInitTime = StartupTimerRead();
 
-	// Setup TX FIFO by set CiFIFOCON register
-	DRV_CANFDSPI_TransmitChannelConfigureObjectReset(&canTxConfig);
-	canTxConfig.FifoSize = 7;
-	canTxConfig.PayLoadSize = CAN_PLSIZE_64;
-	canTxConfig.TxPriority = 1;
+	// Configure CiCON, bit time, FIFOs, filter and interrupts by few burst writes
+	DRV_CANFDSPI_ConfigImageApply(DRV_CANFDSPI_INDEX_0, &canConfigImage);
 
-	DRV_CANFDSPI_TransmitChannelConfigure(DRV_CANFDSPI_INDEX_0, CAN_TX_FIFO, &canTxConfig);
+	// Frames which don't fit into TX FIFO are stored in ring, caller is informed when
+	// ring is full
+	DRV_CANFDSPI_SlabInitialize(&canSlab, canSlabMemory, sizeof(canSlabMemory) / 4, canSlabBlocks);
 
-	// Setup RX FIFO by set CiFIFOCON register
-	DRV_CANFDSPI_ReceiveChannelConfigureObjectReset(&canRxConfig);
-	canRxConfig.FifoSize = 15;
-	canRxConfig.PayLoadSize = CAN_PLSIZE_64;
+	DRV_CANFDSPI_TxRingInitializeSlab(&canTxRing, DRV_CANFDSPI_INDEX_0, CAN_TX_FIFO,
+			CAN_TXRING_BACKPRESSURE, canTxRingSlots, CAN_TX_RING_DEPTH, &canSlab);
 
-	DRV_CANFDSPI_ReceiveChannelConfigure(DRV_CANFDSPI_INDEX_0, CAN_RX_FIFO, &canRxConfig);
+	DRV_CANFDSPI_SlabQueueInitialize(&canRxQueue, canRxQueueSlots, CAN_RX_QUEUE_DEPTH);
 
-	// Setup RX Filter by set CiFLTOBJ0 register
-	canFifoFilterObj.word = 0;
-	canFifoFilterObj.bF.SID = 0xda;
-	canFifoFilterObj.bF.EXIDE = 0;
-	canFifoFilterObj.bF.EID = 0x00;
+	// Filter 0 is configured by canConfigImage, next filters can be allocated together
+	// with handler by DRV_CANFDSPI_FilterHandlerRegister
+	DRV_CANFDSPI_FilterDispatchInitialize(&canFilterDispatch, 0, NULL);
+	DRV_CANFDSPI_FilterHandlerSet(&canFilterDispatch, CAN_FILTER0, CanMessage0DAHandler);
 
-	DRV_CANFDSPI_FilterObjectConfigure(DRV_CANFDSPI_INDEX_0, CAN_FILTER0, &canFifoFilterObj.bF);
+	// After bus off chip is returned to Normal Mode and frames from TX FIFO are sent again
+	DRV_CANFDSPI_RecoveryInitialize(&canRecovery, DRV_CANFDSPI_INDEX_0, CAN_NORMAL_MODE,
+			1 << CAN_TX_FIFO);
 
-	// Setup RX Mask by set CiMASK0 register
-	canFifoMaskObj.word = 0;
-	canFifoMaskObj.bF.MSID = 0x0;
-	canFifoMaskObj.bF.MIDE = 1; // Only allow standard IDs
-	canFifoMaskObj.bF.MEID = 0x0;
-	DRV_CANFDSPI_FilterMaskConfigure(DRV_CANFDSPI_INDEX_0, CAN_FILTER0, &canFifoMaskObj.bF);
+	// When valid TDC profile exist then data bit rate and TDC are taken from it
+	DRV_CANFDSPI_BitTimeSolverConfigObjectReset(&canBitTimeConfig);
+	canBitTimeConfig.sysClk = CAN_SYSCLK;
+	canBitTimeConfig.nominalBitRate = CAN_NOMINAL_BITRATE;
+	canBitTimeConfig.dataBitRate = CAN_DATA_BITRATE;
+	canBitTimeConfig.loopDelay = CAN_BITTIME_LOOP_DELAY_OPTO;
 
-	// Link FIFO and Filter by set CiFLTCON0 register
-	DRV_CANFDSPI_FilterToFifoLink(DRV_CANFDSPI_INDEX_0, CAN_FILTER0, CAN_RX_FIFO, true);
+	DRV_CANFDSPI_TdcProfileApply(DRV_CANFDSPI_INDEX_0, &canTdcProfile, &canBitTimeConfig);
 
-	// Setup Bit Time
-	DRV_CANFDSPI_BitTimeConfigure(DRV_CANFDSPI_INDEX_0, CAN_500K_2M, CAN_SSP_MODE_AUTO, CAN_SYSCLK_40M);
-
-	DRV_CANFDSPI_ReceiveChannelEventEnable(DRV_CANFDSPI_INDEX_0, CAN_RX_FIFO, CAN_RX_FIFO_NOT_EMPTY_EVENT);
-	DRV_CANFDSPI_ModuleEventEnable(DRV_CANFDSPI_INDEX_0, CAN_TX_EVENT | CAN_RX_EVENT);
+	// Bit rates are read back from chip, data bit rate can be taken from profile
+	DRV_CANFDSPI_ReadWordArray(DRV_CANFDSPI_INDEX_0, cREGADDR_CiNBTCFG, bitTimeReg, 2);
+	DRV_CANFDSPI_BusLoadInitializeBitTime(&canBusLoad, CAN_SYSCLK, bitTimeReg[0], bitTimeReg[1], 0);
 
 	// Select Normal Mode
 	DRV_CANFDSPI_OperationModeSelect(DRV_CANFDSPI_INDEX_0, CAN_NORMAL_MODE);
+
+	// Chip is ready for bus communication when mode is changed(after bus integration)
+	while ((DRV_CANFDSPI_OperationModeGet(DRV_CANFDSPI_INDEX_0) != CAN_NORMAL_MODE) &&
+			(attempts < MAX_MODE_CHANGE_ATTEMPTS))
+	{
+		attempts++;
+	}
+
+	canStartupTime = StartupTimerRead();
+
+	// Stop counter, bit 2(CLKSOURCE) stay set so SysTick remain clocked by core clock
+	SysTick->CTRL = 4;
 }
 
+#if CAN_TDC_CALIBRATION_ENABLE
+/*****************************************************************************************
+* CalibrateTdc() - measure loop delay via CANTXD, transceiver and CANRXD for list of data
+* bit rates and store result in canTdcProfile. Chip is initialized again after calibration
+* so profile is applied and frames received in loopback mode are removed.
+*
+*****************************************************************************************/
+void CalibrateTdc(void)
+{
+	static const uint32_t dataBitRates[] = {1000000, 2000000, 4000000, 5000000, 8000000};
+	CAN_TDC_CALIBRATION_CONFIG calibrationConfig;
+
+	InitCanFdChip();
+
+	DRV_CANFDSPI_TdcCalibrationConfigObjectReset(&calibrationConfig);
+	calibrationConfig.txChannel = CAN_TX_FIFO;
+	calibrationConfig.dlc = CAN_TX_DLC;
+
+	DRV_CANFDSPI_TdcCalibrate(DRV_CANFDSPI_INDEX_0, &calibrationConfig, &canBitTimeConfig,
+			dataBitRates, sizeof(dataBitRates) / sizeof(dataBitRates[0]), &canTdcProfile);
+
+	InitCanFdChip();
+}/* void CalibrateTdc(void) */
+#endif
+
 /*****************************************************************************************
 * TestCanChipRamAccess() - very useful function which can be used to verify that SPI
 * connection work correctly. For tested microcontroller not connected SPI to MCP2517FD
@@ -183,7 +367,9 @@ bool TestCanChipRamAccess(void)
 }/* bool TestCanChipRamAccess(void) */
 
 /*****************************************************************************************
-* ReceiveCanMessage() - receive single message from FIFO buffer if isn't empty.
+* ReceiveCanMessage() - move single message from FIFO buffer to RX queue if isn't empty.
+* Message is stored in slab block which fit its DLC and processed later in main loop.
+* When queue or slab is full message is dropped and counted in canRxQueue.overruns.
 *
 *****************************************************************************************/
 void ReceiveCanMessage(void)
@@ -194,92 +380,154 @@ void ReceiveCanMessage(void)
 
 	if (canRxFlags & CAN_RX_FIFO_NOT_EMPTY_EVENT)
 	{
-		// Get CAN RX message and move to global variable
-		DRV_CANFDSPI_ReceiveMessageGet(DRV_CANFDSPI_INDEX_0, CAN_RX_FIFO, &canRxMsgObj,
-			canRxMsgPayload, MAX_DATA_BYTES);
+		DRV_CANFDSPI_SlabReceive(&canSlab, &canRxQueue, DRV_CANFDSPI_INDEX_0, CAN_RX_FIFO, true);
+	}
+}/* void ReceiveCanMessage(void) */
+
+/*****************************************************************************************
+* CanMessage0DAHandler() - process message with standard ID 0xDA. User can add here own
+* code to process payload of received message. Handlers for other IDs can be added by
+* DRV_CANFDSPI_FilterHandlerRegister.
+*
+*****************************************************************************************/
+void CanMessage0DAHandler(const CAN_RX_MSGOBJ* header, uint8_t* data)
+{
+	(void)header;
+	(void)data;
+
+	canRxMessageCounter++;
+}/* void CanMessage0DAHandler(const CAN_RX_MSGOBJ* header, uint8_t* data) */
+
+/*****************************************************************************************
+* ProcessCanMessages() - process all messages waiting in RX queue. Function is called from
+* main loop so interrupt can receive next messages during processing. Every message is
+* passed to handler of filter which accepted it.
+*
+*****************************************************************************************/
+void ProcessCanMessages(void)
+{
+	CAN_SLAB_FRAME* canRxFrame;
+	uint32_t start, end;
+
+	while ((canRxFrame = DRV_CANFDSPI_SlabQueueGet(&canRxQueue)) != NULL)
+	{
+		// Statistics are also updated from SysTick
+		__disable_irq();
+		DRV_CANFDSPI_BusLoadRxFrame(&canBusLoad, &canRxFrame->rx, CAN_SLAB_RX_DATA(canRxFrame));
+		__enable_irq();
 
-		// User can add here own code to process payload of received message
+		start = SysTick->VAL;
 
+		DRV_CANFDSPI_FilterDispatch(&canFilterDispatch, &canRxFrame->rx, CAN_SLAB_RX_DATA(canRxFrame));
 
-		canRxMessageCounter++;
+		// SysTick count down, measurement with reload during dispatch is skipped
+		end = SysTick->VAL;
+		if (end < start)
+		{
+			canDispatchCycles = start - end;
+		}
+
+		DRV_CANFDSPI_SlabFree(&canSlab, canRxFrame);
 	}
-}/* void ReceiveCanMessage(void) */
+}/* void ProcessCanMessages(void) */
 
 /*****************************************************************************************
-* TransmitCanMessage() - send multiply frame with similar payload when FIFO buffer is
-* empty or send single message when FIFO buffer isn't full. Function also assign information
-* to appropriate gobal variable when send isn't possible.
+* TransmitCanMessage() - send multiply frame with similar payload when nothing wait for
+* transmission or send single message otherwise. Frames are stored in software TX ring
+* so function never wait for TX FIFO. When ring is full(bus is congested) frame isn't
+* sent and device status is assigned to appropriate global variable.
 *
 *****************************************************************************************/
 void TransmitCanMessage(void)
 {
-	uint8_t dlcToByteSize;
-	uint8_t txd[MAX_DATA_BYTES];
-	CAN_TX_FIFO_EVENT canTxFlags;
-
-	// Initialize CAN structure with information about CAN ID, length and flags
-	canTxObj.bF.id.SID = 0x100;//CAN ID message
+	int frames = 1;
 
-	canTxObj.bF.ctrl.DLC = 15;
-	canTxObj.bF.ctrl.IDE = 0;
-	canTxObj.bF.ctrl.BRS = 1;
-	canTxObj.bF.ctrl.FDF = 1;
+	// Initialize CAN structure with information about CAN ID and flags
+	canTxFrame.header.bF.id.SID = 0x100;//CAN ID message
 
-	dlcToByteSize = DRV_CANFDSPI_DlcToDataBytes((CAN_DLC) 15);
+	canTxFrame.header.bF.ctrl.DLC = CAN_TX_DLC;
+	canTxFrame.header.bF.ctrl.IDE = 0;
+	canTxFrame.header.bF.ctrl.BRS = 1;
+	canTxFrame.header.bF.ctrl.FDF = 1;
 
 	// Initialize CAN payload by random data
-	for (int i = 0; i < dlcToByteSize; i++)
+	for (int i = 0; i < CanTxFd64_DATA_BYTES; i++)
 	{
-		txd[i] = rand() & 0xff;
+		canTxFrame.data.byte[i] = rand() & 0xff;
 	}
 
+	// Check that nothing wait for transmission and then send many data
+	if (DRV_CANFDSPI_TxRingCount(&canTxRing) == 0)
 	{
-		uint8_t attempts = MAX_TXQUEUE_ATTEMPTS;
+		frames = 4;
+	}
 
-		// Check if FIFO is not full
-		do
+	for (int i = 0; i < frames; i++)
+	{
+		if (frames > 1)
 		{
-			// Get transmission status flags for coresponding FIFO buffer
-			DRV_CANFDSPI_TransmitChannelEventGet(DRV_CANFDSPI_INDEX_0, CAN_TX_FIFO, &canTxFlags);
-
-			// When send isn't possible then check device status
-			if (attempts == 0)
-			{
-				Nop();
-				DRV_CANFDSPI_ErrorCountStateGet(DRV_CANFDSPI_INDEX_0, &canTrasmitErrorCounter,
-						&canReceiveErrorCounter, &canErrorFlags);
-				return;
-			}
-
-			attempts--;
+			canTxFrame.data.byte[0] = i;
 		}
-		while (!(canTxFlags & CAN_TX_FIFO_NOT_FULL_EVENT));
 
-		// Check that buffer is empty and then send many data via buffer
-		if (canTxFlags & CAN_TX_FIFO_EMPTY_EVENT)
+		// When send isn't possible then device status is available in canRecovery
+		if (DRV_CANFDSPI_TxRingSubmit(&canTxRing, &canTxFrame.header, canTxFrame.data.byte,
+				CanTxFd64_DATA_BYTES) < 0)
 		{
-			for (int i = 0; i < 4; i++)
-			{
-				txd[0] = i;
-
-				// Transmit CAN message
-				DRV_CANFDSPI_TransmitChannelLoad(DRV_CANFDSPI_INDEX_0, CAN_TX_FIFO, &canTxObj, txd, dlcToByteSize, true);
-			}
+			Nop();
+			break;
 		}
-		else// Buffer is not full and isn't empty so then send single CAN message
+	}
+
+	// Move frames to TX FIFO, rest is moved when TX FIFO isn't full
+	DRV_CANFDSPI_TxRingService(&canTxRing);
+}/* void TransmitCanMessage(void) */
+
+/*****************************************************************************************
+* ConfirmCanMessages() - account frames transmitted on the bus in bus load statistics.
+* Frames are taken from TEF, so frames rejected by TX ring or not sent during bus off
+* aren't counted.
+*
+*****************************************************************************************/
+void ConfirmCanMessages(void)
+{
+	CAN_TEF_FIFO_STATUS tefStatus = CAN_TEF_FIFO_EMPTY;
+	CAN_TEF_MSGOBJ tefObj;
+
+	DRV_CANFDSPI_TefStatusGet(DRV_CANFDSPI_INDEX_0, &tefStatus);
+
+	while (tefStatus & CAN_TEF_FIFO_NOT_EMPTY)
+	{
+		if (DRV_CANFDSPI_TefMessageGet(DRV_CANFDSPI_INDEX_0, &tefObj))
 		{
-			// Transmit CAN message
-			DRV_CANFDSPI_TransmitChannelLoad(DRV_CANFDSPI_INDEX_0, CAN_TX_FIFO, &canTxObj, txd, dlcToByteSize, true);
+			break;
 		}
+
+		DRV_CANFDSPI_BusLoadTefFrame(&canBusLoad, &tefObj);
+
+		tefStatus = CAN_TEF_FIFO_EMPTY;
+		DRV_CANFDSPI_TefStatusGet(DRV_CANFDSPI_INDEX_0, &tefStatus);
 	}
-}/* void TransmitCanMessage(void) */
+}/* void ConfirmCanMessages(void) */
 
 void SysTick_Handler(void)
 {
+	// Error state is checked every tick, CiTREC is read only after error state change
+	DRV_CANFDSPI_RecoveryService(&canRecovery);
+
+	// Frames sent since previous tick are confirmed before TX FIFO is refilled
+	ConfirmCanMessages();
+
+	// Frames waiting in TX ring are moved to TX FIFO. Without INT pin handler TX FIFO
+	// not full event is polled here.
+	DRV_CANFDSPI_TxRingService(&canTxRing);
+
 	if(interruptCounter >= 5)
 	{
 		ReceiveCanMessage();
 
+		DRV_CANFDSPI_ReadWord(DRV_CANFDSPI_INDEX_0, cREGADDR_CiTBC, &canTime);
+		DRV_CANFDSPI_BusLoadSnapshot(&canBusLoad, canTime, &canBusLoadSnapshot);
+
 		TransmitCanMessage();
 
 		interruptCounter = 0;
@@ -295,7 +543,11 @@ int main(void)
 
 	DRV_SPI_Initialize();
 
+#if CAN_TDC_CALIBRATION_ENABLE
+	CalibrateTdc();
+#else
 	InitCanFdChip();
+#endif
 
 	ramTestStatus = TestCanChipRamAccess();
 
@@ -323,13 +575,14 @@ int main(void)
 	// Set counted value to SYST_RVR register
 	SysTick->LOAD = (1<<23);
 
-	// Set bit 0(ENABLE) and 1(TICKINT) in SYST_CSR register
-	SysTick->CTRL |= 3;
+	// Set bit 0(ENABLE), 1(TICKINT) and 2(CLKSOURCE) in SYST_CSR register
+	SysTick->CTRL = 7;
 
 	// Force the counter to be placed into memory
 	volatile static int i = 0 ;
-	// Enter an infinite loop, just incrementing a counter
+	// Enter an infinite loop, process received messages and increment a counter
 	while(1) {
+		ProcessCanMessages();
 		i++ ;
 	}
 	return 0 ;
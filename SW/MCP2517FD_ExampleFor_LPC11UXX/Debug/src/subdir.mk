@@ -12,6 +12,7 @@ C_SRCS += \
 ../src/MCP2517FD_ExampleFor_LPC11UXX.c \
 ../src/SPI_Driver.c \
 ../src/UART_Driver.c \
+../src/UART_RingBuffer.c \
 ../src/cr_startup_lpc11uxx.c \
 ../src/crp.c \
 ../src/sysinit.c 
@@ -22,6 +23,7 @@ OBJS += \
 ./src/MCP2517FD_ExampleFor_LPC11UXX.o \
 ./src/SPI_Driver.o \
 ./src/UART_Driver.o \
+./src/UART_RingBuffer.o \
 ./src/aeabi_romdiv_patch.o \
 ./src/cr_startup_lpc11uxx.o \
 ./src/crp.o \
@@ -33,6 +35,7 @@ C_DEPS += \
 ./src/MCP2517FD_ExampleFor_LPC11UXX.d \
 ./src/SPI_Driver.d \
 ./src/UART_Driver.d \
+./src/UART_RingBuffer.d \
 ./src/cr_startup_lpc11uxx.d \
 ./src/crp.d \
 ./src/sysinit.d 
@@ -892,6 +892,9 @@ int8_t DRV_CANFDSPI_EccEventClear(CANFDSPI_MODULE_ID index,
 
 // *****************************************************************************
 //! Initialize RAM
+/*!
+ * All cRAM_SIZE bytes are written with d in single SPI transfer.
+ */
 
 int8_t DRV_CANFDSPI_RamInit(CANFDSPI_MODULE_ID index, uint8_t d);
 
@@ -0,0 +1,325 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_canfdspi_bittime.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+
+//! Limits of bit time segments in TQ(register value + 1)
+
+typedef struct _CAN_BITTIME_LIMITS {
+    uint16_t maxTseg1;
+    uint16_t maxTseg2;
+    uint16_t minTq;
+} CAN_BITTIME_LIMITS;
+
+//! Solution for single phase, segments in TQ
+
+typedef struct _CAN_BITTIME_PHASE {
+    uint16_t brp;
+    uint16_t tseg1;
+    uint16_t tseg2;
+    uint16_t samplePoint;
+    uint32_t bitRate;
+} CAN_BITTIME_PHASE;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+//! CiNBTCFG: TSEG1 8 bits, TSEG2 7 bits, at least 8 TQ per bit
+static const CAN_BITTIME_LIMITS canNominalLimits = {256, 128, 8};
+
+//! CiDBTCFG: TSEG1 5 bits, TSEG2 4 bits, at least 4 TQ per bit(10Mbps at 40MHz)
+static const CAN_BITTIME_LIMITS canDataLimits = {32, 16, 4};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local functions
+
+//! Convert delay to SYSCLK periods, rounded up
+
+static uint32_t DRV_CANFDSPI_BitTimeNsToClocks(uint32_t sysClk, uint32_t ns)
+{
+    return (ns * (sysClk / 100000) + 9999) / 10000;
+}
+
+//! Convert SYSCLK periods to ns
+
+static int32_t DRV_CANFDSPI_BitTimeClocksToNs(uint32_t sysClk, int32_t clocks)
+{
+    return (clocks * 10000) / (int32_t) (sysClk / 100000);
+}
+
+//! Bit rate error in ppm
+
+static int32_t DRV_CANFDSPI_BitTimeErrorPpm(uint32_t realBitRate, uint32_t bitRate)
+{
+    uint32_t error = (realBitRate > bitRate) ? (realBitRate - bitRate) : (bitRate - realBitRate);
+    uint32_t kbps = (bitRate < 1000) ? 1 : (bitRate / 1000);
+    int32_t ppm;
+
+    // Bit has at least 4 TQ, so error is at most 1/8 of bit rate and error * 1000 fit
+    ppm = (int32_t) ((error * 1000) / kbps);
+
+    return (realBitRate > bitRate) ? ppm : -ppm;
+}
+
+//! Find prescaler and segments for single phase
+
+static bool DRV_CANFDSPI_BitTimeSolvePhase(uint32_t sysClk, uint32_t bitRate,
+        uint16_t samplePoint, uint16_t tolerance, const CAN_BITTIME_LIMITS* limits,
+        CAN_BITTIME_PHASE* phase)
+{
+    uint32_t brp;
+    uint32_t nTq;
+    uint32_t spTq;
+    uint32_t realBitRate;
+    uint32_t error;
+    uint32_t spError;
+    uint32_t bestError = 0xFFFFFFFF;
+    uint32_t bestSpError = 0xFFFFFFFF;
+    uint32_t maxError = (bitRate / 1000) * tolerance;
+
+    // Smallest bit rate error win, then sample point closest to requested and then
+    // first prescaler so bit has most TQ possible
+    for (brp = 1; brp <= 256; brp++) {
+        nTq = (sysClk + (brp * bitRate) / 2) / (brp * bitRate);
+        if (nTq < limits->minTq) {
+            break;
+        }
+        if (nTq > (1u + limits->maxTseg1 + limits->maxTseg2)) {
+            continue;
+        }
+
+        realBitRate = sysClk / (brp * nTq);
+        error = (realBitRate > bitRate) ? (realBitRate - bitRate) : (bitRate - realBitRate);
+        if ((error > maxError) || (error > bestError)) {
+            continue;
+        }
+
+        // Sample point counted from start of SYNC segment
+        spTq = (nTq * samplePoint + 500) / 1000;
+        if (spTq > (nTq - 1)) {
+            spTq = nTq - 1;
+        }
+        if (spTq > (1u + limits->maxTseg1)) {
+            spTq = 1u + limits->maxTseg1;
+        }
+        if ((spTq < 2) || ((nTq - spTq) > limits->maxTseg2)) {
+            continue;
+        }
+
+        spError = (spTq * 1000) / nTq;
+        spError = (spError > samplePoint) ? (spError - samplePoint) : (samplePoint - spError);
+        if ((error == bestError) && (spError >= bestSpError)) {
+            continue;
+        }
+
+        bestError = error;
+        bestSpError = spError;
+        phase->brp = brp;
+        phase->tseg1 = spTq - 1;
+        phase->tseg2 = nTq - spTq;
+        phase->samplePoint = (spTq * 1000) / nTq;
+        phase->bitRate = realBitRate;
+    }
+
+    return (bestError != 0xFFFFFFFF);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Bit Time Solver
+
+void DRV_CANFDSPI_BitTimeSolverConfigObjectReset(CAN_BITTIME_SOLVER_CONFIG* config)
+{
+    config->sysClk = 40000000;
+    config->nominalBitRate = 500000;
+    config->dataBitRate = 2000000;
+    config->nominalSamplePoint = CAN_BITTIME_DEFAULT_SAMPLE_POINT;
+    config->dataSamplePoint = CAN_BITTIME_DEFAULT_SAMPLE_POINT;
+    config->loopDelay = CAN_BITTIME_LOOP_DELAY_NO_OPTO;
+    config->busDelay = 0;
+    config->bitRateTolerance = CAN_BITTIME_DEFAULT_TOLERANCE;
+    config->sspMode = CAN_SSP_MODE_AUTO;
+}
+
+int8_t DRV_CANFDSPI_BitTimeSolve(const CAN_BITTIME_SOLVER_CONFIG* config,
+        CAN_BITTIME_SOLUTION* solution)
+{
+    CAN_BITTIME_PHASE nominal;
+    CAN_BITTIME_PHASE data;
+    CAN_SSP_MODE sspMode = config->sspMode;
+    uint32_t loopClocks;
+    uint32_t roundTripClocks;
+    int32_t propClocks;
+    uint32_t tdcOffset;
+    int8_t result = 0;
+
+    if ((config->sysClk < 100000) || (config->nominalBitRate == 0)
+            || ((config->dataBitRate != 0) && (config->dataBitRate < config->nominalBitRate))) {
+        return -1;
+    }
+
+    // Arbitration phase
+    if (!DRV_CANFDSPI_BitTimeSolvePhase(config->sysClk, config->nominalBitRate,
+            config->nominalSamplePoint, config->bitRateTolerance, &canNominalLimits, &nominal)) {
+        return -2;
+    }
+
+    solution->nbtcfg.word = canControlResetValues[cREGADDR_CiNBTCFG / 4];
+    solution->nbtcfg.bF.BRP = nominal.brp - 1;
+    solution->nbtcfg.bF.TSEG1 = nominal.tseg1 - 1;
+    solution->nbtcfg.bF.TSEG2 = nominal.tseg2 - 1;
+    solution->nbtcfg.bF.SJW = nominal.tseg2 - 1;
+    solution->nominalBitRate = nominal.bitRate;
+    solution->nominalBitRateError = DRV_CANFDSPI_BitTimeErrorPpm(nominal.bitRate, config->nominalBitRate);
+    solution->nominalSamplePoint = nominal.samplePoint;
+
+    // Phase segment 1 must be at least SJW, rest of TSEG1 is propagation segment
+    roundTripClocks = DRV_CANFDSPI_BitTimeNsToClocks(config->sysClk,
+            2 * ((uint32_t) config->loopDelay + config->busDelay));
+    propClocks = (int32_t) nominal.brp * ((int32_t) nominal.tseg1 - (int32_t) nominal.tseg2);
+    solution->nominalDelayMargin = DRV_CANFDSPI_BitTimeClocksToNs(config->sysClk,
+            propClocks - (int32_t) roundTripClocks);
+    if (solution->nominalDelayMargin < 0) {
+        result = -4;
+    }
+
+    // Data phase
+    solution->dbtcfg.word = canControlResetValues[cREGADDR_CiDBTCFG / 4];
+    solution->tdc.word = 0;
+    solution->dataDelayMargin = 0;
+
+    if (config->dataBitRate == 0) {
+        solution->dataBitRate = 0;
+        solution->dataBitRateError = 0;
+        solution->dataSamplePoint = 0;
+        solution->tdc.bF.TDCMode = CAN_SSP_MODE_OFF;
+        return result;
+    }
+
+    if (!DRV_CANFDSPI_BitTimeSolvePhase(config->sysClk, config->dataBitRate,
+            config->dataSamplePoint, config->bitRateTolerance, &canDataLimits, &data)) {
+        return -3;
+    }
+
+    solution->dbtcfg.bF.BRP = data.brp - 1;
+    solution->dbtcfg.bF.TSEG1 = data.tseg1 - 1;
+    solution->dbtcfg.bF.TSEG2 = data.tseg2 - 1;
+    solution->dbtcfg.bF.SJW = data.tseg2 - 1;
+    solution->dataBitRate = data.bitRate;
+    solution->dataBitRateError = DRV_CANFDSPI_BitTimeErrorPpm(data.bitRate, config->dataBitRate);
+    solution->dataSamplePoint = data.samplePoint;
+
+    // Transmitter Delay Compensation
+    loopClocks = DRV_CANFDSPI_BitTimeNsToClocks(config->sysClk, config->loopDelay);
+
+    if ((sspMode == CAN_SSP_MODE_AUTO) && (config->dataBitRate < CAN_BITTIME_TDC_MIN_BITRATE)) {
+        sspMode = CAN_SSP_MODE_OFF;
+    }
+    solution->tdc.bF.TDCMode = sspMode;
+
+    // SSP = TDCV + TDCO, TDCO place SSP on sample point of received bit
+    tdcOffset = data.brp * data.tseg1;
+    if (tdcOffset > CAN_BITTIME_MAX_TDC) {
+        tdcOffset = CAN_BITTIME_MAX_TDC;
+    }
+    solution->tdc.bF.TDCOffset = tdcOffset;
+
+    if (sspMode == CAN_SSP_MODE_OFF) {
+        // Transmitter check own bit on sample point
+        solution->dataDelayMargin = DRV_CANFDSPI_BitTimeClocksToNs(config->sysClk,
+                (int32_t) (data.brp * (1u + data.tseg1)) - (int32_t) loopClocks);
+    } else {
+        if (sspMode == CAN_SSP_MODE_MANUAL) {
+            solution->tdc.bF.TDCValue = (loopClocks > CAN_BITTIME_MAX_TDC) ? CAN_BITTIME_MAX_TDC : loopClocks;
+        }
+
+        solution->dataDelayMargin = DRV_CANFDSPI_BitTimeClocksToNs(config->sysClk,
+                CAN_BITTIME_MAX_TDC - (int32_t) loopClocks);
+    }
+
+    if ((solution->dataDelayMargin < 0) && (result == 0)) {
+        result = -5;
+    }
+
+    return result;
+}
+
+int8_t DRV_CANFDSPI_BitTimeConfigureSolution(CANFDSPI_MODULE_ID index,
+        const CAN_BITTIME_SOLUTION* solution)
+{
+    int8_t spiTransferError = 0;
+    uint32_t bitTimeRegisters[3];
+    REG_CiTDC ciTdc;
+
+    ciTdc.word = solution->tdc.word;
+
+    // Write Transmitter Delay Compensation
+#ifdef REV_A
+    ciTdc.bF.TDCOffset = 0;
+    ciTdc.bF.TDCValue = 0;
+#endif
+
+    // CiNBTCFG, CiDBTCFG and CiTDC are placed one after another
+    bitTimeRegisters[0] = solution->nbtcfg.word;
+    bitTimeRegisters[1] = solution->dbtcfg.word;
+    bitTimeRegisters[2] = ciTdc.word;
+
+    spiTransferError = DRV_CANFDSPI_WriteWordArray(index, cREGADDR_CiNBTCFG, bitTimeRegisters, 3);
+    if (spiTransferError) {
+        return -1;
+    }
+
+    return spiTransferError;
+}
+
+int8_t DRV_CANFDSPI_BitTimeConfigureCustom(CANFDSPI_MODULE_ID index,
+        const CAN_BITTIME_SOLVER_CONFIG* config)
+{
+    CAN_BITTIME_SOLUTION solution;
+    int8_t result;
+
+    result = DRV_CANFDSPI_BitTimeSolve(config, &solution);
+    if (result) {
+        return result;
+    }
+
+    result = DRV_CANFDSPI_BitTimeConfigureSolution(index, &solution);
+    if (result) {
+        return -6;
+    }
+
+    return result;
+}
@@ -0,0 +1,210 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_canfdspi_busload.h"
+#include "drv_canfdspi_register.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local functions
+
+static void BusLoadIdUpdate(CAN_BUSLOAD* load, uint32_t id, uint32_t time)
+{
+    CAN_BUSLOAD_ID* stat = NULL;
+    uint32_t period;
+    uint8_t i, min = 0;
+
+    for (i = 0; i < load->nIds; i++) {
+        if (load->ids[i].id == id) {
+            stat = &load->ids[i];
+            break;
+        }
+        if (load->ids[i].count < load->ids[min].count) {
+            min = i;
+        }
+    }
+
+    if (stat == NULL) {
+        if (load->nIds < CAN_BUSLOAD_MAX_IDS) {
+            stat = &load->ids[load->nIds++];
+            stat->count = 0;
+        } else {
+            // Replace the least frequent ID, its count is upper bound of new ID count
+            stat = &load->ids[min];
+        }
+        stat->id = id;
+        stat->error = stat->count;
+        stat->firstTime = time;
+        stat->minPeriod = 0xFFFFFFFF;
+        stat->maxPeriod = 0;
+    } else {
+        period = time - stat->lastTime;
+        if (period < stat->minPeriod) {
+            stat->minPeriod = period;
+        }
+        if (period > stat->maxPeriod) {
+            stat->maxPeriod = period;
+        }
+    }
+
+    stat->lastTime = time;
+    stat->count++;
+}
+
+static void BusLoadFrame(CAN_BUSLOAD* load, const uint32_t* header, const uint8_t* data,
+        uint32_t time)
+{
+    CAN_TX_MSGOBJ obj;
+
+    obj.word[0] = header[0];
+    obj.word[1] = header[1];
+
+    load->busyTime += DRV_CANFDSPI_FrameTime(&load->frameTime, header, data);
+
+    if (obj.bF.ctrl.IDE) {
+        BusLoadIdUpdate(load, CAN_FILTER_EXT_ID(((uint32_t) obj.bF.id.SID << 18) | obj.bF.id.EID), time);
+    } else {
+        BusLoadIdUpdate(load, CAN_FILTER_STD_ID(obj.bF.id.SID), time);
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Bus Load Statistics
+
+void DRV_CANFDSPI_BusLoadInitialize(CAN_BUSLOAD* load, uint32_t nominalBitRate,
+        uint32_t dataBitRate, uint32_t time)
+{
+    DRV_CANFDSPI_FrameTimeInitialize(&load->frameTime, nominalBitRate, dataBitRate);
+    load->windowStart = time;
+    load->busyTime = 0;
+    load->rxFrames = 0;
+    load->txFrames = 0;
+    load->peakLoad = 0;
+    load->nIds = 0;
+}
+
+int8_t DRV_CANFDSPI_BusLoadInitializeSetup(CAN_BUSLOAD* load, CAN_BITTIME_SETUP setup,
+        uint32_t time)
+{
+    uint32_t nominalBitRate, dataBitRate;
+
+    if (DRV_CANFDSPI_FrameTimeSetupBitRates(setup, &nominalBitRate, &dataBitRate)) {
+        return -1;
+    }
+
+    DRV_CANFDSPI_BusLoadInitialize(load, nominalBitRate, dataBitRate, time);
+
+    return 0;
+}
+
+void DRV_CANFDSPI_BusLoadInitializeBitTime(CAN_BUSLOAD* load, uint32_t sysClk,
+        uint32_t nbtcfg, uint32_t dbtcfg, uint32_t time)
+{
+    REG_CiNBTCFG ciNbtcfg;
+    REG_CiDBTCFG ciDbtcfg;
+    uint32_t nominalTq, dataTq;
+
+    ciNbtcfg.word = nbtcfg;
+    ciDbtcfg.word = dbtcfg;
+
+    // Bit has SYNC segment and TSEG1 + 1, TSEG2 + 1 TQ, TQ is BRP + 1 SYSCLK periods
+    nominalTq = ((uint32_t) ciNbtcfg.bF.BRP + 1) * (ciNbtcfg.bF.TSEG1 + ciNbtcfg.bF.TSEG2 + 3);
+    dataTq = ((uint32_t) ciDbtcfg.bF.BRP + 1) * (ciDbtcfg.bF.TSEG1 + ciDbtcfg.bF.TSEG2 + 3);
+
+    DRV_CANFDSPI_BusLoadInitialize(load, sysClk / nominalTq, sysClk / dataTq, time);
+}
+
+void DRV_CANFDSPI_BusLoadRxFrame(CAN_BUSLOAD* load, const CAN_RX_MSGOBJ* header,
+        const uint8_t* data)
+{
+    load->rxFrames++;
+    BusLoadFrame(load, header->word, data, header->bF.timeStamp);
+}
+
+void DRV_CANFDSPI_BusLoadTefFrame(CAN_BUSLOAD* load, const CAN_TEF_MSGOBJ* tefObj)
+{
+    load->txFrames++;
+    BusLoadFrame(load, tefObj->word, NULL, tefObj->bF.timeStamp);
+}
+
+void DRV_CANFDSPI_BusLoadTxFrame(CAN_BUSLOAD* load, const CAN_TX_MSGOBJ* header,
+        const uint8_t* data, uint32_t time)
+{
+    load->txFrames++;
+    BusLoadFrame(load, header->word, data, time);
+}
+
+void DRV_CANFDSPI_BusLoadSnapshot(CAN_BUSLOAD* load, uint32_t time,
+        CAN_BUSLOAD_SNAPSHOT* snapshot)
+{
+    uint32_t busyLoad;
+    uint8_t i;
+
+    snapshot->windowTime = time - load->windowStart;
+    snapshot->busyTime = load->busyTime / 1000;
+    snapshot->rxFrames = load->rxFrames;
+    snapshot->txFrames = load->txFrames;
+
+    // ns / us is per mille, time stamp resolution can give little more than 100%
+    busyLoad = snapshot->windowTime ? load->busyTime / snapshot->windowTime : 0;
+    snapshot->load = (busyLoad > 1000) ? 1000 : busyLoad;
+    if (snapshot->load > load->peakLoad) {
+        load->peakLoad = snapshot->load;
+    }
+    snapshot->peakLoad = load->peakLoad;
+
+    snapshot->topId = 0;
+    snapshot->topCount = 0;
+    for (i = 0; i < load->nIds; i++) {
+        if (load->ids[i].count > snapshot->topCount) {
+            snapshot->topId = load->ids[i].id;
+            snapshot->topCount = load->ids[i].count;
+        }
+    }
+
+    load->windowStart = time;
+    load->busyTime = 0;
+    load->rxFrames = 0;
+    load->txFrames = 0;
+}
+
+const CAN_BUSLOAD_ID* DRV_CANFDSPI_BusLoadIdGet(const CAN_BUSLOAD* load, uint32_t id)
+{
+    uint8_t i;
+
+    for (i = 0; i < load->nIds; i++) {
+        if (load->ids[i].id == id) {
+            return &load->ids[i];
+        }
+    }
+
+    return NULL;
+}
@@ -0,0 +1,421 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_canfdspi_capture.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local functions
+
+static void CapturePutWord(uint8_t* buffer, uint32_t value)
+{
+    buffer[0] = value;
+    buffer[1] = value >> 8;
+    buffer[2] = value >> 16;
+    buffer[3] = value >> 24;
+}
+
+static uint32_t CaptureGetWord(const uint8_t* buffer)
+{
+    return buffer[0] | ((uint32_t) buffer[1] << 8) | ((uint32_t) buffer[2] << 16) |
+            ((uint32_t) buffer[3] << 24);
+}
+
+//! Write time since previous record as varint, return number of bytes
+static uint8_t CapturePutTime(CAN_CAPTURE_CODER* coder, uint8_t* buffer, uint32_t timeStamp)
+{
+    uint32_t delta = timeStamp - coder->timeStamp;
+    uint8_t n = 0;
+
+    coder->timeStamp = timeStamp;
+
+    while (delta >= 0x80) {
+        buffer[n++] = (delta & 0x7F) | 0x80;
+        delta >>= 7;
+    }
+    buffer[n++] = delta;
+
+    return n;
+}
+
+//! Read varint time, return number of bytes or 0 when it is truncated or too long
+static uint8_t CaptureGetTime(CAN_CAPTURE_CODER* coder, const uint8_t* buffer, uint16_t length)
+{
+    uint32_t delta = 0;
+    uint8_t n = 0;
+
+    do {
+        if (n == length || n == 5) {
+            return 0;
+        }
+        delta |= (uint32_t) (buffer[n] & 0x7F) << (7 * n);
+    } while (buffer[n++] & 0x80);
+
+    coder->timeStamp += delta;
+
+    return n;
+}
+
+//! Search entry with the same identifier, flags and DLC
+static int8_t CaptureFind(const CAN_CAPTURE_CODER* coder, uint32_t id, uint16_t control)
+{
+    uint8_t i;
+
+    for (i = 0; i < coder->entries; i++) {
+        if (coder->entry[i].id == id && coder->entry[i].control == control) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+//! Select entry for new identifier, free entry or victim of CLOCK algorithm
+static uint8_t CaptureInsert(CAN_CAPTURE_CODER* coder, uint32_t id, uint16_t control)
+{
+    uint8_t index;
+
+    if (coder->entries < coder->dictionarySize) {
+        index = coder->entries++;
+    } else {
+        while (coder->entry[coder->hand].referenced) {
+            coder->entry[coder->hand].referenced = 0;
+            coder->hand = (coder->hand + 1) % coder->dictionarySize;
+        }
+        index = coder->hand;
+        coder->hand = (coder->hand + 1) % coder->dictionarySize;
+    }
+
+    coder->entry[index].id = id;
+    coder->entry[index].control = control;
+    coder->entry[index].referenced = 0;
+
+    return index;
+}
+
+static void CaptureFrameFields(const uint32_t* header, uint32_t* id, uint16_t* control,
+        uint8_t* dataBytes)
+{
+    CAN_TX_MSGOBJ obj;
+
+    obj.word[0] = header[0];
+    obj.word[1] = header[1];
+
+    if (obj.bF.ctrl.IDE) {
+        *id = ((uint32_t) obj.bF.id.SID << 18) | obj.bF.id.EID;
+    } else {
+        *id = obj.bF.id.SID;
+    }
+    *control = obj.word[1] & 0x1FF;
+    *dataBytes = DRV_CANFDSPI_FrameDataBytes(obj.bF.ctrl.FDF, (CAN_DLC) obj.bF.ctrl.DLC);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Capture Format
+
+void DRV_CANFDSPI_CaptureInitialize(CAN_CAPTURE_CODER* coder, uint8_t dictionarySize,
+        uint8_t historyBytes)
+{
+    if (dictionarySize == 0 || dictionarySize > CAN_CAPTURE_DICTIONARY_SIZE) {
+        dictionarySize = CAN_CAPTURE_DICTIONARY_SIZE;
+    }
+    if (historyBytes > CAN_CAPTURE_HISTORY_BYTES) {
+        historyBytes = CAN_CAPTURE_HISTORY_BYTES;
+    }
+
+    coder->dictionarySize = dictionarySize;
+    coder->historyBytes = historyBytes;
+    coder->entries = 0;
+    coder->hand = 0;
+    coder->timeStamp = 0;
+    coder->synchronized = false;
+    coder->frames = 0;
+    coder->hits = 0;
+}
+
+uint8_t DRV_CANFDSPI_CaptureEncodeReset(CAN_CAPTURE_CODER* coder, uint8_t* buffer,
+        uint32_t timeStamp)
+{
+    coder->entries = 0;
+    coder->hand = 0;
+    coder->timeStamp = timeStamp;
+    coder->synchronized = true;
+
+    buffer[0] = CAN_CAPTURE_TAG_RESET;
+    buffer[1] = coder->dictionarySize;
+    buffer[2] = coder->historyBytes;
+    CapturePutWord(&buffer[3], timeStamp);
+
+    return CAN_CAPTURE_RESET_BYTES;
+}
+
+uint8_t DRV_CANFDSPI_CaptureEncodeFrame(CAN_CAPTURE_CODER* coder, uint8_t* buffer,
+        const uint32_t* header, uint32_t timeStamp, const uint8_t* data)
+{
+    CAN_CAPTURE_ENTRY* entry;
+    uint32_t id;
+    uint16_t control;
+    uint8_t dataBytes;
+    uint8_t covered;
+    uint8_t changed = 0;
+    uint8_t n;
+    uint8_t i;
+    int8_t index;
+
+    if (!coder->synchronized) {
+        return 0;
+    }
+
+    CaptureFrameFields(header, &id, &control, &dataBytes);
+    covered = (dataBytes < coder->historyBytes) ? dataBytes : coder->historyBytes;
+    coder->frames++;
+
+    index = CaptureFind(coder, id, control);
+    if (index < 0) {
+        // Literal: flags, time, ID with DLC and raw payload
+        buffer[0] = (control >> 4) << 2;
+        n = 1 + CapturePutTime(coder, &buffer[1], timeStamp);
+        if (control & CAN_CAPTURE_CONTROL_IDE) {
+            CapturePutWord(&buffer[n], id);
+            buffer[n + 4] = control & 0xF;
+            n += 5;
+        } else {
+            buffer[n] = id;
+            buffer[n + 1] = (id >> 8) | ((control & 0xF) << 4);
+            n += 2;
+        }
+
+        entry = &coder->entry[CaptureInsert(coder, id, control)];
+        for (i = 0; i < dataBytes; i++) {
+            buffer[n++] = data[i];
+        }
+        for (i = 0; i < covered; i++) {
+            entry->history[i] = data[i];
+        }
+
+        return n;
+    }
+
+    entry = &coder->entry[index];
+    entry->referenced = 1;
+    coder->hits++;
+
+    for (i = 0; i < covered; i++) {
+        if (data[i] != entry->history[i]) {
+            changed++;
+        }
+    }
+
+    buffer[0] = CAN_CAPTURE_TAG_HIT | (index << 2);
+    n = 1 + CapturePutTime(coder, &buffer[1], timeStamp);
+
+    if (changed == 0 && covered == dataBytes) {
+        buffer[0] |= CAN_CAPTURE_PAYLOAD_SAME;
+    } else if ((covered + 7) / 8 + changed < covered) {
+        // Mask of changed bytes, XOR of changed bytes, rest of payload raw
+        buffer[0] |= CAN_CAPTURE_PAYLOAD_XOR;
+        for (i = 0; i < (covered + 7) / 8; i++) {
+            buffer[n + i] = 0;
+        }
+        changed = n + (covered + 7) / 8;
+        for (i = 0; i < covered; i++) {
+            if (data[i] != entry->history[i]) {
+                buffer[n + i / 8] |= 1 << (i % 8);
+                buffer[changed++] = data[i] ^ entry->history[i];
+                entry->history[i] = data[i];
+            }
+        }
+        for (n = changed; i < dataBytes; i++) {
+            buffer[n++] = data[i];
+        }
+    } else {
+        for (i = 0; i < dataBytes; i++) {
+            buffer[n++] = data[i];
+        }
+        for (i = 0; i < covered; i++) {
+            entry->history[i] = data[i];
+        }
+    }
+
+    return n;
+}
+
+int8_t DRV_CANFDSPI_CaptureDecode(CAN_CAPTURE_CODER* coder, const uint8_t* buffer,
+        uint16_t length, uint16_t* used, uint32_t* header, uint32_t* timeStamp, uint8_t* data)
+{
+    CAN_CAPTURE_ENTRY* entry;
+    CAN_TX_MSGOBJ obj;
+    uint32_t id;
+    uint16_t control;
+    uint16_t n;
+    uint16_t changed;
+    uint8_t timeBytes;
+    uint8_t dataBytes;
+    uint8_t covered;
+    uint8_t maskBytes;
+    uint8_t mode;
+    uint8_t i;
+
+    if (length == 0) {
+        return -1;
+    }
+
+    if (buffer[0] == CAN_CAPTURE_TAG_RESET) {
+        if (length < CAN_CAPTURE_RESET_BYTES || buffer[1] == 0 ||
+                buffer[1] > CAN_CAPTURE_DICTIONARY_SIZE || buffer[2] > CAN_CAPTURE_HISTORY_BYTES) {
+            coder->synchronized = false;
+            return -1;
+        }
+        coder->dictionarySize = buffer[1];
+        coder->historyBytes = buffer[2];
+        coder->entries = 0;
+        coder->hand = 0;
+        coder->timeStamp = CaptureGetWord(&buffer[3]);
+        coder->synchronized = true;
+
+        *timeStamp = coder->timeStamp;
+        *used = CAN_CAPTURE_RESET_BYTES;
+        return CAN_CAPTURE_RESET;
+    }
+
+    if (!coder->synchronized || (!(buffer[0] & CAN_CAPTURE_TAG_HIT) && (buffer[0] & 0x3))) {
+        coder->synchronized = false;
+        return -1;
+    }
+
+    timeBytes = CaptureGetTime(coder, &buffer[1], length - 1);
+    if (timeBytes == 0) {
+        coder->synchronized = false;
+        return -1;
+    }
+    n = 1 + timeBytes;
+
+    if (buffer[0] & CAN_CAPTURE_TAG_HIT) {
+        if (((buffer[0] >> 2) & 0x1F) >= coder->entries) {
+            coder->synchronized = false;
+            return -1;
+        }
+        entry = &coder->entry[(buffer[0] >> 2) & 0x1F];
+        entry->referenced = 1;
+        id = entry->id;
+        control = entry->control;
+        mode = buffer[0] & 0x3;
+        coder->hits++;
+    } else {
+        control = (uint16_t) (buffer[0] >> 2) << 4;
+        if (control & CAN_CAPTURE_CONTROL_IDE) {
+            if (length < n + 5 || buffer[n + 4] > CAN_DLC_64) {
+                coder->synchronized = false;
+                return -1;
+            }
+            id = CaptureGetWord(&buffer[n]) & 0x1FFFFFFF;
+            control |= buffer[n + 4];
+            n += 5;
+        } else {
+            if (length < n + 2) {
+                coder->synchronized = false;
+                return -1;
+            }
+            id = buffer[n] | ((uint16_t) (buffer[n + 1] & 0x7) << 8);
+            control |= buffer[n + 1] >> 4;
+            n += 2;
+        }
+        entry = &coder->entry[CaptureInsert(coder, id, control)];
+        mode = CAN_CAPTURE_PAYLOAD_RAW;
+    }
+
+    obj.word[0] = 0;
+    obj.word[1] = control;
+    if (control & CAN_CAPTURE_CONTROL_IDE) {
+        obj.bF.id.SID = (id >> 18) & 0x7FF;
+        obj.bF.id.EID = id & 0x3FFFF;
+    } else {
+        obj.bF.id.SID = id & 0x7FF;
+    }
+    dataBytes = DRV_CANFDSPI_FrameDataBytes(obj.bF.ctrl.FDF, (CAN_DLC) obj.bF.ctrl.DLC);
+    covered = (dataBytes < coder->historyBytes) ? dataBytes : coder->historyBytes;
+
+    if (mode == CAN_CAPTURE_PAYLOAD_SAME) {
+        if (covered != dataBytes) {
+            coder->synchronized = false;
+            return -1;
+        }
+        for (i = 0; i < dataBytes; i++) {
+            data[i] = entry->history[i];
+        }
+    } else if (mode == CAN_CAPTURE_PAYLOAD_XOR) {
+        maskBytes = (covered + 7) / 8;
+        if (length < n + maskBytes) {
+            coder->synchronized = false;
+            return -1;
+        }
+        changed = n + maskBytes;
+        for (i = 0; i < covered; i++) {
+            if (buffer[n + i / 8] & (1 << (i % 8))) {
+                if (changed == length) {
+                    coder->synchronized = false;
+                    return -1;
+                }
+                entry->history[i] ^= buffer[changed++];
+            }
+            data[i] = entry->history[i];
+        }
+        if (length < changed + (dataBytes - covered)) {
+            coder->synchronized = false;
+            return -1;
+        }
+        for (n = changed; i < dataBytes; i++) {
+            data[i] = buffer[n++];
+        }
+    } else if (mode == CAN_CAPTURE_PAYLOAD_RAW) {
+        if (length < n + dataBytes) {
+            coder->synchronized = false;
+            return -1;
+        }
+        for (i = 0; i < dataBytes; i++) {
+            data[i] = buffer[n++];
+        }
+        for (i = 0; i < covered; i++) {
+            entry->history[i] = data[i];
+        }
+    } else {
+        coder->synchronized = false;
+        return -1;
+    }
+
+    coder->frames++;
+    header[0] = obj.word[0];
+    header[1] = obj.word[1];
+    *timeStamp = coder->timeStamp;
+    *used = n;
+
+    return CAN_CAPTURE_FRAME;
+}
@@ -0,0 +1,251 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _DRV_CANFDSPI_DISPATCH_H
+#define _DRV_CANFDSPI_DISPATCH_H
+
+/*
+* Software acceptance filter, ID dispatch table and filter hit dispatch.
+*
+* When hardware filters are exhausted or accept groups of IDs(see drv_canfdspi_filter.h)
+* received frames are checked again by MCU and passed to handler of their ID. Lookup
+* take constant time independent of number of routes:
+* - standard IDs: 2048 bit bitmap(256 bytes) and number of set bits before every bitmap
+*   word. Index of route is taken from array ordered by ID at position equal number of
+*   set bits below ID(rank), so only accepted IDs use memory.
+* - extended IDs: open addressing hash set with CAN_DISPATCH_EXT_SLOTS slots filled at
+*   most in 3/4, the longest probe sequence is stored during initialization.
+*
+* Table size is selected by CAN_DISPATCH_MAX_STD_IDS and CAN_DISPATCH_EXT_SLOTS_LOG2
+* (default table use 448 bytes of RAM on 32 bit MCU). Routes are kept by user(normally
+* in flash), table store only 8 bit route index.
+*
+* When every handler own hardware filter which accept only its IDs table isn't needed.
+* Received frame carry number of accepting filter in FilterHit field, so handler is
+* selected from 32 entry array indexed by FilterHit(CAN_FILTER_DISPATCH). Filter and
+* handler are allocated together by DRV_CANFDSPI_FilterHandlerRegister, filters
+* configured by CAN_CONFIG_IMAGE get handler by DRV_CANFDSPI_FilterHandlerSet.
+*
+* Simple example code:
+*
+*	static const CAN_DISPATCH_ROUTE routes[] = {
+*		{CAN_FILTER_STD_ID(0x0DA), EngineHandler},
+*		{CAN_FILTER_EXT_ID(0x18FEF100), CruiseHandler}
+*	};
+*	CAN_DISPATCH_TABLE table;
+*
+*	DRV_CANFDSPI_DispatchInitialize(&table, routes, 2, NULL);
+*
+*	DRV_CANFDSPI_Dispatch(&table, &frame->rx, CAN_SLAB_RX_DATA(frame));
+*
+* Simple example code of filter hit dispatch:
+*
+*	CAN_FILTER_DISPATCH filterDispatch;
+*
+*	DRV_CANFDSPI_FilterDispatchInitialize(&filterDispatch, 0, NULL);
+*	DRV_CANFDSPI_FilterHandlerRegister(DRV_CANFDSPI_INDEX_0, &filterDispatch,
+*		CAN_FILTER_STD_ID(0x0DA), 0x7FF, CAN_FIFO_CH1, EngineHandler);
+*
+*	DRV_CANFDSPI_FilterDispatch(&filterDispatch, &frame->rx, CAN_SLAB_RX_DATA(frame));
+*/
+
+#include "drv_canfdspi_api.h"
+#include "drv_canfdspi_filter.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+//! Maximal number of routes for standard IDs(up to 255)
+#ifndef CAN_DISPATCH_MAX_STD_IDS
+#define CAN_DISPATCH_MAX_STD_IDS 32
+#endif
+
+//! Number of hash slots for extended IDs is 2^CAN_DISPATCH_EXT_SLOTS_LOG2
+#ifndef CAN_DISPATCH_EXT_SLOTS_LOG2
+#define CAN_DISPATCH_EXT_SLOTS_LOG2 4
+#endif
+
+#define CAN_DISPATCH_EXT_SLOTS (1 << CAN_DISPATCH_EXT_SLOTS_LOG2)
+
+//! Maximal number of routes for extended IDs(3/4 of slots)
+#define CAN_DISPATCH_MAX_EXT_IDS (CAN_DISPATCH_EXT_SLOTS * 3 / 4)
+
+//! Empty hash slot, extended ID has only 29 bits
+#define CAN_DISPATCH_EMPTY_SLOT 0xFFFFFFFF
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+
+//! Handler of received frame, data point to payload padded to multiply of 4 bytes
+
+typedef void (*CAN_DISPATCH_HANDLER)(const CAN_RX_MSGOBJ* header, uint8_t* data);
+
+//! Route of single ID
+
+typedef struct _CAN_DISPATCH_ROUTE {
+    //! ID created by CAN_FILTER_STD_ID or CAN_FILTER_EXT_ID
+    uint32_t id;
+    CAN_DISPATCH_HANDLER handler;
+} CAN_DISPATCH_ROUTE;
+
+//! Dispatch table
+
+typedef struct _CAN_DISPATCH_TABLE {
+    //! Bit n of word w is set when standard ID 32 * w + n is accepted
+    uint32_t stdBitmap[64];
+    //! Number of accepted standard IDs below 32 * w
+    uint8_t stdRank[64];
+    //! Route index of accepted standard IDs in ascending ID order
+    uint8_t stdRoute[CAN_DISPATCH_MAX_STD_IDS];
+    //! Hash set of extended IDs and route index of every slot
+    uint32_t extId[CAN_DISPATCH_EXT_SLOTS];
+    uint8_t extRoute[CAN_DISPATCH_EXT_SLOTS];
+    //! The longest probe sequence in hash set minus 1
+    uint8_t extMaxProbe;
+    uint8_t nExtIds;
+    const CAN_DISPATCH_ROUTE* routes;
+    //! Called for not accepted frames when isn't NULL
+    CAN_DISPATCH_HANDLER defaultHandler;
+    //! Number of not accepted frames
+    uint32_t rejected;
+} CAN_DISPATCH_TABLE;
+
+//! Handlers selected by FilterHit of received frame
+
+typedef struct _CAN_FILTER_DISPATCH {
+    CAN_DISPATCH_HANDLER handler[CAN_FILTER_TOTAL];
+    //! Bit n is set when filter n is allocated
+    uint32_t used;
+    //! Called for frames accepted by filter without handler when isn't NULL
+    CAN_DISPATCH_HANDLER defaultHandler;
+    //! Number of frames accepted by filter without handler
+    uint32_t rejected;
+} CAN_FILTER_DISPATCH;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Dispatch Table
+
+// *****************************************************************************
+//! Build table from routes
+/*!
+ * Return: 0 - success, -1 - too many standard IDs or routes, -2 - too many extended
+ * IDs, -3 - duplicated ID.
+ */
+
+int8_t DRV_CANFDSPI_DispatchInitialize(CAN_DISPATCH_TABLE* table,
+        const CAN_DISPATCH_ROUTE* routes, uint8_t nRoutes, CAN_DISPATCH_HANDLER defaultHandler);
+
+// *****************************************************************************
+//! ID of received frame in format of CAN_FILTER_STD_ID/CAN_FILTER_EXT_ID
+
+uint32_t DRV_CANFDSPI_DispatchFrameId(const CAN_RX_MSGOBJ* header);
+
+// *****************************************************************************
+//! Route of ID or NULL when ID isn't accepted
+
+const CAN_DISPATCH_ROUTE* DRV_CANFDSPI_DispatchLookup(const CAN_DISPATCH_TABLE* table, uint32_t id);
+
+// *****************************************************************************
+//! Pass received frame to handler of its ID
+/*!
+ * Return: 0 - frame passed to route handler, 1 - frame isn't accepted(passed to
+ * default handler when it is set).
+ */
+
+int8_t DRV_CANFDSPI_Dispatch(CAN_DISPATCH_TABLE* table, const CAN_RX_MSGOBJ* header, uint8_t* data);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Filter Hit Dispatch
+
+// *****************************************************************************
+//! Reset filter hit dispatch
+/*!
+ * Bit n of reservedFilters mark filter n as used by application(e.g. configured without
+ * handler), such filters are never allocated by DRV_CANFDSPI_FilterHandlerRegister.
+ */
+
+void DRV_CANFDSPI_FilterDispatchInitialize(CAN_FILTER_DISPATCH* dispatch,
+        uint32_t reservedFilters, CAN_DISPATCH_HANDLER defaultHandler);
+
+// *****************************************************************************
+//! Set handler of filter configured by application(e.g. by CAN_CONFIG_IMAGE)
+
+void DRV_CANFDSPI_FilterHandlerSet(CAN_FILTER_DISPATCH* dispatch, CAN_FILTER filter,
+        CAN_DISPATCH_HANDLER handler);
+
+// *****************************************************************************
+//! Allocate free filter for handler
+/*!
+ * Filter accept frames with (frameId & mask) == (id & mask), id is created by
+ * CAN_FILTER_STD_ID or CAN_FILTER_EXT_ID and mask has 11 or 29 bits. Handler is set
+ * before filter is enabled and linked with FIFO channel.
+ *
+ * Return: number of allocated filter, -1 - all filters are used, -2 - SPI error
+ * (filter stay free).
+ */
+
+int8_t DRV_CANFDSPI_FilterHandlerRegister(CANFDSPI_MODULE_ID index,
+        CAN_FILTER_DISPATCH* dispatch, uint32_t id, uint32_t mask,
+        CAN_FIFO_CHANNEL channel, CAN_DISPATCH_HANDLER handler);
+
+// *****************************************************************************
+//! Disable filter and release it
+/*!
+ * Frames accepted by filter before it was disabled are passed to default handler.
+ *
+ * Return: 0 - success, -1 - filter isn't allocated, -2 - SPI error.
+ */
+
+int8_t DRV_CANFDSPI_FilterHandlerUnregister(CANFDSPI_MODULE_ID index,
+        CAN_FILTER_DISPATCH* dispatch, CAN_FILTER filter);
+
+// *****************************************************************************
+//! Pass received frame to handler of filter which accepted it
+/*!
+ * Return: 0 - frame passed to handler, 1 - filter doesn't have handler(frame passed
+ * to default handler when it is set).
+ */
+
+int8_t DRV_CANFDSPI_FilterDispatch(CAN_FILTER_DISPATCH* dispatch,
+        const CAN_RX_MSGOBJ* header, uint8_t* data);
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // _DRV_CANFDSPI_DISPATCH_H
@@ -0,0 +1,280 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_canfdspi_filter.h"
+#include "drv_canfdspi_image.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local functions
+
+static uint32_t FilterIdMask(uint32_t id)
+{
+    return (id & CAN_FILTER_EXTENDED) ? 0x1FFFFFFF : 0x7FF;
+}
+
+//! Group contain other group when it compare subset of bits with the same values
+static bool FilterGroupContains(const CAN_FILTER_GROUP* group, const CAN_FILTER_GROUP* other)
+{
+    return ((group->id & CAN_FILTER_EXTENDED) == (other->id & CAN_FILTER_EXTENDED)) &&
+            ((other->mask & group->mask) == group->mask) &&
+            ((other->id & group->mask) == (group->id & ~CAN_FILTER_EXTENDED));
+}
+
+static uint32_t FilterSaturatedAdd(uint32_t a, uint32_t b)
+{
+    return (a + b < a) ? 0xFFFFFFFF : a + b;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Filter Compiler
+
+int8_t DRV_CANFDSPI_FilterCompile(const uint32_t* ids, uint16_t nIds,
+        CAN_FILTER_GROUP* groups, uint8_t maxFilters, uint32_t maxFalseAccepts,
+        uint8_t* nFilters)
+{
+    CAN_FILTER_GROUP merged;
+    uint32_t falseAccepts = 0;
+    uint32_t mergedFalse;
+    uint32_t removedFalse;
+    int32_t cost, bestCost = 0;
+    uint16_t n = 0;
+    uint16_t i, j, a = 0, b = 0;
+    bool found;
+
+    if ((nIds == 0) || (maxFilters == 0) || (maxFilters > CAN_FILTER_TOTAL)) {
+        return -1;
+    }
+
+    // Every ID is group with all bits compared, duplicates are skipped
+    for (i = 0; i < nIds; i++) {
+        groups[n].mask = FilterIdMask(ids[i]);
+        groups[n].id = (ids[i] & groups[n].mask) | (ids[i] & CAN_FILTER_EXTENDED);
+        groups[n].nIds = 1;
+
+        for (j = 0; (j < n) && (groups[j].id != groups[n].id); j++) {
+        }
+        if (j == n) {
+            n++;
+        }
+    }
+
+    while (n > 1) {
+        // Find pair which add the smallest number of IDs to accepted ID space
+        found = false;
+
+        for (i = 0; i < n; i++) {
+            for (j = i + 1; j < n; j++) {
+                if ((groups[i].id & CAN_FILTER_EXTENDED) != (groups[j].id & CAN_FILTER_EXTENDED)) {
+                    continue;
+                }
+
+                merged.mask = groups[i].mask & groups[j].mask & ~(groups[i].id ^ groups[j].id);
+                merged.id = groups[i].id & (merged.mask | CAN_FILTER_EXTENDED);
+
+                cost = (int32_t) DRV_CANFDSPI_FilterGroupIds(&merged) -
+                        (int32_t) DRV_CANFDSPI_FilterGroupIds(&groups[i]) -
+                        (int32_t) DRV_CANFDSPI_FilterGroupIds(&groups[j]);
+
+                if (!found || (cost < bestCost)) {
+                    found = true;
+                    bestCost = cost;
+                    a = i;
+                    b = j;
+                }
+            }
+        }
+
+        if (!found) {
+            break;
+        }
+
+        merged.mask = groups[a].mask & groups[b].mask & ~(groups[a].id ^ groups[b].id);
+        merged.id = groups[a].id & (merged.mask | CAN_FILTER_EXTENDED);
+        merged.nIds = 0;
+
+        // Merged group take over all groups which it contains
+        removedFalse = 0;
+        for (i = 0; i < n; i++) {
+            if (FilterGroupContains(&merged, &groups[i])) {
+                merged.nIds += groups[i].nIds;
+                removedFalse += DRV_CANFDSPI_FilterGroupIds(&groups[i]) - groups[i].nIds;
+            }
+        }
+        mergedFalse = DRV_CANFDSPI_FilterGroupIds(&merged) - merged.nIds;
+
+        // Merge with new false accepts only to fit into filters or within user limit
+        if ((n <= maxFilters) && (mergedFalse > removedFalse) &&
+                (FilterSaturatedAdd(falseAccepts, mergedFalse - removedFalse) > maxFalseAccepts)) {
+            break;
+        }
+
+        j = 0;
+        for (i = 0; i < n; i++) {
+            if (i == a) {
+                groups[j++] = merged;
+            } else if (!FilterGroupContains(&merged, &groups[i])) {
+                groups[j++] = groups[i];
+            }
+        }
+        n = j;
+
+        if (mergedFalse >= removedFalse) {
+            falseAccepts = FilterSaturatedAdd(falseAccepts, mergedFalse - removedFalse);
+        } else {
+            falseAccepts -= removedFalse - mergedFalse;
+        }
+    }
+
+    // Standard and extended IDs can't share filter
+    if (n > maxFilters) {
+        return -1;
+    }
+    *nFilters = (uint8_t) n;
+
+    return (falseAccepts > maxFalseAccepts) ? 1 : 0;
+}
+
+uint32_t DRV_CANFDSPI_FilterGroupIds(const CAN_FILTER_GROUP* group)
+{
+    uint32_t dontCare = FilterIdMask(group->id) & ~group->mask;
+    uint32_t ids = 1;
+
+    while (dontCare != 0) {
+        if (dontCare & 1) {
+            ids <<= 1;
+        }
+        dontCare >>= 1;
+    }
+
+    return ids;
+}
+
+uint32_t DRV_CANFDSPI_FilterFalseAccepts(const CAN_FILTER_GROUP* groups, uint8_t nFilters)
+{
+    uint32_t falseAccepts = 0;
+    uint8_t i;
+
+    for (i = 0; i < nFilters; i++) {
+        falseAccepts = FilterSaturatedAdd(falseAccepts,
+                DRV_CANFDSPI_FilterGroupIds(&groups[i]) - groups[i].nIds);
+    }
+
+    return falseAccepts;
+}
+
+int8_t DRV_CANFDSPI_FilterMatch(const CAN_FILTER_GROUP* groups, uint8_t nFilters, uint32_t id)
+{
+    uint8_t i;
+
+    for (i = 0; i < nFilters; i++) {
+        if (((groups[i].id & CAN_FILTER_EXTENDED) == (id & CAN_FILTER_EXTENDED)) &&
+                ((id & groups[i].mask) == (groups[i].id & ~CAN_FILTER_EXTENDED))) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+void DRV_CANFDSPI_FilterImageGet(const CAN_FILTER_GROUP* groups, uint8_t nFilters,
+        CAN_FIFO_CHANNEL channel, uint32_t* filterObj, uint8_t* filterCon)
+{
+    uint32_t id;
+    uint32_t mask;
+    uint8_t i;
+
+    for (i = 0; i < nFilters; i++) {
+        id = groups[i].id & ~CAN_FILTER_EXTENDED;
+        mask = groups[i].mask;
+
+        if (groups[i].id & CAN_FILTER_EXTENDED) {
+            filterObj[2 * i] = CAN_IMAGE_FLTOBJ_EID(id >> 18, id);
+            filterObj[2 * i + 1] = CAN_IMAGE_MASK(mask >> 18, mask, 1);
+        } else {
+            filterObj[2 * i] = CAN_IMAGE_FLTOBJ_SID(id);
+            filterObj[2 * i + 1] = CAN_IMAGE_MASK(mask, 0, 1);
+        }
+
+        filterCon[i] = CAN_IMAGE_FLTCON(channel);
+    }
+}
+
+int8_t DRV_CANFDSPI_FilterProgram(CANFDSPI_MODULE_ID index, CAN_FILTER firstFilter,
+        const CAN_FILTER_GROUP* groups, uint8_t nFilters, CAN_FIFO_CHANNEL channel)
+{
+    CAN_FILTEROBJ_ID fObj;
+    CAN_MASKOBJ_ID mObj;
+    CAN_FILTER filter;
+    uint32_t id;
+    uint32_t mask;
+    uint8_t i;
+
+    if ((firstFilter + nFilters) > CAN_FILTER_TOTAL) {
+        return -1;
+    }
+
+    for (i = 0; i < nFilters; i++) {
+        filter = firstFilter + i;
+        id = groups[i].id & ~CAN_FILTER_EXTENDED;
+        mask = groups[i].mask;
+
+        fObj.SID11 = 0;
+        fObj.unimplemented1 = 0;
+        mObj.MSID11 = 0;
+        mObj.MIDE = 1;
+        mObj.unimplemented1 = 0;
+
+        if (groups[i].id & CAN_FILTER_EXTENDED) {
+            fObj.SID = id >> 18;
+            fObj.EID = id & 0x3FFFF;
+            fObj.EXIDE = 1;
+            mObj.MSID = mask >> 18;
+            mObj.MEID = mask & 0x3FFFF;
+        } else {
+            fObj.SID = id;
+            fObj.EID = 0;
+            fObj.EXIDE = 0;
+            mObj.MSID = mask;
+            mObj.MEID = 0;
+        }
+
+        // Filter object and mask can be written only when filter is disabled
+        if (DRV_CANFDSPI_FilterDisable(index, filter) ||
+                DRV_CANFDSPI_FilterObjectConfigure(index, filter, &fObj) ||
+                DRV_CANFDSPI_FilterMaskConfigure(index, filter, &mObj) ||
+                DRV_CANFDSPI_FilterToFifoLink(index, filter, channel, true)) {
+            return -2;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _DRV_CANFDSPI_FILTER_H
+#define _DRV_CANFDSPI_FILTER_H
+
+/*
+* Filter and mask compiler.
+*
+* MCP2517FD has 32 filters and every filter has own mask. Frame is accepted when
+* (frameId & mask) == (filterId & mask), so single filter can accept group of IDs
+* which differ only on bits cleared in mask. Frames which aren't accepted by filter
+* are rejected by controller and don't cost any SPI transfer.
+*
+* Compiler take list of accepted standard and extended IDs and create the smallest set
+* of filter/mask pairs which accept all of them. IDs are merged greedily: every step
+* join two groups of the same frame type which add the lowest number of not listed
+* IDs(false accepts) to accepted ID space. Merge without false accepts(e.g. 0x100 and
+* 0x101) is always done. Merge with false accepts is done when there are more groups
+* than available filters or when total number of false accepts stay within limit given
+* by user. With limit 0 result accept exactly listed IDs if they fit into filters.
+*
+* Group which is contained in merged group is removed. Extended IDs are stored as 29 bit
+* values(SID is upper 11 bits). Compiler can be used at runtime or on host
+* (HostTools/FilterCompiler), result can be written by DRV_CANFDSPI_FilterProgram or
+* stored in configuration image by DRV_CANFDSPI_FilterImageGet.
+*
+* Simple example code:
+*
+*	static const uint32_t ids[] = {
+*		0x100, 0x101, 0x102, 0x103, 0x2A0, CAN_FILTER_EXT_ID(0x18FEF100)
+*	};
+*	CAN_FILTER_GROUP groups[6];
+*	uint8_t nFilters;
+*
+*	DRV_CANFDSPI_FilterCompile(ids, 6, groups, 32, 0, &nFilters);
+*	DRV_CANFDSPI_FilterProgram(DRV_CANFDSPI_INDEX_0, CAN_FILTER0, groups, nFilters, CAN_FIFO_CH2);
+*/
+
+#include "drv_canfdspi_api.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+//! Flag of extended ID in accept list and in filter group
+#define CAN_FILTER_EXTENDED 0x80000000
+
+//! Accept list entry for standard and extended ID
+#define CAN_FILTER_STD_ID(sid) ((uint32_t) (sid) & 0x7FF)
+#define CAN_FILTER_EXT_ID(id) (((uint32_t) (id) & 0x1FFFFFFF) | CAN_FILTER_EXTENDED)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+
+//! Group of IDs accepted by single filter
+
+typedef struct _CAN_FILTER_GROUP {
+    //! ID with CAN_FILTER_EXTENDED flag, bits cleared in mask are 0
+    uint32_t id;
+    //! Compared bits(11 bits for standard ID, 29 bits for extended ID)
+    uint32_t mask;
+    //! Number of listed IDs accepted by group
+    uint16_t nIds;
+} CAN_FILTER_GROUP;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Filter Compiler
+
+// *****************************************************************************
+//! Compile accept list into filter groups
+/*!
+ * groups must have space for nIds entries(used as work area), the first nFilters
+ * entries contain result. IDs can be listed in any order, duplicates are allowed.
+ *
+ * Return: 0 - success, 1 - IDs don't fit into maxFilters without exceeding
+ * maxFalseAccepts(result is valid but accept more IDs), -1 - empty list or
+ * maxFilters out of range(standard and extended IDs need at least 2 filters).
+ */
+
+int8_t DRV_CANFDSPI_FilterCompile(const uint32_t* ids, uint16_t nIds,
+        CAN_FILTER_GROUP* groups, uint8_t maxFilters, uint32_t maxFalseAccepts,
+        uint8_t* nFilters);
+
+// *****************************************************************************
+//! Number of IDs accepted by group(up to 2^29 for extended ID with mask 0)
+
+uint32_t DRV_CANFDSPI_FilterGroupIds(const CAN_FILTER_GROUP* group);
+
+// *****************************************************************************
+//! Number of not listed IDs accepted by groups
+/*!
+ * Result is saturated to 0xFFFFFFFF. It is upper bound when groups overlap(merged
+ * group can partially cover other group).
+ */
+
+uint32_t DRV_CANFDSPI_FilterFalseAccepts(const CAN_FILTER_GROUP* groups, uint8_t nFilters);
+
+// *****************************************************************************
+//! Check if ID(with CAN_FILTER_EXTENDED flag for extended ID) is accepted by groups
+/*!
+ * Return: index of accepting group or -1 when ID is rejected.
+ */
+
+int8_t DRV_CANFDSPI_FilterMatch(const CAN_FILTER_GROUP* groups, uint8_t nFilters, uint32_t id);
+
+// *****************************************************************************
+//! Convert groups into CiFLTOBJm/CiMASKm pairs and CiFLTCONm bytes
+/*!
+ * filterObj must have space for 2 * nFilters words and filterCon for nFilters bytes,
+ * result can be used as filterObj and filterCon of CAN_CONFIG_IMAGE.
+ */
+
+void DRV_CANFDSPI_FilterImageGet(const CAN_FILTER_GROUP* groups, uint8_t nFilters,
+        CAN_FIFO_CHANNEL channel, uint32_t* filterObj, uint8_t* filterCon);
+
+// *****************************************************************************
+//! Write groups to filters firstFilter .. firstFilter + nFilters - 1
+/*!
+ * Every filter is disabled, configured and linked with FIFO channel. Filters can be
+ * changed in normal mode.
+ *
+ * Return: 0 - success, -1 - filters out of range, -2 - SPI error.
+ */
+
+int8_t DRV_CANFDSPI_FilterProgram(CANFDSPI_MODULE_ID index, CAN_FILTER firstFilter,
+        const CAN_FILTER_GROUP* groups, uint8_t nFilters, CAN_FIFO_CHANNEL channel);
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // _DRV_CANFDSPI_FILTER_H
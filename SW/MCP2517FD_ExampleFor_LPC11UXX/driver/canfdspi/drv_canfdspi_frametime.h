@@ -0,0 +1,168 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _DRV_CANFDSPI_FRAMETIME_H
+#define _DRV_CANFDSPI_FRAMETIME_H
+
+/*
+* Frame timing calculator.
+*
+* Calculate how long frame occupy the bus: from SOF to the end of intermission(3 bits
+* after EOF), so sum of frame times is bus load and frame time is the shortest gap
+* between start of two frames.
+*
+* Length is calculated in bits of nominal and data phase:
+* - actual length: bit stream from SOF to the end of data field(to the end of CRC15 for
+*   classic frames) is built from real ID, control bits and payload, so every dynamic
+*   stuff bit is counted,
+* - worse case length: every 4 bits after first 5 bits of stuffed part contain stuff
+*   bit(upper bound used in response time analysis).
+* CAN FD frame add stuff count, CRC17(up to 16 bytes) or CRC21 and fixed stuff bits. With
+* BRS bits after BRS bit until CRC delimiter use data bit rate. CRC delimiter, ACK, EOF
+* and intermission always use nominal bit rate.
+*
+* Module depend only on drv_canfdspi_defines.h and use 32 bit integer arithmetic, so it
+* can be built for MCU and for host tools without SPI driver. Bit times are kept in
+* 1/16 ns, frame time is returned in ns.
+*
+* Simple example code:
+*
+*	CAN_FRAMETIME frameTime;
+*	uint32_t ns;
+*
+*	DRV_CANFDSPI_FrameTimeInitializeSetup(&frameTime, CAN_500K_2M);
+*
+*	ns = DRV_CANFDSPI_FrameTime(&frameTime, txObj.word, txd);
+*	ns = DRV_CANFDSPI_FrameTimeWorstCase(&frameTime, false, true, true, CAN_DLC_64);
+*/
+
+#include "drv_canfdspi_defines.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+//! Bits after CRC field: CRC delimiter, ACK slot, ACK delimiter, EOF and intermission
+#define CAN_FRAMETIME_TAIL_BITS (1 + 1 + 1 + 7 + 3)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+
+//! Length of frame in bits
+
+typedef struct _CAN_FRAME_BITS {
+    //! Bits sent with nominal and data bit rate, stuff bits included
+    uint16_t nominalBits;
+    uint16_t dataBits;
+    //! Dynamic stuff bits(fixed stuff bits of CAN FD CRC field aren't counted)
+    uint16_t stuffBits;
+} CAN_FRAME_BITS;
+
+//! Bit times of nominal and data phase in 1/16 ns
+
+typedef struct _CAN_FRAMETIME {
+    uint32_t nominalBitTime;
+    uint32_t dataBitTime;
+} CAN_FRAMETIME;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Frame Timing
+
+// *****************************************************************************
+//! Number of payload bytes sent on the bus(classic frame with DLC > 8 has 8 bytes)
+
+uint8_t DRV_CANFDSPI_FrameDataBytes(bool fdf, CAN_DLC dlc);
+
+// *****************************************************************************
+//! Actual length of frame
+/*!
+ * header is CAN_TX_MSGOBJ or CAN_RX_MSGOBJ word array(ID and control words), when
+ * data is NULL payload is counted as zeros.
+ */
+
+void DRV_CANFDSPI_FrameBits(const uint32_t* header, const uint8_t* data, CAN_FRAME_BITS* bits);
+
+// *****************************************************************************
+//! Worse case length of data frame with any ID and payload
+
+void DRV_CANFDSPI_FrameBitsWorstCase(bool extended, bool fdf, bool brs, CAN_DLC dlc,
+        CAN_FRAME_BITS* bits);
+
+// *****************************************************************************
+//! Initialize bit times
+
+void DRV_CANFDSPI_FrameTimeInitialize(CAN_FRAMETIME* frameTime, uint32_t nominalBitRate,
+        uint32_t dataBitRate);
+
+// *****************************************************************************
+//! Nominal and data bit rate of bit time setup used by DRV_CANFDSPI_BitTimeConfigure
+/*!
+ * Return: 0 - success, -1 - unknown setup.
+ */
+
+int8_t DRV_CANFDSPI_FrameTimeSetupBitRates(CAN_BITTIME_SETUP setup,
+        uint32_t* nominalBitRate, uint32_t* dataBitRate);
+
+// *****************************************************************************
+//! Initialize bit times for CAN_BITTIME_SETUP
+/*!
+ * Return: 0 - success, -1 - unknown setup.
+ */
+
+int8_t DRV_CANFDSPI_FrameTimeInitializeSetup(CAN_FRAMETIME* frameTime, CAN_BITTIME_SETUP setup);
+
+// *****************************************************************************
+//! Time of nominal and data bits in ns
+
+uint32_t DRV_CANFDSPI_FrameTimeBits(const CAN_FRAMETIME* frameTime, const CAN_FRAME_BITS* bits);
+
+// *****************************************************************************
+//! Actual frame time in ns
+
+uint32_t DRV_CANFDSPI_FrameTime(const CAN_FRAMETIME* frameTime, const uint32_t* header,
+        const uint8_t* data);
+
+// *****************************************************************************
+//! Worse case frame time in ns
+
+uint32_t DRV_CANFDSPI_FrameTimeWorstCase(const CAN_FRAMETIME* frameTime, bool extended,
+        bool fdf, bool brs, CAN_DLC dlc);
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // _DRV_CANFDSPI_FRAMETIME_H
@@ -0,0 +1,295 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_canfdspi_slab.h"
+#include "drv_canfdspi_register.h"
+#include "drv_canfdspi_codec.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Slab Allocator
+
+int8_t DRV_CANFDSPI_SlabInitialize(CAN_SLAB* slab, uint32_t* memory, uint32_t memoryWords,
+        const uint8_t blocks[CAN_SLAB_CLASSES])
+{
+    CAN_SLAB_CLASS* slabClass;
+    uint8_t* block = (uint8_t*) memory;
+    uint32_t bytes = 0;
+    uint8_t c;
+    uint8_t i;
+
+    for (c = 0; c < CAN_SLAB_CLASSES; c++) {
+        bytes += blocks[c] * CAN_SLAB_BLOCK_BYTES(CAN_SLAB_CLASS_DATA_BYTES(c));
+    }
+    if (bytes > (memoryWords * 4)) {
+        return -1;
+    }
+
+    for (c = 0; c < CAN_SLAB_CLASSES; c++) {
+        slabClass = &slab->classes[c];
+        slabClass->blockBytes = CAN_SLAB_BLOCK_BYTES(CAN_SLAB_CLASS_DATA_BYTES(c));
+        slabClass->blocks = blocks[c];
+        slabClass->inUse = 0;
+        slabClass->highWatermark = 0;
+        slabClass->allocations = 0;
+        slabClass->fallbacks = 0;
+        slabClass->failures = 0;
+        slabClass->start = block;
+        slabClass->freeList = NULL;
+
+        // Blocks are linked from the last one so the first block is allocated first
+        block += blocks[c] * slabClass->blockBytes;
+        slabClass->end = block;
+
+        for (i = blocks[c]; i > 0; i--) {
+            CAN_SLAB_FRAME* frame = (CAN_SLAB_FRAME*) (slabClass->start + (i - 1) * slabClass->blockBytes);
+            frame->next = slabClass->freeList;
+            slabClass->freeList = frame;
+        }
+    }
+
+    return 0;
+}
+
+uint8_t DRV_CANFDSPI_SlabClassGet(uint32_t dataBytes)
+{
+    uint8_t c;
+
+    for (c = 0; c < CAN_SLAB_CLASSES; c++) {
+        if (dataBytes <= CAN_SLAB_CLASS_DATA_BYTES(c)) {
+            break;
+        }
+    }
+
+    return c;
+}
+
+CAN_SLAB_FRAME* DRV_CANFDSPI_SlabAlloc(CAN_SLAB* slab, uint32_t dataBytes)
+{
+    CAN_SLAB_CLASS* slabClass;
+    CAN_SLAB_FRAME* frame = NULL;
+    uint32_t lockState;
+    uint8_t requested;
+    uint8_t c;
+
+    requested = DRV_CANFDSPI_SlabClassGet(dataBytes);
+    if (requested >= CAN_SLAB_CLASSES) {
+        return NULL;
+    }
+
+    CAN_SLAB_LOCK(lockState);
+
+    slab->classes[requested].allocations++;
+
+    for (c = requested; c < CAN_SLAB_CLASSES; c++) {
+        slabClass = &slab->classes[c];
+        frame = slabClass->freeList;
+
+        if (frame != NULL) {
+            slabClass->freeList = frame->next;
+            slabClass->inUse++;
+            if (slabClass->inUse > slabClass->highWatermark) {
+                slabClass->highWatermark = slabClass->inUse;
+            }
+            if (c != requested) {
+                slab->classes[requested].fallbacks++;
+            }
+            break;
+        }
+    }
+
+    if (frame == NULL) {
+        slab->classes[requested].failures++;
+    }
+
+    CAN_SLAB_UNLOCK(lockState);
+
+    return frame;
+}
+
+void DRV_CANFDSPI_SlabFree(CAN_SLAB* slab, CAN_SLAB_FRAME* frame)
+{
+    CAN_SLAB_CLASS* slabClass;
+    uint32_t lockState;
+    uint8_t c;
+
+    for (c = 0; c < CAN_SLAB_CLASSES; c++) {
+        slabClass = &slab->classes[c];
+
+        if (((uint8_t*) frame >= slabClass->start) && ((uint8_t*) frame < slabClass->end)) {
+            CAN_SLAB_LOCK(lockState);
+            frame->next = slabClass->freeList;
+            slabClass->freeList = frame;
+            slabClass->inUse--;
+            CAN_SLAB_UNLOCK(lockState);
+            return;
+        }
+    }
+}
+
+uint32_t DRV_CANFDSPI_SlabFrameDataBytes(const CAN_SLAB_FRAME* frame)
+{
+    uint32_t dataBytes = DRV_CANFDSPI_DlcToDataBytes((CAN_DLC) frame->tx.bF.ctrl.DLC);
+
+    if (!frame->tx.bF.ctrl.FDF && (dataBytes > 8)) {
+        dataBytes = 8;
+    }
+
+    return dataBytes;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Slab Queue
+
+int8_t DRV_CANFDSPI_SlabQueueInitialize(CAN_SLAB_QUEUE* queue, CAN_SLAB_FRAME** slots,
+        uint8_t depth)
+{
+    if ((depth == 0) || (depth > 128) || (depth & (depth - 1))) {
+        return -1;
+    }
+
+    queue->slots = slots;
+    queue->depth = depth;
+    queue->head = 0;
+    queue->tail = 0;
+    queue->highWatermark = 0;
+    queue->overruns = 0;
+
+    return 0;
+}
+
+bool DRV_CANFDSPI_SlabQueuePut(CAN_SLAB_QUEUE* queue, CAN_SLAB_FRAME* frame)
+{
+    uint8_t head = queue->head;
+    uint8_t count = (uint8_t) (head - queue->tail);
+
+    if (count >= queue->depth) {
+        return false;
+    }
+
+    queue->slots[head & (queue->depth - 1)] = frame;
+
+    CAN_SLAB_BARRIER();
+    queue->head = head + 1;
+
+    if ((count + 1) > queue->highWatermark) {
+        queue->highWatermark = count + 1;
+    }
+
+    return true;
+}
+
+CAN_SLAB_FRAME* DRV_CANFDSPI_SlabQueueGet(CAN_SLAB_QUEUE* queue)
+{
+    uint8_t tail = queue->tail;
+    CAN_SLAB_FRAME* frame;
+
+    if (tail == queue->head) {
+        return NULL;
+    }
+
+    CAN_SLAB_BARRIER();
+    frame = queue->slots[tail & (queue->depth - 1)];
+
+    CAN_SLAB_BARRIER();
+    queue->tail = tail + 1;
+
+    return frame;
+}
+
+uint8_t DRV_CANFDSPI_SlabQueueCount(const CAN_SLAB_QUEUE* queue)
+{
+    return (uint8_t) (queue->head - queue->tail);
+}
+
+int8_t DRV_CANFDSPI_SlabReceive(CAN_SLAB* slab, CAN_SLAB_QUEUE* queue,
+        CANFDSPI_MODULE_ID index, CAN_FIFO_CHANNEL channel, bool timeStamp)
+{
+    uint32_t object[3 + 2];
+    uint32_t headerWords = timeStamp ? 3 : 2;
+    uint32_t dataBytes = 0;
+    CAN_SLAB_FRAME* frame = NULL;
+    uint32_t ua;
+    uint16_t a = 0;
+    uint8_t i;
+
+    // When queue is full frame isn't read at all
+    if (DRV_CANFDSPI_SlabQueueCount(queue) < queue->depth) {
+        if (DRV_CANFDSPI_ReadWord(index, cREGADDR_CiFIFOUA + (channel * CiFIFO_OFFSET), &ua)) {
+            return -1;
+        }
+        a = DRV_CANFDSPI_UA_TO_RAMADDR(ua);
+
+        // Header and payload of classic frame
+        if (DRV_CANFDSPI_ReadByteArray(index, a, (uint8_t*) object, (headerWords + 2) * 4)) {
+            return -1;
+        }
+
+        dataBytes = DRV_CANFDSPI_SlabFrameDataBytes((CAN_SLAB_FRAME*) object);
+        frame = DRV_CANFDSPI_SlabAlloc(slab, dataBytes);
+    }
+
+    if (frame != NULL) {
+        frame->word[0] = object[0];
+        frame->word[1] = object[1];
+        frame->word[2] = timeStamp ? object[2] : 0;
+
+        for (i = 0; i < 2; i++) {
+            ((uint32_t*) CAN_SLAB_RX_DATA(frame))[i] = object[headerWords + i];
+        }
+
+        // Rest of payload
+        if (dataBytes > 8) {
+            if (DRV_CANFDSPI_ReadByteArray(index, a + (headerWords + 2) * 4,
+                    CAN_SLAB_RX_DATA(frame) + 8, CAN_PADDED_DATA_BYTES(dataBytes) - 8)) {
+                DRV_CANFDSPI_SlabFree(slab, frame);
+                return -1;
+            }
+        }
+    }
+
+    // Frame is removed from FIFO also when it is dropped
+    if (DRV_CANFDSPI_ReceiveChannelUpdate(index, channel)) {
+        if (frame != NULL) {
+            DRV_CANFDSPI_SlabFree(slab, frame);
+        }
+        return -1;
+    }
+
+    if (frame == NULL) {
+        queue->overruns++;
+        return 1;
+    }
+
+    DRV_CANFDSPI_SlabQueuePut(queue, frame);
+
+    return 0;
+}
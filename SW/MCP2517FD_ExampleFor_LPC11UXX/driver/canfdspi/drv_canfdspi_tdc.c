@@ -0,0 +1,325 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stddef.h>
+#include "drv_canfdspi_tdc.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+//! Number of CiCON reads while waiting for mode change
+#define CAN_TDC_MODE_CHANGE_TIMEOUT 1000
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local functions
+
+//! Select operation mode and wait until it is active
+
+static int8_t DRV_CANFDSPI_TdcModeChange(CANFDSPI_MODULE_ID index,
+        CAN_OPERATION_MODE opMode)
+{
+    uint16_t attempts = CAN_TDC_MODE_CHANGE_TIMEOUT;
+
+    if (DRV_CANFDSPI_OperationModeSelect(index, opMode)) {
+        return -1;
+    }
+
+    while (DRV_CANFDSPI_OperationModeGet(index) != opMode) {
+        if (--attempts == 0) {
+            return -2;
+        }
+    }
+
+    return 0;
+}
+
+//! CRC16 of profile without crc field
+
+static uint16_t DRV_CANFDSPI_TdcProfileCrc(const CAN_TDC_PROFILE* profile)
+{
+    return DRV_CANFDSPI_CalculateCRC16((uint8_t*) profile, offsetof(CAN_TDC_PROFILE, crc));
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: TDC Calibration
+
+void DRV_CANFDSPI_TdcCalibrationConfigObjectReset(CAN_TDC_CALIBRATION_CONFIG* config)
+{
+    config->txChannel = CAN_FIFO_CH1;
+    config->mode = CAN_EXTERNAL_LOOPBACK_MODE;
+    config->id = 0x7FF;
+    config->dlc = CAN_DLC_64;
+    config->nFrames = CAN_TDC_CALIBRATION_FRAMES;
+    config->timeout = CAN_TDC_CALIBRATION_TIMEOUT;
+}
+
+int8_t DRV_CANFDSPI_TdcMeasure(CANFDSPI_MODULE_ID index,
+        const CAN_TDC_CALIBRATION_CONFIG* config, CAN_TDC_STATISTICS* stats)
+{
+    CAN_TX_MSGOBJ txObj;
+    uint8_t txd[MAX_DATA_BYTES];
+    CAN_TX_FIFO_EVENT txFlags;
+    REG_CiTDC ciTdc;
+    uint8_t tecBefore;
+    uint8_t tecAfter;
+    uint16_t frame;
+    uint16_t attempts;
+    uint32_t nBytes;
+    uint8_t i;
+
+    stats->tdcvMin = 0xFF;
+    stats->tdcvMax = 0;
+    stats->nFrames = 0;
+    stats->tdcvSum = 0;
+    stats->nErrors = 0;
+
+    // Alternating bits give edge in every bit of data phase
+    nBytes = DRV_CANFDSPI_DlcToDataBytes(config->dlc);
+    for (i = 0; i < nBytes; i++) {
+        txd[i] = 0x55;
+    }
+
+    txObj.word[0] = 0;
+    txObj.word[1] = 0;
+    txObj.word[2] = 0;
+    txObj.bF.id.SID = config->id;
+    txObj.bF.ctrl.DLC = config->dlc;
+    txObj.bF.ctrl.FDF = 1;
+    txObj.bF.ctrl.BRS = 1;
+
+    for (frame = 0; frame < config->nFrames; frame++) {
+        if (DRV_CANFDSPI_ErrorCountTransmitGet(index, &tecBefore)) {
+            return -1;
+        }
+
+        if (DRV_CANFDSPI_TransmitChannelLoad(index, config->txChannel, &txObj, txd, nBytes, true)) {
+            return -1;
+        }
+
+        // Wait until frame leave FIFO
+        attempts = config->timeout;
+        do {
+            if (DRV_CANFDSPI_TransmitChannelEventGet(index, config->txChannel, &txFlags)) {
+                return -1;
+            }
+        } while (!(txFlags & CAN_TX_FIFO_EMPTY_EVENT) && (--attempts != 0));
+
+        if (!(txFlags & CAN_TX_FIFO_EMPTY_EVENT)) {
+            DRV_CANFDSPI_TransmitChannelAbort(index, config->txChannel);
+            DRV_CANFDSPI_TransmitChannelReset(index, config->txChannel);
+            stats->nErrors++;
+            continue;
+        }
+
+        if (DRV_CANFDSPI_ErrorCountTransmitGet(index, &tecAfter)) {
+            return -1;
+        }
+
+        if (tecAfter > tecBefore) {
+            stats->nErrors++;
+            continue;
+        }
+
+        // TDCV is updated after every frame with BRS
+        if (DRV_CANFDSPI_ReadWord(index, cREGADDR_CiTDC, &ciTdc.word)) {
+            return -1;
+        }
+
+        if (ciTdc.bF.TDCValue < stats->tdcvMin) {
+            stats->tdcvMin = ciTdc.bF.TDCValue;
+        }
+        if (ciTdc.bF.TDCValue > stats->tdcvMax) {
+            stats->tdcvMax = ciTdc.bF.TDCValue;
+        }
+        stats->tdcvSum += ciTdc.bF.TDCValue;
+        stats->nFrames++;
+    }
+
+    return 0;
+}
+
+int8_t DRV_CANFDSPI_TdcProfileDerive(const CAN_BITTIME_SOLVER_CONFIG* bitTimeConfig,
+        const CAN_BITTIME_SOLUTION* solution, const CAN_TDC_STATISTICS* stats,
+        CAN_TDC_PROFILE* profile)
+{
+    uint32_t brp;
+    uint32_t nTq;
+    uint32_t jitter;
+    uint32_t tdcOffset;
+    uint32_t minOffset;
+    uint32_t maxOffset;
+    uint32_t tseg2;
+    uint16_t samplePoint = solution->dataSamplePoint;
+
+    if ((stats->nFrames == 0) || stats->nErrors) {
+        return -1;
+    }
+
+    // Saturated TDCV mean that real delay is unknown
+    if (stats->tdcvMax >= CAN_BITTIME_MAX_TDC) {
+        return -2;
+    }
+
+    brp = solution->dbtcfg.bF.BRP + 1;
+    nTq = solution->dbtcfg.bF.TSEG1 + solution->dbtcfg.bF.TSEG2 + 3;
+    jitter = stats->tdcvMax - stats->tdcvMin;
+
+    // Received bit can start jitter SYSCLK before or after measured TDCV
+    minOffset = jitter + 1;
+    if ((brp * nTq) < (2 * minOffset)) {
+        return -3;
+    }
+    maxOffset = (brp * nTq) - minOffset;
+    if (maxOffset > CAN_BITTIME_MAX_TDC) {
+        maxOffset = CAN_BITTIME_MAX_TDC;
+    }
+    if (minOffset > maxOffset) {
+        return -3;
+    }
+
+    tdcOffset = solution->tdc.bF.TDCOffset;
+    if (tdcOffset < minOffset) {
+        tdcOffset = minOffset;
+    }
+    if (tdcOffset > maxOffset) {
+        tdcOffset = maxOffset;
+    }
+
+    // Phase segment 2 must be longer than jitter so resynchronization can compensate it
+    tseg2 = jitter / brp + 1;
+    if ((uint32_t) (solution->dbtcfg.bF.TSEG2 + 1) < tseg2) {
+        if ((nTq - tseg2) < 2) {
+            return -3;
+        }
+        samplePoint = ((nTq - tseg2) * 1000) / nTq;
+    }
+
+    profile->magic = CAN_TDC_PROFILE_MAGIC;
+    profile->sysClk = bitTimeConfig->sysClk;
+    profile->nominalBitRate = bitTimeConfig->nominalBitRate;
+    profile->dataBitRate = bitTimeConfig->dataBitRate;
+    profile->tdcvMin = stats->tdcvMin;
+    profile->tdcvMax = stats->tdcvMax;
+    profile->tdcvMean = stats->tdcvSum / stats->nFrames;
+    profile->tdcOffset = tdcOffset;
+    profile->dataSamplePoint = samplePoint;
+    profile->crc = DRV_CANFDSPI_TdcProfileCrc(profile);
+
+    return 0;
+}
+
+int8_t DRV_CANFDSPI_TdcCalibrate(CANFDSPI_MODULE_ID index,
+        const CAN_TDC_CALIBRATION_CONFIG* config,
+        const CAN_BITTIME_SOLVER_CONFIG* bitTimeConfig,
+        const uint32_t* dataBitRates, uint8_t nBitRates, CAN_TDC_PROFILE* profile)
+{
+    CAN_BITTIME_SOLVER_CONFIG rateConfig = *bitTimeConfig;
+    CAN_BITTIME_SOLUTION solution;
+    CAN_TDC_STATISTICS stats;
+    CAN_TDC_PROFILE candidate;
+    uint8_t i;
+    int8_t solverResult;
+    int8_t result = -1;
+
+    for (i = 0; i < nBitRates; i++) {
+        // Data phase delay budget is checked by measurement
+        rateConfig.dataBitRate = dataBitRates[i];
+        solverResult = DRV_CANFDSPI_BitTimeSolve(&rateConfig, &solution);
+        if (solverResult && (solverResult != -5)) {
+            break;
+        }
+
+        // TDCV is measured only in auto mode
+        solution.tdc.bF.TDCMode = CAN_SSP_MODE_AUTO;
+
+        if (DRV_CANFDSPI_TdcModeChange(index, CAN_CONFIGURATION_MODE)
+                || DRV_CANFDSPI_BitTimeConfigureSolution(index, &solution)
+                || DRV_CANFDSPI_TdcModeChange(index, config->mode)
+                || DRV_CANFDSPI_TdcMeasure(index, config, &stats)) {
+            result = -2;
+            break;
+        }
+
+        if (DRV_CANFDSPI_TdcProfileDerive(&rateConfig, &solution, &stats, &candidate)) {
+            break;
+        }
+
+        *profile = candidate;
+        result = 0;
+    }
+
+    if (DRV_CANFDSPI_TdcModeChange(index, CAN_CONFIGURATION_MODE)) {
+        return -2;
+    }
+
+    return result;
+}
+
+bool DRV_CANFDSPI_TdcProfileIsValid(const CAN_TDC_PROFILE* profile)
+{
+    return (profile->magic == CAN_TDC_PROFILE_MAGIC)
+            && (profile->crc == DRV_CANFDSPI_TdcProfileCrc(profile));
+}
+
+int8_t DRV_CANFDSPI_TdcProfileApply(CANFDSPI_MODULE_ID index,
+        const CAN_TDC_PROFILE* profile, const CAN_BITTIME_SOLVER_CONFIG* bitTimeConfig)
+{
+    CAN_BITTIME_SOLVER_CONFIG profileConfig = *bitTimeConfig;
+    CAN_BITTIME_SOLUTION solution;
+    int8_t result;
+
+    if (!DRV_CANFDSPI_TdcProfileIsValid(profile)
+            || (profile->sysClk != bitTimeConfig->sysClk)
+            || (profile->nominalBitRate != bitTimeConfig->nominalBitRate)) {
+        return -1;
+    }
+
+    profileConfig.dataBitRate = profile->dataBitRate;
+    profileConfig.dataSamplePoint = profile->dataSamplePoint;
+    profileConfig.sspMode = CAN_SSP_MODE_AUTO;
+
+    // Data phase delay budget was verified by calibration
+    result = DRV_CANFDSPI_BitTimeSolve(&profileConfig, &solution);
+    if (result && (result != -5)) {
+        return -2;
+    }
+
+    solution.tdc.bF.TDCMode = CAN_SSP_MODE_AUTO;
+    solution.tdc.bF.TDCOffset = profile->tdcOffset;
+
+    if (DRV_CANFDSPI_BitTimeConfigureSolution(index, &solution)) {
+        return -2;
+    }
+
+    return 0;
+}
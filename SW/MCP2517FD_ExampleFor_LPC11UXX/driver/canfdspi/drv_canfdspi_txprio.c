@@ -0,0 +1,200 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_canfdspi_txprio.h"
+#include "drv_canfdspi_register.h"
+#include "drv_canfdspi_codec.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Transmit Priority Engine
+
+void DRV_CANFDSPI_TxPrioClassConfigObjectReset(CAN_TXPRIO_CLASS_CONFIG* config)
+{
+    REG_CiFIFOCON ciFifoCon;
+    ciFifoCon.word = canFifoResetValues[0];
+
+    config->txPriority = 0;
+    config->fifoSize = 7;
+    config->payLoadSize = CAN_PLSIZE_64;
+    config->txAttempts = ciFifoCon.txBF.TxAttempts;
+}
+
+int8_t DRV_CANFDSPI_TxPrioConfigure(CAN_TXPRIO_ENGINE* engine, CANFDSPI_MODULE_ID index,
+        CAN_FIFO_CHANNEL firstChannel, const CAN_TXPRIO_CLASS_CONFIG* classes, uint8_t nClasses)
+{
+    CAN_TX_FIFO_CONFIG txConfig;
+    uint8_t i;
+
+    if ((nClasses == 0) || (nClasses > CAN_TXPRIO_MAX_CLASSES) ||
+            (firstChannel == CAN_FIFO_CH0) ||
+            ((firstChannel + nClasses) > CAN_FIFO_TOTAL_CHANNELS)) {
+        return -1;
+    }
+
+    engine->index = index;
+    engine->firstChannel = firstChannel;
+    engine->nClasses = nClasses;
+    engine->statusReads = 0;
+
+    for (i = 0; i < nClasses; i++) {
+        DRV_CANFDSPI_TransmitChannelConfigureObjectReset(&txConfig);
+        txConfig.TxPriority = classes[i].txPriority;
+        txConfig.FifoSize = classes[i].fifoSize;
+        txConfig.PayLoadSize = classes[i].payLoadSize;
+        txConfig.TxAttempts = classes[i].txAttempts;
+
+        if (DRV_CANFDSPI_TransmitChannelConfigure(index, firstChannel + i, &txConfig)) {
+            return -2;
+        }
+
+        // FIFO is reset by configuration, RAM address is known after first status read
+        engine->classes[i].depth = classes[i].fifoSize + 1;
+        engine->classes[i].objBytes = 8 + CAN_PLSIZE_DATA_BYTES(classes[i].payLoadSize);
+        engine->classes[i].tail = 0;
+        engine->classes[i].level = 0;
+        engine->classes[i].ramBase = 0;
+        engine->classes[i].ramBaseValid = false;
+        engine->classes[i].submitted = 0;
+        engine->classes[i].rejected = 0;
+    }
+
+    return 0;
+}
+
+int8_t DRV_CANFDSPI_TxPrioStatusUpdate(CAN_TXPRIO_ENGINE* engine)
+{
+    uint32_t fifoReg[CAN_TXPRIO_MAX_CLASSES * 3];
+    CAN_TXPRIO_CLASS* txClass;
+    REG_CiFIFOSTA ciFifoSta;
+    uint8_t head;
+    uint8_t i;
+
+    // CiFIFOCON, CiFIFOSTA and CiFIFOUA of all classes are placed one after another
+    if (DRV_CANFDSPI_ReadWordArray(engine->index,
+            cREGADDR_CiFIFOCON + (engine->firstChannel * CiFIFO_OFFSET),
+            fifoReg, engine->nClasses * 3)) {
+        return -1;
+    }
+
+    engine->statusReads++;
+
+    for (i = 0; i < engine->nClasses; i++) {
+        txClass = &engine->classes[i];
+        ciFifoSta.word = fifoReg[i * 3 + 1];
+        head = ciFifoSta.txBF.FifoIndex;
+
+        if (ciFifoSta.txBF.TxEmptyIF) {
+            txClass->level = 0;
+        } else if (!ciFifoSta.txBF.TxNotFullIF) {
+            txClass->level = txClass->depth;
+        } else {
+            txClass->level = (txClass->tail + txClass->depth - head) % txClass->depth;
+        }
+
+        // User address point to object with tail index
+        txClass->ramBase = DRV_CANFDSPI_UA_TO_RAMADDR(fifoReg[i * 3 + 2]) -
+                (txClass->tail * txClass->objBytes);
+        txClass->ramBaseValid = true;
+    }
+
+    return 0;
+}
+
+int8_t DRV_CANFDSPI_TxPrioSubmit(CAN_TXPRIO_ENGINE* engine, uint8_t classIndex,
+        CAN_TX_MSGOBJ* txObj, uint8_t* txd, uint8_t txdNumBytes)
+{
+    uint8_t txBuffer[MAX_MSG_SIZE];
+    CAN_TXPRIO_CLASS* txClass;
+    uint32_t dataBytesInObject;
+    uint16_t n;
+    uint8_t i;
+
+    if (classIndex >= engine->nClasses) {
+        return -2;
+    }
+    txClass = &engine->classes[classIndex];
+
+    // Check that DLC is big enough for data and fit into FIFO payload
+    dataBytesInObject = DRV_CANFDSPI_DlcToDataBytes((CAN_DLC) txObj->bF.ctrl.DLC);
+    if ((dataBytesInObject < txdNumBytes) || ((dataBytesInObject + 8) > txClass->objBytes)) {
+        return -2;
+    }
+
+    // Status is read only when cached level doesn't allow to load frame
+    if (!txClass->ramBaseValid || (txClass->level >= txClass->depth)) {
+        if (DRV_CANFDSPI_TxPrioStatusUpdate(engine)) {
+            return -3;
+        }
+
+        if (txClass->level >= txClass->depth) {
+            txClass->rejected++;
+            return -1;
+        }
+    }
+
+    for (i = 0; i < 8; i++) {
+        txBuffer[i] = txObj->byte[i];
+    }
+    for (i = 0; i < txdNumBytes; i++) {
+        txBuffer[i + 8] = txd[i];
+    }
+
+    // Make sure we write a multiple of 4 bytes to RAM
+    n = CAN_PADDED_DATA_BYTES(txdNumBytes);
+    for (i = txdNumBytes; i < n; i++) {
+        txBuffer[i + 8] = 0;
+    }
+
+    if (DRV_CANFDSPI_WriteByteArray(engine->index,
+            txClass->ramBase + (txClass->tail * txClass->objBytes), txBuffer, n + 8)) {
+        return -3;
+    }
+
+    // Set UINC and TXREQ
+    if (DRV_CANFDSPI_TransmitChannelUpdate(engine->index, engine->firstChannel + classIndex, true)) {
+        return -3;
+    }
+
+    txClass->tail = (txClass->tail + 1) % txClass->depth;
+    txClass->level++;
+    txClass->submitted++;
+
+    return 0;
+}
+
+uint8_t DRV_CANFDSPI_TxPrioFillLevel(const CAN_TXPRIO_ENGINE* engine, uint8_t classIndex)
+{
+    if (classIndex >= engine->nClasses) {
+        return 0;
+    }
+
+    return engine->classes[classIndex].level;
+}
@@ -68,6 +68,49 @@ int8_t DRV_SPI_TransferData(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxData, uin
 	return spi_master_transfer(SpiTxData, SpiRxData, spiTransferSize);
 }
 
+int8_t DRV_SPI_TransferFill(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxHeader, uint16_t spiHeaderSize, uint8_t fillByte, uint16_t spiFillSize)
+{
+	uint16_t totalSize = spiHeaderSize + spiFillSize;
+	uint16_t pos = 0;
+
+	GPIO_SetState(MPC2517_CHIP_CONTROL_LINE_PORT, MPC2517_CHIP_CONTROL_LINE_PIN, false);
+
+	while(pos < totalSize)
+	{
+		uint16_t i = 0;
+
+		for (i = 0; ((pos + i) < totalSize) && i < SPI_BUFFER_SIZE; i++)
+		{
+			// Transmit
+			if ((pos + i) < spiHeaderSize)
+			{
+				SPI_PutByteToTransmitter(MPC2517_CHIP_SPI_PORT_NUMBER, SpiTxHeader[pos + i]);
+			}
+			else
+			{
+				SPI_PutByteToTransmitter(MPC2517_CHIP_SPI_PORT_NUMBER, fillByte);
+			}
+		}
+
+		for (; SPI_CheckBusyFlag(MPC2517_CHIP_SPI_PORT_NUMBER);){}
+
+		for (i = 0; ((pos + i) < totalSize) && i < SPI_BUFFER_SIZE; i++)
+		{
+			// Received data is discarded, FIFO must be only emptied
+			SPI_ReadByteFromTrasmitter(MPC2517_CHIP_SPI_PORT_NUMBER);
+		}
+
+		pos+=i;
+	}/* while(pos < totalSize) */
+
+	GPIO_SetState(MPC2517_CHIP_CONTROL_LINE_PORT, MPC2517_CHIP_CONTROL_LINE_PIN, true);
+
+	Nop();
+	Nop();
+
+	return 0;
+}/* int8_t DRV_SPI_TransferFill(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxHeader, uint16_t spiHeaderSize, uint8_t fillByte, uint16_t spiFillSize) */
+
 void spi_master_init(void)
 {
 	GPIO_Init();
@@ -64,4 +64,8 @@ void DRV_SPI_Initialize(void);
 
 int8_t DRV_SPI_TransferData(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxData, uint8_t *SpiRxData, uint16_t spiTransferSize);
 
+//! SPI Write header followed by spiFillSize copies of fillByte in single transfer(CS asserted once)
+
+int8_t DRV_SPI_TransferFill(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxHeader, uint16_t spiHeaderSize, uint8_t fillByte, uint16_t spiFillSize);
+
 #endif	// _DRV_SPI_H
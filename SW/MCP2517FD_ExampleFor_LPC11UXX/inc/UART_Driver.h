@@ -61,9 +61,34 @@
 *		//refresh status register
 *		status = UART_ReturnStatusRegister(0);
 *	}
+*
+* Polling functions send and receive single byte. For logging and streaming ring buffers
+* can be enabled after UART_DriverInit, then UART interrupt move data between UART FIFOs
+* and buffers and application only copy data to or from buffer(functions don't wait).
+* Interrupt fill whole 16 byte TX FIFO at once and RX interrupt is generated after 8 bytes
+* or character timeout. UART_Write and UART_Read return number of copied bytes. Buffer
+* sizes must be power of two. Lost bytes and errors reported in Line Status register are
+* counted. Line Status register shouldn't be read by application when ring buffers are
+* enabled because read clear error flags.
+*
+* Simple example code with ring buffers:
+*
+*	static uint8_t txMemory[256];
+*	static uint8_t rxMemory[64];
+*	uint8_t rxData[16];
+*	UART_ErrorCounters errors;
+*
+*	UART_DriverInit(0, 115200, L8_BIT, ONE_BIT, NONE_PARITY);
+*	UART_EnableRingBuffers(0, txMemory, sizeof(txMemory), rxMemory, sizeof(rxMemory));
+*
+*	UART_Write(0, (const uint8_t*)"Hello\r\n", 7);
+*	uint16_t received = UART_Read(0, rxData, sizeof(rxData));
+*
+*	UART_ReturnErrorCounters(0, &errors);
 */
 #include <stdint.h>
 #include <stdbool.h>
+#include "UART_RingBuffer.h"
 
 #ifdef MICROCONTROLLER
 
@@ -146,10 +171,24 @@ extern "C" {
 		uint8_t Reserved : 4;
 	}ReadByteErrors;
 
+	typedef struct
+	{
+		uint32_t overrun;//byte lost because RX FIFO wasn't read in time
+		uint32_t framing;
+		uint32_t parity;
+		uint32_t rxDropped;//byte lost because RX ring buffer was full
+	}UART_ErrorCounters;
+
 #ifdef MICROCONTROLLER
 #define ENABLE_DIVISOR_LATCH 0x80
 #define DISABLE_DIVISOR_LATCH 0x7F
 #define ENABLE_AND_RESET_FIFO 0x7
+#define ENABLE_FIFO_RX_TRIGGER_8 0x81 //FIFO enabled, RX interrupt after 8 bytes
+
+//interrupt enable bits used by ring buffers(IER)
+#define UART_IER_RBR (1<<0)
+#define UART_IER_THRE (1<<1)
+#define UART_IER_RLS (1<<2)
 #else
 	typedef struct
 	{
@@ -174,6 +213,13 @@ extern "C" {
 	uint8_t UART_ReadByteFromTrasmitter(uint8_t portNumber);
 	UART_Status UART_ReturnStatusRegister(uint8_t portNumber);
 
+	bool UART_EnableRingBuffers(uint8_t portNumber, uint8_t* txMemory, uint16_t txSize, uint8_t* rxMemory, uint16_t rxSize);
+	uint16_t UART_Write(uint8_t portNumber, const uint8_t* data, uint16_t length);
+	uint16_t UART_Read(uint8_t portNumber, uint8_t* buffer, uint16_t length);
+	uint16_t UART_WriteSpace(uint8_t portNumber);
+	uint16_t UART_ReadCount(uint8_t portNumber);
+	void UART_ReturnErrorCounters(uint8_t portNumber, UART_ErrorCounters* counters);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,116 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef _UART_RING_BUFFER_H_
+#define _UART_RING_BUFFER_H_
+
+/*
+* This module contain byte ring buffer used by UART driver to buffer data between
+* application and UART interrupt. Module don't use any register so is the same for
+* all microcontrollers and can be tested on PC(HostTools/UartRingTest).
+*
+* Buffer can be used by one writer and one reader without disabling interrupts,
+* e.g. application write and interrupt read. Write index is changed only by writer
+* and read index only by reader. Indexes count bytes modulo 65536 so size must be
+* power of two and can't be bigger than 32768 bytes. Whole memory can be used, full
+* buffer is detected by difference of indexes.
+*
+* Simple example code:
+*
+*	static uint8_t txMemory[128];
+*	UART_RingBuffer txRing;
+*	uint8_t byte;
+*
+*	UART_RingBufferInit(&txRing, txMemory, sizeof(txMemory));
+*
+*	//application
+*	UART_RingBufferWrite(&txRing, (const uint8_t*)"Hello", 5);
+*
+*	//interrupt
+*	while (UART_RingBufferGet(&txRing, &byte))
+*	{
+*		//put byte to transmitter
+*	}
+*
+* Buffer can be read also by DMA. UART_RingBufferDmaPlan split data waiting in buffer
+* into at most two contiguous spans(second span start at the beginning of memory when
+* data wrap or continue first span when it was limited by maximal DMA transfer). Spans
+* are sent as linked DMA descriptors and bytes stay in buffer until whole chain is sent,
+* then reader release them by UART_RingBufferSkip and plan next chain:
+*
+*	UART_RingBufferDmaChain chain;
+*
+*	if (UART_RingBufferDmaPlan(&txRing, 1024, &chain) > 0)
+*	{
+*		//start DMA of chain.length[0] bytes from chain.start[0] linked with second span
+*	}
+*
+*	//DMA interrupt
+*	UART_RingBufferSkip(&txRing, chain.total);
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UART_RING_BUFFER_MAX_SIZE 32768
+#define UART_RING_BUFFER_DMA_SPANS 2
+
+	typedef struct
+	{
+		volatile uint8_t* memory;
+		uint16_t mask;//size - 1
+		volatile uint16_t writeIndex;//changed only by writer
+		volatile uint16_t readIndex;//changed only by reader
+	}UART_RingBuffer;
+
+	typedef struct
+	{
+		const volatile uint8_t* start[UART_RING_BUFFER_DMA_SPANS];
+		uint16_t length[UART_RING_BUFFER_DMA_SPANS];
+		uint8_t spans;
+		uint16_t total;//sum of span lengths
+	}UART_RingBufferDmaChain;
+
+	bool UART_RingBufferInit(UART_RingBuffer* ring, uint8_t* memory, uint16_t size);
+	uint16_t UART_RingBufferCount(const UART_RingBuffer* ring);
+	uint16_t UART_RingBufferSpace(const UART_RingBuffer* ring);
+	bool UART_RingBufferPut(UART_RingBuffer* ring, uint8_t byte);
+	bool UART_RingBufferGet(UART_RingBuffer* ring, uint8_t* byte);
+	uint16_t UART_RingBufferWrite(UART_RingBuffer* ring, const uint8_t* data, uint16_t length);
+	uint16_t UART_RingBufferRead(UART_RingBuffer* ring, uint8_t* buffer, uint16_t length);
+	uint16_t UART_RingBufferSkip(UART_RingBuffer* ring, uint16_t length);
+	uint8_t UART_RingBufferDmaPlan(const UART_RingBuffer* ring, uint16_t maxSpan, UART_RingBufferDmaChain* chain);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _UART_RING_BUFFER_H_ */
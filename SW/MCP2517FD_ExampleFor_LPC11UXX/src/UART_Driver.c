@@ -31,6 +31,22 @@ static uint8_t DivisorLatchMSB;//DLM
 static uint8_t DivisorLatchLSB;//DLL
 static uint8_t FractionalDivider;// MULVAL<<4 | DIVADDVAL
 
+//UART0 is only UART port
+#define UART_RING_PORTS 1
+
+typedef struct
+{
+	UART_RingBuffer tx;
+	UART_RingBuffer rx;
+	volatile uint32_t overrun;
+	volatile uint32_t framing;
+	volatile uint32_t parity;
+	volatile uint32_t rxDropped;
+	bool enabled;
+}UART_RingPort;
+
+static UART_RingPort RingPort[UART_RING_PORTS];
+
 static uint32_t* UART_GetBaseAddress(uint8_t portNumber)
 {
 	uint32_t* basePointer = 0;
@@ -158,3 +174,154 @@ void UART_DisableInterrupts(uint8_t portNumber)
 		NVIC_DisableIRQ(UART0_IRQn);
 	}
 }
+
+bool UART_EnableRingBuffers(uint8_t portNumber, uint8_t* txMemory, uint16_t txSize, uint8_t* rxMemory, uint16_t rxSize)
+{
+	LPC_USART_T *UART_Port = (LPC_USART_T*)UART_GetBaseAddress(portNumber);
+	UART_RingPort *port = &RingPort[portNumber];
+
+	if(UART_Port == 0)
+		return false;
+
+	if(!UART_RingBufferInit(&port->tx, txMemory, txSize) || !UART_RingBufferInit(&port->rx, rxMemory, rxSize))
+		return false;
+
+	port->overrun = 0;
+	port->framing = 0;
+	port->parity = 0;
+	port->rxDropped = 0;
+	port->enabled = true;
+
+	//RX interrupt after 8 bytes, rest is received by character timeout interrupt
+	UART_Port->FCR = ENABLE_FIFO_RX_TRIGGER_8;
+
+	//THRE interrupt is enabled only when TX buffer contain data
+	UART_Port->IER = UART_IER_RBR|UART_IER_RLS;
+
+	return true;
+}
+
+/*
+ * Move bytes from TX buffer to TX FIFO. FIFO must be empty and THRE interrupt can't
+ * be serviced at the same time.
+ */
+static void UART_FillTransmitter(LPC_USART_T *UART_Port, UART_RingPort *port)
+{
+	uint8_t byte;
+
+	for(int i = 0; (i < UART_BUFFER_SIZE) && UART_RingBufferGet(&port->tx, &byte); i++)
+		UART_Port->THR = byte;
+}
+
+uint16_t UART_Write(uint8_t portNumber, const uint8_t* data, uint16_t length)
+{
+	LPC_USART_T *UART_Port = (LPC_USART_T*)UART_GetBaseAddress(portNumber);
+	UART_RingPort *port = &RingPort[portNumber];
+	uint16_t written;
+
+	if((UART_Port == 0) || !port->enabled)
+		return 0;
+
+	written = UART_RingBufferWrite(&port->tx, data, length);
+
+	/*
+	 * THRE interrupt is disabled only when TX FIFO is empty and TX buffer don't contain
+	 * data. Then transmission is started here, THRE interrupt is generated when FIFO
+	 * will be empty. LSR isn't read because read clear error flags.
+	 */
+	if((written > 0) && ((UART_Port->IER & UART_IER_THRE) == 0))
+	{
+		UART_FillTransmitter(UART_Port, port);
+		UART_Port->IER |= UART_IER_THRE;
+	}
+
+	return written;
+}
+
+uint16_t UART_Read(uint8_t portNumber, uint8_t* buffer, uint16_t length)
+{
+	if((portNumber >= UART_RING_PORTS) || !RingPort[portNumber].enabled)
+		return 0;
+
+	return UART_RingBufferRead(&RingPort[portNumber].rx, buffer, length);
+}
+
+uint16_t UART_WriteSpace(uint8_t portNumber)
+{
+	if((portNumber >= UART_RING_PORTS) || !RingPort[portNumber].enabled)
+		return 0;
+
+	return UART_RingBufferSpace(&RingPort[portNumber].tx);
+}
+
+uint16_t UART_ReadCount(uint8_t portNumber)
+{
+	if((portNumber >= UART_RING_PORTS) || !RingPort[portNumber].enabled)
+		return 0;
+
+	return UART_RingBufferCount(&RingPort[portNumber].rx);
+}
+
+void UART_ReturnErrorCounters(uint8_t portNumber, UART_ErrorCounters* counters)
+{
+	UART_RingPort *port = &RingPort[portNumber];
+
+	if(portNumber >= UART_RING_PORTS)
+		return;
+
+	counters->overrun = port->overrun;
+	counters->framing = port->framing;
+	counters->parity = port->parity;
+	counters->rxDropped = port->rxDropped;
+}
+
+static void UART_RingInterruptService(uint8_t portNumber)
+{
+	LPC_USART_T *UART_Port = (LPC_USART_T*)UART_GetBaseAddress(portNumber);
+	UART_RingPort *port = &RingPort[portNumber];
+	UART_Status status;
+	uint8_t byte;
+
+	if(!port->enabled)
+	{
+		UART_Port->IER = 0;
+		return;
+	}
+
+	//LSR read clear error flags, so errors are counted after every read
+	for(;;)
+	{
+		status = UART_ReturnStatusRegister(portNumber);
+
+		if(status.OE == 1)
+			port->overrun++;
+
+		if(status.FE == 1)
+			port->framing++;
+
+		if(status.PE == 1)
+			port->parity++;
+
+		if(status.RDR == 0)
+			break;
+
+		byte = UART_Port->RBR;
+
+		if(!UART_RingBufferPut(&port->rx, byte))
+			port->rxDropped++;
+	}
+
+	//TX FIFO is filled when is empty, interrupt is disabled when there is nothing to send
+	if((status.THRE == 1) && ((UART_Port->IER & UART_IER_THRE) != 0))
+	{
+		if(UART_RingBufferCount(&port->tx) > 0)
+			UART_FillTransmitter(UART_Port, port);
+		else
+			UART_Port->IER &= ~UART_IER_THRE;
+	}
+}
+
+void UART_IRQHandler(void)
+{
+	UART_RingInterruptService(0);
+}
@@ -12,6 +12,7 @@ C_SRCS += \
 ../src/MCP2517FD_ExampleFor_LPC82X.c \
 ../src/SPI_Driver.c \
 ../src/UART_Driver.c \
+../src/UART_RingBuffer.c \
 ../src/cr_startup_lpc82x.c \
 ../src/crp.c \
 ../src/mtb.c \
@@ -23,6 +24,7 @@ OBJS += \
 ./src/MCP2517FD_ExampleFor_LPC82X.o \
 ./src/SPI_Driver.o \
 ./src/UART_Driver.o \
+./src/UART_RingBuffer.o \
 ./src/aeabi_romdiv_patch.o \
 ./src/cr_startup_lpc82x.o \
 ./src/crp.o \
@@ -35,6 +37,7 @@ C_DEPS += \
 ./src/MCP2517FD_ExampleFor_LPC82X.d \
 ./src/SPI_Driver.d \
 ./src/UART_Driver.d \
+./src/UART_RingBuffer.d \
 ./src/cr_startup_lpc82x.d \
 ./src/crp.d \
 ./src/mtb.d \
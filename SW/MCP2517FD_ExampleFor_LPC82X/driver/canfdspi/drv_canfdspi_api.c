@@ -2596,23 +2596,17 @@ int8_t DRV_CANFDSPI_CrcValueGet(CANFDSPI_MODULE_ID index, uint16_t* crc)
 
 int8_t DRV_CANFDSPI_RamInit(CANFDSPI_MODULE_ID index, uint8_t d)
 {
-    uint8_t txd[SPI_DEFAULT_BUFFER_LENGTH];
-    uint32_t k;
+    uint8_t txh[2];
     int8_t spiTransferError = 0;
 
-    // Prepare data
-    for (k = 0; k < SPI_DEFAULT_BUFFER_LENGTH; k++) {
-        txd[k] = d;
-    }
-
-    uint16_t a = cRAMADDR_START;
+    // Compose command; address increments automatically so whole RAM is
+    // written in one transfer and with ECC enabled every word gets parity
+    txh[0] = (uint8_t) ((cINSTRUCTION_WRITE << 4) + ((cRAMADDR_START >> 8) & 0xF));
+    txh[1] = (uint8_t) (cRAMADDR_START & 0xFF);
 
-    for (k = 0; k < (cRAM_SIZE / SPI_DEFAULT_BUFFER_LENGTH); k++) {
-        spiTransferError = DRV_CANFDSPI_WriteByteArray(index, a, txd, SPI_DEFAULT_BUFFER_LENGTH);
-        if (spiTransferError) {
-            return -1;
-        }
-        a += SPI_DEFAULT_BUFFER_LENGTH;
+    spiTransferError = DRV_SPI_TransferFill(index, txh, 2, d, cRAM_SIZE);
+    if (spiTransferError) {
+        return -1;
     }
 
     return spiTransferError;
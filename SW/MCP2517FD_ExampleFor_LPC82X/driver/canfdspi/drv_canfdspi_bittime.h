@@ -0,0 +1,186 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _DRV_CANFDSPI_BITTIME_H
+#define _DRV_CANFDSPI_BITTIME_H
+
+/*
+* Bit time solver for any nominal/data bit rate and SYSCLK.
+*
+* DRV_CANFDSPI_BitTimeConfigure support only fixed list of CAN_BITTIME_SETUP pairs
+* and 40/20/10MHz SYSCLK. Solver calculate BRP, TSEG1, TSEG2, SJW and transmitter
+* delay compensation for any bit rate and sample point using the same rules which
+* was used to prepare those tables:
+* - smallest bit rate error, when error is equal smallest BRP(most TQ per bit),
+* - sample point rounded to nearest TQ,
+* - SJW equal TSEG2,
+* - TDC in auto mode for data bit rate from 1Mbps with TDCO placed on sample point.
+*
+* Additionally solver check delay budget of physical layer. Loop delay is time
+* between CANTXD and CANRXD pin of MCP2517FD(transceiver and optoisolation). In
+* arbitration phase propagation segment must cover round trip between two nodes
+* 2 * (loop delay + bus delay). In data phase without TDC sample point must be
+* after loop delay and with TDC measured delay must fit into TDCV register. Solution
+* which don't fit into delay budget is returned with error and margins are negative.
+*
+* All calculations use only 32 bit integer arithmetic. SYSCLK must be multiply of
+* 100kHz to calculate delays correctly.
+*
+* Simple example code which configure 500kbps/5Mbps for board with optoisolation:
+*
+*	CAN_BITTIME_SOLVER_CONFIG config;
+*	CAN_BITTIME_SOLUTION solution;
+*
+*	DRV_CANFDSPI_BitTimeSolverConfigObjectReset(&config);
+*	config.nominalBitRate = 500000;
+*	config.dataBitRate = 5000000;
+*	config.loopDelay = CAN_BITTIME_LOOP_DELAY_OPTO;
+*
+*	if (DRV_CANFDSPI_BitTimeSolve(&config, &solution) == 0) {
+*		DRV_CANFDSPI_BitTimeConfigureSolution(DRV_CANFDSPI_INDEX_0, &solution);
+*	}
+*/
+
+#include "drv_canfdspi_api.h"
+#include "drv_canfdspi_register.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+//! Default sample point in per mille
+#define CAN_BITTIME_DEFAULT_SAMPLE_POINT 800
+
+//! Default bit rate tolerance in per mille, rates which SYSCLK can't divide closer are
+//! rejected(e.g. 3M at 40MHz from Microchip tables is 2.6% off)
+#define CAN_BITTIME_DEFAULT_TOLERANCE 5
+
+//! Worse case loop delay of board with optoisolation in ns: 2 x MAX22245 + MCP2562FD
+#define CAN_BITTIME_LOOP_DELAY_OPTO 243
+
+//! Worse case loop delay of board without optoisolation in ns: MCP2562FD
+#define CAN_BITTIME_LOOP_DELAY_NO_OPTO 180
+
+//! Lowest data bit rate for which solver enable TDC in CAN_SSP_MODE_AUTO
+#define CAN_BITTIME_TDC_MIN_BITRATE 1000000
+
+//! Maximal value of TDCV and TDCO field
+#define CAN_BITTIME_MAX_TDC 63
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+
+//! Bit time solver input
+
+typedef struct _CAN_BITTIME_SOLVER_CONFIG {
+    //! SYSCLK frequency in Hz
+    uint32_t sysClk;
+    //! Arbitration phase bit rate in bit/s
+    uint32_t nominalBitRate;
+    //! Data phase bit rate in bit/s, 0 keep reset value of CiDBTCFG
+    uint32_t dataBitRate;
+    //! Sample points in per mille
+    uint16_t nominalSamplePoint;
+    uint16_t dataSamplePoint;
+    //! CANTXD to CANRXD delay in ns
+    uint16_t loopDelay;
+    //! One way delay of bus cable in ns(about 5ns per meter)
+    uint16_t busDelay;
+    //! Accepted bit rate error in per mille
+    uint16_t bitRateTolerance;
+    //! TDC mode, CAN_SSP_MODE_AUTO select mode basing on data bit rate
+    CAN_SSP_MODE sspMode;
+} CAN_BITTIME_SOLVER_CONFIG;
+
+//! Bit time solver output
+
+typedef struct _CAN_BITTIME_SOLUTION {
+    //! Register values ready to write
+    REG_CiNBTCFG nbtcfg;
+    REG_CiDBTCFG dbtcfg;
+    REG_CiTDC tdc;
+    //! Real bit rates in bit/s
+    uint32_t nominalBitRate;
+    uint32_t dataBitRate;
+    //! Real minus requested bit rate in ppm, caller can reject solution stricter than
+    //! bitRateTolerance
+    int32_t nominalBitRateError;
+    int32_t dataBitRateError;
+    //! Real sample points in per mille
+    uint16_t nominalSamplePoint;
+    uint16_t dataSamplePoint;
+    //! Propagation segment minus arbitration round trip delay in ns
+    int32_t nominalDelayMargin;
+    //! Without TDC: sample point minus loop delay, with TDC: TDCV range minus loop delay in ns
+    int32_t dataDelayMargin;
+} CAN_BITTIME_SOLUTION;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Bit Time Solver
+
+// *****************************************************************************
+//! Reset solver configuration object
+
+void DRV_CANFDSPI_BitTimeSolverConfigObjectReset(CAN_BITTIME_SOLVER_CONFIG* config);
+
+// *****************************************************************************
+//! Calculate register values for configuration
+/*!
+ * Return: 0 - success, -1 - wrong configuration, -2 - nominal bit rate not possible,
+ * -3 - data bit rate not possible, -4 - arbitration delay budget exceeded,
+ * -5 - data phase delay budget exceeded. For -4 and -5 solution is filled.
+ */
+
+int8_t DRV_CANFDSPI_BitTimeSolve(const CAN_BITTIME_SOLVER_CONFIG* config,
+        CAN_BITTIME_SOLUTION* solution);
+
+// *****************************************************************************
+//! Write CiNBTCFG, CiDBTCFG and CiTDC in single SPI transfer
+
+int8_t DRV_CANFDSPI_BitTimeConfigureSolution(CANFDSPI_MODULE_ID index,
+        const CAN_BITTIME_SOLUTION* solution);
+
+// *****************************************************************************
+//! Solve and configure bit time, nothing is written when solver return error
+
+int8_t DRV_CANFDSPI_BitTimeConfigureCustom(CANFDSPI_MODULE_ID index,
+        const CAN_BITTIME_SOLVER_CONFIG* config);
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // _DRV_CANFDSPI_BITTIME_H
@@ -0,0 +1,302 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_canfdspi_frametime.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+
+//! Bit stream with dynamic bit stuffing
+
+typedef struct _CAN_FRAMETIME_STREAM {
+    uint16_t bits;
+    uint16_t stuffBits;
+    uint16_t crc;
+    uint8_t last;
+    uint8_t run;
+} CAN_FRAMETIME_STREAM;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+//! Payload size of CAN FD DLC 9 .. 15
+static const uint8_t canFrameTimeFdDataBytes[7] = {12, 16, 20, 24, 32, 48, 64};
+
+//! Nominal and data bit rate of CAN_BITTIME_SETUP values
+static const uint32_t canFrameTimeSetupBitRates[][2] = {
+    [CAN_500K_1M] = {500000, 1000000},
+    [CAN_500K_2M] = {500000, 2000000},
+    [CAN_500K_3M] = {500000, 3000000},
+    [CAN_500K_4M] = {500000, 4000000},
+    [CAN_500K_5M] = {500000, 5000000},
+    [CAN_500K_6M7] = {500000, 6666667},
+    [CAN_500K_8M] = {500000, 8000000},
+    [CAN_500K_10M] = {500000, 10000000},
+    [CAN_250K_500K] = {250000, 500000},
+    [CAN_250K_833K] = {250000, 833333},
+    [CAN_250K_1M] = {250000, 1000000},
+    [CAN_250K_1M5] = {250000, 1500000},
+    [CAN_250K_2M] = {250000, 2000000},
+    [CAN_250K_3M] = {250000, 3000000},
+    [CAN_250K_4M] = {250000, 4000000},
+    [CAN_1000K_4M] = {1000000, 4000000},
+    [CAN_1000K_8M] = {1000000, 8000000},
+    [CAN_125K_500K] = {125000, 500000}
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local functions
+
+//! Add n bits of value(MSB first), stuff bit is inserted before the next bit so bits
+//! before phase switch don't contain stuff bit which belong to next phase
+static void FrameTimeStreamAdd(CAN_FRAMETIME_STREAM* stream, uint32_t value, uint8_t n)
+{
+    uint8_t bit;
+
+    while (n--) {
+        if (stream->run == 5) {
+            stream->stuffBits++;
+            stream->last ^= 1;
+            stream->run = 1;
+        }
+
+        bit = (value >> n) & 1;
+        if (stream->run && (bit == stream->last)) {
+            stream->run++;
+        } else {
+            stream->last = bit;
+            stream->run = 1;
+        }
+        stream->bits++;
+
+        // CRC15 of classic frame, polynomial 0x4599
+        if ((bit ^ (stream->crc >> 14)) & 1) {
+            stream->crc = ((stream->crc << 1) ^ 0x4599) & 0x7FFF;
+        } else {
+            stream->crc = (stream->crc << 1) & 0x7FFF;
+        }
+    }
+}
+
+//! Stuff bit after the last bit of stuffed part of frame
+static void FrameTimeStreamFlush(CAN_FRAMETIME_STREAM* stream)
+{
+    if (stream->run == 5) {
+        stream->stuffBits++;
+        stream->run = 0;
+    }
+}
+
+//! Stuff count with parity, CRC17/CRC21 and fixed stuff bits
+static uint16_t FrameTimeFdCrcBits(uint8_t dataBytes)
+{
+    return 4 + ((dataBytes > 16) ? (21 + 7) : (17 + 6));
+}
+
+//! Convert bit rate to bit time in 1/16 ns with 32 bit arithmetic
+static uint32_t FrameTimeBitTime(uint32_t bitRate)
+{
+    return (1000000000u / bitRate) * 16 + ((1000000000u % bitRate) * 16) / bitRate;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Frame Timing
+
+uint8_t DRV_CANFDSPI_FrameDataBytes(bool fdf, CAN_DLC dlc)
+{
+    if (dlc <= CAN_DLC_8) {
+        return dlc;
+    }
+
+    return fdf ? canFrameTimeFdDataBytes[(dlc - CAN_DLC_12) & 0x7] : 8;
+}
+
+void DRV_CANFDSPI_FrameBits(const uint32_t* header, const uint8_t* data, CAN_FRAME_BITS* bits)
+{
+    CAN_FRAMETIME_STREAM stream = {0, 0, 0, 0, 0};
+    CAN_TX_MSGOBJ obj;
+    uint8_t dataBytes, i;
+
+    obj.word[0] = header[0];
+    obj.word[1] = header[1];
+
+    dataBytes = DRV_CANFDSPI_FrameDataBytes(obj.bF.ctrl.FDF, (CAN_DLC) obj.bF.ctrl.DLC);
+    if (!obj.bF.ctrl.FDF && obj.bF.ctrl.RTR) {
+        dataBytes = 0;
+    }
+
+    // SOF and base ID
+    FrameTimeStreamAdd(&stream, 0, 1);
+    FrameTimeStreamAdd(&stream, obj.bF.id.SID, 11);
+
+    if (obj.bF.ctrl.IDE) {
+        // SRR, IDE, extended ID
+        FrameTimeStreamAdd(&stream, 3, 2);
+        FrameTimeStreamAdd(&stream, obj.bF.id.EID, 18);
+    }
+
+    if (obj.bF.ctrl.FDF) {
+        // RRS and IDE of standard frame or RRS of extended frame, FDF, res, BRS
+        if (!obj.bF.ctrl.IDE) {
+            FrameTimeStreamAdd(&stream, 0, 1);
+        }
+        FrameTimeStreamAdd(&stream, 0x4 | obj.bF.ctrl.BRS, 4);
+        bits->nominalBits = stream.bits + stream.stuffBits;
+
+        // ESI, DLC, data
+        FrameTimeStreamAdd(&stream, obj.bF.ctrl.ESI, 1);
+        FrameTimeStreamAdd(&stream, obj.bF.ctrl.DLC, 4);
+        for (i = 0; i < dataBytes; i++) {
+            FrameTimeStreamAdd(&stream, data ? data[i] : 0, 8);
+        }
+        FrameTimeStreamFlush(&stream);
+
+        bits->dataBits = stream.bits + stream.stuffBits - bits->nominalBits +
+                FrameTimeFdCrcBits(dataBytes);
+
+        if (!obj.bF.ctrl.BRS) {
+            bits->nominalBits += bits->dataBits;
+            bits->dataBits = 0;
+        }
+    } else {
+        // RTR, IDE/r1, r0, DLC, data and CRC15
+        FrameTimeStreamAdd(&stream, obj.bF.ctrl.RTR << 2, 3);
+        FrameTimeStreamAdd(&stream, obj.bF.ctrl.DLC, 4);
+        for (i = 0; i < dataBytes; i++) {
+            FrameTimeStreamAdd(&stream, data ? data[i] : 0, 8);
+        }
+        FrameTimeStreamAdd(&stream, stream.crc, 15);
+        FrameTimeStreamFlush(&stream);
+
+        bits->nominalBits = stream.bits + stream.stuffBits;
+        bits->dataBits = 0;
+    }
+
+    bits->nominalBits += CAN_FRAMETIME_TAIL_BITS;
+    bits->stuffBits = stream.stuffBits;
+}
+
+void DRV_CANFDSPI_FrameBitsWorstCase(bool extended, bool fdf, bool brs, CAN_DLC dlc,
+        CAN_FRAME_BITS* bits)
+{
+    uint8_t dataBytes = DRV_CANFDSPI_FrameDataBytes(fdf, dlc);
+    uint16_t arbitration, stuffed, arbitrationStuff;
+
+    if (fdf) {
+        // SOF .. BRS, then ESI, DLC and data
+        arbitration = extended ? 36 : 17;
+        stuffed = arbitration + 5 + dataBytes * 8;
+
+        // Stuff bit before the last arbitration bit is counted as nominal, it can only
+        // make result longer
+        arbitrationStuff = (arbitration - 1) / 4;
+        bits->stuffBits = (stuffed - 1) / 4;
+
+        bits->nominalBits = arbitration + arbitrationStuff;
+        bits->dataBits = stuffed - arbitration + bits->stuffBits - arbitrationStuff +
+                FrameTimeFdCrcBits(dataBytes);
+
+        if (!brs) {
+            bits->nominalBits += bits->dataBits;
+            bits->dataBits = 0;
+        }
+    } else {
+        // SOF .. CRC15
+        stuffed = (extended ? 54 : 34) + dataBytes * 8;
+        bits->stuffBits = (stuffed - 1) / 4;
+        bits->nominalBits = stuffed + bits->stuffBits;
+        bits->dataBits = 0;
+    }
+
+    bits->nominalBits += CAN_FRAMETIME_TAIL_BITS;
+}
+
+void DRV_CANFDSPI_FrameTimeInitialize(CAN_FRAMETIME* frameTime, uint32_t nominalBitRate,
+        uint32_t dataBitRate)
+{
+    frameTime->nominalBitTime = FrameTimeBitTime(nominalBitRate);
+    frameTime->dataBitTime = FrameTimeBitTime(dataBitRate);
+}
+
+int8_t DRV_CANFDSPI_FrameTimeSetupBitRates(CAN_BITTIME_SETUP setup,
+        uint32_t* nominalBitRate, uint32_t* dataBitRate)
+{
+    if ((uint32_t) setup >= sizeof(canFrameTimeSetupBitRates) / sizeof(canFrameTimeSetupBitRates[0])) {
+        return -1;
+    }
+
+    *nominalBitRate = canFrameTimeSetupBitRates[setup][0];
+    *dataBitRate = canFrameTimeSetupBitRates[setup][1];
+
+    return 0;
+}
+
+int8_t DRV_CANFDSPI_FrameTimeInitializeSetup(CAN_FRAMETIME* frameTime, CAN_BITTIME_SETUP setup)
+{
+    uint32_t nominalBitRate, dataBitRate;
+
+    if (DRV_CANFDSPI_FrameTimeSetupBitRates(setup, &nominalBitRate, &dataBitRate)) {
+        return -1;
+    }
+
+    DRV_CANFDSPI_FrameTimeInitialize(frameTime, nominalBitRate, dataBitRate);
+
+    return 0;
+}
+
+uint32_t DRV_CANFDSPI_FrameTimeBits(const CAN_FRAMETIME* frameTime, const CAN_FRAME_BITS* bits)
+{
+    return ((uint32_t) bits->nominalBits * frameTime->nominalBitTime +
+            (uint32_t) bits->dataBits * frameTime->dataBitTime + 8) >> 4;
+}
+
+uint32_t DRV_CANFDSPI_FrameTime(const CAN_FRAMETIME* frameTime, const uint32_t* header,
+        const uint8_t* data)
+{
+    CAN_FRAME_BITS bits;
+
+    DRV_CANFDSPI_FrameBits(header, data, &bits);
+
+    return DRV_CANFDSPI_FrameTimeBits(frameTime, &bits);
+}
+
+uint32_t DRV_CANFDSPI_FrameTimeWorstCase(const CAN_FRAMETIME* frameTime, bool extended,
+        bool fdf, bool brs, CAN_DLC dlc)
+{
+    CAN_FRAME_BITS bits;
+
+    DRV_CANFDSPI_FrameBitsWorstCase(extended, fdf, brs, dlc, &bits);
+
+    return DRV_CANFDSPI_FrameTimeBits(frameTime, &bits);
+}
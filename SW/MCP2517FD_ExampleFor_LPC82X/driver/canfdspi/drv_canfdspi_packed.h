@@ -0,0 +1,200 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _DRV_CANFDSPI_PACKED_H
+#define _DRV_CANFDSPI_PACKED_H
+
+/*
+* Variable length packed frame ring.
+*
+* Frames are stored one after another as records: 12 bytes header(ID, control and
+* time stamp) followed by payload with length from DLC rounded up to word. Classic 8
+* byte frame take 20 bytes instead of 76 bytes of fixed slot, so in the same memory
+* ring hold several times more frames when bus carry short frames. Records are word
+* aligned because Cortex-M0 doesn't support unaligned access.
+*
+* Every record is contiguous in memory, so producer and consumer can use it in place
+* (zero copy). When record doesn't fit between write position and end of buffer wrap
+* marker(ID word 0xFFFFFFFF, not valid for any frame) is written and record is placed
+* at the beginning of buffer. Consumer skip marker in Peek. Buffer is never completely
+* filled, so equal indexes mean empty ring.
+*
+* Producer use Reserve/Publish(or Receive which read frame from RX FIFO directly into
+* ring) and consumer use Peek/Commit. Producer write only head and consumer only tail,
+* so they can work in interrupt and main loop without disabling interrupts(the same
+* rules as drv_canfdspi_rxring.h).
+*
+* Simple example code of streamer which send records via UART:
+*
+*	static uint32_t packedMemory[512 / 4];
+*
+*	DRV_CANFDSPI_PackedRingInitialize(&packedRing, packedMemory, sizeof(packedMemory));
+*
+*	// In interrupt
+*	DRV_CANFDSPI_PackedRingReceive(&packedRing, DRV_CANFDSPI_INDEX_0, CAN_FIFO_CH1, true);
+*
+*	// In main loop
+*	while ((record = DRV_CANFDSPI_PackedRingPeek(&packedRing)) != NULL) {
+*		UartSend((uint8_t*) record, DRV_CANFDSPI_PackedRecordBytes(record));
+*		DRV_CANFDSPI_PackedRingCommit(&packedRing);
+*	}
+*/
+
+#include "drv_canfdspi_api.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+//! Header of every record: ID, control and time stamp
+#define CAN_PACKED_HEADER_BYTES 12
+
+//! Minimal size of ring. Empty ring keep indexes where they are, so the biggest record
+//! must fit before end of buffer or before tail at any offset.
+#define CAN_PACKED_MIN_BYTES (2 * (CAN_PACKED_HEADER_BYTES + MAX_DATA_BYTES) + 4)
+
+//! ID word of wrap marker
+#define CAN_PACKED_WRAP_MARKER 0xFFFFFFFF
+
+//! Payload of record
+#define CAN_PACKED_DATA(record) ((uint8_t*) &(record)->word[3])
+
+//! Memory barrier between record and index access
+#ifndef CAN_PACKED_BARRIER
+#define CAN_PACKED_BARRIER() __sync_synchronize()
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+
+//! Record header, payload follow it
+
+typedef union _CAN_PACKED_RECORD {
+    CAN_TX_MSGOBJ tx;
+    CAN_RX_MSGOBJ rx;
+    uint32_t word[3];
+} CAN_PACKED_RECORD;
+
+//! Ring object
+
+typedef struct _CAN_PACKED_RING {
+    uint8_t* buffer;
+    uint16_t size;
+    //! Byte offsets, head is written only by producer and tail by consumer
+    volatile uint16_t head;
+    volatile uint16_t tail;
+    //! Position and size of record reserved by producer
+    uint16_t reservedOffset;
+    uint16_t reservedBytes;
+    //! Statistics
+    uint32_t frames;
+    volatile uint32_t overruns;
+    uint16_t highWatermark;
+} CAN_PACKED_RING;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Packed Ring
+
+// *****************************************************************************
+//! Initialize ring in memory of size bytes(multiply of 4)
+/*!
+ * size must be at least CAN_PACKED_MIN_BYTES and at most 32KB.
+ *
+ * Return: 0 - success, -1 - buffer not word aligned or size too small or too big.
+ */
+
+int8_t DRV_CANFDSPI_PackedRingInitialize(CAN_PACKED_RING* ring, uint32_t* buffer, uint16_t size);
+
+// *****************************************************************************
+//! Size of record in bytes from its header
+
+uint16_t DRV_CANFDSPI_PackedRecordBytes(const CAN_PACKED_RECORD* record);
+
+// *****************************************************************************
+//! Producer: reserve contiguous record for payload size
+/*!
+ * Header and payload must be written before DRV_CANFDSPI_PackedRingPublish.
+ * Return NULL when ring is full(overrun isn't counted).
+ */
+
+CAN_PACKED_RECORD* DRV_CANFDSPI_PackedRingReserve(CAN_PACKED_RING* ring, uint8_t dataBytes);
+
+// *****************************************************************************
+//! Producer: make reserved record visible for consumer
+
+void DRV_CANFDSPI_PackedRingPublish(CAN_PACKED_RING* ring);
+
+// *****************************************************************************
+//! Producer: copy frame into ring
+/*!
+ * Return: 0 - frame stored, 1 - ring full and frame dropped.
+ */
+
+int8_t DRV_CANFDSPI_PackedRingPut(CAN_PACKED_RING* ring, const CAN_RX_MSGOBJ* header,
+        const uint8_t* data);
+
+// *****************************************************************************
+//! Producer: move one frame from RX FIFO to ring
+/*!
+ * timeStamp must be equal RxTimeStampEnable of FIFO, without it time stamp of frame is
+ * 0. When ring is full frame is removed from FIFO and counted in overruns.
+ *
+ * Return: 0 - frame stored, 1 - frame dropped, -1 - SPI error.
+ */
+
+int8_t DRV_CANFDSPI_PackedRingReceive(CAN_PACKED_RING* ring, CANFDSPI_MODULE_ID index,
+        CAN_FIFO_CHANNEL channel, bool timeStamp);
+
+// *****************************************************************************
+//! Consumer: the oldest record or NULL when ring is empty
+
+CAN_PACKED_RECORD* DRV_CANFDSPI_PackedRingPeek(CAN_PACKED_RING* ring);
+
+// *****************************************************************************
+//! Consumer: free record returned by Peek
+
+void DRV_CANFDSPI_PackedRingCommit(CAN_PACKED_RING* ring);
+
+// *****************************************************************************
+//! Number of used bytes including wrap marker
+
+uint16_t DRV_CANFDSPI_PackedRingUsedBytes(const CAN_PACKED_RING* ring);
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // _DRV_CANFDSPI_PACKED_H
@@ -0,0 +1,155 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _DRV_CANFDSPI_RECOVERY_H
+#define _DRV_CANFDSPI_RECOVERY_H
+
+/*
+* Error state monitor and bus off recovery.
+*
+* MCP2517FD report change of error state(EWARN, RXWARN, TXWARN, RXBP, TXBP, TXBO bits of
+* CiTREC) by CAN_BUS_ERROR_EVENT. DRV_CANFDSPI_RecoveryService read only CiINT while
+* node is error active and event isn't set, so it can be called often(e.g. from timer
+* interrupt or after INT pin assertion). CiTREC is read when event is set and every
+* time while node isn't error active.
+*
+* In bus off state controller wait for 128 occurrences of 11 consecutive recessive bits
+* and then return to error active state by itself. Driver never shorten this sequence
+* by configuration mode, because it would clear error counters before time required by
+* ISO 11898-1. When TXBO bit is cleared driver:
+* - request operation mode given during initialization when controller isn't in it,
+* - set TXREQ of TX FIFOs from txChannels which contain frames but don't have TXREQ
+*   set(transmission aborted during bus off), so queued frames are sent immediately.
+*
+* Time when node was offline(from detection of bus off until TX FIFOs are primed) is
+* measured by time base counter CiTBC, so time stamp counter must be enabled(CiTSCON).
+* Time is in CiTBC ticks(prescaler set by CiTSCON). The shortest possible bus off time
+* is CAN_RECOVERY_BUS_OFF_BITS nominal bit times, difference is polling latency.
+*
+* Simple example code:
+*
+*	CAN_RECOVERY recovery;
+*
+*	DRV_CANFDSPI_RecoveryInitialize(&recovery, DRV_CANFDSPI_INDEX_0, CAN_NORMAL_MODE,
+*		1 << CAN_FIFO_CH2);
+*	DRV_CANFDSPI_ModuleEventEnable(DRV_CANFDSPI_INDEX_0, CAN_BUS_ERROR_EVENT);
+*
+*	// Timer interrupt
+*	DRV_CANFDSPI_RecoveryService(&recovery);
+*/
+
+#include "drv_canfdspi_api.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+//! Bus off recovery sequence: 128 occurrences of 11 consecutive recessive bits
+#define CAN_RECOVERY_BUS_OFF_BITS (128 * 11)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+
+//! Error state of node
+
+typedef enum {
+    CAN_RECOVERY_ERROR_ACTIVE = 0,
+    //! TEC or REC reached 96
+    CAN_RECOVERY_ERROR_WARNING,
+    //! TEC or REC reached 128
+    CAN_RECOVERY_ERROR_PASSIVE,
+    //! TEC exceeded 255, controller wait for recovery sequence
+    CAN_RECOVERY_BUS_OFF,
+    //! Recovery sequence finished, waiting for operation mode
+    CAN_RECOVERY_RESTART
+} CAN_RECOVERY_STATE;
+
+//! Error monitor and recovery statistics
+
+typedef struct _CAN_RECOVERY {
+    CANFDSPI_MODULE_ID index;
+    //! Operation mode restored after bus off(CAN_NORMAL_MODE or CAN_CLASSIC_MODE)
+    CAN_OPERATION_MODE mode;
+    //! Bit n set when FIFO n(bit 0 - TXQ) is TX FIFO primed after bus off
+    uint32_t txChannels;
+    CAN_RECOVERY_STATE state;
+    //! Last read CiTREC content
+    uint8_t tec;
+    uint8_t rec;
+    CAN_ERROR_STATE flags;
+    //! Bus diagnostic registers read when bus off was detected
+    CAN_BUS_DIAGNOSTIC busOffDiagnostic;
+    //! CiTBC when bus off was detected
+    uint32_t busOffTime;
+    //! Number of bus off and error passive events
+    uint32_t busOffCount;
+    uint32_t errorPassiveCount;
+    //! Offline time of the last bus off, the longest one and sum of all(CiTBC ticks)
+    uint32_t lastOfflineTime;
+    uint32_t maxOfflineTime;
+    uint32_t totalOfflineTime;
+} CAN_RECOVERY;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Bus Off Recovery
+
+// *****************************************************************************
+//! Reset recovery object, node is assumed error active
+
+void DRV_CANFDSPI_RecoveryInitialize(CAN_RECOVERY* recovery, CANFDSPI_MODULE_ID index,
+        CAN_OPERATION_MODE mode, uint32_t txChannels);
+
+// *****************************************************************************
+//! Check error state and recover node after bus off
+/*!
+ * Return: current state(CAN_RECOVERY_STATE), -1 - SPI error.
+ */
+
+int8_t DRV_CANFDSPI_RecoveryService(CAN_RECOVERY* recovery);
+
+// *****************************************************************************
+//! true when node can transmit frames(error active, warning or passive)
+
+static inline bool DRV_CANFDSPI_RecoveryOnline(const CAN_RECOVERY* recovery)
+{
+    return recovery->state < CAN_RECOVERY_BUS_OFF;
+}
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // _DRV_CANFDSPI_RECOVERY_H
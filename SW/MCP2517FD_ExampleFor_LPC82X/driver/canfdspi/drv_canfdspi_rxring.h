@@ -0,0 +1,182 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _DRV_CANFDSPI_RXRING_H
+#define _DRV_CANFDSPI_RXRING_H
+
+/*
+* Wait-free single producer/single consumer ring of received frames.
+*
+* Received frames are read in interrupt(producer) and processed in main loop
+* (consumer). Ring is generated for RX codec(drv_canfdspi_codec.h) so every entry is
+* whole message object: ID, control field with filter hit, time stamp and payload.
+* Depth is set during compilation and must be power of two not bigger than 128, so
+* ring memory is known at link time and can be checked against RAM of small MCU.
+*
+* Producer write only head index and consumer write only tail index. Both indexes are
+* single bytes, so they are read and written by single instruction and interrupts
+* don't have to be disabled. Entry is filled before head is moved and released before
+* tail is moved(CAN_RX_RING_BARRIER between them).
+*
+* Frame is read from RX FIFO directly into free entry. When ring is full frame is
+* removed from RX FIFO by UINC without reading payload(single SPI transaction) and
+* overrun counter is incremented, so RX FIFO doesn't overflow and loss is visible.
+*
+* Generated symbols:
+* name##_RX_RING - ring type,
+* name##_Initialize() - clear ring, must be called before interrupt is enabled,
+* name##_ReceiveToRing() - producer: move one frame from RX FIFO to ring, return 0 -
+*   frame stored, 1 - ring full and frame dropped, -1 - SPI error,
+* name##_Peek() - consumer: the oldest frame or NULL when ring is empty,
+* name##_Release() - consumer: free frame returned by Peek,
+* name##_Count() - number of frames in ring.
+*
+* Simple example code:
+*
+*	DRV_CANFDSPI_DEFINE_RX_CODEC(Fd64, CAN_PLSIZE_64, 1)
+*	DRV_CANFDSPI_DEFINE_RX_RING(Fd64Ring, Fd64, 8)
+*
+*	Fd64Ring_RX_RING ring;
+*
+*	// In interrupt
+*	Fd64Ring_ReceiveToRing(&ring, DRV_CANFDSPI_INDEX_0, CAN_FIFO_CH1);
+*
+*	// In main loop
+*	while ((frame = Fd64Ring_Peek(&ring)) != NULL) {
+*		process(frame->header.bF.ctrl.FilterHit, frame->header.bF.timeStamp, frame->data.byte);
+*		Fd64Ring_Release(&ring);
+*	}
+*/
+
+#include "drv_canfdspi_api.h"
+#include "drv_canfdspi_codec.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+//! Memory barrier between entry and index access. Cortex-M0 execute memory accesses in
+//! order so only compiler must not reorder them, full barrier make ring safe also on
+//! host with many cores.
+#ifndef CAN_RX_RING_BARRIER
+#define CAN_RX_RING_BARRIER() __sync_synchronize()
+#endif
+
+//! Compile time check that depth is power of two in range 1 .. 128
+#define CAN_RX_RING_CHECK(name, depth) \
+    typedef char name##_RxRingDepthPowerOfTwo[(((depth) > 0) && ((depth) <= 128) && \
+        (((depth) & ((depth) - 1)) == 0)) ? 1 : -1]
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Code generators
+
+//! Generate ring of depth frames for RX codec
+#define DRV_CANFDSPI_DEFINE_RX_RING(name, codec, depth) \
+    CAN_RX_RING_CHECK(name, depth); \
+    \
+    typedef struct { \
+        volatile uint8_t head; \
+        volatile uint8_t tail; \
+        volatile uint8_t highWatermark; \
+        volatile uint32_t overruns; \
+        codec##_RX_FRAME entry[depth]; \
+    } name##_RX_RING; \
+    \
+    static inline void name##_Initialize(name##_RX_RING* ring) \
+    { \
+        ring->head = 0; \
+        ring->tail = 0; \
+        ring->highWatermark = 0; \
+        ring->overruns = 0; \
+    } \
+    \
+    static inline uint8_t name##_Count(const name##_RX_RING* ring) \
+    { \
+        return (uint8_t) (ring->head - ring->tail); \
+    } \
+    \
+    static inline int8_t name##_ReceiveToRing(name##_RX_RING* ring, \
+            CANFDSPI_MODULE_ID index, CAN_FIFO_CHANNEL channel) \
+    { \
+        uint8_t head = ring->head; \
+        uint8_t count = (uint8_t) (head - ring->tail); \
+        \
+        if (count >= (depth)) { \
+            ring->overruns++; \
+            if (DRV_CANFDSPI_ReceiveChannelUpdate(index, channel)) { \
+                return -1; \
+            } \
+            return 1; \
+        } \
+        \
+        if (codec##_ReceiveMessageGet(index, channel, &ring->entry[head & ((depth) - 1)])) { \
+            return -1; \
+        } \
+        \
+        CAN_RX_RING_BARRIER(); \
+        ring->head = head + 1; \
+        \
+        if ((count + 1) > ring->highWatermark) { \
+            ring->highWatermark = count + 1; \
+        } \
+        \
+        return 0; \
+    } \
+    \
+    static inline codec##_RX_FRAME* name##_Peek(name##_RX_RING* ring) \
+    { \
+        uint8_t tail = ring->tail; \
+        \
+        if (tail == ring->head) { \
+            return NULL; \
+        } \
+        \
+        CAN_RX_RING_BARRIER(); \
+        return &ring->entry[tail & ((depth) - 1)]; \
+    } \
+    \
+    static inline void name##_Release(name##_RX_RING* ring) \
+    { \
+        uint8_t tail = ring->tail; \
+        \
+        CAN_RX_RING_BARRIER(); \
+        ring->tail = tail + 1; \
+    }
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // _DRV_CANFDSPI_RXRING_H
@@ -0,0 +1,217 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _DRV_CANFDSPI_TDC_H
+#define _DRV_CANFDSPI_TDC_H
+
+/*
+* Transmitter delay compensation calibration.
+*
+* On board with optoisolation loop delay between CANTXD and CANRXD(two MAX22245 and
+* MCP2562FD) is main limit of data phase bit rate. Value from datasheets is only worse
+* case, real delay depend on used chips, temperature and cable. During calibration
+* MCP2517FD work in loopback mode with TDC in auto mode and after every CAN FD frame
+* with BRS measured delay is read from TDCV field of CiTDC register. External loopback
+* mode include transceiver and optoisolation in measurement, internal loopback can be
+* used only to check that calibration procedure work.
+*
+* Calibration is performed for list of data bit rates sorted from the lowest. For every
+* bit rate bit time is calculated by solver from drv_canfdspi_bittime.h, frames are
+* transmitted and transmit error counter is checked. Calibration stop on first bit rate
+* with errors or when SSP can't be placed safely. From TDCV spread(jitter) is derived:
+* - TDCO: sample point of solver moved so SSP has at least jitter + 1 SYSCLK distance
+*   from both edges of received bit,
+* - data sample point: phase segment 2 must be longer than jitter.
+*
+* Result is stored in CAN_TDC_PROFILE protected by magic number and CRC16. Profile can
+* be saved in nonvolatile memory and applied at init by DRV_CANFDSPI_TdcProfileApply
+* which configure the highest data bit rate which pass calibration.
+*
+* TX FIFO used during calibration must be configured with payload size which fit
+* frame DLC. Frames received in loopback mode are stored in RX FIFO if any filter
+* match so RX FIFO should be reset or chip reinitialized after calibration.
+*
+* Simple example code:
+*
+*	const uint32_t bitRates[] = {1000000, 2000000, 4000000, 5000000, 8000000};
+*
+*	DRV_CANFDSPI_TdcCalibrationConfigObjectReset(&calibrationConfig);
+*	calibrationConfig.txChannel = CAN_FIFO_CH2;
+*
+*	DRV_CANFDSPI_BitTimeSolverConfigObjectReset(&bitTimeConfig);
+*	bitTimeConfig.loopDelay = CAN_BITTIME_LOOP_DELAY_OPTO;
+*
+*	DRV_CANFDSPI_TdcCalibrate(DRV_CANFDSPI_INDEX_0, &calibrationConfig, &bitTimeConfig,
+*		bitRates, 5, &profile);
+*
+*	// After reset
+*	if (DRV_CANFDSPI_TdcProfileApply(DRV_CANFDSPI_INDEX_0, &profile, &bitTimeConfig) != 0) {
+*		DRV_CANFDSPI_BitTimeConfigureCustom(DRV_CANFDSPI_INDEX_0, &bitTimeConfig);
+*	}
+*/
+
+#include "drv_canfdspi_api.h"
+#include "drv_canfdspi_bittime.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+//! Magic number of valid profile("TDCP")
+#define CAN_TDC_PROFILE_MAGIC 0x50434454
+
+//! Default number of frames transmitted for every bit rate
+#define CAN_TDC_CALIBRATION_FRAMES 100
+
+//! Default number of TX FIFO status reads before frame is aborted
+#define CAN_TDC_CALIBRATION_TIMEOUT 1000
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+
+//! TDC calibration configuration
+
+typedef struct _CAN_TDC_CALIBRATION_CONFIG {
+    //! TX FIFO used to transmit calibration frames
+    CAN_FIFO_CHANNEL txChannel;
+    //! CAN_EXTERNAL_LOOPBACK_MODE or CAN_INTERNAL_LOOPBACK_MODE
+    CAN_OPERATION_MODE mode;
+    //! Standard ID and DLC of calibration frames
+    uint16_t id;
+    CAN_DLC dlc;
+    //! Number of frames for every bit rate
+    uint16_t nFrames;
+    //! Number of TX FIFO status reads before frame is aborted
+    uint16_t timeout;
+} CAN_TDC_CALIBRATION_CONFIG;
+
+//! TDCV statistics for single bit rate, values in SYSCLK periods
+
+typedef struct _CAN_TDC_STATISTICS {
+    uint8_t tdcvMin;
+    uint8_t tdcvMax;
+    uint16_t nFrames;
+    uint32_t tdcvSum;
+    //! Frames not transmitted in time or which increment TEC
+    uint16_t nErrors;
+} CAN_TDC_STATISTICS;
+
+//! Calibration result
+
+typedef struct _CAN_TDC_PROFILE {
+    uint32_t magic;
+    //! SYSCLK and nominal bit rate used during calibration
+    uint32_t sysClk;
+    uint32_t nominalBitRate;
+    //! The highest data bit rate which pass calibration
+    uint32_t dataBitRate;
+    //! Measured TDCV for dataBitRate
+    uint8_t tdcvMin;
+    uint8_t tdcvMax;
+    uint8_t tdcvMean;
+    //! Derived TDCO for dataBitRate
+    uint8_t tdcOffset;
+    //! Derived data sample point in per mille
+    uint16_t dataSamplePoint;
+    //! CRC16 of all previous fields
+    uint16_t crc;
+} CAN_TDC_PROFILE;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: TDC Calibration
+
+// *****************************************************************************
+//! Reset calibration configuration object
+
+void DRV_CANFDSPI_TdcCalibrationConfigObjectReset(CAN_TDC_CALIBRATION_CONFIG* config);
+
+// *****************************************************************************
+//! Transmit calibration frames with current bit time and collect TDCV statistics
+/*!
+ * Chip must be in loopback mode and TX FIFO must be empty.
+ */
+
+int8_t DRV_CANFDSPI_TdcMeasure(CANFDSPI_MODULE_ID index,
+        const CAN_TDC_CALIBRATION_CONFIG* config, CAN_TDC_STATISTICS* stats);
+
+// *****************************************************************************
+//! Derive TDCO and data sample point from statistics and fill profile
+/*!
+ * Return: 0 - success, -1 - no frames or errors during measurement, -2 - TDCV
+ * saturated, -3 - jitter too big for data bit time.
+ */
+
+int8_t DRV_CANFDSPI_TdcProfileDerive(const CAN_BITTIME_SOLVER_CONFIG* bitTimeConfig,
+        const CAN_BITTIME_SOLUTION* solution, const CAN_TDC_STATISTICS* stats,
+        CAN_TDC_PROFILE* profile);
+
+// *****************************************************************************
+//! Calibrate data bit rates from list sorted from the lowest
+/*!
+ * Profile is filled for the highest bit rate which pass calibration. Chip is
+ * left in configuration mode.
+ *
+ * Return: 0 - at least one bit rate pass, -1 - the lowest bit rate fail,
+ * -2 - SPI or mode change error.
+ */
+
+int8_t DRV_CANFDSPI_TdcCalibrate(CANFDSPI_MODULE_ID index,
+        const CAN_TDC_CALIBRATION_CONFIG* config,
+        const CAN_BITTIME_SOLVER_CONFIG* bitTimeConfig,
+        const uint32_t* dataBitRates, uint8_t nBitRates, CAN_TDC_PROFILE* profile);
+
+// *****************************************************************************
+//! Check magic number and CRC of profile
+
+bool DRV_CANFDSPI_TdcProfileIsValid(const CAN_TDC_PROFILE* profile);
+
+// *****************************************************************************
+//! Configure bit time with data bit rate, sample point and TDCO from profile
+/*!
+ * Profile is used only when it is valid and SYSCLK and nominal bit rate are the same
+ * as in bitTimeConfig. Chip must be in configuration mode.
+ *
+ * Return: 0 - success, -1 - profile not valid, -2 - solver or SPI error.
+ */
+
+int8_t DRV_CANFDSPI_TdcProfileApply(CANFDSPI_MODULE_ID index,
+        const CAN_TDC_PROFILE* profile, const CAN_BITTIME_SOLVER_CONFIG* bitTimeConfig);
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // _DRV_CANFDSPI_TDC_H
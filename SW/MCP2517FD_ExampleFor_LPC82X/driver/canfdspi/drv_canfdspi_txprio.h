@@ -0,0 +1,173 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _DRV_CANFDSPI_TXPRIO_H
+#define _DRV_CANFDSPI_TXPRIO_H
+
+/*
+* Transmit priority engine.
+*
+* When all frames are transmitted via single TX FIFO urgent frame wait until all bulk
+* frames loaded before it are transmitted. MCP2517FD select frame for transmission
+* from all TX FIFOs with pending request by TXPRI field, so urgent frames can overtake
+* bulk traffic when they are loaded to separate FIFO with higher priority. Engine
+* configure one TX FIFO for every priority class(channels firstChannel .. firstChannel
+* + nClasses - 1) and route every submitted frame to FIFO of its class.
+*
+* Engine doesn't read FIFO registers before every frame like TransmitChannelLoad:
+* - CiFIFOCON, CiFIFOSTA and CiFIFOUA of all classes are read by one burst read
+*   (DRV_CANFDSPI_TxPrioStatusUpdate),
+* - fill level is calculated from FIFO index(head) and number of frames loaded by
+*   engine(tail), RAM address of next object is calculated from it,
+* - status is read again only when cached level say that FIFO is full, so frame is
+*   loaded by two SPI transactions(object write and UINC/TXREQ).
+* Engine must be the only user of its FIFOs, otherwise tail index is wrong.
+*
+* Simple example code with urgent and bulk class:
+*
+*	CAN_TXPRIO_CLASS_CONFIG classes[2];
+*
+*	DRV_CANFDSPI_TxPrioClassConfigObjectReset(&classes[0]);
+*	classes[0].txPriority = 31;
+*	classes[0].fifoSize = 3;
+*	classes[0].payLoadSize = CAN_PLSIZE_8;
+*	DRV_CANFDSPI_TxPrioClassConfigObjectReset(&classes[1]);
+*	classes[1].txPriority = 1;
+*	classes[1].fifoSize = 15;
+*
+*	// In configuration mode
+*	DRV_CANFDSPI_TxPrioConfigure(&engine, DRV_CANFDSPI_INDEX_0, CAN_FIFO_CH2, classes, 2);
+*
+*	// In normal mode, -1 means that FIFO of class is full
+*	DRV_CANFDSPI_TxPrioSubmit(&engine, 0, &txObj, txd, 8);
+*/
+
+#include "drv_canfdspi_api.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+//! Maximal number of classes, registers of all classes must fit into SPI buffer
+#define CAN_TXPRIO_MAX_CLASSES 7
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+
+//! Priority class configuration
+
+typedef struct _CAN_TXPRIO_CLASS_CONFIG {
+    //! TXPRI of FIFO, FIFO with higher value is transmitted first
+    uint8_t txPriority;
+    //! FIFO depth - 1
+    uint8_t fifoSize;
+    CAN_FIFO_PLSIZE payLoadSize;
+    //! CAN_TX_FIFO_CONFIG TxAttempts
+    uint8_t txAttempts;
+} CAN_TXPRIO_CLASS_CONFIG;
+
+//! State of priority class
+
+typedef struct _CAN_TXPRIO_CLASS {
+    uint8_t depth;
+    uint8_t objBytes;
+    //! Index of next object written by engine
+    uint8_t tail;
+    //! Frames in FIFO from last status read plus frames loaded after it
+    uint8_t level;
+    //! RAM address of first object, calculated from CiFIFOUA
+    uint16_t ramBase;
+    bool ramBaseValid;
+    //! Statistics
+    uint32_t submitted;
+    uint32_t rejected;
+} CAN_TXPRIO_CLASS;
+
+//! Engine object
+
+typedef struct _CAN_TXPRIO_ENGINE {
+    CANFDSPI_MODULE_ID index;
+    CAN_FIFO_CHANNEL firstChannel;
+    uint8_t nClasses;
+    CAN_TXPRIO_CLASS classes[CAN_TXPRIO_MAX_CLASSES];
+    //! Number of burst status reads
+    uint32_t statusReads;
+} CAN_TXPRIO_ENGINE;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Transmit Priority Engine
+
+// *****************************************************************************
+//! Reset class configuration object(priority 0, 8 objects, 64 bytes, unlimited attempts)
+
+void DRV_CANFDSPI_TxPrioClassConfigObjectReset(CAN_TXPRIO_CLASS_CONFIG* config);
+
+// *****************************************************************************
+//! Configure TX FIFO for every class
+/*!
+ * Chip must be in configuration mode.
+ *
+ * Return: 0 - success, -1 - wrong number of classes or channels, -2 - SPI error.
+ */
+
+int8_t DRV_CANFDSPI_TxPrioConfigure(CAN_TXPRIO_ENGINE* engine, CANFDSPI_MODULE_ID index,
+        CAN_FIFO_CHANNEL firstChannel, const CAN_TXPRIO_CLASS_CONFIG* classes, uint8_t nClasses);
+
+// *****************************************************************************
+//! Read FIFO registers of all classes by one burst read and update fill levels
+
+int8_t DRV_CANFDSPI_TxPrioStatusUpdate(CAN_TXPRIO_ENGINE* engine);
+
+// *****************************************************************************
+//! Load frame to FIFO of class and request transmission
+/*!
+ * Return: 0 - success, -1 - FIFO full, -2 - wrong class or data don't fit into DLC
+ * or payload size, -3 - SPI error.
+ */
+
+int8_t DRV_CANFDSPI_TxPrioSubmit(CAN_TXPRIO_ENGINE* engine, uint8_t classIndex,
+        CAN_TX_MSGOBJ* txObj, uint8_t* txd, uint8_t txdNumBytes);
+
+// *****************************************************************************
+//! Fill level of class from last status read(can be higher than real level)
+
+uint8_t DRV_CANFDSPI_TxPrioFillLevel(const CAN_TXPRIO_ENGINE* engine, uint8_t classIndex);
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // _DRV_CANFDSPI_TXPRIO_H
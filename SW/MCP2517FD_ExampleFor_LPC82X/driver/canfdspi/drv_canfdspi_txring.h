@@ -0,0 +1,202 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _DRV_CANFDSPI_TXRING_H
+#define _DRV_CANFDSPI_TXRING_H
+
+/*
+* Software TX ring in MCU RAM placed before hardware TX FIFO.
+*
+* When TX FIFO is full application doesn't poll FIFO status. Frame is stored in ring by
+* DRV_CANFDSPI_TxRingSubmit which never access SPI and return immediately. Frames are
+* moved to TX FIFO by DRV_CANFDSPI_TxRingService which should be called after submit
+* and when TX FIFO not full event occur(INT pin or periodic poll). Service read
+* CiFIFOCON, CiFIFOSTA and CiFIFOUA by one read, so every moved frame cost three SPI
+* transactions(status read, object write, UINC/TXREQ) and status is read only once when
+* FIFO is full. While frames wait in ring TX FIFO not full interrupt is enabled, it is
+* disabled again when ring is empty so INT pin isn't active all the time.
+*
+* Behaviour when ring is full is selected by policy:
+* - CAN_TXRING_BACKPRESSURE - frame isn't stored and submit return -1, caller keep
+*   frame and try again later(or reduce data rate),
+* - CAN_TXRING_DROP_NEWEST - submitted frame is dropped and counted, submit return -2,
+* - CAN_TXRING_DROP_OLDEST - the oldest frame from ring is dropped and counted,
+*   submitted frame is stored and submit return 1.
+*
+* Frames can be stored in fixed entries(storage for depth frames with the biggest
+* payload) or in blocks from slab allocator(drv_canfdspi_slab.h) when ring is
+* initialized by DRV_CANFDSPI_TxRingInitializeSlab. In slab mode ring keep only block
+* pointers, block is allocated in submit for DLC of frame and freed in service after
+* frame is written to TX FIFO. When slab has no free block submit behave like when ring
+* is full.
+*
+* Submit and service can be called from different contexts(e.g. main loop and
+* interrupt), tail is written only by submit and head only by service(entry is
+* published and released behind CAN_SLAB_BARRIER). DROP_OLDEST move head also in
+* submit, this is done with interrupts disabled(CAN_SLAB_LOCK), so with this policy
+* service must be called from the same context as submit or from interrupt which can
+* preempt it, never from lower priority than submit.
+*
+* Simple example code:
+*
+*	static uint32_t txRingStorage[CAN_TXRING_STORAGE_WORDS(16, 64)];
+*
+*	DRV_CANFDSPI_TxRingInitialize(&txRing, DRV_CANFDSPI_INDEX_0, CAN_FIFO_CH2,
+*		CAN_TXRING_BACKPRESSURE, txRingStorage, 16, 64);
+*
+*	if (DRV_CANFDSPI_TxRingSubmit(&txRing, &txObj, txd, 64) == -1) {
+*		// Bus is congested, try again later
+*	}
+*	DRV_CANFDSPI_TxRingService(&txRing);
+*
+*	// In INT pin handler
+*	DRV_CANFDSPI_TxRingService(&txRing);
+*/
+
+#include "drv_canfdspi_api.h"
+#include "drv_canfdspi_slab.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+//! Size of ring entry in words: header and payload rounded up to word
+#define CAN_TXRING_ENTRY_WORDS(dataBytes) (2 + (((dataBytes) + 3) / 4))
+
+//! Size of ring storage in words
+#define CAN_TXRING_STORAGE_WORDS(depth, dataBytes) ((depth) * CAN_TXRING_ENTRY_WORDS(dataBytes))
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+
+//! Behaviour when ring is full
+
+typedef enum {
+    CAN_TXRING_BACKPRESSURE,
+    CAN_TXRING_DROP_NEWEST,
+    CAN_TXRING_DROP_OLDEST
+} CAN_TXRING_POLICY;
+
+//! Ring object
+
+typedef struct _CAN_TXRING {
+    CANFDSPI_MODULE_ID index;
+    CAN_FIFO_CHANNEL channel;
+    CAN_TXRING_POLICY policy;
+    uint32_t* storage;
+    //! Slab mode: block pointers and allocator
+    CAN_SLAB_FRAME** slots;
+    CAN_SLAB* slab;
+    uint8_t depth;
+    uint8_t entryWords;
+    uint8_t dataBytes;
+    //! Free running indexes, tail is written only by submit and head by service(and by
+    //! DROP_OLDEST submit with interrupts disabled)
+    volatile uint16_t head;
+    volatile uint16_t tail;
+    //! TX FIFO not full event is enabled
+    bool eventEnabled;
+    //! Statistics
+    uint32_t submitted;
+    uint32_t transmitted;
+    uint32_t rejected;
+    uint32_t dropped;
+    uint32_t statusReads;
+    uint8_t highWatermark;
+} CAN_TXRING;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Software TX Ring
+
+// *****************************************************************************
+//! Initialize ring for TX FIFO
+/*!
+ * storage must have CAN_TXRING_STORAGE_WORDS(depth, dataBytes) words, dataBytes is
+ * the biggest payload of submitted frames. Depth must be power of two not bigger than
+ * 128(free running indexes wrap at 65536). TX FIFO must be configured before first
+ * service.
+ *
+ * Return: 0 - success, -1 - wrong depth, payload size or channel.
+ */
+
+int8_t DRV_CANFDSPI_TxRingInitialize(CAN_TXRING* ring, CANFDSPI_MODULE_ID index,
+        CAN_FIFO_CHANNEL channel, CAN_TXRING_POLICY policy, uint32_t* storage,
+        uint8_t depth, uint8_t dataBytes);
+
+// *****************************************************************************
+//! Initialize ring which store frames in blocks from slab
+/*!
+ * slots must have depth pointers, depth must be power of two not bigger than 128. Slab
+ * can be shared with other rings and RX queue.
+ *
+ * Return: 0 - success, -1 - wrong depth or channel.
+ */
+
+int8_t DRV_CANFDSPI_TxRingInitializeSlab(CAN_TXRING* ring, CANFDSPI_MODULE_ID index,
+        CAN_FIFO_CHANNEL channel, CAN_TXRING_POLICY policy, CAN_SLAB_FRAME** slots,
+        uint8_t depth, CAN_SLAB* slab);
+
+// *****************************************************************************
+//! Store frame in ring without SPI access
+/*!
+ * Payload is padded by zeros up to DLC.
+ *
+ * Return: 0 - frame stored, 1 - frame stored and the oldest frame dropped,
+ * -1 - ring or slab full(backpressure), -2 - ring or slab full and frame dropped,
+ * -3 - data don't fit into DLC or ring entry.
+ */
+
+int8_t DRV_CANFDSPI_TxRingSubmit(CAN_TXRING* ring, const CAN_TX_MSGOBJ* txObj,
+        const uint8_t* txd, uint8_t txdNumBytes);
+
+// *****************************************************************************
+//! Move frames from ring to TX FIFO until ring is empty or FIFO is full
+/*!
+ * Return: 0 - ring empty, 1 - frames wait for TX FIFO not full event, -1 - SPI error.
+ */
+
+int8_t DRV_CANFDSPI_TxRingService(CAN_TXRING* ring);
+
+// *****************************************************************************
+//! Number of frames waiting in ring
+
+uint8_t DRV_CANFDSPI_TxRingCount(const CAN_TXRING* ring);
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
+
+#endif // _DRV_CANFDSPI_TXRING_H
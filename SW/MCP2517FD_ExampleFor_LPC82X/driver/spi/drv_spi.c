@@ -53,6 +53,7 @@ DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
 /* Local function prototypes */
 inline void spi_master_init(void);
 inline int8_t spi_master_transfer(uint8_t *SpiTxData, uint8_t *SpiRxData, uint16_t spiTransferSize);
+inline void spi_master_put_byte(uint8_t byte, bool endOfTransfer);
 
 void DRV_SPI_Initialize(void)
 {
@@ -64,6 +65,36 @@ int8_t DRV_SPI_TransferData(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxData, uin
 	return spi_master_transfer(SpiTxData, SpiRxData, spiTransferSize);
 }
 
+int8_t DRV_SPI_TransferFill(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxHeader, uint16_t spiHeaderSize, uint8_t fillByte, uint16_t spiFillSize)
+{
+	uint16_t totalSize = spiHeaderSize + spiFillSize;
+	uint16_t pos = 0;
+
+	// Received data isn't needed so RXIGNORE is set and only TXRDY is checked. SSEL is
+	// deasserted after the last byte thanks to EOT bit so whole fill is single transfer.
+	for (pos = 0; pos < totalSize; pos++)
+	{
+		if (pos < spiHeaderSize)
+		{
+			spi_master_put_byte(SpiTxHeader[pos], (pos + 1) == totalSize);
+		}
+		else
+		{
+			spi_master_put_byte(fillByte, (pos + 1) == totalSize);
+		}
+	}
+
+	// Wait until the last byte is shifted out and SSEL is deasserted
+	SPI_Status spiStatus = SPI_ReturnStatusRegister(MPC2517_CHIP_SPI_PORT_NUMBER);
+
+	for (; spiStatus.MSTIDLE == 0;)
+	{
+		spiStatus = SPI_ReturnStatusRegister(MPC2517_CHIP_SPI_PORT_NUMBER);
+	}
+
+	return 0;
+}/* int8_t DRV_SPI_TransferFill(uint8_t spiSlaveDeviceIndex, uint8_t *SpiTxHeader, uint16_t spiHeaderSize, uint8_t fillByte, uint16_t spiFillSize) */
+
 void spi_master_init(void)
 {
 	SPI_DriverInit(MPC2517_CHIP_SPI_PORT_NUMBER, SPI_CLK_IDLE_LOW, SPI_CLK_LEADING);
@@ -101,3 +132,14 @@ int8_t __attribute__((optimize("O0"))) spi_master_transfer(uint8_t *SpiTxData, u
 	return 0;
 }/* int8_t spi_master_transfer(uint8_t *SpiTxData, uint8_t *SpiRxData, uint16_t spiTransferSize) */
 
+void spi_master_put_byte(uint8_t byte, bool endOfTransfer)
+{
+	SPI_Status spiStatus = SPI_ReturnStatusRegister(MPC2517_CHIP_SPI_PORT_NUMBER);
+
+	for (; spiStatus.TXRDY == 0;)
+	{
+		spiStatus = SPI_ReturnStatusRegister(MPC2517_CHIP_SPI_PORT_NUMBER);
+	}
+
+	SPI_PutByteToTransmitter(MPC2517_CHIP_SPI_PORT_NUMBER, byte, SPI_CHIP_TXSSEL0_N, endOfTransfer, true);
+}
@@ -59,10 +59,53 @@
 *			dataFromUart = UART_ReadByteFromTrasmitter(0);
 *		}
 *	}
+*
+* Polling functions send and receive single byte. For logging and streaming ring buffers
+* can be enabled after UART_DriverInit, then UART interrupt move data between USART and
+* buffers and application only copy data to or from buffer(functions don't wait).
+* UART_Write and UART_Read return number of copied bytes. Buffer sizes must be power of
+* two. RX buffer must hold all data received between UART_Read calls, lost bytes and
+* errors reported in USART status register are counted.
+*
+* Simple example code with ring buffers:
+*
+*	static uint8_t txMemory[256];
+*	static uint8_t rxMemory[64];
+*	uint8_t rxData[16];
+*	UART_ErrorCounters errors;
+*
+*	UART_DriverInit(0, 3000000, L8_BIT, ONE_BIT, NONE_PARITY);
+*	UART_EnableRingBuffers(0, txMemory, sizeof(txMemory), rxMemory, sizeof(rxMemory));
+*
+*	UART_Write(0, (const uint8_t*)"Hello\r\n", 7);
+*	uint16_t received = UART_Read(0, rxData, sizeof(rxData));
+*
+*	UART_ReturnErrorCounters(0, &errors);
+*
+* TX buffer can be sent by DMA(UART_EnableDmaTx after UART_EnableRingBuffers). Then
+* UART_Write start DMA when it is idle and DMA interrupt start next transfer when the
+* previous one is finished, so CPU is used once per up to two contiguous spans of TX
+* buffer(up to 1024 bytes each) instead of once per byte. USARTn TX use DMA channel
+* 2n+1. DMA controller is shared with other peripherals, so application own descriptor
+* table for all channels(SRAMBASE, aligned to 512 bytes) and DMA_IRQHandler which call
+* UART_DmaInterruptService for every port with DMA TX:
+*
+*	static DMA_CHDESC_T dmaTable[UART_DMA_TABLE_SIZE] __attribute__((aligned(512)));
+*
+*	UART_EnableDmaTx(0, dmaTable);
+*
+*	void DMA_IRQHandler(void)
+*	{
+*		UART_DmaInterruptService(0);
+*	}
+*
+* UART_EnableDmaTx set SRAMBASE only when it wasn't set yet, table used by other DMA
+* users must be passed to it.
 */
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "UART_RingBuffer.h"
 
 #ifdef MICROCONTROLLER
 
@@ -148,8 +191,26 @@ extern "C" {
 		uint8_t Reserved : 4;
 	}ReadByteErrors;
 
+	typedef struct
+	{
+		uint32_t overrun;//byte lost because receiver wasn't read in time
+		uint32_t framing;
+		uint32_t parity;
+		uint32_t rxDropped;//byte lost because RX ring buffer was full
+	}UART_ErrorCounters;
+
 #ifdef MICROCONTROLLER
 #define FRACTIONAL_DIVIDER_EQUAL_256 0xFF
+
+//USART interrupt enable bits used by ring buffers(INTENSET/INTENCLR)
+#define UART_INT_RXRDY (1<<0)
+#define UART_INT_TXRDY (1<<2)
+#define UART_INT_OVERRUN (1<<8)
+#define UART_INT_FRAMERR (1<<13)
+#define UART_INT_PARITYERR (1<<14)
+
+//LPC82X DMA controller has 18 channels, descriptor table must contain all of them
+#define UART_DMA_TABLE_SIZE 18
 #else
 	typedef struct
 	{
@@ -174,6 +235,17 @@ extern "C" {
 	uint8_t UART_ReadByteFromTrasmitter(uint8_t portNumber);
 	UART_Status UART_ReturnStatusRegister(uint8_t portNumber);
 
+	bool UART_EnableRingBuffers(uint8_t portNumber, uint8_t* txMemory, uint16_t txSize, uint8_t* rxMemory, uint16_t rxSize);
+	uint16_t UART_Write(uint8_t portNumber, const uint8_t* data, uint16_t length);
+	uint16_t UART_Read(uint8_t portNumber, uint8_t* buffer, uint16_t length);
+	uint16_t UART_WriteSpace(uint8_t portNumber);
+	uint16_t UART_ReadCount(uint8_t portNumber);
+	void UART_ReturnErrorCounters(uint8_t portNumber, UART_ErrorCounters* counters);
+#ifdef MICROCONTROLLER
+	bool UART_EnableDmaTx(uint8_t portNumber, DMA_CHDESC_T* descriptorTable);
+	void UART_DmaInterruptService(uint8_t portNumber);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -32,9 +32,23 @@ DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
  *****************************************************************************************/
 
 #include "../driver/canfdspi/drv_canfdspi_api.h"
+#include "../driver/canfdspi/drv_canfdspi_codec.h"
+#include "../driver/canfdspi/drv_canfdspi_bittime.h"
+#include "../driver/canfdspi/drv_canfdspi_tdc.h"
+#include "../driver/canfdspi/drv_canfdspi_image.h"
+#include "../driver/canfdspi/drv_canfdspi_ramplan.h"
+#include "../driver/canfdspi/drv_canfdspi_txring.h"
+#include "../driver/canfdspi/drv_canfdspi_slab.h"
+#include "../driver/canfdspi/drv_canfdspi_dispatch.h"
+#include "../driver/canfdspi/drv_canfdspi_recovery.h"
+#include "../driver/canfdspi/drv_canfdspi_busload.h"
+#include "../driver/canfdspi/drv_canfdspi_packed.h"
+#include "../driver/canfdspi/drv_canfdspi_gateway.h"
+#include "../driver/canfdspi/drv_canfdspi_capture.h"
 #include "../driver/spi/drv_spi.h"
 #include "chip.h"
 #include "GPIO_Driver.h"
+#include "UART_Driver.h"
 
 /*****************************************************************************************
  * Structures used to configure MCP2517FD
@@ -45,28 +59,200 @@ DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
 // Receive FIFO channel
 #define CAN_RX_FIFO CAN_FIFO_CH1
 
-// Maximal amount of test that TX fifo isn't full
-#define MAX_TXQUEUE_ATTEMPTS 20
-
-// CAN configuration object
-CAN_CONFIG canConfig;
+// Amount of frames which can wait in MCU RAM when TX FIFO is full
+#define CAN_TX_RING_DEPTH 8
+
+// Amount of received frames which can wait for main loop(power of two)
+#define CAN_RX_QUEUE_DEPTH 32
+
+// Slab blocks for 8, 16, 32 and 64 bytes payload shared by TX ring and RX queue. 64
+// bytes blocks are enough for full TX ring and few received FD frames, classic frames
+// use 20 bytes blocks instead of 76 bytes fixed slots.
+#define CAN_SLAB_BLOCKS_8 16
+#define CAN_SLAB_BLOCKS_16 4
+#define CAN_SLAB_BLOCKS_32 4
+#define CAN_SLAB_BLOCKS_64 12
+
+// Maximal RAM used by frames in MCU, the smallest supported MCUs have only 4KB of RAM
+#define CAN_FRAME_RAM_BUDGET 1536
+
+// Payload size of TX and RX FIFO
+#define CAN_TX_FIFO_PLSIZE CAN_PLSIZE_64
+#define CAN_RX_FIFO_PLSIZE CAN_PLSIZE_64
+
+// DLC of transmitted test frames
+#define CAN_TX_DLC CAN_DLC_64
+
+// Bit rates and SYSCLK of MCP2517FD
+#define CAN_NOMINAL_BITRATE 500000
+#define CAN_DATA_BITRATE 2000000
+#define CAN_SYSCLK 40000000
+
+// Maximal amount of OPMOD reads after Normal Mode request
+#define MAX_MODE_CHANGE_ATTEMPTS 10000
+
+// Set to 1 to calibrate transmitter delay compensation in external loopback mode
+// during startup. Calibrated profile can be read by debugger and stored as constant.
+#define CAN_TDC_CALIBRATION_ENABLE 0
+
+// Set to 1 to work as CAN-UART gateway: every received frame is sent to host via UART
+// and frames sent by host are transmitted(framing in drv_canfdspi_gateway.h, host side
+// in HostTools/GatewayDecoder). Test frames aren't transmitted in this mode.
+#define CAN_GATEWAY_ENABLE 0
+
+// USART0(PIO0_4 TXD, PIO0_0 RXD), only 3Mbaud is verified by UART_DriverInit
+#define CAN_GATEWAY_UART_PORT 0
+#define CAN_GATEWAY_BAUDRATE 3000000
+
+// Received frames waiting for UART in packed records and UART ring buffers(power of two).
+// UART RX buffer must hold records sent by host between two main loop iterations.
+#define CAN_GATEWAY_RING_BYTES 1024
+#define CAN_GATEWAY_UART_TX_BYTES 256
+#define CAN_GATEWAY_UART_RX_BYTES 512
+
+// Set to 1 to send received frames in blocks of compact capture records(format in
+// drv_canfdspi_capture.h), periodic traffic take 2 - 3 times less bytes than frame
+// records. Reset record start every CAN_GATEWAY_CAPTURE_RESET_BLOCKS block, so host
+// decoder recover after lost block. Block which isn't full is sent after
+// CAN_GATEWAY_CAPTURE_FLUSH_TICKS SysTicks.
+#define CAN_GATEWAY_CAPTURE_ENABLE 0
+#define CAN_GATEWAY_CAPTURE_RESET_BLOCKS 16
+#define CAN_GATEWAY_CAPTURE_FLUSH_TICKS 10
+
+// SysTick period in gateway mode(core clock cycles) and maximal amount of frames moved
+// from RX FIFO in single SysTick
+#define CAN_GATEWAY_SYSTICK_CYCLES (SystemCoreClock / 1000)
+#define CAN_GATEWAY_RX_BATCH 8
+
+// Codecs specialized for above FIFO configuration
+DRV_CANFDSPI_DEFINE_TX_CODEC(CanTxFd64, CAN_TX_DLC)
+CAN_TX_CODEC_CHECK(CanTxFd64, CAN_TX_DLC, CAN_TX_FIFO_PLSIZE);
+
+// Bit time used when TDC profile isn't valid
+CAN_IMAGE_NBTCFG_CHECK(CanImage, CAN_SYSCLK, 0, CAN_NOMINAL_BITRATE, CAN_BITTIME_DEFAULT_SAMPLE_POINT);
+CAN_IMAGE_DBTCFG_CHECK(CanImage, CAN_SYSCLK, 0, CAN_DATA_BITRATE, CAN_BITTIME_DEFAULT_SAMPLE_POINT);
+
+// FIFO configuration: TXQ not used, RX FIFO with time stamp and interrupt when not
+// empty, TX FIFO with priority 1 and unlimited retransmission attempts
+#define CAN_RX_FIFOCON_IMAGE CAN_IMAGE_FIFOCON_RX(15, CAN_RX_FIFO_PLSIZE, 1, CAN_RX_FIFO_NOT_EMPTY_EVENT)
+#define CAN_TX_FIFOCON_IMAGE CAN_IMAGE_FIFOCON_TX(7, CAN_TX_FIFO_PLSIZE, 1, 3, CAN_TX_FIFO_NO_EVENT)
+
+static const uint32_t canFifoConImage[] = {
+	[CAN_TXQUEUE_CH0] = CAN_IMAGE_FIFOCON_RESET,
+	[CAN_RX_FIFO] = CAN_RX_FIFOCON_IMAGE,
+	[CAN_TX_FIFO] = CAN_TX_FIFOCON_IMAGE
+};
+
+// TEF confirm transmitted frames for bus load statistics. It has the same depth as TX FIFO
+// and is read before TX FIFO is refilled, so it can't overflow.
+#define CAN_TEFCON_IMAGE CAN_IMAGE_TEFCON(7, 1)
+
+// TEF, TXQ(enabled after reset), RX FIFO and TX FIFO must fit into message RAM.
+// Layout for other traffic mix can be calculated by HostTools/RamLayoutPlanner.
+CAN_RAM_LAYOUT_CHECK(CanRam, CAN_RAM_TEFCON_BYTES(CAN_TEFCON_IMAGE) +
+		CAN_RAM_FIFOCON_BYTES(CAN_IMAGE_FIFOCON_RESET) + CAN_RAM_FIFOCON_BYTES(CAN_RX_FIFOCON_IMAGE) +
+		CAN_RAM_FIFOCON_BYTES(CAN_TX_FIFOCON_IMAGE));
+
+// Filter 0 accept only standard ID 0xDA and store it in RX FIFO, other frames are rejected
+// by controller without SPI transfer. Filters for list of IDs can be generated by
+// HostTools/FilterCompiler(e.g. FilterCompiler 0DA 100 101 102 103). Gateway accept all
+// standard and extended frames.
+static const uint32_t canFilterObjImage[] = {
+#if CAN_GATEWAY_ENABLE
+	CAN_IMAGE_FLTOBJ_SID(0x0), CAN_IMAGE_MASK(0x0, 0x0, 0)
+#else
+	CAN_IMAGE_FLTOBJ_SID(0xda), CAN_IMAGE_MASK(0x7ff, 0x0, 1)
+#endif
+};
+
+static const uint8_t canFilterConImage[] = {
+	CAN_IMAGE_FLTCON(CAN_RX_FIFO)
+};
+
+// Whole controller configuration written during initialization
+static const CAN_CONFIG_IMAGE canConfigImage = {
+	.con = CAN_IMAGE_CON_RESET,
+	.nbtcfg = CAN_IMAGE_BTCFG(CAN_SYSCLK, 0, CAN_NOMINAL_BITRATE, CAN_BITTIME_DEFAULT_SAMPLE_POINT),
+	.dbtcfg = CAN_IMAGE_BTCFG(CAN_SYSCLK, 0, CAN_DATA_BITRATE, CAN_BITTIME_DEFAULT_SAMPLE_POINT),
+	.tdc = CAN_IMAGE_TDC_AUTO(CAN_SYSCLK, 0, CAN_DATA_BITRATE, CAN_BITTIME_DEFAULT_SAMPLE_POINT),
+	.tscon = CAN_IMAGE_TSCON(CAN_SYSCLK / 1000000),
+	.intEnable = CAN_TX_EVENT | CAN_RX_EVENT | CAN_BUS_ERROR_EVENT,
+	.tefcon = CAN_TEFCON_IMAGE,
+	.fifoCon = canFifoConImage,
+	.nFifo = sizeof(canFifoConImage) / sizeof(canFifoConImage[0]),
+	.filterObj = canFilterObjImage,
+	.filterCon = canFilterConImage,
+	.nFilters = sizeof(canFilterConImage) / sizeof(canFilterConImage[0])
+};
 
 // Transmit objects
-CAN_TX_FIFO_CONFIG canTxConfig;
-CAN_TX_MSGOBJ canTxObj;
-
-// Receive objects
-CAN_RX_FIFO_CONFIG canRxConfig;
-REG_CiFLTOBJ canFifoFilterObj;
-REG_CiMASK canFifoMaskObj;
-
-CAN_RX_MSGOBJ canRxMsgObj;
-uint8_t canRxMsgPayload[MAX_DATA_BYTES];
-
-// Comunication status flags and error counters which is get from CiTREC register
-CAN_ERROR_STATE canErrorFlags;
-uint8_t canTrasmitErrorCounter;
-uint8_t canReceiveErrorCounter;
+CanTxFd64_TX_FRAME canTxFrame;
+
+// Frame memory of TX ring and RX queue
+CAN_SLAB canSlab;
+static const uint8_t canSlabBlocks[CAN_SLAB_CLASSES] = {
+	CAN_SLAB_BLOCKS_8, CAN_SLAB_BLOCKS_16, CAN_SLAB_BLOCKS_32, CAN_SLAB_BLOCKS_64
+};
+static uint32_t canSlabMemory[CAN_SLAB_MEMORY_WORDS(CAN_SLAB_BLOCKS_8, CAN_SLAB_BLOCKS_16,
+		CAN_SLAB_BLOCKS_32, CAN_SLAB_BLOCKS_64)];
+typedef char CanSlabFitsRamBudget[(sizeof(canSlabMemory) <= CAN_FRAME_RAM_BUDGET) ? 1 : -1];
+
+// Software TX ring placed before TX FIFO
+CAN_TXRING canTxRing;
+static CAN_SLAB_FRAME* canTxRingSlots[CAN_TX_RING_DEPTH];
+
+// Received frames passed from SysTick interrupt to main loop, time stamp in us
+CAN_SLAB_QUEUE canRxQueue;
+static CAN_SLAB_FRAME* canRxQueueSlots[CAN_RX_QUEUE_DEPTH];
+
+// Handlers of received frames selected by filter which accepted frame. Every filter
+// accept single ID so ID table(CAN_DISPATCH_TABLE) isn't needed, frames of filters
+// without handler are counted in canFilterDispatch.rejected.
+void CanMessage0DAHandler(const CAN_RX_MSGOBJ* header, uint8_t* data);
+
+CAN_FILTER_DISPATCH canFilterDispatch;
+
+// Bit time configuration and TDC profile applied during initialization
+CAN_BITTIME_SOLVER_CONFIG canBitTimeConfig;
+CAN_TDC_PROFILE canTdcProfile;
+
+// Comunication status flags and error counters which is get from CiTREC register, bus off
+// statistics(offline time in us, CiTBC is incremented every 1us)
+CAN_RECOVERY canRecovery;
+
+// Bus load and per ID statistics of received and transmitted frames, snapshot is taken
+// every 5 SysTick periods(window must be shorter than 4s). CiTBC time in us is read then.
+CAN_BUSLOAD canBusLoad;
+CAN_BUSLOAD_SNAPSHOT canBusLoadSnapshot;
+uint32_t canTime;
+
+#if CAN_GATEWAY_ENABLE
+// Received frames passed from SysTick to main loop in packed records, encoded records
+// are sent and received by UART interrupt from ring buffers
+CAN_PACKED_RING canGatewayRing;
+static uint32_t canGatewayRingMemory[CAN_GATEWAY_RING_BYTES / 4];
+static uint8_t canGatewayUartTx[CAN_GATEWAY_UART_TX_BYTES];
+static uint8_t canGatewayUartRx[CAN_GATEWAY_UART_RX_BYTES];
+
+// DMA descriptor table for all channels(SRAMBASE), UART TX use one of them
+static DMA_CHDESC_T canGatewayDmaTable[UART_DMA_TABLE_SIZE] __attribute__((aligned(512)));
+
+// Records from host are decoded in main loop, status is sent to host when it change
+CAN_GATEWAY_DECODER canGatewayDecoder;
+CAN_GATEWAY_STATUS_INFO canGatewayStatus;
+uint32_t canGatewayTxDropped;
+
+#if CAN_GATEWAY_CAPTURE_ENABLE
+// Capture block is built directly in record buffer, canGatewayTicks is incremented by
+// SysTick
+CAN_CAPTURE_CODER canGatewayCapture;
+static uint8_t canGatewayBlock[CAN_GATEWAY_MAX_RECORD_BYTES];
+uint8_t canGatewayBlockBytes;
+uint8_t canGatewayBlockSequence;
+uint32_t canGatewayBlockTick;
+volatile uint32_t canGatewayTicks;
+#endif
+#endif
 
 /*****************************************************************************************
  * Application variables
@@ -74,6 +260,38 @@ uint8_t canReceiveErrorCounter;
 uint32_t canRxMessageCounter;
 uint32_t interruptCounter;
 
+// Duration of RAM initialization and whole initialization until chip enter Normal Mode
+// in core clock cycles. Measured by SysTick so values above 2^24 cycles are not valid.
+uint32_t canRamInitTime;
+uint32_t canStartupTime;
+
+// Core clock cycles of the last dispatched frame(handler lookup and call)
+uint32_t canDispatchCycles;
+
+/*****************************************************************************************
+* StartupTimerStart() - start SysTick as free running down counter without interrupt. It is
+* used only during initialization, later main configure SysTick for periodic interrupt.
+*
+*****************************************************************************************/
+void StartupTimerStart(void)
+{
+	SysTick->CTRL = 0;
+	SysTick->LOAD = 0xFFFFFF;
+	SysTick->VAL = 0;
+
+	// Set bit 0(ENABLE) and 2(CLKSOURCE) so counter is clocked by core clock
+	SysTick->CTRL = 5;
+}
+
+/*****************************************************************************************
+* StartupTimerRead() - return amount of core clock cycles since StartupTimerStart().
+*
+*****************************************************************************************/
+uint32_t StartupTimerRead(void)
+{
+	return 0xFFFFFF - SysTick->VAL;
+}
+
 /*****************************************************************************************
 * InitCanFdChip() - initialize MCP2517FD chip to work with appropriate baudrate and mode.
 * During initialization is also correctly configured RX and TX FIFO.
@@ -81,6 +299,11 @@ uint32_t interruptCounter;
 *****************************************************************************************/
 void InitCanFdChip(void)
 {
+	uint32_t attempts = 0;
+	uint32_t bitTimeReg[2];
+
+	StartupTimerStart();
+
 	// Reset device
 	DRV_CANFDSPI_Reset(DRV_CANFDSPI_INDEX_0);
 
@@ -89,56 +312,83 @@ void InitCanFdChip(void)
 
 	DRV_CANFDSPI_RamInit(DRV_CANFDSPI_INDEX_0, 0xff);
 
-	// Configure device by set CiCON register
-	DRV_CANFDSPI_ConfigureObjectReset(&canConfig);
-	canConfig.IsoCrcEnable = 1;
-	canConfig.StoreInTEF = 0;
+	canRamInitTime = StartupTimerRead();
 
-	DRV_CANFDSPI_Configure(DRV_CANFDSPI_INDEX_0, &canConfig);
+	// Configure CiCON, bit time, FIFOs, filter and interrupts by few burst writes
+	DRV_CANFDSPI_ConfigImageApply(DRV_CANFDSPI_INDEX_0, &canConfigImage);
 
-	// Setup TX FIFO by set CiFIFOCON register
-	DRV_CANFDSPI_TransmitChannelConfigureObjectReset(&canTxConfig);
-	canTxConfig.FifoSize = 7;
-	canTxConfig.PayLoadSize = CAN_PLSIZE_64;
-	canTxConfig.TxPriority = 1;
+	// Frames which don't fit into TX FIFO are stored in ring, caller is informed when
+	// ring is full
+	DRV_CANFDSPI_SlabInitialize(&canSlab, canSlabMemory, sizeof(canSlabMemory) / 4, canSlabBlocks);
 
-	DRV_CANFDSPI_TransmitChannelConfigure(DRV_CANFDSPI_INDEX_0, CAN_TX_FIFO, &canTxConfig);
+	DRV_CANFDSPI_TxRingInitializeSlab(&canTxRing, DRV_CANFDSPI_INDEX_0, CAN_TX_FIFO,
+			CAN_TXRING_BACKPRESSURE, canTxRingSlots, CAN_TX_RING_DEPTH, &canSlab);
 
-	// Setup RX FIFO by set CiFIFOCON register
-	DRV_CANFDSPI_ReceiveChannelConfigureObjectReset(&canRxConfig);
-	canRxConfig.FifoSize = 15;
-	canRxConfig.PayLoadSize = CAN_PLSIZE_64;
+	DRV_CANFDSPI_SlabQueueInitialize(&canRxQueue, canRxQueueSlots, CAN_RX_QUEUE_DEPTH);
 
-	DRV_CANFDSPI_ReceiveChannelConfigure(DRV_CANFDSPI_INDEX_0, CAN_RX_FIFO, &canRxConfig);
+	// Filter 0 is configured by canConfigImage, next filters can be allocated together
+	// with handler by DRV_CANFDSPI_FilterHandlerRegister
+	DRV_CANFDSPI_FilterDispatchInitialize(&canFilterDispatch, 0, NULL);
+	DRV_CANFDSPI_FilterHandlerSet(&canFilterDispatch, CAN_FILTER0, CanMessage0DAHandler);
 
-	// Setup RX Filter by set CiFLTOBJ0 register
-	canFifoFilterObj.word = 0;
-	canFifoFilterObj.bF.SID = 0xda;
-	canFifoFilterObj.bF.EXIDE = 0;
-	canFifoFilterObj.bF.EID = 0x00;
+	// After bus off chip is returned to Normal Mode and frames from TX FIFO are sent again
+	DRV_CANFDSPI_RecoveryInitialize(&canRecovery, DRV_CANFDSPI_INDEX_0, CAN_NORMAL_MODE,
+			1 << CAN_TX_FIFO);
 
-	DRV_CANFDSPI_FilterObjectConfigure(DRV_CANFDSPI_INDEX_0, CAN_FILTER0, &canFifoFilterObj.bF);
+	// When valid TDC profile exist then data bit rate and TDC are taken from it
+	DRV_CANFDSPI_BitTimeSolverConfigObjectReset(&canBitTimeConfig);
+	canBitTimeConfig.sysClk = CAN_SYSCLK;
+	canBitTimeConfig.nominalBitRate = CAN_NOMINAL_BITRATE;
+	canBitTimeConfig.dataBitRate = CAN_DATA_BITRATE;
+	canBitTimeConfig.loopDelay = CAN_BITTIME_LOOP_DELAY_OPTO;
 
-	// Setup RX Mask by set CiMASK0 register
-	canFifoMaskObj.word = 0;
-	canFifoMaskObj.bF.MSID = 0x0;
-	canFifoMaskObj.bF.MIDE = 1; // Only allow standard IDs
-	canFifoMaskObj.bF.MEID = 0x0;
-	DRV_CANFDSPI_FilterMaskConfigure(DRV_CANFDSPI_INDEX_0, CAN_FILTER0, &canFifoMaskObj.bF);
+	DRV_CANFDSPI_TdcProfileApply(DRV_CANFDSPI_INDEX_0, &canTdcProfile, &canBitTimeConfig);
 
-	// Link FIFO and Filter by set CiFLTCON0 register
-	DRV_CANFDSPI_FilterToFifoLink(DRV_CANFDSPI_INDEX_0, CAN_FILTER0, CAN_RX_FIFO, true);
-
-	// Setup Bit Time
-	DRV_CANFDSPI_BitTimeConfigure(DRV_CANFDSPI_INDEX_0, CAN_500K_2M, CAN_SSP_MODE_AUTO, CAN_SYSCLK_40M);
-
-	DRV_CANFDSPI_ReceiveChannelEventEnable(DRV_CANFDSPI_INDEX_0, CAN_RX_FIFO, CAN_RX_FIFO_NOT_EMPTY_EVENT);
-	DRV_CANFDSPI_ModuleEventEnable(DRV_CANFDSPI_INDEX_0, CAN_TX_EVENT | CAN_RX_EVENT);
+	// Bit rates are read back from chip, data bit rate can be taken from profile
+	DRV_CANFDSPI_ReadWordArray(DRV_CANFDSPI_INDEX_0, cREGADDR_CiNBTCFG, bitTimeReg, 2);
+	DRV_CANFDSPI_BusLoadInitializeBitTime(&canBusLoad, CAN_SYSCLK, bitTimeReg[0], bitTimeReg[1], 0);
 
 	// Select Normal Mode
 	DRV_CANFDSPI_OperationModeSelect(DRV_CANFDSPI_INDEX_0, CAN_NORMAL_MODE);
+
+	// Chip is ready for bus communication when mode is changed(after bus integration)
+	while ((DRV_CANFDSPI_OperationModeGet(DRV_CANFDSPI_INDEX_0) != CAN_NORMAL_MODE) &&
+			(attempts < MAX_MODE_CHANGE_ATTEMPTS))
+	{
+		attempts++;
+	}
+
+	canStartupTime = StartupTimerRead();
+
+	// Stop counter, bit 2(CLKSOURCE) stay set so SysTick remain clocked by core clock
+	SysTick->CTRL = 4;
 }
 
+#if CAN_TDC_CALIBRATION_ENABLE
+/*****************************************************************************************
+* CalibrateTdc() - measure loop delay via CANTXD, transceiver and CANRXD for list of data
+* bit rates and store result in canTdcProfile. Chip is initialized again after calibration
+* so profile is applied and frames received in loopback mode are removed.
+*
+*****************************************************************************************/
+void CalibrateTdc(void)
+{
+	static const uint32_t dataBitRates[] = {1000000, 2000000, 4000000, 5000000, 8000000};
+	CAN_TDC_CALIBRATION_CONFIG calibrationConfig;
+
+	InitCanFdChip();
+
+	DRV_CANFDSPI_TdcCalibrationConfigObjectReset(&calibrationConfig);
+	calibrationConfig.txChannel = CAN_TX_FIFO;
+	calibrationConfig.dlc = CAN_TX_DLC;
+
+	DRV_CANFDSPI_TdcCalibrate(DRV_CANFDSPI_INDEX_0, &calibrationConfig, &canBitTimeConfig,
+			dataBitRates, sizeof(dataBitRates) / sizeof(dataBitRates[0]), &canTdcProfile);
+
+	InitCanFdChip();
+}/* void CalibrateTdc(void) */
+#endif
+
 /*****************************************************************************************
 * TestCanChipRamAccess() - very useful function which can be used to verify that SPI
 * connection work correctly. For tested microcontroller not connected SPI to MCP2517FD
@@ -184,7 +434,9 @@ bool TestCanChipRamAccess(void)
 }/* bool TestCanChipRamAccess(void) */
 
 /*****************************************************************************************
-* ReceiveCanMessage() - receive single message from FIFO buffer if isn't empty.
+* ReceiveCanMessage() - move single message from FIFO buffer to RX queue if isn't empty.
+* Message is stored in slab block which fit its DLC and processed later in main loop.
+* When queue or slab is full message is dropped and counted in canRxQueue.overruns.
 *
 *****************************************************************************************/
 void ReceiveCanMessage(void)
@@ -195,98 +447,406 @@ void ReceiveCanMessage(void)
 
 	if (canRxFlags & CAN_RX_FIFO_NOT_EMPTY_EVENT)
 	{
-		// Get CAN RX message and move to global variable
-		DRV_CANFDSPI_ReceiveMessageGet(DRV_CANFDSPI_INDEX_0, CAN_RX_FIFO, &canRxMsgObj,
-			canRxMsgPayload, MAX_DATA_BYTES);
+		DRV_CANFDSPI_SlabReceive(&canSlab, &canRxQueue, DRV_CANFDSPI_INDEX_0, CAN_RX_FIFO, true);
+	}
+}/* void ReceiveCanMessage(void) */
 
-		// User can add here own code to process payload of received message
+/*****************************************************************************************
+* CanMessage0DAHandler() - process message with standard ID 0xDA. User can add here own
+* code to process payload of received message. Handlers for other IDs can be added by
+* DRV_CANFDSPI_FilterHandlerRegister.
+*
+*****************************************************************************************/
+void CanMessage0DAHandler(const CAN_RX_MSGOBJ* header, uint8_t* data)
+{
+	(void)header;
+	(void)data;
+
+	canRxMessageCounter++;
+}/* void CanMessage0DAHandler(const CAN_RX_MSGOBJ* header, uint8_t* data) */
+
+/*****************************************************************************************
+* ProcessCanMessages() - process all messages waiting in RX queue. Function is called from
+* main loop so interrupt can receive next messages during processing. Every message is
+* passed to handler of filter which accepted it.
+*
+*****************************************************************************************/
+void ProcessCanMessages(void)
+{
+	CAN_SLAB_FRAME* canRxFrame;
+	uint32_t start, end;
+
+	while ((canRxFrame = DRV_CANFDSPI_SlabQueueGet(&canRxQueue)) != NULL)
+	{
+		// Statistics are also updated from SysTick
+		__disable_irq();
+		DRV_CANFDSPI_BusLoadRxFrame(&canBusLoad, &canRxFrame->rx, CAN_SLAB_RX_DATA(canRxFrame));
+		__enable_irq();
 
+		start = SysTick->VAL;
+
+		DRV_CANFDSPI_FilterDispatch(&canFilterDispatch, &canRxFrame->rx, CAN_SLAB_RX_DATA(canRxFrame));
+
+		// SysTick count down, measurement with reload during dispatch is skipped
+		end = SysTick->VAL;
+		if (end < start)
+		{
+			canDispatchCycles = start - end;
+		}
 
-		canRxMessageCounter++;
+		DRV_CANFDSPI_SlabFree(&canSlab, canRxFrame);
 	}
-}/* void ReceiveCanMessage(void) */
+}/* void ProcessCanMessages(void) */
 
 /*****************************************************************************************
-* TransmitCanMessage() - send multiply frame with similar payload when FIFO buffer is
-* empty or send single message when FIFO buffer isn't full. Function also assign information
-* to appropriate gobal variable when send isn't possible.
+* TransmitCanMessage() - send multiply frame with similar payload when nothing wait for
+* transmission or send single message otherwise. Frames are stored in software TX ring
+* so function never wait for TX FIFO. When ring is full(bus is congested) frame isn't
+* sent and device status is assigned to appropriate global variable.
 *
 *****************************************************************************************/
 void TransmitCanMessage(void)
 {
-	uint8_t dlcToByteSize;
-	uint8_t txd[MAX_DATA_BYTES];
-	CAN_TX_FIFO_EVENT canTxFlags;
+	int frames = 1;
 
-	// Initialize CAN structure with information about CAN ID, length and flags
-	canTxObj.bF.id.SID = 0x100;//CAN ID message
+	// Initialize CAN structure with information about CAN ID and flags
+	canTxFrame.header.bF.id.SID = 0x100;//CAN ID message
 
-	canTxObj.bF.ctrl.DLC = 15;
-	canTxObj.bF.ctrl.IDE = 0;
-	canTxObj.bF.ctrl.BRS = 1;
-	canTxObj.bF.ctrl.FDF = 1;
-
-	dlcToByteSize = DRV_CANFDSPI_DlcToDataBytes((CAN_DLC) 15);
+	canTxFrame.header.bF.ctrl.DLC = CAN_TX_DLC;
+	canTxFrame.header.bF.ctrl.IDE = 0;
+	canTxFrame.header.bF.ctrl.BRS = 1;
+	canTxFrame.header.bF.ctrl.FDF = 1;
 
 	// Initialize CAN payload by random data
-	for (int i = 0; i < dlcToByteSize; i++)
+	for (int i = 0; i < CanTxFd64_DATA_BYTES; i++)
 	{
-		txd[i] = rand() & 0xff;
+		canTxFrame.data.byte[i] = rand() & 0xff;
 	}
 
+	// Check that nothing wait for transmission and then send many data
+	if (DRV_CANFDSPI_TxRingCount(&canTxRing) == 0)
 	{
-		uint8_t attempts = MAX_TXQUEUE_ATTEMPTS;
+		frames = 4;
+	}
 
-		// Check if FIFO is not full
-		do
+	for (int i = 0; i < frames; i++)
+	{
+		if (frames > 1)
 		{
-			// Get transmission status flags for coresponding FIFO buffer
-			DRV_CANFDSPI_TransmitChannelEventGet(DRV_CANFDSPI_INDEX_0, CAN_TX_FIFO, &canTxFlags);
+			canTxFrame.data.byte[0] = i;
+		}
 
-			// When send isn't possible then check device status
-			if (attempts == 0)
-			{
-				Nop();
-				DRV_CANFDSPI_ErrorCountStateGet(DRV_CANFDSPI_INDEX_0, &canTrasmitErrorCounter,
-						&canReceiveErrorCounter, &canErrorFlags);
-				return;
-			}
+		// When send isn't possible then device status is available in canRecovery
+		if (DRV_CANFDSPI_TxRingSubmit(&canTxRing, &canTxFrame.header, canTxFrame.data.byte,
+				CanTxFd64_DATA_BYTES) < 0)
+		{
+			Nop();
+			break;
+		}
+	}
+
+	// Move frames to TX FIFO, rest is moved when TX FIFO isn't full
+	DRV_CANFDSPI_TxRingService(&canTxRing);
+}/* void TransmitCanMessage(void) */
+
+/*****************************************************************************************
+* ConfirmCanMessages() - account frames transmitted on the bus in bus load statistics.
+* Frames are taken from TEF, so frames rejected by TX ring or not sent during bus off
+* aren't counted.
+*
+*****************************************************************************************/
+void ConfirmCanMessages(void)
+{
+	CAN_TEF_FIFO_STATUS tefStatus = CAN_TEF_FIFO_EMPTY;
+	CAN_TEF_MSGOBJ tefObj;
+
+	DRV_CANFDSPI_TefStatusGet(DRV_CANFDSPI_INDEX_0, &tefStatus);
+
+	while (tefStatus & CAN_TEF_FIFO_NOT_EMPTY)
+	{
+		if (DRV_CANFDSPI_TefMessageGet(DRV_CANFDSPI_INDEX_0, &tefObj))
+		{
+			break;
+		}
+
+		DRV_CANFDSPI_BusLoadTefFrame(&canBusLoad, &tefObj);
+
+		tefStatus = CAN_TEF_FIFO_EMPTY;
+		DRV_CANFDSPI_TefStatusGet(DRV_CANFDSPI_INDEX_0, &tefStatus);
+	}
+}/* void ConfirmCanMessages(void) */
+
+#if CAN_GATEWAY_ENABLE
+/*****************************************************************************************
+* GatewayInitialize() - configure UART used by gateway. UART interrupt move received data
+* to ring buffer and has higher priority than SysTick, so SPI transfers in SysTick don't
+* cause UART overrun(USART has only one byte receive buffer). TX buffer is sent by DMA.
+*
+*****************************************************************************************/
+void GatewayInitialize(void)
+{
+	// Enable clock for switch matrix, PIO0_4 work as U0_TXD and PIO0_0 as U0_RXD
+	LPC_SYSCTL->SYSAHBCLKCTRL |= (1<<7);
+	LPC_SWM->PINASSIGN[0] = (LPC_SWM->PINASSIGN[0] & 0xFFFF0000)|(0x4)|(0<<8);
+
+	DRV_CANFDSPI_PackedRingInitialize(&canGatewayRing, canGatewayRingMemory, sizeof(canGatewayRingMemory));
+	DRV_CANFDSPI_GatewayDecoderInitialize(&canGatewayDecoder);
+#if CAN_GATEWAY_CAPTURE_ENABLE
+	DRV_CANFDSPI_CaptureInitialize(&canGatewayCapture, CAN_CAPTURE_DICTIONARY_SIZE, CAN_CAPTURE_HISTORY_BYTES);
+#endif
+
+	UART_DriverInit(CAN_GATEWAY_UART_PORT, CAN_GATEWAY_BAUDRATE, L8_BIT, ONE_BIT, NONE_PARITY);
+	UART_EnableRingBuffers(CAN_GATEWAY_UART_PORT, canGatewayUartTx, sizeof(canGatewayUartTx),
+			canGatewayUartRx, sizeof(canGatewayUartRx));
+
+	// Records are sent by DMA, CPU only start transfer when previous one is finished
+	UART_EnableDmaTx(CAN_GATEWAY_UART_PORT, canGatewayDmaTable);
 
-			attempts--;
+	NVIC_SetPriority(UART0_IRQn, 0);
+	NVIC_SetPriority(SysTick_IRQn, 3);
+}/* void GatewayInitialize(void) */
+
+/*****************************************************************************************
+* GatewayReceive() - move received frames from RX FIFO to packed ring. Function is called
+* from SysTick and move at most CAN_GATEWAY_RX_BATCH frames, rest is moved in the next
+* SysTick. When ring is full frame is dropped and counted in canGatewayRing.overruns.
+*
+*****************************************************************************************/
+void GatewayReceive(void)
+{
+	CAN_RX_FIFO_EVENT canRxFlags;
+
+	for (int i = 0; i < CAN_GATEWAY_RX_BATCH; i++)
+	{
+		if (DRV_CANFDSPI_ReceiveChannelEventGet(DRV_CANFDSPI_INDEX_0, CAN_RX_FIFO, &canRxFlags) ||
+				!(canRxFlags & CAN_RX_FIFO_NOT_EMPTY_EVENT))
+		{
+			break;
 		}
-		while (!(canTxFlags & CAN_TX_FIFO_NOT_FULL_EVENT));
 
-		// Check that buffer is empty and then send many data via buffer
-		if (canTxFlags & CAN_TX_FIFO_EMPTY_EVENT)
+		if (DRV_CANFDSPI_PackedRingReceive(&canGatewayRing, DRV_CANFDSPI_INDEX_0, CAN_RX_FIFO, true) < 0)
 		{
-			for (int i = 0; i < 4; i++)
+			break;
+		}
+	}
+}/* void GatewayReceive(void) */
+
+#if CAN_GATEWAY_CAPTURE_ENABLE
+/*****************************************************************************************
+* GatewayFlushCapture() - send capture block when whole record fit into UART TX buffer.
+* Return false when block has to wait for next call.
+*
+*****************************************************************************************/
+bool GatewayFlushCapture(void)
+{
+	uint8_t length;
+
+	if (UART_WriteSpace(CAN_GATEWAY_UART_PORT) < (CAN_GATEWAY_OVERHEAD_BYTES + 2 + canGatewayBlockBytes))
+	{
+		return false;
+	}
+
+	length = DRV_CANFDSPI_GatewayEncodeCapture(canGatewayBlock, canGatewayBlockSequence++, canGatewayBlockBytes);
+	UART_Write(CAN_GATEWAY_UART_PORT, canGatewayBlock, length);
+	canGatewayBlockBytes = 0;
+
+	return true;
+}/* bool GatewayFlushCapture(void) */
+
+/*****************************************************************************************
+* GatewaySendCapture() - encode frames from packed ring into capture block. Frame is
+* encoded only when the longest record for its DLC fit into block, otherwise block is
+* sent first. Encoder state is changed by every frame, so frame is taken from ring only
+* after it is written into block.
+*
+*****************************************************************************************/
+void GatewaySendCapture(void)
+{
+	CAN_PACKED_RECORD* record;
+	uint8_t* blockData = &canGatewayBlock[CAN_GATEWAY_CAPTURE_DATA_OFFSET];
+	uint8_t dataBytes;
+
+	while ((record = DRV_CANFDSPI_PackedRingPeek(&canGatewayRing)) != NULL)
+	{
+		if (canGatewayBlockBytes == 0)
+		{
+			if ((canGatewayBlockSequence % CAN_GATEWAY_CAPTURE_RESET_BLOCKS) == 0)
 			{
-				txd[0] = i;
+				canGatewayBlockBytes = DRV_CANFDSPI_CaptureEncodeReset(&canGatewayCapture, blockData,
+						record->rx.bF.timeStamp);
+			}
+			canGatewayBlockTick = canGatewayTicks;
+		}
 
-				// Transmit CAN message
-				DRV_CANFDSPI_TransmitChannelLoad(DRV_CANFDSPI_INDEX_0, CAN_TX_FIFO, &canTxObj, txd, dlcToByteSize, true);
+		dataBytes = DRV_CANFDSPI_FrameDataBytes(record->rx.bF.ctrl.FDF, (CAN_DLC)record->rx.bF.ctrl.DLC);
+		if ((canGatewayBlockBytes + CAN_CAPTURE_FRAME_BYTES(dataBytes)) > CAN_GATEWAY_CAPTURE_DATA_BYTES)
+		{
+			if (!GatewayFlushCapture())
+			{
+				return;
 			}
+			continue;
 		}
-		else// Buffer is not full and isn't empty so then send single CAN message
+
+		canGatewayBlockBytes += DRV_CANFDSPI_CaptureEncodeFrame(&canGatewayCapture,
+				&blockData[canGatewayBlockBytes], record->word, record->rx.bF.timeStamp,
+				CAN_PACKED_DATA(record));
+
+		DRV_CANFDSPI_PackedRingCommit(&canGatewayRing);
+	}
+
+	// Idle bus, don't keep frames in block for long time
+	if ((canGatewayBlockBytes > 0) &&
+			((canGatewayTicks - canGatewayBlockTick) >= CAN_GATEWAY_CAPTURE_FLUSH_TICKS))
+	{
+		GatewayFlushCapture();
+	}
+}/* void GatewaySendCapture(void) */
+#endif
+
+/*****************************************************************************************
+* GatewaySend() - encode waiting records into UART TX buffer. Record is taken from packed
+* ring only when whole record fit into buffer, rest wait for next call. Status record is
+* added when error state or any drop counter was changed.
+*
+*****************************************************************************************/
+void GatewaySend(void)
+{
+#if !CAN_GATEWAY_CAPTURE_ENABLE
+	CAN_PACKED_RECORD* record;
+#endif
+	uint8_t buffer[CAN_GATEWAY_MAX_FRAME_RECORD_BYTES];
+	uint8_t length;
+
+	if (UART_WriteSpace(CAN_GATEWAY_UART_PORT) < CAN_GATEWAY_MAX_FRAME_RECORD_BYTES)
+	{
+		return;
+	}
+
+	if ((canGatewayStatus.state != canRecovery.state) ||
+			(canGatewayStatus.tec != canRecovery.tec) ||
+			(canGatewayStatus.rec != canRecovery.rec) ||
+			(canGatewayStatus.rxOverruns != canGatewayRing.overruns) ||
+			(canGatewayStatus.decodeErrors != canGatewayDecoder.errors) ||
+			(canGatewayStatus.txDropped != canGatewayTxDropped))
+	{
+		canGatewayStatus.state = canRecovery.state;
+		canGatewayStatus.tec = canRecovery.tec;
+		canGatewayStatus.rec = canRecovery.rec;
+		canGatewayStatus.rxOverruns = canGatewayRing.overruns;
+		canGatewayStatus.decodeErrors = canGatewayDecoder.errors;
+		canGatewayStatus.txDropped = canGatewayTxDropped;
+
+		length = DRV_CANFDSPI_GatewayEncodeStatus(buffer, &canGatewayStatus);
+		UART_Write(CAN_GATEWAY_UART_PORT, buffer, length);
+	}
+
+#if CAN_GATEWAY_CAPTURE_ENABLE
+	GatewaySendCapture();
+#else
+	while ((UART_WriteSpace(CAN_GATEWAY_UART_PORT) >= CAN_GATEWAY_MAX_FRAME_RECORD_BYTES) &&
+			((record = DRV_CANFDSPI_PackedRingPeek(&canGatewayRing)) != NULL))
+	{
+		length = DRV_CANFDSPI_GatewayEncodeFrame(buffer, CAN_GATEWAY_RX_FRAME, record->word,
+				record->rx.bF.timeStamp, CAN_PACKED_DATA(record));
+		UART_Write(CAN_GATEWAY_UART_PORT, buffer, length);
+
+		DRV_CANFDSPI_PackedRingCommit(&canGatewayRing);
+	}
+#endif
+}/* void GatewaySend(void) */
+
+/*****************************************************************************************
+* GatewayDecode() - pass bytes from host to decoder. Decoded TX frame is stored in TX ring
+* and moved to TX FIFO by next SysTick. When ring is full frame is dropped, host see it in
+* txDropped of status record.
+*
+*****************************************************************************************/
+void GatewayDecode(void)
+{
+	CAN_TX_MSGOBJ txObj;
+	uint8_t txd[MAX_DATA_BYTES];
+	uint32_t timeStamp;
+	uint8_t buffer[16];
+	uint16_t length;
+
+	while ((length = UART_Read(CAN_GATEWAY_UART_PORT, buffer, sizeof(buffer))) > 0)
+	{
+		for (uint16_t i = 0; i < length; i++)
 		{
-			// Transmit CAN message
-			DRV_CANFDSPI_TransmitChannelLoad(DRV_CANFDSPI_INDEX_0, CAN_TX_FIFO, &canTxObj, txd, dlcToByteSize, true);
+			if (DRV_CANFDSPI_GatewayDecoderPut(&canGatewayDecoder, buffer[i]) != 1)
+			{
+				continue;
+			}
+
+			if (DRV_CANFDSPI_GatewayDecodeFrame(&canGatewayDecoder, txObj.word, &timeStamp, txd) != CAN_GATEWAY_TX_FRAME)
+			{
+				continue;
+			}
+
+			if (DRV_CANFDSPI_TxRingSubmit(&canTxRing, &txObj, txd,
+					DRV_CANFDSPI_FrameDataBytes(txObj.bF.ctrl.FDF, (CAN_DLC)txObj.bF.ctrl.DLC)) < 0)
+			{
+				canGatewayTxDropped++;
+			}
 		}
 	}
-}/* void TransmitCanMessage(void) */
+}/* void GatewayDecode(void) */
+
+/*****************************************************************************************
+* GatewayService() - called from main loop, decode records received from host and send
+* received frames to host.
+*
+*****************************************************************************************/
+void GatewayService(void)
+{
+	GatewayDecode();
+	GatewaySend();
+}/* void GatewayService(void) */
+
+/*****************************************************************************************
+* DMA_IRQHandler() - DMA interrupt is common for all channels, only UART TX channel of
+* gateway is used.
+*
+*****************************************************************************************/
+void DMA_IRQHandler(void)
+{
+	UART_DmaInterruptService(CAN_GATEWAY_UART_PORT);
+}/* void DMA_IRQHandler(void) */
+#endif
 
 void SysTick_Handler(void)
 {
+	// Error state is checked every tick, CiTREC is read only after error state change
+	DRV_CANFDSPI_RecoveryService(&canRecovery);
+
+	// Frames sent since previous tick are confirmed before TX FIFO is refilled
+	ConfirmCanMessages();
+
+	// Frames waiting in TX ring are moved to TX FIFO. Without INT pin handler TX FIFO
+	// not full event is polled here.
+	DRV_CANFDSPI_TxRingService(&canTxRing);
+
+#if CAN_GATEWAY_ENABLE
+	GatewayReceive();
+#if CAN_GATEWAY_CAPTURE_ENABLE
+	canGatewayTicks++;
+#endif
+#else
 	if(interruptCounter >= 5)
 	{
 		ReceiveCanMessage();
 
+		DRV_CANFDSPI_ReadWord(DRV_CANFDSPI_INDEX_0, cREGADDR_CiTBC, &canTime);
+		DRV_CANFDSPI_BusLoadSnapshot(&canBusLoad, canTime, &canBusLoadSnapshot);
+
 		TransmitCanMessage();
 
 		interruptCounter = 0;
 	}
 
 	interruptCounter++;
+#endif
 }
 
 int main(void)
@@ -296,7 +856,11 @@ int main(void)
 
 	DRV_SPI_Initialize();
 
+#if CAN_TDC_CALIBRATION_ENABLE
+	CalibrateTdc();
+#else
 	InitCanFdChip();
+#endif
 
 	ramTestStatus = TestCanChipRamAccess();
 
@@ -313,7 +877,11 @@ int main(void)
 		Nop();
 	}
 #endif
+#if CAN_GATEWAY_ENABLE
+	GatewayInitialize();
+#else
 	TransmitCanMessage();
+#endif
 
 	/***********************************************************************
 	 * configure systick timer
@@ -322,15 +890,24 @@ int main(void)
 	SysTick->VAL = 0;
 
 	// Set counted value to SYST_RVR register
+#if CAN_GATEWAY_ENABLE
+	SysTick->LOAD = CAN_GATEWAY_SYSTICK_CYCLES;
+#else
 	SysTick->LOAD = (1<<23);
+#endif
 
-	// Set bit 0(ENABLE) and 1(TICKINT) in SYST_CSR register
-	SysTick->CTRL |= 3;
+	// Set bit 0(ENABLE), 1(TICKINT) and 2(CLKSOURCE) in SYST_CSR register
+	SysTick->CTRL = 7;
 
 	// Force the counter to be placed into memory
 	volatile static int i = 0 ;
-	// Enter an infinite loop, just incrementing a counter
+	// Enter an infinite loop, process received messages and increment a counter
 	while(1) {
+#if CAN_GATEWAY_ENABLE
+		GatewayService();
+#else
+		ProcessCanMessages();
+#endif
 		i++ ;
 	}
 	return 0 ;
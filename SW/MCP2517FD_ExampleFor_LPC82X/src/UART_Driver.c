@@ -32,6 +32,32 @@ static uint8_t FractionalGaneratorFractionalMultiplier = 0x0;
 
 static uint8_t UartFieldBRGVAL;
 
+typedef struct
+{
+	UART_RingBuffer tx;
+	UART_RingBuffer rx;
+	volatile uint32_t overrun;
+	volatile uint32_t framing;
+	volatile uint32_t parity;
+	volatile uint32_t rxDropped;
+	bool enabled;
+	bool dmaTx;
+	uint16_t dmaTxBytes;//bytes sent by current DMA chain, 0 - DMA idle
+}UART_RingPort;
+
+static UART_RingPort RingPort[UART_DEVICES];
+
+//XFERCOUNT field is 10 bits
+#define UART_DMA_MAX_SPAN 1024
+
+//USARTn TX request is connected to DMA channel 2n+1
+#define UART_DMA_TX_CHANNEL(portNumber) ((portNumber) * 2 + 1)
+
+//descriptor of first span is in channel table(owned by application) and is linked with
+//descriptor of second span
+static DMA_CHDESC_T *DmaDescriptorTable;
+static DMA_CHDESC_T DmaLinkedDescriptor[UART_DEVICES] __attribute__((aligned(16)));
+
 /*
  * Equation how baudrate is calculated:
  *
@@ -198,3 +224,267 @@ UART_Status UART_ReturnStatusRegister(uint8_t portNumber)
 	UART_Status status = *((UART_Status*)&(UART_Port->STAT));
 	return status;
 }
+
+bool UART_EnableRingBuffers(uint8_t portNumber, uint8_t* txMemory, uint16_t txSize, uint8_t* rxMemory, uint16_t rxSize)
+{
+	LPC_USART_T *UART_Port = (LPC_USART_T*)UART_GetBaseAddress(portNumber);
+	UART_RingPort *port = &RingPort[portNumber];
+
+	if(UART_Port == 0)
+		return false;
+
+	if(!UART_RingBufferInit(&port->tx, txMemory, txSize) || !UART_RingBufferInit(&port->rx, rxMemory, rxSize))
+		return false;
+
+	port->overrun = 0;
+	port->framing = 0;
+	port->parity = 0;
+	port->rxDropped = 0;
+	port->enabled = true;
+
+	//TXRDY interrupt is enabled only when TX buffer contain data
+	UART_Port->INTENSET = UART_INT_RXRDY|UART_INT_OVERRUN|UART_INT_FRAMERR|UART_INT_PARITYERR;
+
+	return true;
+}
+
+/*
+ * Start DMA of data waiting in TX buffer as chain of one or two descriptors, only the
+ * last one generate interrupt. Must be called when DMA channel is idle and DMA interrupt
+ * can't be serviced at the same time.
+ */
+static void UART_DmaTxStart(uint8_t portNumber)
+{
+	LPC_USART_T *UART_Port = (LPC_USART_T*)UART_GetBaseAddress(portNumber);
+	UART_RingPort *port = &RingPort[portNumber];
+	uint8_t channel = UART_DMA_TX_CHANNEL(portNumber);
+	DMA_CHDESC_T *first = &DmaDescriptorTable[channel];
+	DMA_CHDESC_T *second = &DmaLinkedDescriptor[portNumber];
+	uint32_t transferConfig = DMA_XFERCFG_CFGVALID|DMA_XFERCFG_SWTRIG|DMA_XFERCFG_WIDTH_8|
+			DMA_XFERCFG_SRCINC_1|DMA_XFERCFG_DSTINC_0;
+	UART_RingBufferDmaChain chain;
+
+	if(UART_RingBufferDmaPlan(&port->tx, UART_DMA_MAX_SPAN, &chain) == 0)
+	{
+		port->dmaTxBytes = 0;
+		return;
+	}
+
+	port->dmaTxBytes = chain.total;
+
+	//source and destination are addresses of the last byte
+	first->source = DMA_ADDR(chain.start[0] + chain.length[0] - 1);
+	first->dest = DMA_ADDR(&UART_Port->TXDATA);
+
+	if(chain.spans > 1)
+	{
+		second->xfercfg = transferConfig|DMA_XFERCFG_SETINTA|DMA_XFERCFG_XFERCOUNT(chain.length[1]);
+		second->source = DMA_ADDR(chain.start[1] + chain.length[1] - 1);
+		second->dest = DMA_ADDR(&UART_Port->TXDATA);
+		second->next = 0;
+
+		first->next = DMA_ADDR(second);
+		LPC_DMA->DMACH[channel].XFERCFG = transferConfig|DMA_XFERCFG_RELOAD|DMA_XFERCFG_XFERCOUNT(chain.length[0]);
+	}
+	else
+	{
+		first->next = 0;
+		LPC_DMA->DMACH[channel].XFERCFG = transferConfig|DMA_XFERCFG_SETINTA|DMA_XFERCFG_XFERCOUNT(chain.length[0]);
+	}
+}
+
+bool UART_EnableDmaTx(uint8_t portNumber, DMA_CHDESC_T* descriptorTable)
+{
+	LPC_USART_T *UART_Port = (LPC_USART_T*)UART_GetBaseAddress(portNumber);
+	uint8_t channel = UART_DMA_TX_CHANNEL(portNumber);
+
+	if((UART_Port == 0) || !RingPort[portNumber].enabled || (descriptorTable == 0))
+		return false;
+
+	//table must be aligned to 512 bytes
+	if((DMA_ADDR(descriptorTable) & 0x1FF) != 0)
+		return false;
+
+	//connect DMA to AHB bus
+	LPC_SYSCON->SYSAHBCLKCTRL |= (1<<29);
+
+	//table is common for all channels, it is set only when DMA isn't used yet and table
+	//already used by other channels isn't replaced
+	if(LPC_DMA->SRAMBASE == 0)
+		LPC_DMA->SRAMBASE = DMA_ADDR(descriptorTable);
+	else if(LPC_DMA->SRAMBASE != DMA_ADDR(descriptorTable))
+		return false;
+
+	DmaDescriptorTable = descriptorTable;
+
+	if((LPC_DMA->CTRL & 1) == 0)
+		LPC_DMA->CTRL = 1;
+
+	//channel is triggered by software and transfer every byte when USART TXRDY request it
+	LPC_DMA->DMACH[channel].CFG = DMA_CFG_PERIPHREQEN;
+	LPC_DMA->DMACOMMON[0].ENABLESET = (1<<channel);
+	LPC_DMA->DMACOMMON[0].INTENSET = (1<<channel);
+
+	UART_Port->INTENCLR = UART_INT_TXRDY;
+	RingPort[portNumber].dmaTxBytes = 0;
+	RingPort[portNumber].dmaTx = true;
+
+	NVIC_EnableIRQ(DMA_IRQn);
+
+	return true;
+}
+
+uint16_t UART_Write(uint8_t portNumber, const uint8_t* data, uint16_t length)
+{
+	LPC_USART_T *UART_Port = (LPC_USART_T*)UART_GetBaseAddress(portNumber);
+	uint16_t written;
+
+	if((UART_Port == 0) || !RingPort[portNumber].enabled)
+		return 0;
+
+	written = UART_RingBufferWrite(&RingPort[portNumber].tx, data, length);
+
+	if(written == 0)
+		return 0;
+
+	if(RingPort[portNumber].dmaTx)
+	{
+		//idle DMA is started here, otherwise DMA interrupt start next chain
+		NVIC_DisableIRQ(DMA_IRQn);
+
+		if(RingPort[portNumber].dmaTxBytes == 0)
+			UART_DmaTxStart(portNumber);
+
+		NVIC_EnableIRQ(DMA_IRQn);
+	}
+	else
+	{
+		//interrupt is disabled by itself when TX buffer will be empty
+		UART_Port->INTENSET = UART_INT_TXRDY;
+	}
+
+	return written;
+}
+
+uint16_t UART_Read(uint8_t portNumber, uint8_t* buffer, uint16_t length)
+{
+	if((portNumber >= UART_DEVICES) || !RingPort[portNumber].enabled)
+		return 0;
+
+	return UART_RingBufferRead(&RingPort[portNumber].rx, buffer, length);
+}
+
+uint16_t UART_WriteSpace(uint8_t portNumber)
+{
+	if((portNumber >= UART_DEVICES) || !RingPort[portNumber].enabled)
+		return 0;
+
+	return UART_RingBufferSpace(&RingPort[portNumber].tx);
+}
+
+uint16_t UART_ReadCount(uint8_t portNumber)
+{
+	if((portNumber >= UART_DEVICES) || !RingPort[portNumber].enabled)
+		return 0;
+
+	return UART_RingBufferCount(&RingPort[portNumber].rx);
+}
+
+void UART_ReturnErrorCounters(uint8_t portNumber, UART_ErrorCounters* counters)
+{
+	UART_RingPort *port = &RingPort[portNumber];
+
+	if(portNumber >= UART_DEVICES)
+		return;
+
+	counters->overrun = port->overrun;
+	counters->framing = port->framing;
+	counters->parity = port->parity;
+	counters->rxDropped = port->rxDropped;
+}
+
+static void UART_RingInterruptService(uint8_t portNumber)
+{
+	LPC_USART_T *UART_Port = (LPC_USART_T*)UART_GetBaseAddress(portNumber);
+	UART_RingPort *port = &RingPort[portNumber];
+	UART_Status status = UART_ReturnStatusRegister(portNumber);
+	uint32_t clearFlags = 0;
+	uint8_t byte;
+
+	if(!port->enabled)
+	{
+		UART_Port->INTENCLR = UART_INT_RXRDY|UART_INT_TXRDY|UART_INT_OVERRUN|UART_INT_FRAMERR|UART_INT_PARITYERR;
+		return;
+	}
+
+	//error flags are cleared by write one, only counted flags are cleared
+	if(status.OVERRUNINT == 1)
+	{
+		port->overrun++;
+		clearFlags |= UART_INT_OVERRUN;
+	}
+
+	if(status.FRAMERRINT == 1)
+	{
+		port->framing++;
+		clearFlags |= UART_INT_FRAMERR;
+	}
+
+	if(status.PARITYERRINT == 1)
+	{
+		port->parity++;
+		clearFlags |= UART_INT_PARITYERR;
+	}
+
+	if(clearFlags != 0)
+		UART_Port->STAT = clearFlags;
+
+	//USART has only one byte receive buffer
+	if(status.RXRDY == 1)
+	{
+		byte = UART_Port->RXDATA;
+
+		if(!UART_RingBufferPut(&port->rx, byte))
+			port->rxDropped++;
+	}
+
+	if((status.TXRDY == 1) && ((UART_Port->INTENSET & UART_INT_TXRDY) != 0))
+	{
+		if(UART_RingBufferGet(&port->tx, &byte))
+			UART_Port->TXDATA = byte;
+		else
+			UART_Port->INTENCLR = UART_INT_TXRDY;
+	}
+}
+
+void UART0_IRQHandler(void)
+{
+	UART_RingInterruptService(0);
+}
+
+void UART1_IRQHandler(void)
+{
+	UART_RingInterruptService(1);
+}
+
+void UART2_IRQHandler(void)
+{
+	UART_RingInterruptService(2);
+}
+
+void UART_DmaInterruptService(uint8_t portNumber)
+{
+	uint8_t channel = UART_DMA_TX_CHANNEL(portNumber);
+
+	if((portNumber >= UART_DEVICES) || !RingPort[portNumber].dmaTx)
+		return;
+
+	if((LPC_DMA->DMACOMMON[0].INTA & (1<<channel)) == 0)
+		return;
+
+	LPC_DMA->DMACOMMON[0].INTA = (1<<channel);
+
+	//whole chain was sent, bytes can be overwritten by UART_Write
+	UART_RingBufferSkip(&RingPort[portNumber].tx, RingPort[portNumber].dmaTxBytes);
+	UART_DmaTxStart(portNumber);
+}
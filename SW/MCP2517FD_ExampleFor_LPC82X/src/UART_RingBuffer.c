@@ -0,0 +1,160 @@
+/*
+* Copyright (c) 2026, Adrian Chemicz
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*    1. Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*    2. Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*    3. Neither the name of contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDER BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "UART_RingBuffer.h"
+
+bool UART_RingBufferInit(UART_RingBuffer* ring, uint8_t* memory, uint16_t size)
+{
+	//size must be power of two, the biggest one in uint16_t is UART_RING_BUFFER_MAX_SIZE
+	if((size == 0) || ((size & (size - 1)) != 0))
+		return false;
+
+	ring->memory = memory;
+	ring->mask = size - 1;
+	ring->writeIndex = 0;
+	ring->readIndex = 0;
+
+	return true;
+}
+
+uint16_t UART_RingBufferCount(const UART_RingBuffer* ring)
+{
+	return (uint16_t)(ring->writeIndex - ring->readIndex);
+}
+
+uint16_t UART_RingBufferSpace(const UART_RingBuffer* ring)
+{
+	return (uint16_t)(ring->mask + 1 - UART_RingBufferCount(ring));
+}
+
+bool UART_RingBufferPut(UART_RingBuffer* ring, uint8_t byte)
+{
+	uint16_t writeIndex = ring->writeIndex;
+
+	if((uint16_t)(writeIndex - ring->readIndex) > ring->mask)
+		return false;
+
+	ring->memory[writeIndex & ring->mask] = byte;
+
+	//index is changed after byte is stored, reader can't see byte before
+	ring->writeIndex = writeIndex + 1;
+
+	return true;
+}
+
+bool UART_RingBufferGet(UART_RingBuffer* ring, uint8_t* byte)
+{
+	uint16_t readIndex = ring->readIndex;
+
+	if(readIndex == ring->writeIndex)
+		return false;
+
+	*byte = ring->memory[readIndex & ring->mask];
+
+	//index is changed after byte is taken, writer can't overwrite it before
+	ring->readIndex = readIndex + 1;
+
+	return true;
+}
+
+uint16_t UART_RingBufferWrite(UART_RingBuffer* ring, const uint8_t* data, uint16_t length)
+{
+	uint16_t writeIndex = ring->writeIndex;
+	uint16_t space = (uint16_t)(ring->mask + 1 - (uint16_t)(writeIndex - ring->readIndex));
+
+	if(length > space)
+		length = space;
+
+	for(uint16_t i = 0; i < length; i++)
+		ring->memory[(uint16_t)(writeIndex + i) & ring->mask] = data[i];
+
+	//all bytes are visible for reader at once
+	ring->writeIndex = writeIndex + length;
+
+	return length;
+}
+
+uint16_t UART_RingBufferRead(UART_RingBuffer* ring, uint8_t* buffer, uint16_t length)
+{
+	uint16_t readIndex = ring->readIndex;
+	uint16_t count = (uint16_t)(ring->writeIndex - readIndex);
+
+	if(length > count)
+		length = count;
+
+	for(uint16_t i = 0; i < length; i++)
+		buffer[i] = ring->memory[(uint16_t)(readIndex + i) & ring->mask];
+
+	ring->readIndex = readIndex + length;
+
+	return length;
+}
+
+uint16_t UART_RingBufferSkip(UART_RingBuffer* ring, uint16_t length)
+{
+	uint16_t readIndex = ring->readIndex;
+	uint16_t count = (uint16_t)(ring->writeIndex - readIndex);
+
+	if(length > count)
+		length = count;
+
+	ring->readIndex = readIndex + length;
+
+	return length;
+}
+
+uint8_t UART_RingBufferDmaPlan(const UART_RingBuffer* ring, uint16_t maxSpan, UART_RingBufferDmaChain* chain)
+{
+	uint16_t index = ring->readIndex;
+	uint16_t count = (uint16_t)(ring->writeIndex - index);
+	uint16_t length;
+
+	chain->spans = 0;
+	chain->total = 0;
+
+	while((count > 0) && (maxSpan > 0) && (chain->spans < UART_RING_BUFFER_DMA_SPANS))
+	{
+		//span end at the end of memory or after maxSpan bytes
+		length = (uint16_t)(ring->mask + 1 - (index & ring->mask));
+
+		if(length > count)
+			length = count;
+
+		if(length > maxSpan)
+			length = maxSpan;
+
+		chain->start[chain->spans] = &ring->memory[index & ring->mask];
+		chain->length[chain->spans] = length;
+		chain->spans++;
+		chain->total += length;
+
+		index += length;
+		count -= length;
+	}
+
+	return chain->spans;
+}